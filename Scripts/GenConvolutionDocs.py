@@ -38,6 +38,14 @@ StandardNames = [
     "LTE PBCH",
 ]
 
+# Control channels gate access to everything else, so their decoders default
+# to a higher priority.
+HighPriorityStandardNames = [
+    "GSM RACH",
+    "GSM SCH",
+    "LTE PBCH",
+]
+
 # Note: we need the dummy functions, or Pothos will parse everything as a single
 # giant doc.
 EncoderTemplate = """
@@ -65,6 +73,42 @@ DecoderTemplate = """
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/{1}_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "{2}"
+ * |preview valid
  */
 void {1}();
 """
@@ -76,9 +120,12 @@ def convertStandardName(standardName):
 
     return convertedStandardName
 
+def defaultPriority(standardName):
+    return "High" if standardName in HighPriorityStandardNames else "Normal"
+
 def outputDocFile():
     encoderDocs = "".join([EncoderTemplate.format(standardName, convertStandardName(standardName)) for standardName in StandardNames])
-    decoderDocs = "".join([DecoderTemplate.format(standardName, convertStandardName(standardName)) for standardName in StandardNames])
+    decoderDocs = "".join([DecoderTemplate.format(standardName, convertStandardName(standardName), defaultPriority(standardName)) for standardName in StandardNames])
     fileContents = "{0}\n{1}\n{2}".format(Prefix, encoderDocs, decoderDocs)
 
     with open(OutputFile, "w") as f:
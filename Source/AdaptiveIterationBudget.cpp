@@ -0,0 +1,118 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "AdaptiveIterationBudget.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// SNR bins of half a dB, with everything outside of the range in the end bins
+static constexpr double MinSNR = -10.0;
+static constexpr double SNRBinWidth = 0.5;
+static constexpr size_t NumSNRBins = 61;
+
+// A bin needs this many blocks before its cap drops below the maximum.
+static constexpr std::uint32_t MinBinHistory = 32;
+
+// A bin's counts are halved when it reaches this many blocks.
+static constexpr std::uint32_t MaxBinHistory = 1024;
+
+static size_t snrBin(double snr)
+{
+    const double bin = std::floor((snr - MinSNR) / SNRBinWidth);
+    if(!(bin > 0.0)) return 0;
+
+    return std::min(static_cast<size_t>(bin), (NumSNRBins - 1));
+}
+
+AdaptiveIterationBudget::AdaptiveIterationBudget():
+    _targetBLER(0.01),
+    _convergenceCounts(NumSNRBins),
+    _binTotals(NumSNRBins, 0)
+{
+}
+
+double AdaptiveIterationBudget::targetBLER() const
+{
+    return _targetBLER;
+}
+
+void AdaptiveIterationBudget::setTargetBLER(double targetBLER)
+{
+    if(!(targetBLER > 0.0) || !(targetBLER < 1.0))
+    {
+        throw Pothos::InvalidArgumentException("Target BLER must be in (0, 1)");
+    }
+
+    _targetBLER = targetBLER;
+}
+
+double AdaptiveIterationBudget::estimateSNR(const std::int8_t* softBits, size_t length, size_t stride)
+{
+    double m2 = 0.0;
+    double m4 = 0.0;
+    for(size_t elem = 0; elem < length; ++elem)
+    {
+        const double squared = double(softBits[elem * stride]) * double(softBits[elem * stride]);
+        m2 += squared;
+        m4 += squared * squared;
+    }
+    m2 /= double(length);
+    m4 /= double(length);
+
+    // For real BPSK with signal power S and noise power N, M2 = S+N and
+    // M4 = S^2 + 6SN + 3N^2, so S = sqrt((3*M2^2 - M4) / 2).
+    const double signalPower = std::sqrt(std::max(0.0, (((3.0 * m2 * m2) - m4) / 2.0)));
+    const double noisePower = m2 - signalPower;
+
+    if(!(signalPower > 0.0)) return MinSNR;
+    if(!(noisePower > 0.0))  return (MinSNR + (SNRBinWidth * NumSNRBins));
+
+    return 10.0 * std::log10(signalPower / noisePower);
+}
+
+size_t AdaptiveIterationBudget::iterationCap(double snr, size_t maxIterations) const
+{
+    const size_t bin = snrBin(snr);
+    const auto& counts = _convergenceCounts[bin];
+    const auto total = _binTotals[bin];
+    if(total < MinBinHistory) return maxIterations;
+
+    // Blocks that didn't converge count against every cap.
+    const double required = (1.0 - _targetBLER) * double(total);
+    double numConverged = 0.0;
+    for(size_t iteration = 1; (iteration < counts.size()) && (iteration < maxIterations); ++iteration)
+    {
+        numConverged += double(counts[iteration]);
+        if(numConverged >= required) return iteration;
+    }
+
+    return maxIterations;
+}
+
+void AdaptiveIterationBudget::recordDecode(double snr, size_t convergedIteration)
+{
+    const size_t bin = snrBin(snr);
+    auto& counts = _convergenceCounts[bin];
+
+    if(counts.size() <= convergedIteration) counts.resize(convergedIteration+1, 0);
+    ++counts[convergedIteration];
+
+    if(++_binTotals[bin] >= MaxBinHistory)
+    {
+        _binTotals[bin] = 0;
+        for(auto& count: counts)
+        {
+            count /= 2;
+            _binTotals[bin] += count;
+        }
+    }
+}
+
+void AdaptiveIterationBudget::reset()
+{
+    for(auto& counts: _convergenceCounts) counts.clear();
+    std::fill(_binTotals.begin(), _binTotals.end(), 0);
+}
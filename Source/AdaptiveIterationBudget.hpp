@@ -0,0 +1,52 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Chooses an iterative decoder's iteration cap for each block from an
+// estimate of the block's SNR. For each SNR bin, it learns how many
+// iterations blocks took to converge, and caps each block at the fewest
+// iterations that let all but the target block error rate of blocks in
+// its bin converge. Bins without enough history use the maximum, as do
+// bins where too many blocks don't converge, so the cap corrects itself
+// when the channel changes.
+//
+// It only learns from decoders that can say which iteration a block
+// converged at. In the LTE turbo decoder, those are the in-tree engines,
+// checking their stopping criterion after each iteration. TurboFEC always
+// runs every iteration, so with it the budget never learns, and every
+// block gets the maximum.
+class AdaptiveIterationBudget
+{
+public:
+    AdaptiveIterationBudget();
+
+    double targetBLER() const;
+
+    void setTargetBLER(double targetBLER);
+
+    // Estimates the SNR, in dB, of BPSK soft bits with the M2M4 moment
+    // estimator, which doesn't need the transmitted bits. Elements are
+    // stride apart.
+    static double estimateSNR(const std::int8_t* softBits, size_t length, size_t stride);
+
+    size_t iterationCap(double snr, size_t maxIterations) const;
+
+    // A converged iteration of 0 means the block didn't converge within
+    // its cap.
+    void recordDecode(double snr, size_t convergedIteration);
+
+    void reset();
+
+private:
+    double _targetBLER;
+
+    // [bin][converged iteration], with counts halved now and then so the
+    // history follows the channel
+    std::vector<std::vector<std::uint32_t>> _convergenceCounts;
+    std::vector<std::uint32_t> _binTotals;
+};
@@ -0,0 +1,33 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "BufferChunkPool.hpp"
+
+BufferChunkPool::BufferChunkPool(size_t numBuffers):
+    _buffers(numBuffers),
+    _nextBuffer(0)
+{
+}
+
+Pothos::BufferChunk BufferChunkPool::get(const Pothos::DType& dtype, size_t numElements)
+{
+    const size_t numBytes = numElements * dtype.size();
+
+    for(size_t i = 0; i < _buffers.size(); ++i)
+    {
+        auto& poolBuffer = _buffers[_nextBuffer];
+        _nextBuffer = (_nextBuffer + 1) % _buffers.size();
+
+        if((0 != poolBuffer.address) && !poolBuffer.unique()) continue;
+
+        if(poolBuffer.length < numBytes) poolBuffer = Pothos::BufferChunk(dtype, numElements);
+
+        auto buffer = poolBuffer;
+        buffer.dtype = dtype;
+        buffer.length = numBytes;
+        return buffer;
+    }
+
+    // Downstream blocks are holding on to every buffer in the pool.
+    return Pothos::BufferChunk(dtype, numElements);
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <Pothos/Framework.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// A fixed number of reusable buffers, for blocks that post buffers larger
+// than their ports'. Once a block has posted a buffer, only the pool and any
+// downstream blocks reference it, so a buffer only the pool references is
+// free to reuse. Buffers grow to the largest size requested.
+//
+// Block thread only.
+class BufferChunkPool
+{
+public:
+    explicit BufferChunkPool(size_t numBuffers);
+
+    // Returns a buffer of the given type and number of elements. Only
+    // allocates if no pooled buffer is free, or the free one is too small.
+    Pothos::BufferChunk get(const Pothos::DType& dtype, size_t numElements);
+
+private:
+    std::vector<Pothos::BufferChunk> _buffers;
+    size_t _nextBuffer;
+};
@@ -0,0 +1,137 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CRC.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <array>
+
+using CRCTable = std::array<std::uint32_t, 256>;
+
+static constexpr std::uint32_t CRC24Mask = 0xFFFFFF;
+
+// Generator polynomials, without the implicit x^24 term
+static constexpr std::uint32_t CRC24APoly = 0x864CFB;
+static constexpr std::uint32_t CRC24BPoly = 0x800063;
+
+static CRCTable makeCRCTable(std::uint32_t poly)
+{
+    CRCTable table;
+    for(std::uint32_t byte = 0; byte < table.size(); ++byte)
+    {
+        std::uint32_t crc = byte << 16;
+        for(size_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x800000) ? ((crc << 1) ^ poly) : (crc << 1);
+        }
+
+        table[byte] = crc & CRC24Mask;
+    }
+
+    return table;
+}
+
+static const CRCTable& getCRCTable(CRCType crcType)
+{
+    static const CRCTable CRC24ATable = makeCRCTable(CRC24APoly);
+    static const CRCTable CRC24BTable = makeCRCTable(CRC24BPoly);
+
+    switch(crcType)
+    {
+        case CRCType::CRC24A:
+            return CRC24ATable;
+
+        case CRCType::CRC24B:
+            return CRC24BTable;
+
+        default:
+            throw Pothos::InvalidArgumentException("No CRC table for the given CRC type");
+    }
+}
+
+CRCType crcTypeFromString(const std::string& crcType)
+{
+    if("None" == crcType)        return CRCType::None;
+    else if("CRC24A" == crcType) return CRCType::CRC24A;
+    else if("CRC24B" == crcType) return CRCType::CRC24B;
+
+    throw Pothos::InvalidArgumentException("Invalid CRC type: "+crcType);
+}
+
+std::string crcTypeToString(CRCType crcType)
+{
+    switch(crcType)
+    {
+        case CRCType::None:
+            return "None";
+
+        case CRCType::CRC24A:
+            return "CRC24A";
+
+        case CRCType::CRC24B:
+            return "CRC24B";
+
+        default:
+            throw Pothos::AssertionViolationException("Invalid CRC type");
+    }
+}
+
+std::uint32_t calcCRC24(
+    CRCType crcType,
+    const std::uint8_t* bits,
+    size_t numBits,
+    bool unpacked)
+{
+    return updateCRC24(crcType, 0, bits, numBits, unpacked);
+}
+
+std::uint32_t updateCRC24(
+    CRCType crcType,
+    std::uint32_t crc,
+    const std::uint8_t* bits,
+    size_t numBits,
+    bool unpacked)
+{
+    const auto& table = getCRCTable(crcType);
+
+    const size_t numBytes = numBits / 8;
+
+    for(size_t byteIndex = 0; byteIndex < numBytes; ++byteIndex)
+    {
+        std::uint8_t byte = 0;
+        if(unpacked)
+        {
+            const auto* byteBits = bits + (byteIndex * 8);
+            for(size_t bit = 0; bit < 8; ++bit)
+            {
+                byte = std::uint8_t(byte << 1) | (byteBits[bit] & 1);
+            }
+        }
+        else byte = bits[byteIndex];
+
+        crc = ((crc << 8) ^ table[((crc >> 16) ^ byte) & 0xFF]) & CRC24Mask;
+    }
+
+    // Any remaining bits are shifted in one at a time.
+    const auto poly = (CRCType::CRC24A == crcType) ? CRC24APoly : CRC24BPoly;
+    for(size_t bitIndex = (numBytes * 8); bitIndex < numBits; ++bitIndex)
+    {
+        const std::uint32_t bit = unpacked ? (bits[bitIndex] & 1)
+                                           : ((bits[bitIndex / 8] >> (7 - (bitIndex % 8))) & 1);
+
+        const bool feedback = ((crc >> 23) & 1) != bit;
+        crc = ((crc << 1) ^ (feedback ? poly : 0)) & CRC24Mask;
+    }
+
+    return crc;
+}
+
+bool checkCRC24(
+    CRCType crcType,
+    const std::uint8_t* bits,
+    size_t numBits,
+    bool unpacked)
+{
+    return (0 == calcCRC24(crcType, bits, numBits, unpacked));
+}
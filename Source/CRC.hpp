@@ -0,0 +1,48 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The 24-bit CRCs used by LTE (3GPP TS 36.212, section 5.1.1). CRC24A
+// covers a whole transport block, and CRC24B covers each code block when
+// a transport block is segmented.
+enum class CRCType
+{
+    None,
+    CRC24A,
+    CRC24B
+};
+
+CRCType crcTypeFromString(const std::string& crcType);
+
+std::string crcTypeToString(CRCType crcType);
+
+// Calculates the CRC of the given bits, either one bit per byte or packed
+// MSB-first, matching the output of the LTE turbo decoder.
+std::uint32_t calcCRC24(
+    CRCType crcType,
+    const std::uint8_t* bits,
+    size_t numBits,
+    bool unpacked);
+
+// Continues calculating a CRC over more bits, for bits that aren't
+// contiguous. calcCRC24() starts from a CRC of 0. Packed bits start on a
+// byte boundary.
+std::uint32_t updateCRC24(
+    CRCType crcType,
+    std::uint32_t crc,
+    const std::uint8_t* bits,
+    size_t numBits,
+    bool unpacked);
+
+// Returns true if the given bits end with a matching CRC, in which case
+// the CRC over all of the bits is zero.
+bool checkCRC24(
+    CRCType crcType,
+    const std::uint8_t* bits,
+    size_t numBits,
+    bool unpacked);
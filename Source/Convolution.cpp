@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "ConvolutionBase.hpp"
+#include "DecoderFarm.hpp"
 #include "Utility.hpp"
 
 extern "C"
@@ -22,6 +23,7 @@ extern "C"
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 static const std::unordered_map<std::string, const lte_conv_code*> ConvCodeMap =
@@ -54,6 +56,14 @@ static const std::unordered_map<std::string, const lte_conv_code*> ConvCodeMap =
 };
 using ConvCodeMapPair = std::unordered_map<std::string, const lte_conv_code*>::value_type;
 
+// Decoders for these standards default to high priority.
+static const std::unordered_set<std::string> ControlChannelStandards =
+{
+    "GSM RACH",
+    "GSM SCH",
+    "LTE PBCH",
+};
+
 // The generator polynomial is stored in a static array of size 4, but the
 // values may not be of size 4. The simplest workaround for the case where
 // existing values exist is just to store the array lengths.
@@ -89,7 +99,10 @@ static const std::unordered_map<std::string, size_t> GenArrLengthsMap =
 class Convolution: public ConvolutionBase
 {
 public:
-    static Pothos::Block* make(const std::string& standard, bool isEncoder)
+    static Pothos::Block* make(
+        const std::string& standard,
+        bool isEncoder,
+        size_t numChannels)
     {
         auto mapIter = ConvCodeMap.find(standard);
         if(ConvCodeMap.end() != mapIter)
@@ -97,14 +110,20 @@ public:
             return new Convolution(
                            standard,
                            const_cast<lte_conv_code*>(mapIter->second),
-                           isEncoder);
+                           isEncoder,
+                           numChannels);
         }
 
         throw Pothos::InvalidArgumentException("Invalid standard: "+standard);
     }
 
-    Convolution(const std::string& standard, lte_conv_code* pConvCode, bool isEncoder):
-        ConvolutionBase(pConvCode, isEncoder),
+    Convolution(
+        const std::string& standard,
+        lte_conv_code* pConvCode,
+        bool isEncoder,
+        size_t numChannels
+    ):
+        ConvolutionBase(pConvCode, isEncoder, numChannels),
         _standard(standard)
     {
         auto genArrLengthsIter = GenArrLengthsMap.find(_standard);
@@ -119,6 +138,13 @@ public:
                       "Could not find GenArrLengthsMap entry for "+_standard);
         }
 
+        // Control channels are latency-critical, so they shouldn't wait
+        // behind traffic channels for a decode slot.
+        if(!_isEncoder && ControlChannelStandards.count(_standard))
+        {
+            _priority = DecodePriority::High;
+        }
+
         this->registerCall(this, POTHOS_FCN_TUPLE(Convolution, standard));
     }
 
@@ -131,6 +157,99 @@ private:
     std::string _standard;
 };
 
+class ConvolutionDecoderFarmWorkerState: public DecoderFarmWorkerState
+{
+public:
+    ConvolutionDecoderFarmWorkerState(const lte_conv_code* pConvCode):
+        _pConvCode(pConvCode)
+    {}
+
+    void decode(DecoderFarmJob& job) override
+    {
+        throwOnErrCode(::lte_conv_decode(
+            _pConvCode,
+            job.inputs[0].as<const std::int8_t*>(),
+            job.output.as<std::uint8_t*>()));
+    }
+
+private:
+    const lte_conv_code* _pConvCode;
+};
+
+class ConvolutionDecoderFarm: public DecoderFarmBase
+{
+public:
+    static Pothos::Block* make(const std::string& standard, size_t numWorkers)
+    {
+        auto mapIter = ConvCodeMap.find(standard);
+        if(ConvCodeMap.end() != mapIter)
+        {
+            return new ConvolutionDecoderFarm(standard, mapIter->second, numWorkers);
+        }
+
+        throw Pothos::InvalidArgumentException("Invalid standard: "+standard);
+    }
+
+    ConvolutionDecoderFarm(
+        const std::string& standard,
+        const lte_conv_code* pConvCode,
+        size_t numWorkers
+    ):
+        DecoderFarmBase(1, "int8", numWorkers),
+        _standard(standard),
+        _pConvCode(pConvCode)
+    {
+        // As in ConvolutionBase, the simplest way to get the encoded length
+        // is to encode dummy data.
+        std::vector<std::uint8_t> dummyInput(_pConvCode->len);
+        std::vector<std::uint8_t> dummyOutput(_pConvCode->len * 500);
+
+        int encodeRet = ::lte_conv_encode(
+                            _pConvCode,
+                            dummyInput.data(),
+                            dummyOutput.data());
+        throwOnErrCode(encodeRet);
+
+        _encodeSize = static_cast<size_t>(encodeRet);
+
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionDecoderFarm, standard));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionDecoderFarm, length));
+
+        this->registerProbe("length");
+    }
+
+    std::string standard() const
+    {
+        return _standard;
+    }
+
+    int length() const
+    {
+        return _pConvCode->len;
+    }
+
+protected:
+    void findNextFrame(
+        size_t,
+        size_t,
+        FrameInfo& frameInfoOut) override
+    {
+        frameInfoOut.inputSize = _encodeSize;
+        frameInfoOut.outputSize = static_cast<size_t>(_pConvCode->len);
+    }
+
+    std::unique_ptr<DecoderFarmWorkerState> makeWorkerState() override
+    {
+        return std::unique_ptr<DecoderFarmWorkerState>(
+                   new ConvolutionDecoderFarmWorkerState(_pConvCode));
+    }
+
+private:
+    std::string _standard;
+    const lte_conv_code* _pConvCode;
+    size_t _encodeSize;
+};
+
 //
 // Registrations
 //
@@ -158,7 +277,8 @@ static std::vector<Pothos::BlockRegistry> _getConvolutionBlockRegistries()
                    ("/fec/"+convertedStandardName+(isEncoder ? "_encoder" : "_decoder")),
                    Pothos::Callable(&Convolution::make)
                        .bind(standardName, 0)
-                       .bind(isEncoder, 1));
+                       .bind(isEncoder, 1)
+                       .bind(size_t(1), 2));
     };
 
     auto convCodeMapPairToEncoderBlockRegistry = std::bind(convCodeMapPairToBlockRegistry, std::placeholders::_1, true);
@@ -182,3 +302,197 @@ static std::vector<Pothos::BlockRegistry> _getConvolutionBlockRegistries()
 }
 
 static const auto convolutionBlockRegistries = _getConvolutionBlockRegistries();
+
+/*
+ * |PothosDoc Multi-Channel Convolution Encoder
+ *
+ * Encodes multiple independent bytestreams (such as the timeslots of a TDMA
+ * carrier) with the same standard-specific convolution code. Each channel
+ * has its own input and output port, and every frame ready on any channel
+ * is encoded in a single call.
+ *
+ * |category /FEC/Encoders
+ * |keywords coder gsm tdma timeslot channel
+ * |factory /fec/multichannel_conv_encoder(standard,numChannels)
+ *
+ * |param standard[Standard]
+ * |widget ComboBox(editable=False)
+ * |option [GSM XCCH] "GSM XCCH"
+ * |option [GPRS CS2] "GPRS CS2"
+ * |option [GPRS CS3] "GPRS CS3"
+ * |option [GSM RACH] "GSM RACH"
+ * |option [GSM SCH] "GSM SCH"
+ * |option [GSM TCH-FR] "GSM TCH-FR"
+ * |option [GSM TCH-HR] "GSM TCH-HR"
+ * |option [GSM TCH-AFS12.2] "GSM TCH-AFS12.2"
+ * |option [GSM TCH-AFS10.2] "GSM TCH-AFS10.2"
+ * |option [GSM TCH-AFS7.95] "GSM TCH-AFS7.95"
+ * |option [GSM TCH-AFS7.4] "GSM TCH-AFS7.4"
+ * |option [GSM TCH-AFS6.7] "GSM TCH-AFS6.7"
+ * |option [GSM TCH-AFS5.9] "GSM TCH-AFS5.9"
+ * |option [GSM TCH-AHS7.95] "GSM TCH-AHS7.95"
+ * |option [GSM TCH-AHS7.4] "GSM TCH-AHS7.4"
+ * |option [GSM TCH-AHS6.7] "GSM TCH-AHS6.7"
+ * |option [GSM TCH-AHS5.9] "GSM TCH-AHS5.9"
+ * |option [GSM TCH-AHS5.15] "GSM TCH-AHS5.15"
+ * |option [GSM TCH-AHS4.75] "GSM TCH-AHS4.75"
+ * |option [WiMax FCH] "WiMax FCH"
+ * |option [LTE PBCH] "LTE PBCH"
+ * |default "GSM XCCH"
+ * |preview enable
+ *
+ * |param numChannels[Num Channels]
+ * |widget SpinBox(minimum=1)
+ * |default 8
+ * |preview enable
+ */
+static Pothos::BlockRegistry registerMultiChannelConvolutionEncoder(
+    "/fec/multichannel_conv_encoder",
+    Pothos::Callable(&Convolution::make)
+        .bind(true, 1));
+
+/*
+ * |PothosDoc Multi-Channel Convolution Decoder
+ *
+ * Decodes multiple independent soft-bit streams (such as the timeslots of a
+ * TDMA carrier) with the same standard-specific convolution code. Each
+ * channel has its own input and output port, and every frame ready on each
+ * channel is decoded on each call, so a single block can replace one decoder
+ * block per channel.
+ *
+ * |category /FEC/Decoders
+ * |keywords coder gsm tdma timeslot channel
+ * |factory /fec/multichannel_conv_decoder(standard,numChannels)
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param standard[Standard]
+ * |widget ComboBox(editable=False)
+ * |option [GSM XCCH] "GSM XCCH"
+ * |option [GPRS CS2] "GPRS CS2"
+ * |option [GPRS CS3] "GPRS CS3"
+ * |option [GSM RACH] "GSM RACH"
+ * |option [GSM SCH] "GSM SCH"
+ * |option [GSM TCH-FR] "GSM TCH-FR"
+ * |option [GSM TCH-HR] "GSM TCH-HR"
+ * |option [GSM TCH-AFS12.2] "GSM TCH-AFS12.2"
+ * |option [GSM TCH-AFS10.2] "GSM TCH-AFS10.2"
+ * |option [GSM TCH-AFS7.95] "GSM TCH-AFS7.95"
+ * |option [GSM TCH-AFS7.4] "GSM TCH-AFS7.4"
+ * |option [GSM TCH-AFS6.7] "GSM TCH-AFS6.7"
+ * |option [GSM TCH-AFS5.9] "GSM TCH-AFS5.9"
+ * |option [GSM TCH-AHS7.95] "GSM TCH-AHS7.95"
+ * |option [GSM TCH-AHS7.4] "GSM TCH-AHS7.4"
+ * |option [GSM TCH-AHS6.7] "GSM TCH-AHS6.7"
+ * |option [GSM TCH-AHS5.9] "GSM TCH-AHS5.9"
+ * |option [GSM TCH-AHS5.15] "GSM TCH-AHS5.15"
+ * |option [GSM TCH-AHS4.75] "GSM TCH-AHS4.75"
+ * |option [WiMax FCH] "WiMax FCH"
+ * |option [LTE PBCH] "LTE PBCH"
+ * |default "GSM XCCH"
+ * |preview enable
+ *
+ * |param numChannels[Num Channels]
+ * |widget SpinBox(minimum=1)
+ * |default 8
+ * |preview enable
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerMultiChannelConvolutionDecoder(
+    "/fec/multichannel_conv_decoder",
+    Pothos::Callable(&Convolution::make)
+        .bind(false, 1));
+
+/*
+ * |PothosDoc Convolution Decoder Farm
+ *
+ * Decodes a stream of standard-specific convolution-coded frames using a
+ * pool of worker threads, so a single stream can be decoded on multiple
+ * cores. Frames are dispatched to the workers round-robin through lock-free
+ * queues, and decoded frames are output in the order they were received.
+ *
+ * Labels within a frame are output at the start of the decoded frame.
+ *
+ * |category /FEC/Decoders
+ * |keywords coder thread parallel worker
+ * |factory /fec/conv_decoder_farm(standard,numWorkers)
+ * |setter setPriority(priority)
+ *
+ * |param standard[Standard]
+ * |widget ComboBox(editable=False)
+ * |option [GSM XCCH] "GSM XCCH"
+ * |option [GPRS CS2] "GPRS CS2"
+ * |option [GPRS CS3] "GPRS CS3"
+ * |option [GSM RACH] "GSM RACH"
+ * |option [GSM SCH] "GSM SCH"
+ * |option [GSM TCH-FR] "GSM TCH-FR"
+ * |option [GSM TCH-HR] "GSM TCH-HR"
+ * |option [GSM TCH-AFS12.2] "GSM TCH-AFS12.2"
+ * |option [GSM TCH-AFS10.2] "GSM TCH-AFS10.2"
+ * |option [GSM TCH-AFS7.95] "GSM TCH-AFS7.95"
+ * |option [GSM TCH-AFS7.4] "GSM TCH-AFS7.4"
+ * |option [GSM TCH-AFS6.7] "GSM TCH-AFS6.7"
+ * |option [GSM TCH-AFS5.9] "GSM TCH-AFS5.9"
+ * |option [GSM TCH-AHS7.95] "GSM TCH-AHS7.95"
+ * |option [GSM TCH-AHS7.4] "GSM TCH-AHS7.4"
+ * |option [GSM TCH-AHS6.7] "GSM TCH-AHS6.7"
+ * |option [GSM TCH-AHS5.9] "GSM TCH-AHS5.9"
+ * |option [GSM TCH-AHS5.15] "GSM TCH-AHS5.15"
+ * |option [GSM TCH-AHS4.75] "GSM TCH-AHS4.75"
+ * |option [WiMax FCH] "WiMax FCH"
+ * |option [LTE PBCH] "LTE PBCH"
+ * |default "GSM XCCH"
+ * |preview enable
+ *
+ * |param numWorkers[Num Workers]
+ * The number of decoding threads. If 0, one thread per core is used.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerConvolutionDecoderFarm(
+    "/fec/conv_decoder_farm",
+    Pothos::Callable(&ConvolutionDecoderFarm::make));
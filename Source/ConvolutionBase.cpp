@@ -9,16 +9,42 @@
 
 #include <Pothos/Exception.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
-ConvolutionBase::ConvolutionBase(lte_conv_code* pConvCode, bool isEncoder):
+// Posted at the start of an output frame that was zeroed out instead of decoded.
+static const std::string SkippedLabelID = "skipped";
+
+// The output offset of a frame that was dropped instead of decoded
+static constexpr size_t DroppedFrameOffset = ~size_t(0);
+
+ConvolutionBase::ConvolutionBase(
+    lte_conv_code* pConvCode,
+    bool isEncoder,
+    size_t numChannels
+):
     Pothos::Block(),
     _pConvCode(pConvCode),
     _genArrLength(4),
-    _isEncoder(isEncoder)
+    _isEncoder(isEncoder),
+    _numChannels(numChannels),
+    _energyThreshold(0.0f),
+    _numDecodedFrames(0),
+    _numSkippedFrames(0),
+    _priority(DecodePriority::Normal),
+    _frameOutputOffsets(numChannels)
 {
-    this->setupInput(0, (_isEncoder ? "uint8" : "int8"));
-    this->setupOutput(0, "uint8");
+    if(0 == _numChannels)
+    {
+        throw Pothos::InvalidArgumentException("The number of channels must be positive");
+    }
+
+    for(size_t chan = 0; chan < _numChannels; ++chan)
+    {
+        this->setupInput(chan, (_isEncoder ? "uint8" : "int8"));
+        this->setupOutput(chan, "uint8");
+    }
 
     this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, N));
     this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, K));
@@ -27,6 +53,7 @@ ConvolutionBase::ConvolutionBase(lte_conv_code* pConvCode, bool isEncoder):
     this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, gen));
     this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, puncture));
     this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, terminationType));
+    this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, numChannels));
 
     this->registerProbe("N");
     this->registerProbe("K");
@@ -35,6 +62,32 @@ ConvolutionBase::ConvolutionBase(lte_conv_code* pConvCode, bool isEncoder):
     this->registerProbe("gen");
     this->registerProbe("puncture");
     this->registerProbe("terminationType");
+    this->registerProbe("numChannels");
+
+    if(!_isEncoder)
+    {
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, energyThreshold));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, setEnergyThreshold));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, numDecodedFrames));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, numSkippedFrames));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, deadlineBudget));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, setDeadlineBudget));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, timestampID));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, setTimestampID));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, numDroppedFrames));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, priority));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, setPriority));
+        this->registerCall(this, POTHOS_FCN_TUPLE(ConvolutionBase, resetFrameCounts));
+
+        this->registerProbe("energyThreshold");
+        this->registerProbe("numDecodedFrames");
+        this->registerProbe("numSkippedFrames");
+        this->registerProbe("deadlineBudget");
+        this->registerProbe("numDroppedFrames");
+        this->registerProbe("priority");
+
+        this->registerSignal("energyThresholdChanged");
+    }
 }
 
 ConvolutionBase::~ConvolutionBase() {}
@@ -93,12 +146,161 @@ std::string ConvolutionBase::terminationType() const
     return this->_terminationType();
 }
 
-void ConvolutionBase::work()
+size_t ConvolutionBase::numChannels() const
+{
+    return _numChannels;
+}
+
+float ConvolutionBase::energyThreshold() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return _energyThreshold;
+}
+
+void ConvolutionBase::setEnergyThreshold(float energyThreshold)
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    if(energyThreshold < 0.0f)
+    {
+        throw Pothos::InvalidArgumentException("Energy threshold must be >= 0");
+    }
+
+    _energyThreshold = energyThreshold;
+
+    this->emitSignal("energyThresholdChanged", _energyThreshold);
+}
+
+unsigned long long ConvolutionBase::numDecodedFrames() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return _numDecodedFrames;
+}
+
+unsigned long long ConvolutionBase::numSkippedFrames() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return _numSkippedFrames;
+}
+
+double ConvolutionBase::deadlineBudget() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return _deadlineTracker.budget();
+}
+
+void ConvolutionBase::setDeadlineBudget(double deadlineBudget)
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    _deadlineTracker.setBudget(deadlineBudget);
+}
+
+std::string ConvolutionBase::timestampID() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return _deadlineTracker.timestampID();
+}
+
+void ConvolutionBase::setTimestampID(const std::string& timestampID)
 {
     Poco::FastMutex::ScopedLock lock(_convCodeMutex);
 
-    if(_isEncoder) this->encoderWork();
-    else           this->decoderWork();
+    _deadlineTracker.setTimestampID(timestampID);
+}
+
+unsigned long long ConvolutionBase::numDroppedFrames() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return _deadlineTracker.numDroppedFrames();
+}
+
+std::string ConvolutionBase::priority() const
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    return decodePriorityToString(_priority);
+}
+
+void ConvolutionBase::setPriority(const std::string& priority)
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    _priority = decodePriorityFromString(priority);
+}
+
+void ConvolutionBase::resetFrameCounts()
+{
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+
+    _numDecodedFrames = 0;
+    _numSkippedFrames = 0;
+    _deadlineTracker.resetCounts();
+}
+
+void ConvolutionBase::propagateLabels(const Pothos::InputPort* input)
+{
+    if(!_isEncoder)
+    {
+        // Decoded frames are a different size than their input, and dropped
+        // frames produce no output, so each label moves to the start of its
+        // frame's output, and labels within dropped frames are dropped too.
+        auto output = this->output(input->index());
+        const auto& frameOutputOffsets = _frameOutputOffsets[input->index()];
+        const auto inputFrameSize = static_cast<size_t>(_expectedEncodeSize);
+
+        for(const auto& label: input->labels())
+        {
+            const auto frame = label.index / inputFrameSize;
+            if((frame >= frameOutputOffsets.size()) || (DroppedFrameOffset == frameOutputOffsets[frame])) continue;
+
+            auto outputLabel = label;
+            outputLabel.index = frameOutputOffsets[frame];
+            output->postLabel(outputLabel);
+        }
+    }
+    else if(_numChannels > 1)
+    {
+        // Each channel's labels only apply to its own output.
+        auto output = this->output(input->index());
+        for(const auto& label: input->labels())
+        {
+            output->postLabel(label);
+        }
+    }
+    else Pothos::Block::propagateLabels(input);
+}
+
+void ConvolutionBase::work()
+{
+    if(_isEncoder)
+    {
+        Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+        this->encoderWork();
+        return;
+    }
+
+    // Waiting on the DecodeScheduler with the mutex held would block calls
+    // and probes on this block behind every other block's decodes, so the
+    // slot is taken first, and covers every frame decoded in this call.
+    DecodePriority priority = DecodePriority::Normal;
+    {
+        Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+        if(!this->_hasDecoderFrames()) return;
+
+        priority = _priority;
+    }
+
+    DecodeScheduler::Slot decodeSlot(priority);
+
+    Poco::FastMutex::ScopedLock lock(_convCodeMutex);
+    this->decoderWork();
 }
 
 std::vector<unsigned> ConvolutionBase::_gen() const
@@ -173,54 +375,139 @@ void ConvolutionBase::_getEncodeSize()
     _expectedEncodeSize = encodeRet;
 }
 
-void ConvolutionBase::encoderWork()
+bool ConvolutionBase::_hasDecoderFrames() const
 {
-    auto input = this->input(0);
-    auto output = this->output(0);
+    const auto inputFrameSize = static_cast<size_t>(_expectedEncodeSize);
+    const auto outputFrameSize = static_cast<size_t>(_pConvCode->len);
 
-    if((input->elements() < static_cast<size_t>(_pConvCode->len)) ||
-       (output->elements() < static_cast<size_t>(_expectedEncodeSize)))
+    for(size_t chan = 0; chan < _numChannels; ++chan)
     {
-        return;
+        if((this->input(chan)->elements() >= inputFrameSize) &&
+           (this->output(chan)->elements() >= outputFrameSize))
+        {
+            return true;
+        }
     }
 
-    int encodeRet = ::lte_conv_encode(
-                         _pConvCode,
-                         input->buffer(),
-                         output->buffer());
-    throwOnErrCode(encodeRet);
+    return false;
+}
 
-    if(encodeRet != _expectedEncodeSize)
+void ConvolutionBase::encoderWork()
+{
+    const auto inputFrameSize = static_cast<size_t>(_pConvCode->len);
+    const auto outputFrameSize = static_cast<size_t>(_expectedEncodeSize);
+
+    for(size_t chan = 0; chan < _numChannels; ++chan)
     {
-        throw Pothos::AssertionViolationException(
-                  "lte_conv_encode returned an unexpected output length",
-                  Poco::format(
-                      "Expected %s, got %s",
-                      Poco::NumberFormatter::format(encodeRet),
-                      Poco::NumberFormatter::format(_expectedEncodeSize)));
+        auto input = this->input(chan);
+        auto output = this->output(chan);
+
+        const auto numFrames = std::min(
+                                   input->elements() / inputFrameSize,
+                                   output->elements() / outputFrameSize);
+        if(0 == numFrames) continue;
+
+        const auto* inBuff = input->buffer().as<const std::uint8_t*>();
+        auto* outBuff = output->buffer().as<std::uint8_t*>();
+
+        for(size_t frame = 0; frame < numFrames; ++frame)
+        {
+            int encodeRet = ::lte_conv_encode(
+                                 _pConvCode,
+                                 inBuff + (frame * inputFrameSize),
+                                 outBuff + (frame * outputFrameSize));
+            throwOnErrCode(encodeRet);
+
+            if(encodeRet != _expectedEncodeSize)
+            {
+                throw Pothos::AssertionViolationException(
+                          "lte_conv_encode returned an unexpected output length",
+                          Poco::format(
+                              "Expected %s, got %s",
+                              Poco::NumberFormatter::format(encodeRet),
+                              Poco::NumberFormatter::format(_expectedEncodeSize)));
+            }
+        }
+
+        input->consume(numFrames * inputFrameSize);
+        output->produce(numFrames * outputFrameSize);
     }
-
-    input->consume(_pConvCode->len);
-    output->produce(_expectedEncodeSize);
 }
 
 void ConvolutionBase::decoderWork()
 {
-    auto input = this->input(0);
-    auto output = this->output(0);
+    const auto inputFrameSize = static_cast<size_t>(_expectedEncodeSize);
+    const auto outputFrameSize = static_cast<size_t>(_pConvCode->len);
 
-    if((input->elements() < static_cast<size_t>(_expectedEncodeSize)) ||
-       (output->elements() < static_cast<size_t>(_pConvCode->len)))
+    for(size_t chan = 0; chan < _numChannels; ++chan)
     {
-        return;
+        auto input = this->input(chan);
+        auto output = this->output(chan);
+        auto& frameOutputOffsets = _frameOutputOffsets[chan];
+
+        const auto numFrames = std::min(
+                                   input->elements() / inputFrameSize,
+                                   output->elements() / outputFrameSize);
+        frameOutputOffsets.assign(numFrames, DroppedFrameOffset);
+        if(0 == numFrames) continue;
+
+        if(_deadlineTracker.enabled()) _deadlineTracker.indexTimestamps(input, (numFrames * inputFrameSize));
+
+        const auto* inBuff = input->buffer().as<const std::int8_t*>();
+        auto* outBuff = output->buffer().as<std::uint8_t*>();
+
+        // Dropped frames produce no output.
+        size_t outputOffset = 0;
+        for(size_t frame = 0; frame < numFrames; ++frame)
+        {
+            const auto inputOffset = frame * inputFrameSize;
+
+            // An idle timeslot is just noise, so don't bother running the Viterbi
+            // decoder on it.
+            if(_energyThreshold > 0.0f)
+            {
+                const float energy = meanAbsoluteValue(inBuff + inputOffset, inputFrameSize);
+                if(energy < _energyThreshold)
+                {
+                    std::memset(outBuff + outputOffset, 0, outputFrameSize);
+                    output->postLabel(SkippedLabelID, energy, outputOffset);
+
+                    frameOutputOffsets[frame] = outputOffset;
+                    outputOffset += outputFrameSize;
+                    ++_numSkippedFrames;
+                    continue;
+                }
+            }
+
+            // If this frame can't be decoded before its deadline, drop it rather
+            // than decoding it late and making every frame after it late too.
+            FrameDeadlineTracker::Clock::time_point deadline;
+            const bool hasDeadline = _deadlineTracker.enabled() &&
+                                     _deadlineTracker.findDeadline(inputOffset, inputFrameSize, deadline);
+            if(hasDeadline && (_deadlineTracker.workUnitsRemaining(deadline) < 1.0))
+            {
+                _deadlineTracker.frameDropped();
+                continue;
+            }
+
+            const auto decodeStartTime = FrameDeadlineTracker::Clock::now();
+            int decodeRet = ::lte_conv_decode(
+                                _pConvCode,
+                                inBuff + inputOffset,
+                                outBuff + outputOffset);
+            throwOnErrCode(decodeRet);
+
+            if(hasDeadline)
+            {
+                _deadlineTracker.recordDecodeTime(1.0, (FrameDeadlineTracker::Clock::now() - decodeStartTime));
+            }
+
+            frameOutputOffsets[frame] = outputOffset;
+            outputOffset += outputFrameSize;
+            ++_numDecodedFrames;
+        }
+
+        input->consume(numFrames * inputFrameSize);
+        if(outputOffset > 0) output->produce(outputOffset);
     }
-
-    int decodeRet = ::lte_conv_decode(
-                         _pConvCode,
-                         input->buffer(),
-                         output->buffer());
-    throwOnErrCode(decodeRet);
-
-    input->consume(_expectedEncodeSize);
-    output->produce(_pConvCode->len);
 }
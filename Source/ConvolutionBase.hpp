@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include "DecodeScheduler.hpp"
+#include "FrameDeadlineTracker.hpp"
+
 #include <Pothos/Framework.hpp>
 
 #include <Poco/Mutex.h>
@@ -12,13 +15,17 @@ extern "C"
 #include <turbofec/conv.h>
 }
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 class ConvolutionBase: public Pothos::Block
 {
 public:
-    ConvolutionBase(lte_conv_code* pConvCode, bool isEncoder);
+    ConvolutionBase(
+        lte_conv_code* pConvCode,
+        bool isEncoder,
+        size_t numChannels = 1);
 
     virtual ~ConvolutionBase();
 
@@ -38,6 +45,34 @@ public:
 
     std::string terminationType() const;
 
+    size_t numChannels() const;
+
+    float energyThreshold() const;
+
+    void setEnergyThreshold(float energyThreshold);
+
+    unsigned long long numDecodedFrames() const;
+
+    unsigned long long numSkippedFrames() const;
+
+    double deadlineBudget() const;
+
+    void setDeadlineBudget(double deadlineBudget);
+
+    std::string timestampID() const;
+
+    void setTimestampID(const std::string& timestampID);
+
+    unsigned long long numDroppedFrames() const;
+
+    std::string priority() const;
+
+    void setPriority(const std::string& priority);
+
+    void resetFrameCounts();
+
+    void propagateLabels(const Pothos::InputPort* input) override;
+
     void work() override;
 
 protected:
@@ -45,12 +80,31 @@ protected:
     size_t _genArrLength;
     bool _isEncoder;
 
+    // Each channel has its own input/output port pair, all using the same code.
+    size_t _numChannels;
+
     mutable Poco::FastMutex _convCodeMutex;
 
     int _expectedEncodeSize;
     std::vector<std::uint8_t> _expectedEncodeCalcInputVec;
     std::vector<std::uint8_t> _expectedEncodeCalcOutputVec;
 
+    // Decoder only: frames whose mean absolute soft value is below
+    // this threshold are assumed empty and are not decoded.
+    float _energyThreshold;
+    unsigned long long _numDecodedFrames;
+    unsigned long long _numSkippedFrames;
+
+    // Decoder only: frames that can't be decoded before their deadline are dropped.
+    FrameDeadlineTracker _deadlineTracker;
+
+    // Decoder only: priority when waiting for a slot in the shared DecodeScheduler
+    DecodePriority _priority;
+
+    // Decoder only: per channel, where each frame consumed this call starts
+    // in the output, so labels can follow their frames
+    std::vector<std::vector<size_t>> _frameOutputOffsets;
+
     std::vector<unsigned> _gen() const;
 
     std::vector<int> _punctureFunc() const;
@@ -59,6 +113,9 @@ protected:
 
     void _getEncodeSize();
 
+    // Must be called with the mutex held.
+    bool _hasDecoderFrames() const;
+
     void encoderWork();
 
     void decoderWork();
@@ -289,6 +289,42 @@ void lte_pbch();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_xcch_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_xcch();
 
@@ -302,6 +338,42 @@ void gsm_xcch();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gprs_cs2_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gprs_cs2();
 
@@ -315,6 +387,42 @@ void gprs_cs2();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gprs_cs3_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gprs_cs3();
 
@@ -328,6 +436,42 @@ void gprs_cs3();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_rach_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "High"
+ * |preview valid
  */
 void gsm_rach();
 
@@ -341,6 +485,42 @@ void gsm_rach();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_sch_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "High"
+ * |preview valid
  */
 void gsm_sch();
 
@@ -354,6 +534,42 @@ void gsm_sch();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_fr_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_fr();
 
@@ -367,6 +583,42 @@ void gsm_tch_fr();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_hr_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_hr();
 
@@ -380,6 +632,42 @@ void gsm_tch_hr();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_afs12_2_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_afs12_2();
 
@@ -393,6 +681,42 @@ void gsm_tch_afs12_2();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_afs10_2_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_afs10_2();
 
@@ -406,6 +730,42 @@ void gsm_tch_afs10_2();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_afs7_95_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_afs7_95();
 
@@ -419,6 +779,42 @@ void gsm_tch_afs7_95();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_afs7_4_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_afs7_4();
 
@@ -432,6 +828,42 @@ void gsm_tch_afs7_4();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_afs6_7_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_afs6_7();
 
@@ -445,6 +877,42 @@ void gsm_tch_afs6_7();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_afs5_9_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_afs5_9();
 
@@ -458,6 +926,42 @@ void gsm_tch_afs5_9();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_ahs7_95_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_ahs7_95();
 
@@ -471,6 +975,42 @@ void gsm_tch_ahs7_95();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_ahs7_4_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_ahs7_4();
 
@@ -484,6 +1024,42 @@ void gsm_tch_ahs7_4();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_ahs6_7_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_ahs6_7();
 
@@ -497,6 +1073,42 @@ void gsm_tch_ahs6_7();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_ahs5_9_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_ahs5_9();
 
@@ -510,6 +1122,42 @@ void gsm_tch_ahs5_9();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_ahs5_15_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_ahs5_15();
 
@@ -523,6 +1171,42 @@ void gsm_tch_ahs5_15();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/gsm_tch_ahs4_75_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void gsm_tch_ahs4_75();
 
@@ -536,6 +1220,42 @@ void gsm_tch_ahs4_75();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/wimax_fch_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 void wimax_fch();
 
@@ -549,5 +1269,41 @@ void wimax_fch();
  * |category /FEC/Decoders
  * |keywords coder lte
  * |factory /fec/lte_pbch_decoder()
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "High"
+ * |preview valid
  */
 void lte_pbch();
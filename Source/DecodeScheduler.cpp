@@ -0,0 +1,159 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DecodeScheduler.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <thread>
+
+DecodePriority decodePriorityFromString(const std::string& priority)
+{
+    if("High" == priority)        return DecodePriority::High;
+    else if("Normal" == priority) return DecodePriority::Normal;
+    else if("Low" == priority)    return DecodePriority::Low;
+
+    throw Pothos::InvalidArgumentException("Invalid decode priority: "+priority);
+}
+
+std::string decodePriorityToString(DecodePriority priority)
+{
+    switch(priority)
+    {
+        case DecodePriority::High:
+            return "High";
+
+        case DecodePriority::Normal:
+            return "Normal";
+
+        case DecodePriority::Low:
+            return "Low";
+
+        default:
+            throw Pothos::AssertionViolationException("Invalid decode priority");
+    }
+}
+
+DecodeScheduler& DecodeScheduler::instance()
+{
+    static DecodeScheduler scheduler;
+    return scheduler;
+}
+
+DecodeScheduler::DecodeScheduler():
+    _maxConcurrentDecodes(std::max<size_t>(1, std::thread::hardware_concurrency())),
+    _numActiveDecodes(0)
+{
+    std::fill(_nextTicket, _nextTicket+NumDecodePriorities, 0);
+    std::fill(_nowServing, _nowServing+NumDecodePriorities, 0);
+}
+
+size_t DecodeScheduler::maxConcurrentDecodes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _maxConcurrentDecodes;
+}
+
+void DecodeScheduler::setMaxConcurrentDecodes(size_t maxConcurrentDecodes)
+{
+    if(0 == maxConcurrentDecodes)
+    {
+        throw Pothos::InvalidArgumentException("The maximum number of concurrent decodes must be positive");
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _maxConcurrentDecodes = maxConcurrentDecodes;
+    _notifyNextWaiter();
+}
+
+DecodeScheduler::Slot::Slot(DecodePriority priority)
+{
+    DecodeScheduler::instance()._acquire(priority);
+}
+
+DecodeScheduler::Slot::~Slot()
+{
+    DecodeScheduler::instance()._release();
+}
+
+void DecodeScheduler::_acquire(DecodePriority priority)
+{
+    const auto priorityIndex = static_cast<size_t>(priority);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    const auto ticket = _nextTicket[priorityIndex]++;
+
+    _conds[priorityIndex].wait(
+        lock,
+        [&]()
+        {
+            if(_numActiveDecodes >= _maxConcurrentDecodes) return false;
+            if(ticket != _nowServing[priorityIndex]) return false;
+
+            // Higher priority waiters always go first.
+            for(size_t higherIndex = 0; higherIndex < priorityIndex; ++higherIndex)
+            {
+                if(_nextTicket[higherIndex] != _nowServing[higherIndex]) return false;
+            }
+
+            return true;
+        });
+
+    ++_numActiveDecodes;
+    ++_nowServing[priorityIndex];
+
+    // The next waiter in this class may also be able to go.
+    _notifyNextWaiter();
+}
+
+void DecodeScheduler::_release()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    --_numActiveDecodes;
+    _notifyNextWaiter();
+}
+
+void DecodeScheduler::_notifyNextWaiter()
+{
+    if(_numActiveDecodes >= _maxConcurrentDecodes) return;
+
+    for(size_t priorityIndex = 0; priorityIndex < NumDecodePriorities; ++priorityIndex)
+    {
+        if(_nextTicket[priorityIndex] != _nowServing[priorityIndex])
+        {
+            // Waiters check their own ticket, so wake the whole class.
+            _conds[priorityIndex].notify_all();
+            return;
+        }
+    }
+}
+
+//
+// Registration
+//
+
+static size_t getMaxConcurrentDecodes()
+{
+    return DecodeScheduler::instance().maxConcurrentDecodes();
+}
+
+static void setMaxConcurrentDecodes(size_t maxConcurrentDecodes)
+{
+    DecodeScheduler::instance().setMaxConcurrentDecodes(maxConcurrentDecodes);
+}
+
+pothos_static_block(registerDecodeScheduler)
+{
+    Pothos::PluginRegistry::addCall(
+        "/fec/decode_scheduler/get_max_concurrent_decodes",
+        &getMaxConcurrentDecodes);
+    Pothos::PluginRegistry::addCall(
+        "/fec/decode_scheduler/set_max_concurrent_decodes",
+        &setMaxConcurrentDecodes);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+enum class DecodePriority
+{
+    High = 0,
+    Normal,
+    Low
+};
+static constexpr size_t NumDecodePriorities = 3;
+
+DecodePriority decodePriorityFromString(const std::string& priority);
+
+std::string decodePriorityToString(DecodePriority priority);
+
+// Process-wide admission control for decoding. Every decoder in the module
+// takes a slot before decoding, so no more than a fixed number of decodes
+// run at once, regardless of how many blocks there are. When slots
+// are contended, they are granted strictly by priority, then in request
+// order, so a burst of bulk traffic decoding can't delay latency-critical
+// control channels behind it.
+class DecodeScheduler
+{
+public:
+    static DecodeScheduler& instance();
+
+    size_t maxConcurrentDecodes() const;
+
+    void setMaxConcurrentDecodes(size_t maxConcurrentDecodes);
+
+    // Holds a decode slot for its lifetime.
+    class Slot
+    {
+    public:
+        explicit Slot(DecodePriority priority);
+        ~Slot();
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+    };
+
+private:
+    DecodeScheduler();
+
+    void _acquire(DecodePriority priority);
+
+    void _release();
+
+    // Must be called with the mutex held.
+    void _notifyNextWaiter();
+
+    mutable std::mutex _mutex;
+    size_t _maxConcurrentDecodes;
+    size_t _numActiveDecodes;
+
+    // Per-priority FIFO tickets
+    unsigned long long _nextTicket[NumDecodePriorities];
+    unsigned long long _nowServing[NumDecodePriorities];
+    std::condition_variable _conds[NumDecodePriorities];
+};
@@ -0,0 +1,419 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DecoderFarm.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+// Per-worker job queue depth. The block never has more than this many
+// frames in flight per worker, so the result queues never overflow.
+static constexpr size_t WorkerQueueDepth = 16;
+
+// Per-worker output buffer pool size, enough for a full queue's frames
+// in flight plus as many still held downstream.
+static constexpr size_t WorkerOutputPoolSize = 2 * WorkerQueueDepth;
+
+//
+// DecoderFarmWorker
+//
+
+DecoderFarmWorker::DecoderFarmWorker(
+    std::unique_ptr<DecoderFarmWorkerState>&& state,
+    size_t queueDepth,
+    const std::atomic<DecodePriority>& priority,
+    const std::function<void()>& resultCallback
+):
+    _state(std::move(state)),
+    _jobQueue(queueDepth),
+    _resultQueue(queueDepth),
+    _priority(priority),
+    _resultCallback(resultCallback),
+    _outputPool(WorkerOutputPoolSize),
+    _running(false),
+    _sleeping(false)
+{
+}
+
+DecoderFarmWorker::~DecoderFarmWorker()
+{
+    this->stop();
+}
+
+void DecoderFarmWorker::start()
+{
+    _running = true;
+    _thread = std::thread(&DecoderFarmWorker::_threadLoop, this);
+}
+
+void DecoderFarmWorker::stop()
+{
+    if(!_thread.joinable()) return;
+
+    _running = false;
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCond.notify_all();
+
+    _thread.join();
+}
+
+bool DecoderFarmWorker::canSubmit() const
+{
+    return !_jobQueue.full();
+}
+
+bool DecoderFarmWorker::submit(DecoderFarmJob&& job)
+{
+    if(!_jobQueue.push(std::move(job))) return false;
+
+    // Pairs with the fence in _threadLoop() so either the worker sees the
+    // new job before sleeping, or we see that it's sleeping.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_sleeping.load())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _sleepCond.notify_one();
+    }
+
+    return true;
+}
+
+Pothos::BufferChunk DecoderFarmWorker::outputBuffer(size_t numBytes)
+{
+    return _outputPool.get("uint8", numBytes);
+}
+
+SPSCQueue<DecoderFarmJob>& DecoderFarmWorker::results()
+{
+    return _resultQueue;
+}
+
+void DecoderFarmWorker::_threadLoop()
+{
+    while(_running.load())
+    {
+        DecoderFarmJob job;
+        if(_jobQueue.pop(job))
+        {
+            try
+            {
+                DecodeScheduler::Slot decodeSlot(_priority.load());
+                _state->decode(job);
+            }
+            catch(...)
+            {
+                job.error = std::current_exception();
+            }
+
+            while(!_resultQueue.push(std::move(job)))
+            {
+                if(!_running.load()) return;
+                std::this_thread::yield();
+            }
+
+            _resultCallback();
+            continue;
+        }
+
+        _sleeping = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCond.wait(
+            lock,
+            [this]()
+            {
+                return (!_running.load() || !_jobQueue.empty());
+            });
+
+        _sleeping = false;
+    }
+}
+
+//
+// DecoderFarmBase
+//
+
+DecoderFarmBase::DecoderFarmBase(
+    size_t numInputs,
+    const Pothos::DType& inputDType,
+    size_t numWorkers
+):
+    Pothos::Block(),
+    _numWorkers(numWorkers),
+    _nextDispatchSequence(0),
+    _nextEmitSequence(0),
+    _numFramesDecoded(0),
+    _priority(DecodePriority::Normal)
+{
+    if(numInputs > DecoderFarmJob::MaxInputs)
+    {
+        throw Pothos::AssertionViolationException(
+                  "DecoderFarmBase::DecoderFarmBase",
+                  "Too many inputs: "+std::to_string(numInputs));
+    }
+
+    // Default to one worker per core.
+    if(0 == _numWorkers)
+    {
+        _numWorkers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    for(size_t port = 0; port < numInputs; ++port)
+    {
+        this->setupInput(port, inputDType);
+    }
+    this->setupOutput(0, "uint8");
+
+    this->registerCall(this, POTHOS_FCN_TUPLE(DecoderFarmBase, numWorkers));
+    this->registerCall(this, POTHOS_FCN_TUPLE(DecoderFarmBase, numFramesDecoded));
+    this->registerCall(this, POTHOS_FCN_TUPLE(DecoderFarmBase, priority));
+    this->registerCall(this, POTHOS_FCN_TUPLE(DecoderFarmBase, setPriority));
+
+    this->registerProbe("numWorkers");
+    this->registerProbe("numFramesDecoded");
+    this->registerProbe("priority");
+}
+
+DecoderFarmBase::~DecoderFarmBase()
+{
+    // Workers reference this block in their callbacks, so make sure
+    // they're stopped before we're destroyed.
+    _workers.clear();
+}
+
+size_t DecoderFarmBase::numWorkers() const
+{
+    return _numWorkers;
+}
+
+unsigned long long DecoderFarmBase::numFramesDecoded() const
+{
+    return _numFramesDecoded.load();
+}
+
+std::string DecoderFarmBase::priority() const
+{
+    return decodePriorityToString(_priority.load());
+}
+
+void DecoderFarmBase::setPriority(const std::string& priority)
+{
+    _priority = decodePriorityFromString(priority);
+}
+
+void DecoderFarmBase::activate()
+{
+    _workers.clear();
+    for(size_t workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+    {
+        _workers.emplace_back(new DecoderFarmWorker(
+            this->makeWorkerState(),
+            WorkerQueueDepth,
+            _priority,
+            std::bind(&DecoderFarmBase::_notifyResult, this)));
+    }
+
+    for(auto& worker: _workers) worker->start();
+
+    _nextDispatchSequence = 0;
+    _nextEmitSequence = 0;
+}
+
+void DecoderFarmBase::deactivate()
+{
+    // Any frames still in flight are dropped.
+    _workers.clear();
+}
+
+void DecoderFarmBase::propagateLabels(const Pothos::InputPort*)
+{
+    // Labels are forwarded along with their frame when it's emitted.
+}
+
+void DecoderFarmBase::work()
+{
+    size_t numProcessed = this->_emitResults();
+    numProcessed += this->_dispatchFrames();
+
+    if(_nextDispatchSequence == _nextEmitSequence) return;
+
+    // We have frames in flight but nothing else to do, so rather than
+    // spinning, wait for a worker to finish a frame.
+    if(0 == numProcessed)
+    {
+        auto& nextWorker = *_workers[_nextEmitSequence % _numWorkers];
+
+        std::unique_lock<std::mutex> lock(_resultMutex);
+        _resultCond.wait_for(
+            lock,
+            std::chrono::nanoseconds(this->workInfo().maxTimeoutNs),
+            [&nextWorker]()
+            {
+                return (nullptr != nextWorker.results().front());
+            });
+        lock.unlock();
+
+        this->_emitResults();
+    }
+
+    // Make sure we're called again to emit the remaining frames, even
+    // if no new input arrives.
+    this->yield();
+}
+
+bool DecoderFarmBase::isFramingLabel(const Pothos::Label&) const
+{
+    return false;
+}
+
+void DecoderFarmBase::onFrameEmitted(const DecoderFarmJob&, size_t)
+{
+}
+
+void DecoderFarmBase::indexFrames(size_t)
+{
+}
+
+// Workers are assigned frames round-robin and each one completes its
+// frames in order, so the next frame in sequence is always at the front
+// of a known worker's result queue. This makes the per-worker result
+// queues a reorder buffer with no searching.
+size_t DecoderFarmBase::_emitResults()
+{
+    auto output = this->output(0);
+
+    size_t numEmitted = 0;
+    size_t outputOffset = 0;
+    while(_nextEmitSequence != _nextDispatchSequence)
+    {
+        auto& results = _workers[_nextEmitSequence % _numWorkers]->results();
+
+        auto* pJob = results.front();
+        if(!pJob) break;
+
+        if(pJob->sequence != _nextEmitSequence)
+        {
+            throw Pothos::AssertionViolationException(
+                      "DecoderFarmBase::_emitResults",
+                      "Frame emitted out of order");
+        }
+
+        // Take the frame off the queue before anything can throw, so a
+        // failed frame isn't rethrown on every later call.
+        DecoderFarmJob job;
+        results.pop(job);
+        ++_nextEmitSequence;
+
+        if(job.error) std::rethrow_exception(job.error);
+
+        output->postBuffer(job.output);
+        for(auto label: job.labels)
+        {
+            label.index += outputOffset;
+            output->postLabel(label);
+        }
+        this->onFrameEmitted(job, outputOffset);
+
+        outputOffset += job.output.elements();
+
+        ++_numFramesDecoded;
+        ++numEmitted;
+    }
+
+    return numEmitted;
+}
+
+size_t DecoderFarmBase::_dispatchFrames()
+{
+    const auto& inputs = this->inputs();
+
+    const auto numAvailable = this->workInfo().minInElements;
+    const auto maxInFlight = _numWorkers * WorkerQueueDepth;
+
+    this->indexFrames(numAvailable);
+
+    _frameLabels.clear();
+    for(const auto& label: inputs[0]->labels())
+    {
+        if((label.index < numAvailable) && !this->isFramingLabel(label)) _frameLabels.emplace_back(label);
+    }
+
+    // Labels are almost always in order already.
+    const auto byIndex = [](const Pothos::Label& label0, const Pothos::Label& label1)
+    {
+        return (label0.index < label1.index);
+    };
+    if(!std::is_sorted(_frameLabels.begin(), _frameLabels.end(), byIndex))
+    {
+        std::stable_sort(_frameLabels.begin(), _frameLabels.end(), byIndex);
+    }
+
+    size_t numDispatched = 0;
+    size_t offset = 0;
+    size_t reserve = 0;
+    size_t nextLabel = 0;
+    while((_nextDispatchSequence - _nextEmitSequence) < maxInFlight)
+    {
+        auto& worker = *_workers[_nextDispatchSequence % _numWorkers];
+        if(!worker.canSubmit()) break;
+
+        FrameInfo frameInfo = {0, 0, 0};
+        this->findNextFrame(offset, (numAvailable - offset), frameInfo);
+
+        offset += frameInfo.skip;
+        if(0 == frameInfo.inputSize) break;
+
+        // Wait until we have the whole frame.
+        if(frameInfo.inputSize > (numAvailable - offset))
+        {
+            reserve = frameInfo.inputSize;
+            break;
+        }
+
+        DecoderFarmJob job;
+        job.sequence = _nextDispatchSequence;
+        for(size_t port = 0; port < inputs.size(); ++port)
+        {
+            auto& inputChunk = job.inputs[port];
+            inputChunk = inputs[port]->buffer();
+            inputChunk.address += (offset * inputChunk.dtype.size());
+            inputChunk.setElements(frameInfo.inputSize);
+        }
+        while((nextLabel < _frameLabels.size()) && (_frameLabels[nextLabel].index < offset)) ++nextLabel;
+        while((nextLabel < _frameLabels.size()) && (_frameLabels[nextLabel].index < (offset + frameInfo.inputSize)))
+        {
+            job.labels.emplace_back(_frameLabels[nextLabel++]);
+            job.labels.back().index = 0;
+        }
+        job.output = worker.outputBuffer(frameInfo.outputSize);
+
+        worker.submit(std::move(job));
+
+        offset += frameInfo.inputSize;
+        ++_nextDispatchSequence;
+        ++numDispatched;
+    }
+
+    if(offset > 0)
+    {
+        for(auto* input: inputs) input->consume(offset);
+    }
+    for(auto* input: inputs) input->setReserve(reserve);
+
+    return numDispatched;
+}
+
+void DecoderFarmBase::_notifyResult()
+{
+    {
+        std::lock_guard<std::mutex> lock(_resultMutex);
+    }
+    _resultCond.notify_one();
+}
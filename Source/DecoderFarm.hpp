@@ -0,0 +1,188 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "BufferChunkPool.hpp"
+#include "DecodeScheduler.hpp"
+#include "SPSCQueue.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A frame handed off to a worker thread. The input chunks reference the
+// block's input buffers, so frames are not copied on the way in.
+struct DecoderFarmJob
+{
+    static constexpr size_t MaxInputs = 3;
+
+    unsigned long long sequence;
+    std::array<Pothos::BufferChunk, MaxInputs> inputs;
+    Pothos::BufferChunk output;
+
+    // Non-framing labels that arrived within this frame, reposted at
+    // the start of the decoded output.
+    std::vector<Pothos::Label> labels;
+
+    // Set if decoding threw, rethrown on the block thread.
+    std::exception_ptr error;
+};
+
+// Each worker thread owns one instance, so implementations can hold
+// decoder state that isn't safe to share between threads.
+class DecoderFarmWorkerState
+{
+public:
+    virtual ~DecoderFarmWorkerState() = default;
+
+    virtual void decode(DecoderFarmJob& job) = 0;
+};
+
+class DecoderFarmWorker
+{
+public:
+    DecoderFarmWorker(
+        std::unique_ptr<DecoderFarmWorkerState>&& state,
+        size_t queueDepth,
+        const std::atomic<DecodePriority>& priority,
+        const std::function<void()>& resultCallback);
+
+    ~DecoderFarmWorker();
+
+    void start();
+
+    void stop();
+
+    // Block thread only
+    bool canSubmit() const;
+
+    // Block thread only
+    bool submit(DecoderFarmJob&& job);
+
+    // Block thread only. Returns an output buffer of the given size from
+    // this worker's pool, reusing buffers once they're no longer
+    // referenced downstream.
+    Pothos::BufferChunk outputBuffer(size_t numBytes);
+
+    SPSCQueue<DecoderFarmJob>& results();
+
+private:
+    std::unique_ptr<DecoderFarmWorkerState> _state;
+    SPSCQueue<DecoderFarmJob> _jobQueue;
+    SPSCQueue<DecoderFarmJob> _resultQueue;
+    const std::atomic<DecodePriority>& _priority;
+    std::function<void()> _resultCallback;
+
+    BufferChunkPool _outputPool;
+
+    std::thread _thread;
+    std::atomic<bool> _running;
+
+    // Only used to sleep when there are no jobs, never on the data path.
+    std::atomic<bool> _sleeping;
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCond;
+
+    void _threadLoop();
+};
+
+// Dispatches frames to a pool of worker threads, each with its own decoder
+// state, and emits the decoded frames in input order. Subclasses determine
+// how frames are delimited and how they're decoded.
+class DecoderFarmBase: public Pothos::Block
+{
+public:
+    DecoderFarmBase(
+        size_t numInputs,
+        const Pothos::DType& inputDType,
+        size_t numWorkers);
+
+    virtual ~DecoderFarmBase();
+
+    size_t numWorkers() const;
+
+    unsigned long long numFramesDecoded() const;
+
+    std::string priority() const;
+
+    void setPriority(const std::string& priority);
+
+    void activate() override;
+
+    void deactivate() override;
+
+    void propagateLabels(const Pothos::InputPort* input) override;
+
+    void work() override;
+
+protected:
+    // Describes the next frame, relative to the offset passed into findNextFrame().
+    struct FrameInfo
+    {
+        // Elements preceding the frame that can be dropped
+        size_t skip;
+
+        // Zero if no frame start was found
+        size_t inputSize;
+
+        size_t outputSize;
+    };
+
+    // Frames are found and dispatched in a loop within a single work() call,
+    // and input is only consumed at the end, so this searches the inputs
+    // starting at the given offset.
+    virtual void findNextFrame(
+        size_t offset,
+        size_t numAvailable,
+        FrameInfo& frameInfoOut) = 0;
+
+    // Called once per work() call before any findNextFrame() calls, so
+    // subclasses can index the input's labels in one pass rather than
+    // searching them for every frame.
+    virtual void indexFrames(size_t numAvailable);
+
+    virtual std::unique_ptr<DecoderFarmWorkerState> makeWorkerState() = 0;
+
+    // Labels with this ID delimit frames and are not forwarded.
+    virtual bool isFramingLabel(const Pothos::Label& label) const;
+
+    // Called after a decoded frame is posted, with the frame's offset
+    // into this call's output.
+    virtual void onFrameEmitted(const DecoderFarmJob& job, size_t outputOffset);
+
+    size_t _numWorkers;
+
+private:
+    std::vector<std::unique_ptr<DecoderFarmWorker>> _workers;
+
+    unsigned long long _nextDispatchSequence;
+    unsigned long long _nextEmitSequence;
+    std::atomic<unsigned long long> _numFramesDecoded;
+
+    // Workers take a slot from the shared DecodeScheduler with this priority.
+    std::atomic<DecodePriority> _priority;
+
+    std::mutex _resultMutex;
+    std::condition_variable _resultCond;
+
+    // Input 0's non-framing labels, sorted by index, gathered once per
+    // work() call
+    std::vector<Pothos::Label> _frameLabels;
+
+    size_t _emitResults();
+
+    size_t _dispatchFrames();
+
+    void _notifyResult();
+};
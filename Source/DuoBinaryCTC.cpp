@@ -0,0 +1,608 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DuoBinaryCTC.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <initializer_list>
+#include <limits>
+#include <string>
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+//
+// Trellis
+//
+
+// The constituent encoder's state is its shift register (s1,s2,s3), with s1
+// as the most significant bit, and its input is a couple u=(A,B), as 2A+B.
+// The feedback bit is n = A^B^s1^s3, B is also added into the second and
+// third stages, and the parity bits are Y = n^s2^s3 and W = n^s3
+// (IEEE 802.16-2009, section 8.4.9.2.3.1).
+
+static constexpr size_t NumStates = 8;
+static constexpr size_t NumSymbols = 4;
+
+static constexpr int feedbackBit(int state, int symbol)
+{
+    return (symbol >> 1) ^ (symbol & 1) ^ (state >> 2) ^ (state & 1);
+}
+
+static constexpr int nextState(int state, int symbol)
+{
+    return (feedbackBit(state, symbol) << 2) |
+           ((((state >> 2) ^ symbol) & 1) << 1) |
+           (((state >> 1) ^ symbol) & 1);
+}
+
+static constexpr int parityBitY(int state, int symbol)
+{
+    return feedbackBit(state, symbol) ^ ((state >> 1) & 1) ^ (state & 1);
+}
+
+static constexpr int parityBitW(int state, int symbol)
+{
+    return feedbackBit(state, symbol) ^ (state & 1);
+}
+
+// A is stored first, so swapping A and B swaps symbols 1 and 2.
+static inline int swapSymbol(int symbol, bool swap)
+{
+    return swap ? (((symbol & 1) << 1) | (symbol >> 1)) : symbol;
+}
+
+// Each entry is the next state, with the Y and W bits above it.
+using EncoderTable = std::array<std::array<std::uint8_t, NumSymbols>, NumStates>;
+
+static const EncoderTable& getEncoderTable()
+{
+    static const EncoderTable table = []()
+    {
+        EncoderTable ret;
+        for(int state = 0; state < int(NumStates); ++state)
+        {
+            for(int symbol = 0; symbol < int(NumSymbols); ++symbol)
+            {
+                ret[state][symbol] = std::uint8_t(
+                                         nextState(state, symbol) |
+                                         (parityBitY(state, symbol) << 3) |
+                                         (parityBitW(state, symbol) << 4));
+            }
+        }
+
+        return ret;
+    }();
+
+    return table;
+}
+
+// The circulation state Sc solves Sc = G^N Sc + S0, where S0 is the state
+// after encoding the block from state 0, so it depends only on N mod 7 and
+// S0 (IEEE 802.16-2009, table 8-311). It doesn't exist if N is a multiple
+// of 7.
+static const std::uint8_t CirculationStates[6][NumStates] =
+{
+    {0, 6, 4, 2, 7, 1, 3, 5},
+    {0, 3, 7, 4, 5, 6, 2, 1},
+    {0, 5, 3, 6, 2, 7, 1, 4},
+    {0, 4, 1, 5, 6, 2, 7, 3},
+    {0, 2, 5, 7, 1, 3, 4, 6},
+    {0, 7, 6, 1, 3, 4, 5, 2}
+};
+
+// Encodes N symbols, one per byte, from the circulation state.
+static void runCRSC(size_t N, const std::uint8_t* symbols, std::uint8_t* y, std::uint8_t* w)
+{
+    const auto& table = getEncoderTable();
+
+    int state = 0;
+    for(size_t k = 0; k < N; ++k) state = table[state][symbols[k]] & 7;
+
+    state = CirculationStates[(N % 7) - 1][state];
+    for(size_t k = 0; k < N; ++k)
+    {
+        const auto entry = table[state][symbols[k]];
+        y[k] = (entry >> 3) & 1;
+        w[k] = (entry >> 4) & 1;
+        state = entry & 7;
+    }
+}
+
+//
+// Encoder
+//
+
+DuoBinaryCTCEncoder::DuoBinaryCTCEncoder(DuoBinaryCTCInterleaverFcn interleaverFcn):
+    _interleaverFcn(interleaverFcn)
+{
+}
+
+void DuoBinaryCTCEncoder::encode(size_t N, const std::uint8_t* bits, std::uint8_t* out)
+{
+    const auto& interleaver = _interleaverFcn(N);
+    if(0 == (N % 7))
+    {
+        throw Pothos::InvalidArgumentException("No circulation state exists for N="+std::to_string(N));
+    }
+
+    std::uint8_t* A = out;
+    std::uint8_t* B = out + N;
+    std::uint8_t* symbols = out + (2*N);
+
+    // The natural order's symbols go in the Y2 subblock until the first
+    // constituent encoder is done with them.
+    for(size_t i = 0; i < N; ++i)
+    {
+        A[i] = bits[2*i] & 1;
+        B[i] = bits[(2*i)+1] & 1;
+        symbols[i] = std::uint8_t((A[i] << 1) | B[i]);
+    }
+
+    _interleavedSymbols.resize(N);
+    for(size_t j = 0; j < N; ++j)
+    {
+        const size_t i = interleaver.forward[j];
+        _interleavedSymbols[j] = std::uint8_t(swapSymbol(symbols[i], (i & 1)));
+    }
+
+    runCRSC(N, symbols, out + (2*N), out + (4*N));
+    runCRSC(N, _interleavedSymbols.data(), out + (3*N), out + (5*N));
+}
+
+//
+// SISO
+//
+
+// Extrinsic symbol metrics are clamped to leave headroom for the state
+// metrics.
+static constexpr int ExtrinsicMax = 2047;
+
+// Training runs set the state metrics at each end of the circle.
+static constexpr size_t TrainingLength = 32;
+
+static inline std::int16_t saturate(int value)
+{
+    return static_cast<std::int16_t>(std::min<int>(
+                                         std::max<int>(value, std::numeric_limits<std::int16_t>::min()),
+                                         std::numeric_limits<std::int16_t>::max()));
+}
+
+#if !defined(__SSE4_1__)
+
+static inline std::int16_t branchMetric(const std::int16_t* branchSys, std::int16_t y, std::int16_t w, int state, int symbol)
+{
+    return saturate(
+               branchSys[symbol] +
+               (parityBitY(state, symbol) ? y : 0) +
+               (parityBitW(state, symbol) ? w : 0));
+}
+
+static void forwardStepScalar(std::int16_t* alpha, const std::int16_t* branchSys, std::int16_t y, std::int16_t w)
+{
+    std::int16_t newAlpha[NumStates];
+    std::fill(newAlpha, newAlpha+NumStates, std::numeric_limits<std::int16_t>::min());
+
+    for(int state = 0; state < int(NumStates); ++state)
+    {
+        for(int symbol = 0; symbol < int(NumSymbols); ++symbol)
+        {
+            auto& metric = newAlpha[nextState(state, symbol)];
+            metric = std::max(metric, saturate(alpha[state] + branchMetric(branchSys, y, w, state, symbol)));
+        }
+    }
+
+    for(size_t state = 0; state < NumStates; ++state) alpha[state] = saturate(newAlpha[state] - newAlpha[0]);
+}
+
+// Outputs the symbol metrics, if given somewhere to.
+static void backwardStepScalar(
+    std::int16_t* beta,
+    const std::int16_t* branchSys,
+    std::int16_t y,
+    std::int16_t w,
+    const std::int16_t* alpha,
+    std::int16_t* appOut)
+{
+    std::int16_t newBeta[NumStates];
+    std::int16_t symbolMetrics[NumSymbols];
+    std::fill(symbolMetrics, symbolMetrics+NumSymbols, std::numeric_limits<std::int16_t>::min());
+
+    for(int state = 0; state < int(NumStates); ++state)
+    {
+        newBeta[state] = std::numeric_limits<std::int16_t>::min();
+        for(int symbol = 0; symbol < int(NumSymbols); ++symbol)
+        {
+            const auto metric = saturate(beta[nextState(state, symbol)] + branchMetric(branchSys, y, w, state, symbol));
+            newBeta[state] = std::max(newBeta[state], metric);
+
+            if(appOut) symbolMetrics[symbol] = std::max(symbolMetrics[symbol], saturate(alpha[state] + metric));
+        }
+    }
+
+    for(size_t state = 0; state < NumStates; ++state) beta[state] = saturate(newBeta[state] - newBeta[0]);
+    if(appOut)
+    {
+        for(size_t symbol = 0; symbol < NumSymbols; ++symbol) appOut[symbol] = saturate(symbolMetrics[symbol] - symbolMetrics[0]);
+    }
+}
+
+static void runSISO(
+    size_t N,
+    const std::int16_t* branchSys,
+    const std::int16_t* y,
+    const std::int16_t* w,
+    std::int16_t* alphas,
+    std::int16_t* appOut)
+{
+    const size_t trainingLength = std::min(N, TrainingLength);
+
+    std::int16_t alpha[NumStates] = {};
+    for(size_t k = N - trainingLength; k < N; ++k) forwardStepScalar(alpha, branchSys + (k*NumSymbols), y[k], w[k]);
+    for(size_t k = 0; k < N; ++k)
+    {
+        std::copy(alpha, alpha+NumStates, alphas + (k*NumStates));
+        forwardStepScalar(alpha, branchSys + (k*NumSymbols), y[k], w[k]);
+    }
+
+    std::int16_t beta[NumStates] = {};
+    for(size_t k = trainingLength; k-- > 0;) backwardStepScalar(beta, branchSys + (k*NumSymbols), y[k], w[k], nullptr, nullptr);
+    for(size_t k = N; k-- > 0;)
+    {
+        backwardStepScalar(
+            beta,
+            branchSys + (k*NumSymbols),
+            y[k],
+            w[k],
+            alphas + (k*NumStates),
+            appOut + (k*NumSymbols));
+    }
+}
+
+#else
+
+// Radix-4 recursions: each step takes the best of the four symbols' branches
+// into (or out of) every state. For a given symbol, the branches are a
+// permutation of the states, so each symbol's contribution is one shuffle of
+// the state metrics plus a branch metric, and parity bits are added to the
+// lanes whose branches output a 1.
+struct SSETrellis
+{
+    // Forward: lane s' takes the state metric of prev[symbol][s'].
+    __m128i prevShuffles[NumSymbols];
+    __m128i forwardYMasks[NumSymbols];
+    __m128i forwardWMasks[NumSymbols];
+
+    // Backward: lane s takes the state metric of next[symbol][s].
+    __m128i nextShuffles[NumSymbols];
+    __m128i backwardYMasks[NumSymbols];
+    __m128i backwardWMasks[NumSymbols];
+};
+
+static const SSETrellis& getSSETrellis()
+{
+    static const SSETrellis trellis = []()
+    {
+        SSETrellis ret;
+        for(int symbol = 0; symbol < int(NumSymbols); ++symbol)
+        {
+            alignas(16) std::uint8_t prevShuffle[16], nextShuffle[16];
+            alignas(16) std::int16_t forwardY[NumStates], forwardW[NumStates];
+            alignas(16) std::int16_t backwardY[NumStates], backwardW[NumStates];
+
+            for(int state = 0; state < int(NumStates); ++state)
+            {
+                const int next = nextState(state, symbol);
+
+                prevShuffle[2*next] = std::uint8_t(2*state);
+                prevShuffle[(2*next)+1] = std::uint8_t((2*state)+1);
+                forwardY[next] = parityBitY(state, symbol) ? -1 : 0;
+                forwardW[next] = parityBitW(state, symbol) ? -1 : 0;
+
+                nextShuffle[2*state] = std::uint8_t(2*next);
+                nextShuffle[(2*state)+1] = std::uint8_t((2*next)+1);
+                backwardY[state] = parityBitY(state, symbol) ? -1 : 0;
+                backwardW[state] = parityBitW(state, symbol) ? -1 : 0;
+            }
+
+            ret.prevShuffles[symbol] = _mm_load_si128(reinterpret_cast<const __m128i*>(prevShuffle));
+            ret.forwardYMasks[symbol] = _mm_load_si128(reinterpret_cast<const __m128i*>(forwardY));
+            ret.forwardWMasks[symbol] = _mm_load_si128(reinterpret_cast<const __m128i*>(forwardW));
+            ret.nextShuffles[symbol] = _mm_load_si128(reinterpret_cast<const __m128i*>(nextShuffle));
+            ret.backwardYMasks[symbol] = _mm_load_si128(reinterpret_cast<const __m128i*>(backwardY));
+            ret.backwardWMasks[symbol] = _mm_load_si128(reinterpret_cast<const __m128i*>(backwardW));
+        }
+
+        return ret;
+    }();
+
+    return trellis;
+}
+
+// Subtracts state 0's metric from every state's.
+static inline __m128i normalize(__m128i metrics)
+{
+    return _mm_subs_epi16(metrics, _mm_shuffle_epi8(metrics, _mm_set1_epi16(0x0100)));
+}
+
+static inline __m128i branchMetrics(std::int16_t branchSys, __m128i y, __m128i w, __m128i yMask, __m128i wMask)
+{
+    return _mm_adds_epi16(
+               _mm_set1_epi16(branchSys),
+               _mm_adds_epi16(_mm_and_si128(y, yMask), _mm_and_si128(w, wMask)));
+}
+
+static inline __m128i forwardStep(
+    const SSETrellis& trellis,
+    __m128i alpha,
+    const std::int16_t* branchSys,
+    std::int16_t y,
+    std::int16_t w)
+{
+    const auto yValues = _mm_set1_epi16(y);
+    const auto wValues = _mm_set1_epi16(w);
+
+    __m128i candidates[NumSymbols];
+    for(size_t symbol = 0; symbol < NumSymbols; ++symbol)
+    {
+        candidates[symbol] = _mm_adds_epi16(
+                                 _mm_shuffle_epi8(alpha, trellis.prevShuffles[symbol]),
+                                 branchMetrics(
+                                     branchSys[symbol],
+                                     yValues,
+                                     wValues,
+                                     trellis.forwardYMasks[symbol],
+                                     trellis.forwardWMasks[symbol]));
+    }
+
+    return normalize(_mm_max_epi16(
+                         _mm_max_epi16(candidates[0], candidates[1]),
+                         _mm_max_epi16(candidates[2], candidates[3])));
+}
+
+// Each symbol's metrics, through every state, before the best is taken
+static inline void backwardCandidates(
+    const SSETrellis& trellis,
+    __m128i beta,
+    const std::int16_t* branchSys,
+    std::int16_t y,
+    std::int16_t w,
+    __m128i* candidatesOut)
+{
+    const auto yValues = _mm_set1_epi16(y);
+    const auto wValues = _mm_set1_epi16(w);
+
+    for(size_t symbol = 0; symbol < NumSymbols; ++symbol)
+    {
+        candidatesOut[symbol] = _mm_adds_epi16(
+                                    _mm_shuffle_epi8(beta, trellis.nextShuffles[symbol]),
+                                    branchMetrics(
+                                        branchSys[symbol],
+                                        yValues,
+                                        wValues,
+                                        trellis.backwardYMasks[symbol],
+                                        trellis.backwardWMasks[symbol]));
+    }
+}
+
+static inline __m128i maxCandidates(const __m128i* candidates)
+{
+    return normalize(_mm_max_epi16(
+                         _mm_max_epi16(candidates[0], candidates[1]),
+                         _mm_max_epi16(candidates[2], candidates[3])));
+}
+
+// The four symbols' best metrics over every state, in the low four lanes,
+// relative to symbol 0's. Interleaving the registers takes the maximum of
+// all four at once.
+static inline void storeSymbolMetrics(const __m128i* metrics, std::int16_t* appOut)
+{
+    const auto max01 = _mm_max_epi16(_mm_unpacklo_epi16(metrics[0], metrics[1]), _mm_unpackhi_epi16(metrics[0], metrics[1]));
+    const auto max23 = _mm_max_epi16(_mm_unpacklo_epi16(metrics[2], metrics[3]), _mm_unpackhi_epi16(metrics[2], metrics[3]));
+    const auto max0123 = _mm_max_epi16(_mm_unpacklo_epi32(max01, max23), _mm_unpackhi_epi32(max01, max23));
+    const auto result = _mm_max_epi16(max0123, _mm_unpackhi_epi64(max0123, max0123));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(appOut), normalize(result));
+}
+
+static void runSISO(
+    size_t N,
+    const std::int16_t* branchSys,
+    const std::int16_t* y,
+    const std::int16_t* w,
+    std::int16_t* alphas,
+    std::int16_t* appOut)
+{
+    const auto& trellis = getSSETrellis();
+    const size_t trainingLength = std::min(N, TrainingLength);
+
+    auto alpha = _mm_setzero_si128();
+    for(size_t k = N - trainingLength; k < N; ++k) alpha = forwardStep(trellis, alpha, branchSys + (k*NumSymbols), y[k], w[k]);
+    for(size_t k = 0; k < N; ++k)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(alphas + (k*NumStates)), alpha);
+        alpha = forwardStep(trellis, alpha, branchSys + (k*NumSymbols), y[k], w[k]);
+    }
+
+    __m128i candidates[NumSymbols];
+
+    auto beta = _mm_setzero_si128();
+    for(size_t k = trainingLength; k-- > 0;)
+    {
+        backwardCandidates(trellis, beta, branchSys + (k*NumSymbols), y[k], w[k], candidates);
+        beta = maxCandidates(candidates);
+    }
+    for(size_t k = N; k-- > 0;)
+    {
+        backwardCandidates(trellis, beta, branchSys + (k*NumSymbols), y[k], w[k], candidates);
+        beta = maxCandidates(candidates);
+
+        const auto alphaK = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alphas + (k*NumStates)));
+        for(auto& candidate: candidates) candidate = _mm_adds_epi16(candidate, alphaK);
+        storeSymbolMetrics(candidates, appOut + (k*NumSymbols));
+    }
+}
+
+#endif
+
+//
+// Element-wise stages
+//
+
+// Extrinsic information is what the SISO adds to its input. Max-log-MAP
+// overestimates its reliability, so it's scaled by 0.75.
+static void calcExtrinsic(const std::int16_t* app, const std::int16_t* branchSys, std::int16_t* out, size_t length)
+{
+    for(size_t elem = 0; elem < length; ++elem)
+    {
+        const int extrinsic = int(app[elem]) - int(branchSys[elem]);
+        out[elem] = std::int16_t(std::min(std::max(extrinsic - (extrinsic >> 2), -ExtrinsicMax), ExtrinsicMax));
+    }
+}
+
+// Adds one ordering's extrinsic symbol metrics to the other's systematic
+// metrics, where couple i of the output's ordering is couple indices[i] of
+// the extrinsic metrics'. A and B are swapped if the couple's natural-order
+// index is odd, which is indices[i] if swapByIndex, or i otherwise.
+static void addPermutedExtrinsic(
+    size_t N,
+    const std::int16_t* sys,
+    const std::int16_t* extrinsic,
+    const std::uint16_t* indices,
+    bool swapByIndex,
+    std::int16_t* out)
+{
+    for(size_t i = 0; i < N; ++i)
+    {
+        const size_t index = indices[i];
+        const bool swap = (swapByIndex ? index : i) & 1;
+        for(int symbol = 0; symbol < int(NumSymbols); ++symbol)
+        {
+            out[(i*NumSymbols) + symbol] = saturate(
+                                               sys[(i*NumSymbols) + symbol] +
+                                               extrinsic[(index*NumSymbols) + swapSymbol(symbol, swap)]);
+        }
+    }
+}
+
+//
+// Decoder
+//
+
+DuoBinaryCTCDecoder::DuoBinaryCTCDecoder(DuoBinaryCTCInterleaverFcn interleaverFcn):
+    _interleaverFcn(interleaverFcn),
+    _N(0),
+    _pInterleaver(nullptr)
+{
+}
+
+void DuoBinaryCTCDecoder::_setBlockSize(size_t N)
+{
+    if(N == _N) return;
+
+    _pInterleaver = &_interleaverFcn(N);
+    if(0 == (N % 7))
+    {
+        throw Pothos::InvalidArgumentException("No circulation state exists for N="+std::to_string(N));
+    }
+
+    _N = N;
+
+    for(auto* symbolMetrics: {&_sys1, &_sys2, &_branchSys, &_extrinsic, &_app})
+    {
+        symbolMetrics->resize(N * NumSymbols);
+    }
+    for(auto* parity: {&_y1, &_w1, &_y2, &_w2}) parity->resize(N);
+    _alphas.resize(N * NumStates);
+}
+
+size_t DuoBinaryCTCDecoder::decode(
+    size_t N,
+    size_t maxIterations,
+    const std::int8_t* in,
+    std::uint8_t* bitsOut,
+    const StopFcn& stopFcn)
+{
+    _setBlockSize(N);
+
+    const auto& interleaver = *_pInterleaver;
+    const std::int8_t* A = in;
+    const std::int8_t* B = in + N;
+
+    auto loadSys = [](std::int16_t* sys, std::int16_t a, std::int16_t b)
+    {
+        sys[0] = 0;
+        sys[1] = b;
+        sys[2] = a;
+        sys[3] = std::int16_t(a + b);
+    };
+
+    for(size_t i = 0; i < N; ++i)
+    {
+        loadSys(_sys1.data() + (i*NumSymbols), A[i], B[i]);
+        _y1[i] = in[(2*N) + i];
+        _w1[i] = in[(4*N) + i];
+    }
+    for(size_t j = 0; j < N; ++j)
+    {
+        const size_t i = interleaver.forward[j];
+        if(i & 1) loadSys(_sys2.data() + (j*NumSymbols), B[i], A[i]);
+        else      loadSys(_sys2.data() + (j*NumSymbols), A[i], B[i]);
+
+        _y2[j] = in[(3*N) + j];
+        _w2[j] = in[(5*N) + j];
+    }
+
+    std::fill(_extrinsic.begin(), _extrinsic.end(), 0);
+
+    size_t iteration = 0;
+    while(iteration < maxIterations)
+    {
+        ++iteration;
+
+        // Natural order, with the interleaved decoder's extrinsic metrics
+        addPermutedExtrinsic(N, _sys1.data(), _extrinsic.data(), interleaver.inverse.data(), false, _branchSys.data());
+        runSISO(N, _branchSys.data(), _y1.data(), _w1.data(), _alphas.data(), _app.data());
+        calcExtrinsic(_app.data(), _branchSys.data(), _extrinsic.data(), _app.size());
+
+        // Interleaved order
+        addPermutedExtrinsic(N, _sys2.data(), _extrinsic.data(), interleaver.forward.data(), true, _branchSys.data());
+        runSISO(N, _branchSys.data(), _y2.data(), _w2.data(), _alphas.data(), _app.data());
+        calcExtrinsic(_app.data(), _branchSys.data(), _extrinsic.data(), _app.size());
+
+        // Each couple is its most likely symbol.
+        int minMargin = std::numeric_limits<std::int16_t>::max();
+        for(size_t i = 0; i < N; ++i)
+        {
+            const auto* app = _app.data() + (interleaver.inverse[i] * NumSymbols);
+            const bool swap = i & 1;
+
+            int best = 0, secondBest = std::numeric_limits<int>::min();
+            int bestSymbol = 0;
+            for(int symbol = 1; symbol < int(NumSymbols); ++symbol)
+            {
+                const int metric = app[swapSymbol(symbol, swap)];
+                if(metric > best)
+                {
+                    secondBest = best;
+                    best = metric;
+                    bestSymbol = symbol;
+                }
+                else secondBest = std::max(secondBest, metric);
+            }
+
+            bitsOut[2*i] = std::uint8_t(bestSymbol >> 1);
+            bitsOut[(2*i)+1] = std::uint8_t(bestSymbol & 1);
+            minMargin = std::min(minMargin, best - secondBest);
+        }
+
+        if(stopFcn && stopFcn(iteration, bitsOut, minMargin)) break;
+    }
+
+    return iteration;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// The 8-state duo-binary circular recursive systematic convolutional (CRSC)
+// turbo code shared by DVB-RCS and the WiMAX (IEEE 802.16) data channels.
+// Each block of K bits is encoded as N=K/2 couples (A,B), by two
+// constituent encoders, one in natural order and one in interleaved order.
+// Each constituent encoder starts and ends in the same circulation state,
+// so the trellis is a circle and there are no tail bits.
+
+// A duo-binary interleaver, as the permutation between couples in input
+// order and in interleaved order. The interleaver also swaps A and B in
+// every couple with an odd input index.
+struct DuoBinaryCTCInterleaver
+{
+    size_t N;
+
+    // Interleaved couple j is input couple forward[j].
+    std::vector<std::uint16_t> forward;
+
+    // Input couple i is interleaved couple inverse[i].
+    std::vector<std::uint16_t> inverse;
+};
+
+// Returns a code's cached interleaver for N couples. Throws if N isn't a
+// valid block size for the code.
+using DuoBinaryCTCInterleaverFcn = const DuoBinaryCTCInterleaver&(*)(size_t N);
+
+// Encodes with lookup tables, two passes per constituent encoder: one from
+// state 0 to find the circulation state, and one from the circulation state.
+class DuoBinaryCTCEncoder
+{
+public:
+    explicit DuoBinaryCTCEncoder(DuoBinaryCTCInterleaverFcn interleaverFcn);
+
+    // Takes 2N bits, one per byte, as A[0], B[0], A[1], B[1], ..., and
+    // outputs 6N bits, one per byte, as IEEE 802.16's six subblocks of N
+    // bits each: A, B, Y1, Y2, W1, W2.
+    void encode(size_t N, const std::uint8_t* bits, std::uint8_t* out);
+
+private:
+    DuoBinaryCTCInterleaverFcn _interleaverFcn;
+
+    std::vector<std::uint8_t> _interleavedSymbols;
+};
+
+// An iterative max-log-MAP decoder. Each constituent decoder works on
+// symbol (couple) metrics, taking all four inputs of a trellis step at
+// once, with the eight states' 16-bit metrics in one SSE register. As the
+// trellis is circular, each recursion starts from a short training run
+// over the other end of the block.
+//
+// Soft inputs follow the turbo decoders' convention, where a positive value
+// corresponds to a 1 bit.
+class DuoBinaryCTCDecoder
+{
+public:
+    // Called after each full iteration with the decoded bits so far, one
+    // per byte, and the smallest margin between a couple's most and second
+    // most likely values. Return true to stop.
+    using StopFcn = std::function<bool(size_t numIterations, const std::uint8_t* bits, int minMargin)>;
+
+    explicit DuoBinaryCTCDecoder(DuoBinaryCTCInterleaverFcn interleaverFcn);
+
+    // The input holds 6N soft bits, laid out as output by the encoder. The
+    // 2N decoded bits are output one per byte, in the encoder's input order.
+    // Returns the number of iterations run.
+    size_t decode(
+        size_t N,
+        size_t maxIterations,
+        const std::int8_t* in,
+        std::uint8_t* bitsOut,
+        const StopFcn& stopFcn = StopFcn());
+
+private:
+    DuoBinaryCTCInterleaverFcn _interleaverFcn;
+
+    size_t _N;
+    const DuoBinaryCTCInterleaver* _pInterleaver;
+
+    // Symbol metrics hold four values per couple, one for each value of
+    // (A,B), as 2A+B, relative to (0,0).
+    std::vector<std::int16_t> _sys1;
+    std::vector<std::int16_t> _sys2;
+    std::vector<std::int16_t> _branchSys;
+    std::vector<std::int16_t> _extrinsic;
+    std::vector<std::int16_t> _app;
+
+    // Each constituent decoder's parity soft bits
+    std::vector<std::int16_t> _y1;
+    std::vector<std::int16_t> _w1;
+    std::vector<std::int16_t> _y2;
+    std::vector<std::int16_t> _w2;
+
+    // Each step's forward state metrics
+    std::vector<std::int16_t> _alphas;
+
+    void _setBlockSize(size_t N);
+};
@@ -0,0 +1,142 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "FrameDeadlineTracker.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <limits>
+
+// Weight given to each new decode time in the running average
+static constexpr double CostAverageWeight = 0.1;
+
+FrameDeadlineTracker::FrameDeadlineTracker():
+    _timestampID("rxTime"),
+    _budget(Clock::duration::zero()),
+    _nsPerWorkUnit(0.0),
+    _numDroppedFrames(0),
+    _numDegradedFrames(0)
+{
+}
+
+std::string FrameDeadlineTracker::timestampID() const
+{
+    return _timestampID;
+}
+
+void FrameDeadlineTracker::setTimestampID(const std::string& timestampID)
+{
+    _timestampID = timestampID;
+}
+
+double FrameDeadlineTracker::budget() const
+{
+    return std::chrono::duration<double>(_budget).count();
+}
+
+void FrameDeadlineTracker::setBudget(double budget)
+{
+    if(budget < 0.0)
+    {
+        throw Pothos::InvalidArgumentException("Deadline budget must be >= 0");
+    }
+
+    _budget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budget));
+}
+
+bool FrameDeadlineTracker::enabled() const
+{
+    return (_budget > Clock::duration::zero());
+}
+
+void FrameDeadlineTracker::indexTimestamps(const Pothos::InputPort* input, size_t numElements)
+{
+    _timestamps.clear();
+    for(const auto& label: input->labels())
+    {
+        if((label.id != _timestampID) || (label.index >= numElements)) continue;
+
+        const auto timestampNs = label.data.convert<long long>();
+        const auto deadline = Clock::time_point(
+                                  std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::nanoseconds(timestampNs)))
+                            + _budget;
+        _timestamps.emplace_back(Timestamp{label.index, deadline});
+    }
+
+    // Labels are almost always in order already.
+    const auto byIndex = [](const Timestamp& timestamp0, const Timestamp& timestamp1)
+    {
+        return (timestamp0.index < timestamp1.index);
+    };
+    if(!std::is_sorted(_timestamps.begin(), _timestamps.end(), byIndex))
+    {
+        std::stable_sort(_timestamps.begin(), _timestamps.end(), byIndex);
+    }
+}
+
+bool FrameDeadlineTracker::findDeadline(
+    size_t frameOffset,
+    size_t frameSize,
+    Clock::time_point& deadlineOut) const
+{
+    const auto iter = std::lower_bound(
+                          _timestamps.begin(),
+                          _timestamps.end(),
+                          frameOffset,
+                          [](const Timestamp& timestamp, size_t index)
+                          {
+                              return (timestamp.index < index);
+                          });
+    if((iter == _timestamps.end()) || (iter->index >= (frameOffset + frameSize))) return false;
+
+    deadlineOut = iter->deadline;
+    return true;
+}
+
+void FrameDeadlineTracker::recordDecodeTime(double numWorkUnits, Clock::duration elapsed)
+{
+    if(numWorkUnits <= 0.0) return;
+
+    const double nsPerWorkUnit = double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / numWorkUnits;
+
+    if(0.0 == _nsPerWorkUnit) _nsPerWorkUnit = nsPerWorkUnit;
+    else _nsPerWorkUnit += CostAverageWeight * (nsPerWorkUnit - _nsPerWorkUnit);
+}
+
+double FrameDeadlineTracker::workUnitsRemaining(const Clock::time_point& deadline) const
+{
+    const auto now = Clock::now();
+    if(now >= deadline) return 0.0;
+    if(0.0 == _nsPerWorkUnit) return std::numeric_limits<double>::infinity();
+
+    const double nsRemaining = double(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count());
+    return (nsRemaining / _nsPerWorkUnit);
+}
+
+unsigned long long FrameDeadlineTracker::numDroppedFrames() const
+{
+    return _numDroppedFrames;
+}
+
+unsigned long long FrameDeadlineTracker::numDegradedFrames() const
+{
+    return _numDegradedFrames;
+}
+
+void FrameDeadlineTracker::frameDropped()
+{
+    ++_numDroppedFrames;
+}
+
+void FrameDeadlineTracker::frameDegraded()
+{
+    ++_numDegradedFrames;
+}
+
+void FrameDeadlineTracker::resetCounts()
+{
+    _numDroppedFrames = 0;
+    _numDegradedFrames = 0;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <Pothos/Framework.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Determines per-frame decode deadlines from a timestamp label plus a
+// configurable budget, and keeps a running estimate of decode cost so
+// callers can decide whether a frame can still be decoded in time.
+//
+// Timestamps are expected to be nanoseconds since the system clock's epoch.
+class FrameDeadlineTracker
+{
+public:
+    using Clock = std::chrono::system_clock;
+
+    FrameDeadlineTracker();
+
+    std::string timestampID() const;
+
+    void setTimestampID(const std::string& timestampID);
+
+    // In seconds. A budget of zero disables deadlines.
+    double budget() const;
+
+    void setBudget(double budget);
+
+    bool enabled() const;
+
+    // Indexes the timestamp labels within the input's first numElements
+    // elements. Call once per work() call, before finding any deadlines.
+    void indexTimestamps(const Pothos::InputPort* input, size_t numElements);
+
+    // Returns false if no indexed timestamp label falls within the frame.
+    bool findDeadline(
+        size_t frameOffset,
+        size_t frameSize,
+        Clock::time_point& deadlineOut) const;
+
+    // Feeds the cost estimate. Callers choose what a unit of work is,
+    // such as a frame or a bit-iteration.
+    void recordDecodeTime(double numWorkUnits, Clock::duration elapsed);
+
+    // How many units of work can be done before the deadline, based on
+    // the current cost estimate. If there's no estimate yet, this is
+    // unlimited until the deadline passes.
+    double workUnitsRemaining(const Clock::time_point& deadline) const;
+
+    unsigned long long numDroppedFrames() const;
+
+    unsigned long long numDegradedFrames() const;
+
+    void frameDropped();
+
+    void frameDegraded();
+
+    void resetCounts();
+
+private:
+    std::string _timestampID;
+    Clock::duration _budget;
+
+    struct Timestamp
+    {
+        size_t index;
+        Clock::time_point deadline;
+    };
+
+    // Sorted by index
+    std::vector<Timestamp> _timestamps;
+
+    // Running average of nanoseconds per unit of work, 0 if unknown
+    double _nsPerWorkUnit;
+
+    unsigned long long _numDroppedFrames;
+    unsigned long long _numDegradedFrames;
+};
@@ -422,6 +422,10 @@ static Pothos::BlockRegistry registerGenericConvolutionEncoder(
  * |setter setGen(gen)
  * |setter setPuncture(puncture)
  * |setter setTerminationType(terminationType)
+ * |setter setEnergyThreshold(energyThreshold)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setPriority(priority)
  *
  * |param N[Rate] 2, 3, 4 (corresponding to 1/2, 1/3, 1/4)
  * |widget SpinBox(minimum=2,maximum=4)
@@ -461,6 +465,38 @@ static Pothos::BlockRegistry registerGenericConvolutionEncoder(
  * |option [Tail-biting] "Tail-biting"
  * |default "Flush"
  * |preview enable
+ *
+ * |param energyThreshold[Energy Threshold]
+ * If positive, frames whose mean absolute soft value is below this threshold
+ * are not decoded. Instead, the block outputs zeros and posts a "skipped" label.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each frame with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Frames that can't be decoded in time are dropped.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a frame's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
  */
 static Pothos::BlockRegistry registerGenericConvolutionDecoder(
     "/fec/generic_conv_decoder",
@@ -0,0 +1,339 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LTERateMatching.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+extern "C"
+{
+#include <turbofec/turbo.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+static constexpr size_t MaxNumHARQProcesses = 16;
+
+// Every process's soft buffer has room for the largest block.
+static constexpr size_t MaxSoftBufferSize = 3 * (TURBO_MAX_K + 4);
+
+//
+// Block
+//
+
+struct LTEHARQProcess
+{
+    // Null if the process has nothing buffered
+    const LTECircularBuffer* circularBuffer;
+    size_t numTransmissions;
+};
+
+template <typename T>
+class LTEHARQBuffer: public Pothos::Block
+{
+    public:
+        LTEHARQBuffer(size_t numProcesses, const std::string& softType):
+            Pothos::Block(),
+            _processes(numProcesses, LTEHARQProcess{nullptr, 0}),
+            _softBufferPool(numProcesses * MaxSoftBufferSize, 0),
+            _blockStartID("START")
+        {
+            this->setupInput(0, softType);
+
+            // Laid out like the LTE turbo encoder's outputs
+            this->setupOutput(0, "uint8");
+            this->setupOutput(1, "uint8");
+            this->setupOutput(2, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTEHARQBuffer, numProcesses));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTEHARQBuffer, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTEHARQBuffer, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTEHARQBuffer, numTransmissions));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTEHARQBuffer, resetProcess));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTEHARQBuffer, reset));
+
+            this->registerProbe("numProcesses");
+
+            _streams.reserve(MaxSoftBufferSize);
+        }
+
+        size_t numProcesses() const
+        {
+            return _processes.size();
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            if(blockStartID.empty())
+            {
+                throw Pothos::InvalidArgumentException("The block start ID must not be empty");
+            }
+
+            _blockStartID = blockStartID;
+        }
+
+        // The number of transmissions combined in the given process's
+        // soft buffer
+        size_t numTransmissions(size_t process) const
+        {
+            return _processes.at(process).numTransmissions;
+        }
+
+        void resetProcess(size_t process)
+        {
+            _processes.at(process) = LTEHARQProcess{nullptr, 0};
+        }
+
+        void reset()
+        {
+            for(size_t process = 0; process < _processes.size(); ++process) this->resetProcess(process);
+        }
+
+        // Labels describing a transmission are consumed here.
+        void propagateLabels(const Pothos::InputPort*) override
+        {
+        }
+
+        void work() override
+        {
+            auto input = this->input(0);
+
+            const auto elems = input->elements();
+            if(0 == elems) return;
+
+            size_t inputSize = 0;
+            bool transmissionFound = false;
+
+            for(const auto& label: input->labels())
+            {
+                // Skip if we haven't received enough data for this label.
+                if(label.index > elems) continue;
+
+                // Skip if this isn't a block start label.
+                if(label.id != _blockStartID) continue;
+
+                if(!label.data.canConvert(typeid(size_t)))
+                {
+                    throw Pothos::InvalidArgumentException("Block start labels must contain the transmission's length");
+                }
+                inputSize = label.data.convert<size_t>();
+
+                // Skip all data before the transmission starts.
+                if(0 != label.index)
+                {
+                    input->consume(label.index);
+                    input->setReserve(inputSize);
+                    return;
+                }
+
+                // Wait until the whole transmission is here.
+                if(elems < inputSize)
+                {
+                    input->setReserve(inputSize);
+                    return;
+                }
+
+                transmissionFound = true;
+                break;
+            }
+
+            if(transmissionFound) _combine(inputSize);
+            else                  input->consume(elems);
+        }
+
+    private:
+        std::vector<LTEHARQProcess> _processes;
+
+        // One fixed-size soft buffer per process, from a single allocation,
+        // so memory use is bounded and never changes while running
+        std::vector<T> _softBufferPool;
+
+        // The combined soft bits, in encoder output order
+        std::vector<std::int8_t> _streams;
+
+        std::string _blockStartID;
+
+        void _combine(size_t inputSize)
+        {
+            auto input = this->input(0);
+            const auto& outputs = this->outputs();
+
+            // The transmission's parameters are labeled at its start.
+            size_t processIndex = 0;
+            size_t rv = 0;
+            size_t K = 0;
+            size_t numFillerBits = 0;
+            size_t Ncb = 0;
+            bool hasNewData = false;
+            bool newData = false;
+            std::vector<Pothos::Label> otherLabels;
+
+            for(const auto& label: input->labels())
+            {
+                if(0 != label.index) continue;
+
+                if("harqProcess" == label.id)             processIndex = label.data.convert<size_t>();
+                else if("rv" == label.id)                 rv = label.data.convert<size_t>();
+                else if("blockSize" == label.id)          K = label.data.convert<size_t>();
+                else if("numFillerBits" == label.id)      numFillerBits = label.data.convert<size_t>();
+                else if("circularBufferSize" == label.id) Ncb = label.data.convert<size_t>();
+                else if("newData" == label.id)
+                {
+                    newData = label.data.convert<bool>();
+                    hasNewData = true;
+                }
+                else if(_blockStartID != label.id) otherLabels.push_back(label);
+            }
+
+            if(processIndex >= _processes.size())
+            {
+                throw Pothos::InvalidArgumentException("Invalid HARQ process: "+std::to_string(processIndex));
+            }
+            if(rv >= NumLTERedundancyVersions)
+            {
+                throw Pothos::InvalidArgumentException("Invalid redundancy version: "+std::to_string(rv));
+            }
+
+            // Throws on an invalid block size, filler bit count or Ncb.
+            const auto& circularBuffer = getLTECircularBuffer(
+                                             K,
+                                             numFillerBits,
+                                             ((0 == Ncb) ? getLTEFullCircularBufferSize(K) : Ncb));
+            const size_t D = circularBuffer.streamLength;
+            const size_t circularBufferSize = 3 * D;
+
+            // Without a new data indicator, the first redundancy version
+            // starts a new block.
+            if(!hasNewData) newData = (0 == rv);
+
+            auto& process = _processes[processIndex];
+            T* softBuffer = _softBufferPool.data() + (processIndex * MaxSoftBufferSize);
+
+            // A retransmission with a different circular buffer means the
+            // original transmission was missed, so there's nothing to combine
+            // with.
+            if(newData || (process.circularBuffer != &circularBuffer))
+            {
+                std::fill(softBuffer, softBuffer + circularBufferSize, T(0));
+                process.circularBuffer = &circularBuffer;
+                process.numTransmissions = 0;
+            }
+
+            // A transmission is a contiguous run of the circular buffer,
+            // wrapping around as many times as needed.
+            accumulateTransmission(circularBuffer, rv, input->buffer().template as<const T*>(), inputSize, softBuffer);
+            ++process.numTransmissions;
+
+            // Each output is sized as the LTE turbo encoder's are, with the
+            // stream at the front.
+            _streams.resize(circularBufferSize);
+            deinterleave(circularBuffer, softBuffer, _streams.data());
+
+            const size_t outputSize = circularBufferSize;
+            const bool mustPostBuffer = (outputSize > this->workInfo().minOutElements);
+
+            for(size_t port = 0; port < 3; ++port)
+            {
+                Pothos::BufferChunk outputBuffer = mustPostBuffer ? Pothos::BufferChunk("uint8", outputSize)
+                                                                  : outputs[port]->buffer();
+
+                auto* output = outputBuffer.as<std::int8_t*>();
+                std::memcpy(output, _streams.data() + (port * D), D);
+                std::memset(output + D, 0, (outputSize - D));
+
+                if(mustPostBuffer) outputs[port]->postBuffer(std::move(outputBuffer));
+                else               outputs[port]->produce(outputSize);
+            }
+
+            input->consume(inputSize);
+
+            // Output a start block ID so the decoder can operate on the same data.
+            outputs[0]->postLabel(_blockStartID, outputSize, 0);
+            outputs[0]->postLabel("harqTransmissions", process.numTransmissions, 0);
+            for(const auto& label: otherLabels) outputs[0]->postLabel(label.id, label.data, 0);
+        }
+};
+
+static Pothos::Block* makeLTEHARQBuffer(size_t numProcesses, const std::string& softType)
+{
+    if((0 == numProcesses) || (numProcesses > MaxNumHARQProcesses))
+    {
+        throw Pothos::InvalidArgumentException("Num processes must be between 1 and "+std::to_string(MaxNumHARQProcesses));
+    }
+
+    if("int8" == softType)       return new LTEHARQBuffer<std::int8_t>(numProcesses, softType);
+    else if("int16" == softType) return new LTEHARQBuffer<std::int16_t>(numProcesses, softType);
+
+    throw Pothos::InvalidArgumentException("Invalid soft type: "+softType);
+}
+
+/*
+ * |PothosDoc LTE HARQ Buffer
+ *
+ * Combines retransmissions of LTE turbo-coded blocks ahead of the LTE turbo
+ * decoder, for incremental redundancy or Chase combining. Each HARQ process
+ * has a soft buffer holding the block's circular buffer (3GPP TS 36.212,
+ * section 5.1.4.1), into which each transmission's soft bits are added,
+ * with saturation, starting at its redundancy version's offset.
+ *
+ * Each transmission starts with a block start label containing its length,
+ * with these labels at the same index:
+ * <ul>
+ * <li><b>blockSize:</b> the code block size, K (required)</li>
+ * <li><b>harqProcess:</b> the HARQ process (default: 0)</li>
+ * <li><b>rv:</b> the redundancy version, 0-3 (default: 0)</li>
+ * <li><b>numFillerBits:</b> the number of filler bits, F (default: 0)</li>
+ * <li><b>circularBufferSize:</b> the circular buffer size, Ncb (default: the
+ * whole circular buffer, Kw, as for the uplink)</li>
+ * <li><b>newData:</b> whether this is a new block, rather than a retransmission
+ * (default: true for redundancy version 0)</li>
+ * </ul>
+ *
+ * After each transmission, the combined soft bits are output in the same
+ * layout as the LTE turbo encoder's output, with a block start label and a
+ * "harqTransmissions" label with the number of transmissions combined. Other
+ * labels at the start of the transmission, such as timestamps, are kept.
+ *
+ * All soft buffers are allocated up front, sized for the largest block.
+ *
+ * |category /FEC/Decoders
+ * |keywords lte harq combining soft buffer
+ * |factory /fec/lte_harq_buffer(numProcesses,softType)
+ * |setter setBlockStartID(blockStartID)
+ *
+ * |param numProcesses[Num Processes]
+ * The number of HARQ processes: 8 for FDD, or up to 15 for TDD.
+ * |widget SpinBox(minimum=1,maximum=16)
+ * |default 8
+ * |preview enable
+ *
+ * |param softType[Soft Type]
+ * The type of the input soft bits, and of the soft buffers. 8-bit soft buffers
+ * halve the memory traffic, but saturate sooner.
+ * |widget ComboBox(editable=False)
+ * |option [Int8] "int8"
+ * |option [Int16] "int16"
+ * |default "int8"
+ * |preview enable
+ *
+ * |param blockStartID[Block Start ID]
+ * The label marking the start of each transmission, and of each output block.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerLTEHARQBuffer(
+    "/fec/lte_harq_buffer",
+    Pothos::Callable(&makeLTEHARQBuffer));
@@ -0,0 +1,607 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LTERateMatching.hpp"
+#include "LTETurbo.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void validateRV(size_t rv)
+{
+    if(rv >= NumLTERedundancyVersions)
+    {
+        throw Pothos::InvalidArgumentException("Invalid redundancy version: "+std::to_string(rv));
+    }
+}
+
+// A circular buffer size of 0 means the whole circular buffer, Kw.
+static const LTECircularBuffer& getCircularBuffer(
+    size_t K,
+    size_t numFillerBits,
+    size_t circularBufferSize)
+{
+    return getLTECircularBuffer(
+               K,
+               numFillerBits,
+               (0 == circularBufferSize) ? getLTEFullCircularBufferSize(K) : circularBufferSize);
+}
+
+//
+// Rate matcher
+//
+
+class LTERateMatcher: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make()
+        {
+            return new LTERateMatcher();
+        }
+
+        LTERateMatcher():
+            Pothos::Block(),
+            _blockStartID("START"),
+            _outputSize(0),
+            _rv(0),
+            _numFillerBits(0),
+            _circularBufferSize(0)
+        {
+            // Laid out like the LTE turbo encoder's outputs
+            this->setupInput(0, "uint8");
+            this->setupInput(1, "uint8");
+            this->setupInput(2, "uint8");
+
+            this->setupOutput(0, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, outputSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, setOutputSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, rv));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, setRV));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, numFillerBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, setNumFillerBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, circularBufferSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateMatcher, setCircularBufferSize));
+
+            this->registerProbe("outputSize");
+            this->registerProbe("rv");
+            this->registerProbe("numFillerBits");
+            this->registerProbe("circularBufferSize");
+
+            _streams.reserve(3 * (TURBO_MAX_K + 4));
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            if(blockStartID.empty())
+            {
+                throw Pothos::InvalidArgumentException("The block start ID must not be empty");
+            }
+
+            _blockStartID = blockStartID;
+        }
+
+        size_t outputSize() const
+        {
+            return _outputSize;
+        }
+
+        void setOutputSize(size_t outputSize)
+        {
+            _outputSize = outputSize;
+        }
+
+        size_t rv() const
+        {
+            return _rv;
+        }
+
+        void setRV(size_t rv)
+        {
+            validateRV(rv);
+
+            _rv = rv;
+        }
+
+        size_t numFillerBits() const
+        {
+            return _numFillerBits;
+        }
+
+        // Checked against each block's size as it's rate matched.
+        void setNumFillerBits(size_t numFillerBits)
+        {
+            _numFillerBits = numFillerBits;
+        }
+
+        size_t circularBufferSize() const
+        {
+            return _circularBufferSize;
+        }
+
+        void setCircularBufferSize(size_t circularBufferSize)
+        {
+            _circularBufferSize = circularBufferSize;
+        }
+
+        // Output labels are posted with each rate-matched block.
+        void propagateLabels(const Pothos::InputPort*) override
+        {
+        }
+
+        void work() override
+        {
+            const auto& inputs = this->inputs();
+
+            const auto elems = this->workInfo().minInElements;
+            if(0 == elems) return;
+
+            size_t inputSize = 0;
+            bool blockFound = false;
+
+            // We take in three inputs, but input 0 is expected to have
+            // the block ID label.
+            for(const auto& label: inputs[0]->labels())
+            {
+                // Skip if we haven't received enough data for this label.
+                if(label.index > elems) continue;
+
+                // Skip if this isn't a block start label.
+                if(label.id != _blockStartID) continue;
+
+                if(!label.data.canConvert(typeid(size_t)))
+                {
+                    throw Pothos::InvalidArgumentException("Block start labels must contain the encoded block's length");
+                }
+                inputSize = label.data.convert<size_t>();
+
+                // Skip all data before the block starts.
+                if(0 != label.index)
+                {
+                    for(auto* input: inputs)
+                    {
+                        input->consume(label.index);
+                        input->setReserve(inputSize);
+                    }
+                    return;
+                }
+
+                // Wait until we have the whole block.
+                if(elems < inputSize)
+                {
+                    for(auto* input: inputs) input->setReserve(inputSize);
+                    return;
+                }
+
+                blockFound = true;
+                break;
+            }
+
+            if(blockFound) _work(inputSize);
+            else           for(auto* input: inputs) input->consume(elems);
+        }
+
+    private:
+        std::string _blockStartID;
+        size_t _outputSize;
+        size_t _rv;
+        size_t _numFillerBits;
+
+        // Ncb, or 0 for the whole circular buffer
+        size_t _circularBufferSize;
+
+        // The encoder's output streams, one after another
+        std::vector<std::uint8_t> _streams;
+
+        void _work(size_t inputSize)
+        {
+            const auto& inputs = this->inputs();
+            auto output = this->output(0);
+
+            // Labels at the start of the block override the defaults.
+            size_t outputSize = _outputSize;
+            size_t rv = _rv;
+            size_t numFillerBits = _numFillerBits;
+            size_t circularBufferSize = _circularBufferSize;
+            std::vector<Pothos::Label> otherLabels;
+
+            for(const auto& label: inputs[0]->labels())
+            {
+                if(0 != label.index) continue;
+
+                if("outputSize" == label.id)              outputSize = label.data.convert<size_t>();
+                else if("rv" == label.id)                 rv = label.data.convert<size_t>();
+                else if("numFillerBits" == label.id)      numFillerBits = label.data.convert<size_t>();
+                else if("circularBufferSize" == label.id) circularBufferSize = label.data.convert<size_t>();
+                else if(_blockStartID != label.id)        otherLabels.push_back(label);
+            }
+
+            validateRV(rv);
+            if(0 == outputSize)
+            {
+                throw Pothos::InvalidArgumentException("The rate-matched output size must be positive");
+            }
+
+            // Throws on an invalid block size, filler bit count or Ncb.
+            const auto K = calcDecoderOutputSize(inputSize);
+            const auto& circularBuffer = getCircularBuffer(K, numFillerBits, circularBufferSize);
+            const size_t D = circularBuffer.streamLength;
+
+            _streams.resize(3 * D);
+            for(size_t port = 0; port < 3; ++port)
+            {
+                std::memcpy(_streams.data() + (port * D), inputs[port]->buffer().as<const std::uint8_t*>(), D);
+            }
+
+            const bool mustPostBuffer = (outputSize > output->elements());
+            Pothos::BufferChunk outputBuffer = mustPostBuffer ? Pothos::BufferChunk("uint8", outputSize)
+                                                              : output->buffer();
+
+            rateMatch(circularBuffer, rv, _streams.data(), outputBuffer.as<std::uint8_t*>(), outputSize);
+
+            for(auto* input: inputs) input->consume(inputSize);
+            if(mustPostBuffer) output->postBuffer(std::move(outputBuffer));
+            else               output->produce(outputSize);
+
+            // Label the block for a de-rate-matcher or HARQ buffer.
+            output->postLabel(_blockStartID, outputSize, 0);
+            output->postLabel("blockSize", K, 0);
+            output->postLabel("rv", rv, 0);
+            output->postLabel("numFillerBits", numFillerBits, 0);
+            output->postLabel("circularBufferSize", circularBuffer.Ncb, 0);
+            for(const auto& label: otherLabels) output->postLabel(label.id, label.data, 0);
+        }
+};
+
+//
+// De-rate-matcher
+//
+
+class LTERateDematcher: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make()
+        {
+            return new LTERateDematcher();
+        }
+
+        LTERateDematcher():
+            Pothos::Block(),
+            _blockStartID("START"),
+            _rv(0),
+            _numFillerBits(0),
+            _circularBufferSize(0)
+        {
+            this->setupInput(0, "int8");
+
+            // Laid out like the LTE turbo encoder's outputs
+            this->setupOutput(0, "uint8");
+            this->setupOutput(1, "uint8");
+            this->setupOutput(2, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, rv));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, setRV));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, numFillerBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, setNumFillerBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, circularBufferSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTERateDematcher, setCircularBufferSize));
+
+            this->registerProbe("rv");
+            this->registerProbe("numFillerBits");
+            this->registerProbe("circularBufferSize");
+
+            _streams.reserve(3 * (TURBO_MAX_K + 4));
+            _scratch.reserve(3 * (TURBO_MAX_K + 4));
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            if(blockStartID.empty())
+            {
+                throw Pothos::InvalidArgumentException("The block start ID must not be empty");
+            }
+
+            _blockStartID = blockStartID;
+        }
+
+        size_t rv() const
+        {
+            return _rv;
+        }
+
+        void setRV(size_t rv)
+        {
+            validateRV(rv);
+
+            _rv = rv;
+        }
+
+        size_t numFillerBits() const
+        {
+            return _numFillerBits;
+        }
+
+        // Checked against each block's size as it's de-rate-matched.
+        void setNumFillerBits(size_t numFillerBits)
+        {
+            _numFillerBits = numFillerBits;
+        }
+
+        size_t circularBufferSize() const
+        {
+            return _circularBufferSize;
+        }
+
+        void setCircularBufferSize(size_t circularBufferSize)
+        {
+            _circularBufferSize = circularBufferSize;
+        }
+
+        // Output labels are posted with each de-rate-matched block.
+        void propagateLabels(const Pothos::InputPort*) override
+        {
+        }
+
+        void work() override
+        {
+            auto input = this->input(0);
+
+            const auto elems = input->elements();
+            if(0 == elems) return;
+
+            size_t inputSize = 0;
+            bool blockFound = false;
+
+            for(const auto& label: input->labels())
+            {
+                // Skip if we haven't received enough data for this label.
+                if(label.index > elems) continue;
+
+                // Skip if this isn't a block start label.
+                if(label.id != _blockStartID) continue;
+
+                if(!label.data.canConvert(typeid(size_t)))
+                {
+                    throw Pothos::InvalidArgumentException("Block start labels must contain the transmission's length");
+                }
+                inputSize = label.data.convert<size_t>();
+
+                // Skip all data before the block starts.
+                if(0 != label.index)
+                {
+                    input->consume(label.index);
+                    input->setReserve(inputSize);
+                    return;
+                }
+
+                // Wait until we have the whole block.
+                if(elems < inputSize)
+                {
+                    input->setReserve(inputSize);
+                    return;
+                }
+
+                blockFound = true;
+                break;
+            }
+
+            if(blockFound) _work(inputSize);
+            else           input->consume(elems);
+        }
+
+    private:
+        std::string _blockStartID;
+        size_t _rv;
+        size_t _numFillerBits;
+
+        // Ncb, or 0 for the whole circular buffer
+        size_t _circularBufferSize;
+
+        // The de-rate-matched soft bits, one stream after another
+        std::vector<std::int8_t> _streams;
+        std::vector<std::int8_t> _scratch;
+
+        void _work(size_t inputSize)
+        {
+            auto input = this->input(0);
+            const auto& outputs = this->outputs();
+
+            // The transmission's parameters are labeled at its start.
+            size_t K = 0;
+            size_t rv = _rv;
+            size_t numFillerBits = _numFillerBits;
+            size_t circularBufferSize = _circularBufferSize;
+            std::vector<Pothos::Label> otherLabels;
+
+            for(const auto& label: input->labels())
+            {
+                if(0 != label.index) continue;
+
+                if("blockSize" == label.id)               K = label.data.convert<size_t>();
+                else if("rv" == label.id)                 rv = label.data.convert<size_t>();
+                else if("numFillerBits" == label.id)      numFillerBits = label.data.convert<size_t>();
+                else if("circularBufferSize" == label.id) circularBufferSize = label.data.convert<size_t>();
+                else if(_blockStartID != label.id)        otherLabels.push_back(label);
+            }
+
+            validateRV(rv);
+
+            // Throws on an invalid block size, filler bit count or Ncb.
+            const auto& circularBuffer = getCircularBuffer(K, numFillerBits, circularBufferSize);
+            const size_t D = circularBuffer.streamLength;
+            const size_t streamsSize = 3 * D;
+
+            _streams.resize(streamsSize);
+            _scratch.resize(streamsSize);
+            deRateMatch(
+                circularBuffer,
+                rv,
+                input->buffer().as<const std::int8_t*>(),
+                inputSize,
+                _streams.data(),
+                _scratch.data());
+
+            // Each output is sized as the LTE turbo encoder's are, with the
+            // stream at the front.
+            const size_t outputSize = streamsSize;
+            const bool mustPostBuffer = (outputSize > this->workInfo().minOutElements);
+
+            for(size_t port = 0; port < 3; ++port)
+            {
+                Pothos::BufferChunk outputBuffer = mustPostBuffer ? Pothos::BufferChunk("uint8", outputSize)
+                                                                  : outputs[port]->buffer();
+
+                auto* output = outputBuffer.as<std::int8_t*>();
+                std::memcpy(output, _streams.data() + (port * D), D);
+                std::memset(output + D, 0, (outputSize - D));
+
+                if(mustPostBuffer) outputs[port]->postBuffer(std::move(outputBuffer));
+                else               outputs[port]->produce(outputSize);
+            }
+
+            input->consume(inputSize);
+
+            // Output a start block ID so the decoder can operate on the same data.
+            outputs[0]->postLabel(_blockStartID, outputSize, 0);
+            for(const auto& label: otherLabels) outputs[0]->postLabel(label.id, label.data, 0);
+        }
+};
+
+/*
+ * |PothosDoc LTE Rate Matcher
+ *
+ * Rate matches blocks from the LTE turbo encoder (3GPP TS 36.212, section
+ * 5.1.4.1). Each of the encoder's three output streams is sub-block
+ * interleaved, and the results are collected into a circular buffer, from
+ * which each transmission reads its bits, starting at its redundancy
+ * version's offset and skipping <NULL> bits. The <NULL> bits include the
+ * filler bits at the start of a transport block's first code block, and only
+ * the first Ncb bits of the circular buffer are read. The circular buffer's
+ * tables are precomputed once per block size, number of filler bits and
+ * Ncb, so each block is a single gather.
+ *
+ * Each block must start with a block start label containing its length, as
+ * output by the LTE turbo encoder. "outputSize", "rv", "numFillerBits" and
+ * "circularBufferSize" labels at the same index override the matching
+ * settings for that block. Each output block has a block start label with its
+ * length, and "blockSize", "rv", "numFillerBits" and "circularBufferSize"
+ * labels, as expected by the LTE de-rate-matcher and HARQ buffer.
+ *
+ * |category /FEC/Encoders
+ * |keywords lte rate matching circular buffer redundancy version filler
+ * |factory /fec/lte_rate_matcher()
+ * |setter setBlockStartID(blockStartID)
+ * |setter setOutputSize(outputSize)
+ * |setter setRV(rv)
+ * |setter setNumFillerBits(numFillerBits)
+ * |setter setCircularBufferSize(circularBufferSize)
+ *
+ * |param blockStartID[Block Start ID]
+ * The label marking the start of each input and output block.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview valid
+ *
+ * |param outputSize[Output Size]
+ * The number of bits to transmit per block, E.
+ * |widget SpinBox(minimum=1)
+ * |default 1024
+ * |preview enable
+ *
+ * |param rv[Redundancy Version]
+ * |widget SpinBox(minimum=0,maximum=3)
+ * |default 0
+ * |preview enable
+ *
+ * |param numFillerBits[Num Filler Bits]
+ * The number of filler bits, F, at the start of each block. Only a transport
+ * block's first code block has filler bits, so this is usually set per block
+ * with a label.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param circularBufferSize[Circular Buffer Size]
+ * The number of circular buffer bits to transmit from, Ncb, including <NULL> bits.
+ * For the downlink, this is min(floor(N_IR / C), Kw). 0 uses the whole
+ * circular buffer, Kw, as for the uplink.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ */
+static Pothos::BlockRegistry registerLTERateMatcher(
+    "/fec/lte_rate_matcher",
+    Pothos::Callable(&LTERateMatcher::make));
+
+/*
+ * |PothosDoc LTE Rate Dematcher
+ *
+ * Undoes LTE rate matching (3GPP TS 36.212, section 5.1.4.1) for a single
+ * transmission, outputting soft bits in the LTE turbo encoder's output
+ * layout, for the LTE turbo decoder. Soft bits that weren't transmitted are
+ * 0, and repeated soft bits are combined with saturation. To combine separate
+ * transmissions, use the LTE HARQ buffer instead.
+ *
+ * Each transmission must start with a block start label containing its
+ * length, and a "blockSize" label with the code block size, as output by the
+ * LTE rate matcher. "rv", "numFillerBits" and "circularBufferSize" labels at
+ * the same index override the matching settings for that transmission.
+ * Soft bits for <NULL> bits, including filler bits, are 0.
+ *
+ * |category /FEC/Decoders
+ * |keywords lte rate matching circular buffer redundancy version filler
+ * |factory /fec/lte_rate_dematcher()
+ * |setter setBlockStartID(blockStartID)
+ * |setter setRV(rv)
+ * |setter setNumFillerBits(numFillerBits)
+ * |setter setCircularBufferSize(circularBufferSize)
+ *
+ * |param blockStartID[Block Start ID]
+ * The label marking the start of each input and output block.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview valid
+ *
+ * |param rv[Redundancy Version]
+ * |widget SpinBox(minimum=0,maximum=3)
+ * |default 0
+ * |preview enable
+ *
+ * |param numFillerBits[Num Filler Bits]
+ * The number of filler bits, F, at the start of each block. Only a transport
+ * block's first code block has filler bits, so this is usually set per block
+ * with a label.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param circularBufferSize[Circular Buffer Size]
+ * The number of circular buffer bits to receive into, Ncb, including <NULL> bits.
+ * For the downlink, this is min(floor(N_IR / C), Kw). 0 uses the whole
+ * circular buffer, Kw, as for the uplink.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ */
+static Pothos::BlockRegistry registerLTERateDematcher(
+    "/fec/lte_rate_dematcher",
+    Pothos::Callable(&LTERateDematcher::make));
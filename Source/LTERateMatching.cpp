@@ -0,0 +1,315 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LTERateMatching.hpp"
+#include "LTETurboInterleaver.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+static constexpr size_t NumSubBlockColumns = 32;
+
+// 3GPP TS 36.212, table 5.1.4-1
+static const std::uint8_t SubBlockColumnPermutation[NumSubBlockColumns] =
+{
+    0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30,
+    1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31
+};
+
+static size_t calcNumRows(size_t K)
+{
+    return ((K + 4) + NumSubBlockColumns - 1) / NumSubBlockColumns;
+}
+
+static void buildLTECircularBuffer(
+    LTECircularBuffer& circularBuffer,
+    size_t K,
+    size_t numFillerBits,
+    size_t Ncb)
+{
+    const size_t D = K + 4;
+    const size_t numRows = calcNumRows(K);
+    const size_t Kpi = numRows * NumSubBlockColumns;
+    const size_t numNulls = Kpi - D;
+
+    circularBuffer.K = K;
+    circularBuffer.numFillerBits = numFillerBits;
+    circularBuffer.Ncb = Ncb;
+    circularBuffer.streamLength = D;
+    circularBuffer.streamIndices.clear();
+    circularBuffer.streamIndices.reserve(3 * D);
+
+    // The <NULL> bits are padded onto the front of each stream before
+    // interleaving, and skipped here, as are the filler bits' systematic
+    // and first parity bits. The second parity stream comes from the
+    // interleaved input, so its first bits aren't filler.
+    size_t position = 0;
+    auto addBit = [&](size_t stream, size_t paddedIndex)
+    {
+        const size_t numStreamNulls = numNulls + ((2 == stream) ? 0 : numFillerBits);
+        if((position < Ncb) && (paddedIndex >= numStreamNulls))
+        {
+            circularBuffer.streamIndices.push_back(static_cast<std::uint16_t>((stream * D) + (paddedIndex - numNulls)));
+        }
+        ++position;
+    };
+
+    // The sub-block interleaver writes each stream row by row, and reads
+    // it column by column, in permuted column order. The third stream is
+    // offset by one, so its bits don't line up with the second stream's.
+    auto interleavedIndex = [&](size_t stream, size_t k)
+    {
+        const size_t index = SubBlockColumnPermutation[k / numRows] + (NumSubBlockColumns * (k % numRows));
+
+        return (2 == stream) ? ((index + 1) % Kpi) : index;
+    };
+
+    // The number of bits before each position in the circular buffer with
+    // <NULL> bits, to convert the redundancy versions' start positions.
+    std::vector<std::uint16_t> nonNullCounts;
+    nonNullCounts.reserve(3 * Kpi);
+
+    // The systematic stream comes first, then the two parity streams,
+    // interlaced.
+    for(size_t k = 0; k < Kpi; ++k)
+    {
+        nonNullCounts.push_back(static_cast<std::uint16_t>(circularBuffer.streamIndices.size()));
+        addBit(0, interleavedIndex(0, k));
+    }
+    for(size_t k = 0; k < Kpi; ++k)
+    {
+        nonNullCounts.push_back(static_cast<std::uint16_t>(circularBuffer.streamIndices.size()));
+        addBit(1, interleavedIndex(1, k));
+
+        nonNullCounts.push_back(static_cast<std::uint16_t>(circularBuffer.streamIndices.size()));
+        addBit(2, interleavedIndex(2, k));
+    }
+
+    if(circularBuffer.streamIndices.empty())
+    {
+        throw Pothos::InvalidArgumentException("Ncb="+std::to_string(Ncb)+" leaves no bits to transmit");
+    }
+
+    // k0 = R * (2 * ceil(Ncb / (8 * R)) * rv + 2), and transmissions read
+    // the circular buffer modulo Ncb.
+    const size_t rvStep = 2 * ((Ncb + (8 * numRows) - 1) / (8 * numRows));
+    for(size_t rv = 0; rv < NumLTERedundancyVersions; ++rv)
+    {
+        const size_t k0 = numRows * ((rvStep * rv) + 2);
+        circularBuffer.startIndices[rv] = nonNullCounts[k0 % Ncb];
+    }
+}
+
+size_t getLTEFullCircularBufferSize(size_t K)
+{
+    // Throws on an invalid block size.
+    (void)getLTETurboBlockSizeIndex(K);
+
+    return 3 * calcNumRows(K) * NumSubBlockColumns;
+}
+
+const LTECircularBuffer& getLTECircularBuffer(
+    size_t K,
+    size_t numFillerBits,
+    size_t Ncb)
+{
+    const size_t Kw = getLTEFullCircularBufferSize(K);
+    if(numFillerBits >= K)
+    {
+        throw Pothos::InvalidArgumentException("Invalid number of filler bits for K="+std::to_string(K)+": "+std::to_string(numFillerBits));
+    }
+    if((0 == Ncb) || (Ncb > Kw))
+    {
+        throw Pothos::InvalidArgumentException("Ncb must be between 1 and "+std::to_string(Kw)+" for K="+std::to_string(K));
+    }
+
+    // The uplink's tables are built once per block size, without locking.
+    if((0 == numFillerBits) && (Kw == Ncb)) return getLTECircularBuffer(K);
+
+    // Other combinations are few in practice, as the filler bits and Ncb
+    // are set per transport block, so they're kept until the process exits.
+    using Key = std::tuple<size_t, size_t, size_t>;
+    static std::mutex mutex;
+    static std::map<Key, std::unique_ptr<LTECircularBuffer>> circularBuffers;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& circularBufferUPtr = circularBuffers[Key(K, numFillerBits, Ncb)];
+    if(!circularBufferUPtr)
+    {
+        std::unique_ptr<LTECircularBuffer> newCircularBufferUPtr(new LTECircularBuffer());
+        buildLTECircularBuffer(*newCircularBufferUPtr, K, numFillerBits, Ncb);
+        circularBufferUPtr = std::move(newCircularBufferUPtr);
+    }
+
+    return *circularBufferUPtr;
+}
+
+const LTECircularBuffer& getLTECircularBuffer(size_t K)
+{
+    static std::once_flag onceFlags[NumLTETurboBlockSizes];
+    static LTECircularBuffer circularBuffers[NumLTETurboBlockSizes];
+
+    const size_t index = getLTETurboBlockSizeIndex(K);
+    std::call_once(
+        onceFlags[index],
+        buildLTECircularBuffer,
+        std::ref(circularBuffers[index]),
+        K,
+        size_t(0),
+        getLTEFullCircularBufferSize(K));
+
+    return circularBuffers[index];
+}
+
+void rateMatch(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::uint8_t* streams,
+    std::uint8_t* bitsOut,
+    size_t outputSize)
+{
+    const auto* streamIndices = circularBuffer.streamIndices.data();
+    const size_t circularBufferSize = circularBuffer.streamIndices.size();
+
+    // Split at the wraparound, so the inner loop is a plain gather.
+    size_t position = circularBuffer.startIndices[rv];
+    while(outputSize > 0)
+    {
+        const size_t length = std::min(outputSize, (circularBufferSize - position));
+        const auto* indices = streamIndices + position;
+        for(size_t elem = 0; elem < length; ++elem) bitsOut[elem] = streams[indices[elem]];
+
+        bitsOut += length;
+        outputSize -= length;
+        position = 0;
+    }
+}
+
+template <typename T>
+static void accumulateTransmissionT(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const T* softBits,
+    size_t inputSize,
+    T* softCircularBuffer)
+{
+    const size_t circularBufferSize = circularBuffer.streamIndices.size();
+
+    size_t position = circularBuffer.startIndices[rv];
+    while(inputSize > 0)
+    {
+        const size_t length = std::min(inputSize, (circularBufferSize - position));
+        accumulateSaturate(softCircularBuffer + position, softBits, length);
+
+        softBits += length;
+        inputSize -= length;
+        position = 0;
+    }
+}
+
+void accumulateTransmission(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::int8_t* softBits,
+    size_t inputSize,
+    std::int8_t* softCircularBuffer)
+{
+    accumulateTransmissionT(circularBuffer, rv, softBits, inputSize, softCircularBuffer);
+}
+
+void accumulateTransmission(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::int16_t* softBits,
+    size_t inputSize,
+    std::int16_t* softCircularBuffer)
+{
+    accumulateTransmissionT(circularBuffer, rv, softBits, inputSize, softCircularBuffer);
+}
+
+// With <NULL> bits pruned or Ncb < Kw, some stream bits aren't written.
+static void clearUnwrittenStreamBits(
+    const LTECircularBuffer& circularBuffer,
+    std::int8_t* streamsOut)
+{
+    const size_t streamsSize = 3 * circularBuffer.streamLength;
+    if(circularBuffer.streamIndices.size() < streamsSize) std::memset(streamsOut, 0, streamsSize);
+}
+
+void deinterleave(
+    const LTECircularBuffer& circularBuffer,
+    const std::int8_t* softCircularBuffer,
+    std::int8_t* streamsOut)
+{
+    const auto* streamIndices = circularBuffer.streamIndices.data();
+    const size_t circularBufferSize = circularBuffer.streamIndices.size();
+
+    clearUnwrittenStreamBits(circularBuffer, streamsOut);
+    for(size_t elem = 0; elem < circularBufferSize; ++elem)
+    {
+        streamsOut[streamIndices[elem]] = softCircularBuffer[elem];
+    }
+}
+
+void deinterleave(
+    const LTECircularBuffer& circularBuffer,
+    const std::int16_t* softCircularBuffer,
+    std::int8_t* streamsOut)
+{
+    const auto* streamIndices = circularBuffer.streamIndices.data();
+    const size_t circularBufferSize = circularBuffer.streamIndices.size();
+
+    clearUnwrittenStreamBits(circularBuffer, streamsOut);
+    for(size_t elem = 0; elem < circularBufferSize; ++elem)
+    {
+        streamsOut[streamIndices[elem]] = static_cast<std::int8_t>(std::min<int>(
+                                                                        std::max<int>(softCircularBuffer[elem], std::numeric_limits<std::int8_t>::min()),
+                                                                        std::numeric_limits<std::int8_t>::max()));
+    }
+}
+
+void deRateMatch(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::int8_t* softBits,
+    size_t inputSize,
+    std::int8_t* streamsOut,
+    std::int8_t* scratch)
+{
+    const auto* streamIndices = circularBuffer.streamIndices.data();
+    const size_t circularBufferSize = circularBuffer.streamIndices.size();
+
+    // Repeated soft bits have to be combined first.
+    if(inputSize > circularBufferSize)
+    {
+        std::memset(scratch, 0, circularBufferSize);
+        accumulateTransmission(circularBuffer, rv, softBits, inputSize, scratch);
+        deinterleave(circularBuffer, scratch, streamsOut);
+        return;
+    }
+
+    std::memset(streamsOut, 0, (3 * circularBuffer.streamLength));
+
+    size_t position = circularBuffer.startIndices[rv];
+    while(inputSize > 0)
+    {
+        const size_t length = std::min(inputSize, (circularBufferSize - position));
+        const auto* indices = streamIndices + position;
+        for(size_t elem = 0; elem < length; ++elem) streamsOut[indices[elem]] = softBits[elem];
+
+        softBits += length;
+        inputSize -= length;
+        position = 0;
+    }
+}
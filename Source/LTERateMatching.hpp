@@ -0,0 +1,111 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The LTE turbo code's circular buffer (3GPP TS 36.212, section 5.1.4.1).
+// Each of the encoder's three output streams, of D = K+4 bits, goes through
+// a sub-block interleaver that pads it with <NULL> bits, and the interleaved
+// streams are collected into a circular buffer of Kw bits that transmissions
+// read from, skipping the <NULL> bits. Here, the circular buffer is kept
+// without its <NULL> bits, so any transmission is a contiguous, wrapping run
+// of it.
+//
+// The <NULL> bits include the padding, and the systematic and first parity
+// bits of the F filler bits at the start of the first code block of a
+// transport block (section 5.1.3.2.1). Only the first Ncb bits of the
+// circular buffer are transmitted: all Kw for the uplink, and fewer for the
+// downlink when the UE's soft buffer can't hold the whole block.
+
+constexpr size_t NumLTERedundancyVersions = 4;
+
+struct LTECircularBuffer
+{
+    size_t K;
+    size_t numFillerBits;
+    size_t Ncb;
+
+    // D = K+4, the length of each encoder output stream
+    size_t streamLength;
+
+    // Circular buffer bit i is bit (streamIndices[i] % D) of encoder output
+    // stream (streamIndices[i] / D). Encoder output bits that are <NULL> or
+    // beyond Ncb aren't here.
+    std::vector<std::uint16_t> streamIndices;
+
+    // Where each redundancy version starts reading the circular buffer
+    size_t startIndices[NumLTERedundancyVersions];
+};
+
+// Kw, the size of the whole circular buffer, including <NULL> bits. Throws if
+// K isn't a valid LTE turbo block size.
+size_t getLTEFullCircularBufferSize(size_t K);
+
+// The tables for each combination of block size, number of filler bits and
+// Ncb are built on first use, then shared by every block in the process.
+// Throws if K isn't a valid LTE turbo block size, if there are K or more
+// filler bits, or if Ncb isn't between 1 and Kw.
+const LTECircularBuffer& getLTECircularBuffer(
+    size_t K,
+    size_t numFillerBits,
+    size_t Ncb);
+
+// The whole circular buffer without filler bits, as for the uplink
+const LTECircularBuffer& getLTECircularBuffer(size_t K);
+
+// Reads a transmission of outputSize bits from the circular buffer, starting
+// at the redundancy version's offset. The encoder's three output streams are
+// laid out one after another.
+void rateMatch(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::uint8_t* streams,
+    std::uint8_t* bitsOut,
+    size_t outputSize);
+
+// Adds a transmission's soft bits into the soft bits of a circular buffer,
+// with saturation, starting at the redundancy version's offset and wrapping
+// around as many times as needed.
+void accumulateTransmission(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::int8_t* softBits,
+    size_t inputSize,
+    std::int8_t* softCircularBuffer);
+
+void accumulateTransmission(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::int16_t* softBits,
+    size_t inputSize,
+    std::int16_t* softCircularBuffer);
+
+// Undoes the sub-block interleaving of a circular buffer's soft bits, into
+// three streams laid out one after another, saturated to 8 bits. Soft bits
+// that aren't in the circular buffer are 0.
+void deinterleave(
+    const LTECircularBuffer& circularBuffer,
+    const std::int8_t* softCircularBuffer,
+    std::int8_t* streamsOut);
+
+void deinterleave(
+    const LTECircularBuffer& circularBuffer,
+    const std::int16_t* softCircularBuffer,
+    std::int8_t* streamsOut);
+
+// Undoes rate matching for a single transmission, into three streams laid out
+// one after another. Soft bits that weren't transmitted, including <NULL>
+// bits, are 0. A transmission no longer than the circular buffer is written
+// in a single pass. Longer ones are first combined in the 3D-element scratch
+// space.
+void deRateMatch(
+    const LTECircularBuffer& circularBuffer,
+    size_t rv,
+    const std::int8_t* softBits,
+    size_t inputSize,
+    std::int8_t* streamsOut,
+    std::int8_t* scratch);
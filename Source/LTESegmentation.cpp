@@ -0,0 +1,78 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LTESegmentation.hpp"
+#include "LTETurboInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+
+extern "C"
+{
+#include <turbofec/turbo.h>
+}
+
+// Returns the index of the smallest block size >= minSize.
+static size_t findBlockSizeIndex(size_t minSize)
+{
+    size_t low = 0;
+    size_t high = NumLTETurboBlockSizes - 1;
+    while(low < high)
+    {
+        const size_t mid = (low + high) / 2;
+        if(getLTETurboBlockSize(mid) < minSize) low = mid + 1;
+        else                                    high = mid;
+    }
+
+    return low;
+}
+
+LTESegmentation getLTESegmentation(size_t transportBlockSize)
+{
+    if(0 == transportBlockSize)
+    {
+        throw Pothos::InvalidArgumentException("The transport block must not be empty");
+    }
+
+    LTESegmentation segmentation{};
+    segmentation.transportBlockSize = transportBlockSize;
+
+    const size_t B = transportBlockSize + LTECRCSize;
+
+    // B', the number of bits once each code block has its CRC
+    size_t segmentedBits = B;
+    if(B <= TURBO_MAX_K)
+    {
+        segmentation.numCodeBlocks = 1;
+        segmentation.codeBlockCRCSize = 0;
+    }
+    else
+    {
+        segmentation.codeBlockCRCSize = LTECRCSize;
+        segmentation.numCodeBlocks = (B + (TURBO_MAX_K - LTECRCSize) - 1) / (TURBO_MAX_K - LTECRCSize);
+        segmentedBits += segmentation.numCodeBlocks * LTECRCSize;
+    }
+
+    const size_t C = segmentation.numCodeBlocks;
+
+    // K+ is the smallest block size where C blocks fit every bit, and K-
+    // is the next size down.
+    const size_t largeIndex = findBlockSizeIndex((segmentedBits + C - 1) / C);
+    segmentation.largeCodeBlockSize = getLTETurboBlockSize(largeIndex);
+
+    if((1 == C) || (0 == largeIndex))
+    {
+        segmentation.numSmallCodeBlocks = 0;
+        segmentation.smallCodeBlockSize = 0;
+    }
+    else
+    {
+        segmentation.smallCodeBlockSize = getLTETurboBlockSize(largeIndex - 1);
+
+        const size_t deltaK = segmentation.largeCodeBlockSize - segmentation.smallCodeBlockSize;
+        segmentation.numSmallCodeBlocks = ((C * segmentation.largeCodeBlockSize) - segmentedBits) / deltaK;
+    }
+
+    segmentation.numFillerBits = segmentation.segmentedSize() - segmentedBits;
+
+    return segmentation;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+
+// The number of bits in each CRC attached to transport blocks and code blocks
+constexpr size_t LTECRCSize = 24;
+
+// How a transport block is split into code blocks for the LTE turbo coder
+// (3GPP TS 36.212, section 5.1.2). The transport block gets a CRC24A, and if
+// it's then too large for one code block, each code block gets a CRC24B.
+// Code blocks are sized up to valid turbo block sizes with filler bits at
+// the start of the first code block.
+struct LTESegmentation
+{
+    // A, the number of bits in the transport block without its CRC
+    size_t transportBlockSize;
+
+    // C
+    size_t numCodeBlocks;
+
+    // The first numSmallCodeBlocks (C-) code blocks are K- bits, and the rest
+    // are K+ bits.
+    size_t numSmallCodeBlocks;
+    size_t smallCodeBlockSize;
+    size_t largeCodeBlockSize;
+
+    // F
+    size_t numFillerBits;
+
+    // L, 0 if there's only one code block
+    size_t codeBlockCRCSize;
+
+    size_t codeBlockSize(size_t codeBlock) const
+    {
+        return (codeBlock < numSmallCodeBlocks) ? smallCodeBlockSize : largeCodeBlockSize;
+    }
+
+    // The sum of the code block sizes
+    size_t segmentedSize() const
+    {
+        return (numSmallCodeBlocks * smallCodeBlockSize) +
+               ((numCodeBlocks - numSmallCodeBlocks) * largeCodeBlockSize);
+    }
+};
+
+// Throws if the transport block is empty.
+LTESegmentation getLTESegmentation(size_t transportBlockSize);
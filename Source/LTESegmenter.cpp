@@ -0,0 +1,459 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CRC.hpp"
+#include "LTESegmentation.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Writes the CRC as bits, MSB first.
+static void unpackCRC24(std::uint32_t crc, std::uint8_t* bitsOut)
+{
+    for(size_t bit = 0; bit < LTECRCSize; ++bit)
+    {
+        bitsOut[bit] = (crc >> (LTECRCSize - 1 - bit)) & 1;
+    }
+}
+
+// Waits for a whole transport block, starting with a label with the given ID
+// containing its length. Returns false if there's no whole transport block
+// at the start of the input yet.
+static bool findTransportBlock(
+    Pothos::InputPort* input,
+    const std::string& transportBlockID,
+    size_t* inputSizeOut)
+{
+    const auto elems = input->elements();
+
+    for(const auto& label: input->labels())
+    {
+        if((label.index > elems) || (label.id != transportBlockID)) continue;
+
+        if(!label.data.canConvert(typeid(size_t)))
+        {
+            throw Pothos::InvalidArgumentException("Transport block labels must contain the transport block's length");
+        }
+        *inputSizeOut = label.data.convert<size_t>();
+
+        // Skip all data before the transport block starts.
+        if(0 != label.index)
+        {
+            input->consume(label.index);
+            input->setReserve(*inputSizeOut);
+            return false;
+        }
+
+        // Wait until the whole transport block is here.
+        if(elems < *inputSizeOut)
+        {
+            input->setReserve(*inputSizeOut);
+            return false;
+        }
+
+        return true;
+    }
+
+    input->consume(elems);
+    return false;
+}
+
+//
+// Segmenter
+//
+
+class LTETransportBlockSegmenter: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make()
+        {
+            return new LTETransportBlockSegmenter();
+        }
+
+        LTETransportBlockSegmenter():
+            Pothos::Block(),
+            _transportBlockID("TB"),
+            _blockStartID("START")
+        {
+            this->setupInput(0, "uint8");
+            this->setupOutput(0, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockSegmenter, transportBlockID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockSegmenter, setTransportBlockID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockSegmenter, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockSegmenter, setBlockStartID));
+        }
+
+        std::string transportBlockID() const
+        {
+            return _transportBlockID;
+        }
+
+        void setTransportBlockID(const std::string& transportBlockID)
+        {
+            if(transportBlockID.empty())
+            {
+                throw Pothos::InvalidArgumentException("The transport block ID must not be empty");
+            }
+
+            _transportBlockID = transportBlockID;
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            if(blockStartID.empty())
+            {
+                throw Pothos::InvalidArgumentException("The block start ID must not be empty");
+            }
+
+            _blockStartID = blockStartID;
+        }
+
+        // Output labels are posted with each transport block.
+        void propagateLabels(const Pothos::InputPort*) override
+        {
+        }
+
+        void work() override
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            if(0 == input->elements()) return;
+
+            size_t inputSize = 0;
+            if(!findTransportBlock(input, _transportBlockID, &inputSize)) return;
+
+            const auto segmentation = getLTESegmentation(inputSize);
+            const auto outputSize = segmentation.segmentedSize();
+
+            const bool mustPostBuffer = (outputSize > output->elements());
+            Pothos::BufferChunk outputBuffer = mustPostBuffer ? Pothos::BufferChunk("uint8", outputSize)
+                                                              : output->buffer();
+
+            const auto* transportBlock = input->buffer().as<const std::uint8_t*>();
+            auto* codeBlocks = outputBuffer.as<std::uint8_t*>();
+
+            // The transport block's CRC follows its last bit.
+            std::uint8_t transportBlockCRC[LTECRCSize];
+            unpackCRC24(calcCRC24(CRCType::CRC24A, transportBlock, inputSize, true), transportBlockCRC);
+
+            std::vector<Pothos::Label> otherLabels;
+            for(const auto& label: input->labels())
+            {
+                if((0 == label.index) && (label.id != _transportBlockID)) otherLabels.push_back(label);
+            }
+
+            // Label everything before posting the output, so the labels'
+            // indices are relative to the start of the transport block.
+            output->postLabel(_transportBlockID, outputSize, 0);
+            output->postLabel("transportBlockSize", inputSize, 0);
+            for(const auto& label: otherLabels) output->postLabel(label.id, label.data, 0);
+
+            // Each code block is written in one pass: filler bits, then the
+            // next run of the transport block and its CRC, then the code
+            // block's CRC.
+            size_t inputIndex = 0;
+            size_t outputIndex = 0;
+            for(size_t codeBlockIndex = 0; codeBlockIndex < segmentation.numCodeBlocks; ++codeBlockIndex)
+            {
+                const size_t codeBlockSize = segmentation.codeBlockSize(codeBlockIndex);
+                auto* codeBlock = codeBlocks + outputIndex;
+
+                size_t codeBlockBit = 0;
+                if(0 == codeBlockIndex)
+                {
+                    std::memset(codeBlock, 0, segmentation.numFillerBits);
+                    codeBlockBit = segmentation.numFillerBits;
+                }
+
+                const size_t dataEnd = codeBlockSize - segmentation.codeBlockCRCSize;
+
+                const size_t numTransportBlockBits = std::min((dataEnd - codeBlockBit), (inputSize - std::min(inputIndex, inputSize)));
+                std::memcpy(codeBlock + codeBlockBit, transportBlock + inputIndex, numTransportBlockBits);
+                codeBlockBit += numTransportBlockBits;
+                inputIndex += numTransportBlockBits;
+
+                const size_t numCRCBits = dataEnd - codeBlockBit;
+                if(numCRCBits > 0)
+                {
+                    std::memcpy(codeBlock + codeBlockBit, transportBlockCRC + (inputIndex - inputSize), numCRCBits);
+                    inputIndex += numCRCBits;
+                }
+
+                if(0 != segmentation.codeBlockCRCSize)
+                {
+                    unpackCRC24(calcCRC24(CRCType::CRC24B, codeBlock, dataEnd, true), codeBlock + dataEnd);
+                }
+
+                // The rate matcher prunes the filler bits.
+                output->postLabel(_blockStartID, codeBlockSize, outputIndex);
+                output->postLabel("numFillerBits", ((0 == codeBlockIndex) ? segmentation.numFillerBits : 0), outputIndex);
+                outputIndex += codeBlockSize;
+            }
+
+            input->consume(inputSize);
+            if(mustPostBuffer) output->postBuffer(std::move(outputBuffer));
+            else               output->produce(outputSize);
+        }
+
+    private:
+        std::string _transportBlockID;
+        std::string _blockStartID;
+};
+
+//
+// Reassembler
+//
+
+class LTETransportBlockReassembler: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make()
+        {
+            return new LTETransportBlockReassembler();
+        }
+
+        LTETransportBlockReassembler():
+            Pothos::Block(),
+            _transportBlockID("TB"),
+            _transportBlockSize(0),
+            _numCodeBlockCRCFailures(0),
+            _numTransportBlockCRCFailures(0)
+        {
+            this->setupInput(0, "uint8");
+            this->setupOutput(0, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockReassembler, transportBlockID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockReassembler, setTransportBlockID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockReassembler, transportBlockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockReassembler, setTransportBlockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockReassembler, numCodeBlockCRCFailures));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETransportBlockReassembler, numTransportBlockCRCFailures));
+
+            this->registerProbe("numCodeBlockCRCFailures");
+            this->registerProbe("numTransportBlockCRCFailures");
+        }
+
+        std::string transportBlockID() const
+        {
+            return _transportBlockID;
+        }
+
+        void setTransportBlockID(const std::string& transportBlockID)
+        {
+            if(transportBlockID.empty())
+            {
+                throw Pothos::InvalidArgumentException("The transport block ID must not be empty");
+            }
+
+            _transportBlockID = transportBlockID;
+        }
+
+        size_t transportBlockSize() const
+        {
+            return _transportBlockSize;
+        }
+
+        void setTransportBlockSize(size_t transportBlockSize)
+        {
+            _transportBlockSize = transportBlockSize;
+        }
+
+        unsigned long long numCodeBlockCRCFailures() const
+        {
+            return _numCodeBlockCRCFailures;
+        }
+
+        unsigned long long numTransportBlockCRCFailures() const
+        {
+            return _numTransportBlockCRCFailures;
+        }
+
+        // Output labels are posted with each transport block.
+        void propagateLabels(const Pothos::InputPort*) override
+        {
+        }
+
+        void work() override
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            if(0 == input->elements()) return;
+
+            size_t inputSize = 0;
+            if(!findTransportBlock(input, _transportBlockID, &inputSize)) return;
+
+            size_t transportBlockSize = _transportBlockSize;
+            std::vector<Pothos::Label> otherLabels;
+            for(const auto& label: input->labels())
+            {
+                if(0 != label.index) continue;
+
+                if("transportBlockSize" == label.id) transportBlockSize = label.data.convert<size_t>();
+                else if(("numFillerBits" != label.id) && (label.id != _transportBlockID))
+                {
+                    otherLabels.push_back(label);
+                }
+            }
+
+            const auto segmentation = getLTESegmentation(transportBlockSize);
+            if(segmentation.segmentedSize() != inputSize)
+            {
+                throw Pothos::InvalidArgumentException(
+                          "Transport block of " + std::to_string(inputSize) +
+                          " bits doesn't match transport block size " + std::to_string(transportBlockSize));
+            }
+
+            // The transport block is output as views of each code block's
+            // data in the input buffer, so nothing is copied.
+            const auto inputBuffer = input->buffer();
+            const auto* codeBlocks = inputBuffer.as<const std::uint8_t*>();
+
+            std::vector<Pothos::BufferChunk> views;
+            views.reserve(segmentation.numCodeBlocks);
+
+            bool codeBlockCRCsPassed = true;
+            std::uint32_t transportBlockCRC = 0;
+            size_t remaining = transportBlockSize + LTECRCSize;
+            size_t inputIndex = 0;
+
+            for(size_t codeBlockIndex = 0; codeBlockIndex < segmentation.numCodeBlocks; ++codeBlockIndex)
+            {
+                const size_t codeBlockSize = segmentation.codeBlockSize(codeBlockIndex);
+                const auto* codeBlock = codeBlocks + inputIndex;
+
+                if((0 != segmentation.codeBlockCRCSize) && !checkCRC24(CRCType::CRC24B, codeBlock, codeBlockSize, true))
+                {
+                    ++_numCodeBlockCRCFailures;
+                    codeBlockCRCsPassed = false;
+                }
+
+                const size_t dataStart = (0 == codeBlockIndex) ? segmentation.numFillerBits : 0;
+                const size_t numDataBits = codeBlockSize - segmentation.codeBlockCRCSize - dataStart;
+                transportBlockCRC = updateCRC24(CRCType::CRC24A, transportBlockCRC, codeBlock + dataStart, numDataBits, true);
+
+                // The transport block's CRC isn't output.
+                remaining -= numDataBits;
+                const size_t numCRCBits = std::min(numDataBits, (LTECRCSize - std::min(remaining, LTECRCSize)));
+                const size_t numViewBits = numDataBits - numCRCBits;
+                if(numViewBits > 0)
+                {
+                    views.emplace_back(inputBuffer);
+                    views.back().address += (inputIndex + dataStart);
+                    views.back().setElements(numViewBits);
+                }
+
+                inputIndex += codeBlockSize;
+            }
+
+            const bool crcPassed = codeBlockCRCsPassed && (0 == transportBlockCRC);
+            if(!crcPassed) ++_numTransportBlockCRCFailures;
+
+            // Label everything before posting the output, so the labels'
+            // indices are relative to the start of the transport block.
+            output->postLabel(_transportBlockID, transportBlockSize, 0);
+            output->postLabel("crcPassed", crcPassed, 0);
+            for(const auto& label: otherLabels) output->postLabel(label.id, label.data, 0);
+
+            input->consume(inputSize);
+            for(auto& view: views) output->postBuffer(std::move(view));
+        }
+
+    private:
+        std::string _transportBlockID;
+        size_t _transportBlockSize;
+
+        unsigned long long _numCodeBlockCRCFailures;
+        unsigned long long _numTransportBlockCRCFailures;
+};
+
+/*
+ * |PothosDoc LTE Transport Block Segmenter
+ *
+ * Prepares transport blocks of any size for the LTE turbo encoder (3GPP TS
+ * 36.212, sections 5.1.1 and 5.1.2). Each transport block gets a CRC24A, and
+ * is then split into code blocks of valid turbo block sizes, with filler bits
+ * at the start of the first code block. If there's more than one code block,
+ * each gets a CRC24B.
+ *
+ * Each input transport block, one bit per byte, must start with a transport
+ * block label containing its length. The segmented transport block is output
+ * with a transport block label containing its new length, a
+ * "transportBlockSize" label with the original length. Each code block has a
+ * block start label containing its length, for the LTE turbo encoder, and a
+ * "numFillerBits" label with its number of filler bits, so the LTE rate
+ * matcher can prune them.
+ *
+ * |category /FEC/Encoders
+ * |keywords lte transport block code block segmentation crc filler
+ * |factory /fec/lte_transport_block_segmenter()
+ * |setter setTransportBlockID(transportBlockID)
+ * |setter setBlockStartID(blockStartID)
+ *
+ * |param transportBlockID[Transport Block ID]
+ * The label marking the start of each input and output transport block.
+ * |widget LineEdit()
+ * |default "TB"
+ * |preview valid
+ *
+ * |param blockStartID[Block Start ID]
+ * The label marking the start of each output code block.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerLTETransportBlockSegmenter(
+    "/fec/lte_transport_block_segmenter",
+    Pothos::Callable(&LTETransportBlockSegmenter::make));
+
+/*
+ * |PothosDoc LTE Transport Block Reassembler
+ *
+ * Reassembles transport blocks from the LTE turbo decoder's decoded code
+ * blocks, undoing the LTE transport block segmenter. Each code block's
+ * CRC24B and the transport block's CRC24A are checked, and the filler bits
+ * and CRCs are removed. Without copying, the transport block is output as
+ * views of each code block's data in the input buffer.
+ *
+ * Each input transport block, one bit per byte, must start with a transport
+ * block label containing its length, as output by the LTE turbo decoder when
+ * decoding transport blocks. A "transportBlockSize" label at the same index
+ * gives the original transport block size, overriding this block's setting.
+ * Each output transport block has a transport block label with its length,
+ * and a "crcPassed" label with whether all of its CRCs passed.
+ *
+ * |category /FEC/Decoders
+ * |keywords lte transport block code block segmentation crc filler
+ * |factory /fec/lte_transport_block_reassembler()
+ * |setter setTransportBlockID(transportBlockID)
+ * |setter setTransportBlockSize(transportBlockSize)
+ *
+ * |param transportBlockID[Transport Block ID]
+ * The label marking the start of each input and output transport block.
+ * |widget LineEdit()
+ * |default "TB"
+ * |preview valid
+ *
+ * |param transportBlockSize[Transport Block Size]
+ * The size of each transport block, A, without its CRC, when not given by a
+ * "transportBlockSize" label.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerLTETransportBlockReassembler(
+    "/fec/lte_transport_block_reassembler",
+    Pothos::Callable(&LTETransportBlockReassembler::make));
@@ -0,0 +1,69 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+extern "C"
+{
+#include <turbofec/turbo.h>
+}
+
+#include "LTETurboInterleaver.hpp"
+#include "UMTSTurboInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using DecodeFcn = int(*)(struct tdecoder*, int, int, uint8_t*, const int8_t*, const int8_t*, const int8_t*);
+
+using tDecoderUPtr = std::unique_ptr<tdecoder, decltype(&::free_tdec)>;
+static inline tDecoderUPtr makeDecoderUPtr()
+{
+    return tDecoderUPtr(::alloc_tdec(), &free_tdec);
+}
+
+// Each decoder input holds the block plus four tail bits.
+constexpr size_t calcDecoderOutputSize(size_t inputSize)
+{
+    return (inputSize / 3) - 4;
+}
+
+// The inverse of calcDecoderOutputSize()
+constexpr size_t calcDecoderInputSize(size_t outputSize)
+{
+    return (outputSize + 4) * 3;
+}
+
+// The turbo coders' fixed block size is either 0, for none, or a valid LTE
+// turbo block size. Throws on an invalid size.
+static inline void checkFixedBlockSize(size_t blockSize)
+{
+    size_t f1, f2;
+    if((0 != blockSize) && !getQPPParams(blockSize, &f1, &f2))
+    {
+        throw Pothos::InvalidArgumentException("Invalid LTE turbo block size: "+std::to_string(blockSize));
+    }
+}
+
+// The same for the UMTS turbo coders, whose valid block sizes are 40 to 5114
+static inline void checkUMTSFixedBlockSize(size_t blockSize)
+{
+    if((0 != blockSize) && !isUMTSTurboBlockSize(blockSize))
+    {
+        throw Pothos::InvalidArgumentException("Invalid UMTS turbo block size: "+std::to_string(blockSize));
+    }
+}
+
+// The turbo coders either carry their three streams on separate ports, or
+// interleaved on one port. Throws on an invalid format.
+static inline bool isInterleavedStreamFormat(const std::string& streamFormat)
+{
+    if("Interleaved" == streamFormat)   return true;
+    else if("Separate" == streamFormat) return false;
+
+    throw Pothos::InvalidArgumentException("Invalid stream format: "+streamFormat);
+}
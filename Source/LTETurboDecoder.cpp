@@ -1,33 +1,86 @@
 // Copyright (c) 2020 Nicholas Corgan
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "AdaptiveIterationBudget.hpp"
+#include "BufferChunkPool.hpp"
+#include "CRC.hpp"
+#include "DecodeScheduler.hpp"
+#include "FrameDeadlineTracker.hpp"
+#include "LabelFramer.hpp"
+#include "LTETurbo.hpp"
+#include "LTETurboSISO.hpp"
 #include "Utility.hpp"
+#include "WorkerPool.hpp"
 
 #include <Pothos/Exception.hpp>
 #include <Pothos/Framework.hpp>
 #include <Pothos/Plugin.hpp>
 
-extern "C"
-{
-#include <turbofec/turbo.h>
-}
-
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
-using DecodeFcn = int(*)(struct tdecoder*, int, int, uint8_t*, const int8_t*, const int8_t*, const int8_t*);
-
-using tDecoderUPtr = std::unique_ptr<tdecoder, decltype(&::free_tdec)>;
-static inline tDecoderUPtr makeDecoderUPtr()
+// Everything needed to decode one block, so each thread decoding a
+// transport block's code blocks can have its own.
+struct LTETurboDecodeContext
 {
-    return tDecoderUPtr(::alloc_tdec(), &free_tdec);
-}
+    LTETurboDecodeContext():
+        turboFECDecoderUPtr(makeDecoderUPtr())
+    {
+        // Reserve up front, so decoding never allocates.
+        decodedBits.reserve(TURBO_MAX_K);
+        prevOutput.reserve(TURBO_MAX_K);
+        convergenceOutput.reserve(TURBO_MAX_K);
+        streams.reserve(3 * (TURBO_MAX_K + 4));
+        scaledInputs.reserve(3 * (TURBO_MAX_K + 4));
+    }
+
+    tDecoderUPtr turboFECDecoderUPtr;
+
+    // If null, TurboFEC is used.
+    std::unique_ptr<LTETurboSISODecoder> sisoDecoderUPtr;
+    std::vector<std::uint8_t> decodedBits;
+
+    // The previous attempt's output, for the hard decision criterion
+    std::vector<std::uint8_t> prevOutput;
+
+    // The previous iteration's output, for the adaptive iteration cap
+    std::vector<std::uint8_t> convergenceOutput;
+
+    // Interleaved inputs, split apart for TurboFEC
+    std::vector<std::int8_t> streams;
 
-constexpr size_t calcOutputSize(size_t inputSize)
+    // Inputs once scaled and saturated to 8 bits
+    std::vector<std::int8_t> scaledInputs;
+};
+
+// The in-tree engines' log-MAP correction assumes soft inputs have 4 units
+// per nat, so auto-scaled inputs use the same.
+static constexpr double SoftInputUnitsPerNat = 4.0;
+
+// Transport blocks too large for the output buffers are posted from pools
+// this deep per output, enough for a few still held downstream.
+static constexpr size_t TransportBlockPoolSize = 4;
+
+// A code block within a transport block
+struct LTETurboCodeBlock
 {
-    return (inputSize / 3) - 4;
-}
+    size_t inputOffset;
+    size_t inputSize;
+    size_t outputOffset;
+    size_t outputSize;
+    size_t softOutputOffset;
+    size_t numIterations;
+
+    // For the adaptive iteration cap
+    double snr;
+    size_t iterationCap;
+    size_t convergedIteration;
+};
 
 class LTETurboDecoder: public Pothos::Block
 {
@@ -42,7 +95,26 @@ class LTETurboDecoder: public Pothos::Block
             _numIterations(numIterations),
             _unpack(unpack),
             _decodeFcn(_unpack ? ::lte_turbo_decode_unpack : ::lte_turbo_decode),
-            _tDecoderUPtr(makeDecoderUPtr())
+            _softOutputType("None"),
+            _interleaved(false),
+            _inputType("uint8"),
+            _inputElemSize(1),
+            _decodeContexts(1),
+            _blockSize(0),
+            _transportBlockPool(TransportBlockPoolSize),
+            _softTransportBlockPool(TransportBlockPoolSize),
+            _deadlinePolicy("Drop"),
+            _priority(DecodePriority::Normal),
+            _engine("TurboFEC"),
+            _numWindows(1),
+            _numThreads(1),
+            _crcType(CRCType::None),
+            _stoppingCriterion("CRC"),
+            _minLLRThreshold(64.0),
+            _adaptiveIterations(false),
+            _inputScaling("None"),
+            _inputScale(1.0),
+            _inputSaturation(std::numeric_limits<std::int8_t>::max())
         {
             // Despite the function taking in int8_t*, it's immmediately casted to uint8_t*
             // internally, so for consistency with the encoder, we'll take in uint8_t* buffers.
@@ -56,8 +128,74 @@ class LTETurboDecoder: public Pothos::Block
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setNumIterations));
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, blockStartID));
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, blockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setBlockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, transportBlockID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setTransportBlockID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, numCodeBlockThreads));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setNumCodeBlockThreads));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, deadlineBudget));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setDeadlineBudget));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, timestampID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setTimestampID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, deadlinePolicy));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setDeadlinePolicy));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, numDroppedFrames));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, numDegradedFrames));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, priority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setPriority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, engine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setEngine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, numWindows));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setNumWindows));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, numThreads));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setNumThreads));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, crcType));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setCRCType));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, stoppingCriterion));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setStoppingCriterion));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, minLLRThreshold));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setMinLLRThreshold));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, iterationHistogram));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, resetIterationHistogram));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, adaptiveIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setAdaptiveIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, targetBLER));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setTargetBLER));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, iterationCapHistogram));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, resetIterationCapHistogram));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, inputScaling));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setInputScaling));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, inputScale));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setInputScale));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, inputSaturation));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setInputSaturation));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, softOutputType));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setSoftOutputType));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, streamFormat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setStreamFormat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, inputType));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoder, setInputType));
 
             this->registerProbe("numIterations");
+            this->registerProbe("blockSize");
+            this->registerProbe("deadlineBudget");
+            this->registerProbe("numCodeBlockThreads");
+            this->registerProbe("numDroppedFrames");
+            this->registerProbe("numDegradedFrames");
+            this->registerProbe("priority");
+            this->registerProbe("engine");
+            this->registerProbe("numWindows");
+            this->registerProbe("numThreads");
+            this->registerProbe("crcType");
+            this->registerProbe("stoppingCriterion");
+            this->registerProbe("iterationHistogram");
+            this->registerProbe("iterationCapHistogram");
+            this->registerProbe("inputScaling");
+            this->registerProbe("inputScale");
+            this->registerProbe("softOutputType");
+            this->registerProbe("streamFormat");
+            this->registerProbe("inputType");
             this->registerSignal("numIterationsChanged");
         }
 
@@ -83,14 +221,363 @@ class LTETurboDecoder: public Pothos::Block
             _blockStartID = blockStartID;
         }
 
+        size_t blockSize() const
+        {
+            return _blockSize;
+        }
+
+        void setBlockSize(size_t blockSize)
+        {
+            checkFixedBlockSize(blockSize);
+            _blockSize = blockSize;
+        }
+
+        std::string transportBlockID() const
+        {
+            return _transportBlockID;
+        }
+
+        void setTransportBlockID(const std::string& transportBlockID)
+        {
+            _transportBlockID = transportBlockID;
+        }
+
+        size_t numCodeBlockThreads() const
+        {
+            return _decodeContexts.size();
+        }
+
+        void setNumCodeBlockThreads(size_t numCodeBlockThreads)
+        {
+            if(0 == numCodeBlockThreads)
+            {
+                throw Pothos::InvalidArgumentException("Num code block threads must be positive");
+            }
+
+            std::vector<LTETurboDecodeContext> decodeContexts(numCodeBlockThreads);
+            for(auto& decodeContext: decodeContexts)
+            {
+                decodeContext.sisoDecoderUPtr = _makeSISODecoder(_engine);
+            }
+
+            _workerPoolUPtr.reset((numCodeBlockThreads > 1) ? new WorkerPool(numCodeBlockThreads) : nullptr);
+            _decodeContexts = std::move(decodeContexts);
+        }
+
+        double deadlineBudget() const
+        {
+            return _deadlineTracker.budget();
+        }
+
+        void setDeadlineBudget(double deadlineBudget)
+        {
+            _deadlineTracker.setBudget(deadlineBudget);
+        }
+
+        std::string timestampID() const
+        {
+            return _deadlineTracker.timestampID();
+        }
+
+        void setTimestampID(const std::string& timestampID)
+        {
+            _deadlineTracker.setTimestampID(timestampID);
+        }
+
+        std::string deadlinePolicy() const
+        {
+            return _deadlinePolicy;
+        }
+
+        void setDeadlinePolicy(const std::string& deadlinePolicy)
+        {
+            if(("Drop" != deadlinePolicy) && ("Degrade" != deadlinePolicy))
+            {
+                throw Pothos::InvalidArgumentException("Invalid deadline policy: "+deadlinePolicy);
+            }
+
+            _deadlinePolicy = deadlinePolicy;
+        }
+
+        unsigned long long numDroppedFrames() const
+        {
+            return _deadlineTracker.numDroppedFrames();
+        }
+
+        unsigned long long numDegradedFrames() const
+        {
+            return _deadlineTracker.numDegradedFrames();
+        }
+
+        std::string priority() const
+        {
+            return decodePriorityToString(_priority);
+        }
+
+        void setPriority(const std::string& priority)
+        {
+            _priority = decodePriorityFromString(priority);
+        }
+
+        std::string engine() const
+        {
+            return _engine;
+        }
+
+        void setEngine(const std::string& engine)
+        {
+            if(("TurboFEC" == engine) && _hasSoftOutput())
+            {
+                throw Pothos::InvalidArgumentException("The TurboFEC engine can't be used with soft output");
+            }
+
+            for(auto& decodeContext: _decodeContexts)
+            {
+                decodeContext.sisoDecoderUPtr = _makeSISODecoder(engine);
+            }
+
+            _engine = engine;
+        }
+
+        size_t numWindows() const
+        {
+            return _numWindows;
+        }
+
+        void setNumWindows(size_t numWindows)
+        {
+            if(0 == numWindows)
+            {
+                throw Pothos::InvalidArgumentException("Num windows must be positive");
+            }
+
+            for(auto& decodeContext: _decodeContexts)
+            {
+                if(decodeContext.sisoDecoderUPtr) decodeContext.sisoDecoderUPtr->setNumWindows(numWindows);
+            }
+            _numWindows = numWindows;
+        }
+
+        size_t numThreads() const
+        {
+            return _numThreads;
+        }
+
+        void setNumThreads(size_t numThreads)
+        {
+            if(0 == numThreads)
+            {
+                throw Pothos::InvalidArgumentException("Num threads must be positive");
+            }
+
+            for(auto& decodeContext: _decodeContexts)
+            {
+                if(decodeContext.sisoDecoderUPtr) decodeContext.sisoDecoderUPtr->setNumThreads(numThreads);
+            }
+            _numThreads = numThreads;
+        }
+
+        std::string crcType() const
+        {
+            return crcTypeToString(_crcType);
+        }
+
+        void setCRCType(const std::string& crcType)
+        {
+            _crcType = crcTypeFromString(crcType);
+        }
+
+        std::string stoppingCriterion() const
+        {
+            return _stoppingCriterion;
+        }
+
+        void setStoppingCriterion(const std::string& stoppingCriterion)
+        {
+            if(("CRC" != stoppingCriterion) &&
+               ("Hard Decision" != stoppingCriterion) &&
+               ("Min LLR" != stoppingCriterion))
+            {
+                throw Pothos::InvalidArgumentException("Invalid stopping criterion: "+stoppingCriterion);
+            }
+
+            _stoppingCriterion = stoppingCriterion;
+        }
+
+        double minLLRThreshold() const
+        {
+            return _minLLRThreshold;
+        }
+
+        void setMinLLRThreshold(double minLLRThreshold)
+        {
+            if(minLLRThreshold < 0.0)
+            {
+                throw Pothos::InvalidArgumentException("Min LLR threshold must be >= 0");
+            }
+
+            _minLLRThreshold = minLLRThreshold;
+        }
+
+        // Index N holds the number of blocks whose final decode took N iterations.
+        std::vector<unsigned long long> iterationHistogram() const
+        {
+            return _iterationHistogram;
+        }
+
+        void resetIterationHistogram()
+        {
+            _iterationHistogram.clear();
+        }
+
+        bool adaptiveIterations() const
+        {
+            return _adaptiveIterations;
+        }
+
+        void setAdaptiveIterations(bool adaptiveIterations)
+        {
+            // Start learning from scratch.
+            if(adaptiveIterations && !_adaptiveIterations) _iterationBudget.reset();
+
+            _adaptiveIterations = adaptiveIterations;
+        }
+
+        double targetBLER() const
+        {
+            return _iterationBudget.targetBLER();
+        }
+
+        void setTargetBLER(double targetBLER)
+        {
+            _iterationBudget.setTargetBLER(targetBLER);
+        }
+
+        // Index N holds the number of blocks whose adaptive iteration cap was N.
+        std::vector<unsigned long long> iterationCapHistogram() const
+        {
+            return _iterationCapHistogram;
+        }
+
+        void resetIterationCapHistogram()
+        {
+            _iterationCapHistogram.clear();
+        }
+
+        std::string inputScaling() const
+        {
+            return _inputScaling;
+        }
+
+        void setInputScaling(const std::string& inputScaling)
+        {
+            if(("None" != inputScaling) && ("Fixed" != inputScaling) && ("Auto" != inputScaling))
+            {
+                throw Pothos::InvalidArgumentException("Invalid input scaling: "+inputScaling);
+            }
+
+            _inputScaling = inputScaling;
+        }
+
+        double inputScale() const
+        {
+            return _inputScale;
+        }
+
+        void setInputScale(double inputScale)
+        {
+            if(!(inputScale > 0.0) || !std::isfinite(inputScale))
+            {
+                throw Pothos::InvalidArgumentException("Input scale must be positive");
+            }
+
+            _inputScale = inputScale;
+        }
+
+        int inputSaturation() const
+        {
+            return _inputSaturation;
+        }
+
+        void setInputSaturation(int inputSaturation)
+        {
+            if((inputSaturation < 1) || (inputSaturation > std::numeric_limits<std::int8_t>::max()))
+            {
+                throw Pothos::InvalidArgumentException("Input saturation must be in [1, 127]");
+            }
+
+            _inputSaturation = inputSaturation;
+        }
+
+        std::string softOutputType() const
+        {
+            return _softOutputType;
+        }
+
+        // Once set up, the soft output port stays, so "None" leaves it unused.
+        void setSoftOutputType(const std::string& softOutputType)
+        {
+            if(("None" != softOutputType) && ("int8" != softOutputType) && ("int16" != softOutputType))
+            {
+                throw Pothos::InvalidArgumentException("Invalid soft output type: "+softOutputType);
+            }
+            if(("None" != softOutputType) && ("TurboFEC" == _engine))
+            {
+                throw Pothos::InvalidArgumentException("Soft output needs an in-tree engine, as TurboFEC only outputs decoded bits");
+            }
+            _throwIfActive("soft output type");
+
+            if("None" != softOutputType) this->setupOutput(1, softOutputType);
+            _softOutputType = softOutputType;
+        }
+
+        std::string streamFormat() const
+        {
+            return _interleaved ? "Interleaved" : "Separate";
+        }
+
+        void setStreamFormat(const std::string& streamFormat)
+        {
+            const bool interleaved = isInterleavedStreamFormat(streamFormat);
+            _throwIfActive("stream format");
+
+            _interleaved = interleaved;
+        }
+
+        std::string inputType() const
+        {
+            return _inputType;
+        }
+
+        void setInputType(const std::string& inputType)
+        {
+            if(("uint8" != inputType) && ("int8" != inputType) &&
+               ("int16" != inputType) && ("float32" != inputType))
+            {
+                throw Pothos::InvalidArgumentException("Invalid input type: "+inputType);
+            }
+            _throwIfActive("input type");
+
+            for(size_t port = 0; port < 3; ++port) this->setupInput(port, inputType);
+            _inputType = inputType;
+            _inputElemSize = this->input(0)->dtype().size();
+        }
+
         void propagateLabels(const Pothos::InputPort* input) override
         {
-            if(!_blockStartID.empty())
+            // The framer set aside input 0's labels to pass on when it
+            // scanned.
+            if(_framer.scanned() && (input == this->input(0)))
+            {
+                auto* output = this->output(0);
+                _framer.propagateLabels(&output, 1);
+            }
+            else if(!_blockStartID.empty())
             {
                 // Don't propagate input label.
                 for(const auto& label: input->labels())
                 {
-                    if(label.id != _blockStartID)
+                    if((label.id != _blockStartID) && (label.id != _transportBlockID))
                     {
                         this->output(0)->postLabel(label);
                     }
@@ -99,79 +586,586 @@ class LTETurboDecoder: public Pothos::Block
             else Pothos::Block::propagateLabels(input);
         }
 
+        // Each buffer must hold at least one block of the largest K, with
+        // the soft output at its widest type, or _work() would overrun it.
+        Pothos::BufferManager::Sptr getOutputBufferManager(
+            const std::string& name,
+            const std::string& domain) override
+        {
+            if(domain.empty())
+            {
+                Pothos::BufferManagerArgs args;
+                args.bufferSize = ("1" == name) ? (TURBO_MAX_K * sizeof(std::int16_t))
+                                                : TURBO_MAX_K;
+
+                return Pothos::BufferManager::make("generic", args);
+            }
+
+            return Pothos::Block::getOutputBufferManager(name, domain);
+        }
+
         void work() override
         {
-            const auto elems = this->workInfo().minInElements;
-            if((0 == elems) || (calcOutputSize(elems) < TURBO_MIN_K))
+            _framer.reset();
+
+            // In the interleaved stream format, inputs 1 and 2 go unused.
+            const auto& inputs = this->inputs();
+            _inputPorts.assign(inputs.begin(), inputs.begin() + (_interleaved ? 1 : 3));
+
+            size_t elems = _inputPorts[0]->elements();
+            for(const auto* input: _inputPorts) elems = std::min(elems, input->elements());
+            if((0 == elems) || (calcDecoderOutputSize(elems) < TURBO_MIN_K))
             {
                 return;
             }
 
-            if(_blockStartID.empty()) _work(elems);
-            else                      _blockIDWork(elems);
+            if(_deadlineTracker.enabled()) _deadlineTracker.indexTimestamps(this->input(0), elems);
+
+            if(!_transportBlockID.empty()) _transportBlockWork(elems);
+            else if(0 != _blockSize)       _blockSizeWork(elems);
+            else if(_blockStartID.empty()) _work(elems);
+            else                           _blockIDWork(elems);
         }
 
     private:
         size_t _numIterations;
         bool _unpack;
         DecodeFcn _decodeFcn;
-        tDecoderUPtr _tDecoderUPtr;
+        std::string _softOutputType;
+
+        // If true, the three streams are interleaved on input 0.
+        bool _interleaved;
+
+        std::string _inputType;
+        size_t _inputElemSize;
+
+        // The inputs in use for the stream format
+        std::vector<Pothos::InputPort*> _inputPorts;
+
+        // One per code block thread, with the first used by the block thread
+        std::vector<LTETurboDecodeContext> _decodeContexts;
+        std::unique_ptr<WorkerPool> _workerPoolUPtr;
 
         std::string _blockStartID;
 
-        // Common code when we've determined our input size.
-        void _work(size_t inputSize)
+        // If nonzero, the input is split into blocks of this size.
+        size_t _blockSize;
+
+        LabelFramer _framer;
+
+        std::string _transportBlockID;
+        std::vector<LTETurboCodeBlock> _codeBlocks;
+        BufferChunkPool _transportBlockPool;
+        BufferChunkPool _softTransportBlockPool;
+
+        FrameDeadlineTracker _deadlineTracker;
+        std::string _deadlinePolicy;
+
+        DecodePriority _priority;
+
+        std::string _engine;
+
+        // Applied to the in-tree engines
+        size_t _numWindows;
+        size_t _numThreads;
+
+        CRCType _crcType;
+        std::string _stoppingCriterion;
+        double _minLLRThreshold;
+        std::vector<unsigned long long> _iterationHistogram;
+
+        bool _adaptiveIterations;
+        AdaptiveIterationBudget _iterationBudget;
+        std::vector<unsigned long long> _iterationCapHistogram;
+
+        std::string _inputScaling;
+        double _inputScale;
+        int _inputSaturation;
+
+        // Port layout can't change under a running topology.
+        void _throwIfActive(const std::string& setting) const
         {
-            const auto& inputs = this->inputs();
-            auto output = this->output(0);
+            if(this->isActive())
+            {
+                throw Pothos::IllegalStateException("The "+setting+" can't be changed while the block is active");
+            }
+        }
+
+        // Returns null for TurboFEC.
+        std::unique_ptr<LTETurboSISODecoder> _makeSISODecoder(const std::string& engine) const
+        {
+            std::unique_ptr<LTETurboSISODecoder> sisoDecoderUPtr;
+
+            if("TurboFEC" == engine)                return sisoDecoderUPtr;
+            else if("Max-Log-MAP 16-bit" == engine) sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int16, false));
+            else if("Log-MAP 16-bit" == engine)     sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int16, true));
+            else if("Max-Log-MAP 8-bit" == engine)  sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int8, false));
+            else if("Log-MAP 8-bit" == engine)      sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int8, true));
+            else throw Pothos::InvalidArgumentException("Invalid engine: "+engine);
+
+            sisoDecoderUPtr->setNumWindows(_numWindows);
+            sisoDecoderUPtr->setNumThreads(_numThreads);
+
+            return sisoDecoderUPtr;
+        }
+
+        // Only the in-tree engines can check the stopping criterion between
+        // iterations.
+        bool _isStoppingEarly() const
+        {
+            return ("TurboFEC" != _engine) &&
+                   (("CRC" != _stoppingCriterion) || (CRCType::None != _crcType));
+        }
+
+        // Converts a block's inputs to the 8-bit soft bits the engines take.
+        // 8-bit inputs without scaling or saturation are used as they are.
+        // Only touches the given context, so blocks can be converted
+        // concurrently.
+        void _scaleInputs(
+            LTETurboDecodeContext& decodeContext,
+            const std::uint8_t* const* rawInputs,
+            size_t outputSize,
+            const std::int8_t** inputsOut) const
+        {
+            if((1 == _inputElemSize) &&
+               ("None" == _inputScaling) &&
+               (std::numeric_limits<std::int8_t>::max() == _inputSaturation))
+            {
+                for(size_t port = 0; port < 3; ++port) inputsOut[port] = reinterpret_cast<const std::int8_t*>(rawInputs[port]);
+            }
+            else if("int16" == _inputType)   _scaleInputs<std::int16_t>(decodeContext, rawInputs, outputSize, inputsOut);
+            else if("float32" == _inputType) _scaleInputs<float>(decodeContext, rawInputs, outputSize, inputsOut);
+            else                             _scaleInputs<std::int8_t>(decodeContext, rawInputs, outputSize, inputsOut);
+        }
+
+        template <typename T>
+        void _scaleInputs(
+            LTETurboDecodeContext& decodeContext,
+            const std::uint8_t* const* rawInputs,
+            size_t outputSize,
+            const std::int8_t** inputsOut) const
+        {
+            // Either each stream on its own input, or all three on one
+            const size_t numInputs = _interleaved ? 1 : 3;
+            const size_t length = (_interleaved ? 3 : 1) * (outputSize + 4);
+
+            const T* inputs[3] = {};
+            for(size_t port = 0; port < numInputs; ++port) inputs[port] = reinterpret_cast<const T*>(rawInputs[port]);
+
+            double scale = 1.0;
+            if("Fixed" == _inputScaling) scale = _inputScale;
+            else if("Auto" == _inputScaling)
+            {
+                // For BPSK with amplitude A and noise power N, the LLR of x
+                // is 2Ax/N nats. At high SNR, this saturates almost every
+                // input, so the scale is capped to saturate about half.
+                // Without any signal, the fixed scale is used.
+                double amplitude = 0.0;
+                double noisePower = 0.0;
+                estimateBPSKStatistics(inputs, numInputs, length, &amplitude, &noisePower);
+
+                if(amplitude > 0.0)
+                {
+                    scale = double(_inputSaturation) / amplitude;
+                    if(noisePower > 0.0) scale = std::min(scale, (SoftInputUnitsPerNat * 2.0 * amplitude / noisePower));
+                }
+                else scale = _inputScale;
+            }
+
+            auto& scaledInputs = decodeContext.scaledInputs;
+            scaledInputs.resize(numInputs * length);
+            for(size_t port = 0; port < numInputs; ++port)
+            {
+                auto* scaledInput = scaledInputs.data() + (port * length);
+                scaleSaturate(inputs[port], scaledInput, length, float(scale), static_cast<std::int8_t>(_inputSaturation));
+                inputsOut[port] = scaledInput;
+            }
+        }
+
+        // The in-tree engine can check the stopping criterion after every
+        // iteration.
+        size_t _sisoDecode(
+            LTETurboDecodeContext& decodeContext,
+            const std::int8_t* const* inputs,
+            std::uint8_t* output,
+            size_t outputSize,
+            size_t maxIterations,
+            size_t* convergedIterationOut)
+        {
+            std::uint8_t* bits = output;
+            if(!_unpack)
+            {
+                decodeContext.decodedBits.resize(outputSize);
+                bits = decodeContext.decodedBits.data();
+            }
+
+            LTETurboSISODecoder::StopFcn stopFcn;
+            if(_isStoppingEarly())
+            {
+                if("Hard Decision" == _stoppingCriterion)
+                {
+                    auto& prevOutput = decodeContext.prevOutput;
+                    prevOutput.clear();
+                    stopFcn = [&prevOutput, outputSize](size_t numIterations, const std::uint8_t* decodedBits, int)
+                    {
+                        const bool converged = (1 < numIterations) &&
+                                               (0 == std::memcmp(prevOutput.data(), decodedBits, outputSize));
+                        prevOutput.assign(decodedBits, decodedBits + outputSize);
+
+                        return converged;
+                    };
+                }
+                else if("Min LLR" == _stoppingCriterion)
+                {
+                    stopFcn = [this](size_t, const std::uint8_t*, int minAbsLLR)
+                    {
+                        return (double(minAbsLLR) >= _minLLRThreshold);
+                    };
+                }
+                else
+                {
+                    stopFcn = [this, outputSize](size_t, const std::uint8_t* decodedBits, int)
+                    {
+                        return checkCRC24(_crcType, decodedBits, outputSize, true);
+                    };
+                }
+            }
+
+            // For the adaptive iteration cap, note when the decoded bits stop
+            // changing, or the stopping criterion is met.
+            if(convergedIterationOut)
+            {
+                *convergedIterationOut = 0;
+                auto& convergenceOutput = decodeContext.convergenceOutput;
+                convergenceOutput.clear();
+
+                stopFcn = [stopFcn, convergedIterationOut, &convergenceOutput, outputSize](
+                              size_t numIterations,
+                              const std::uint8_t* decodedBits,
+                              int minAbsLLR)
+                {
+                    const bool stop = stopFcn && stopFcn(numIterations, decodedBits, minAbsLLR);
+                    const bool unchanged = (1 < numIterations) &&
+                                           (0 == std::memcmp(convergenceOutput.data(), decodedBits, outputSize));
+                    convergenceOutput.assign(decodedBits, decodedBits + outputSize);
+
+                    if(0 == *convergedIterationOut)
+                    {
+                        if(stop)           *convergedIterationOut = numIterations;
+                        else if(unchanged) *convergedIterationOut = numIterations - 1;
+                    }
+
+                    return stop;
+                };
+            }
+
+            const auto numIterations = _interleaved ? decodeContext.sisoDecoderUPtr->decodeInterleaved(
+                                                          outputSize,
+                                                          maxIterations,
+                                                          inputs[0],
+                                                          bits,
+                                                          stopFcn)
+                                                    : decodeContext.sisoDecoderUPtr->decode(
+                                                          outputSize,
+                                                          maxIterations,
+                                                          inputs[0],
+                                                          inputs[1],
+                                                          inputs[2],
+                                                          bits,
+                                                          stopFcn);
+            if(!_unpack) packBits(bits, output, outputSize);
+
+            return numIterations;
+        }
+
+        // Decodes a block, stopping early once the stopping criterion is met.
+        // Returns the number of iterations run. If given, also outputs
+        // how many iterations the block took to converge, or 0 if it didn't,
+        // for the adaptive iteration cap. Only touches the given context, so
+        // blocks can be decoded concurrently.
+        size_t _decode(
+            LTETurboDecodeContext& decodeContext,
+            const std::int8_t* const* inputs,
+            std::uint8_t* output,
+            size_t outputSize,
+            size_t maxIterations,
+            size_t* convergedIterationOut = nullptr)
+        {
+            if(decodeContext.sisoDecoderUPtr)
+            {
+                return _sisoDecode(decodeContext, inputs, output, outputSize, maxIterations, convergedIterationOut);
+            }
+
+            if(convergedIterationOut) *convergedIterationOut = 0;
+
+            // TurboFEC needs the streams apart.
+            const std::int8_t* streams[] = {inputs[0], inputs[1], inputs[2]};
+            if(_interleaved)
+            {
+                const size_t streamLength = outputSize + 4;
+                auto& deinterleaved = decodeContext.streams;
+                deinterleaved.resize(3 * streamLength);
 
-            const auto outputSize = calcOutputSize(inputSize);
+                std::int8_t* const streamsOut[] =
+                {
+                    deinterleaved.data(),
+                    deinterleaved.data() + streamLength,
+                    deinterleaved.data() + (2 * streamLength)
+                };
+                deinterleaveStreams(inputs[0], streamsOut, streamLength);
+                std::copy(streamsOut, streamsOut+3, streams);
+            }
 
+            // TurboFEC can't be stopped partway through, so it always runs
+            // every iteration.
             _decodeFcn(
-                _tDecoderUPtr.get(),
+                decodeContext.turboFECDecoderUPtr.get(),
                 static_cast<int>(outputSize),
-                static_cast<int>(_numIterations),
-                output->buffer(),
-                inputs[0]->buffer(),
-                inputs[1]->buffer(),
-                inputs[2]->buffer());
+                static_cast<int>(maxIterations),
+                output,
+                streams[0],
+                streams[1],
+                streams[2]);
 
-            for(auto* input: inputs) input->consume(inputSize);
-            output->produce(_unpack ? outputSize : (outputSize / 8));
+            return maxIterations;
+        }
+
+        bool _hasSoftOutput() const
+        {
+            return ("None" != _softOutputType);
+        }
+
+        // Writes the a-posteriori LLRs of the block just decoded with the
+        // given context. Soft output is only allowed with the in-tree
+        // engines.
+        void _writeSoftOutput(
+            const LTETurboDecodeContext& decodeContext,
+            size_t outputSize,
+            void* softOutput) const
+        {
+            const auto* llrs = decodeContext.sisoDecoderUPtr->llrs().data();
+            if("int8" == _softOutputType)
+            {
+                constexpr int maxLLR = std::numeric_limits<std::int8_t>::max();
+
+                auto* softOutput8 = static_cast<std::int8_t*>(softOutput);
+                for(size_t elem = 0; elem < outputSize; ++elem)
+                {
+                    softOutput8[elem] = static_cast<std::int8_t>(std::min<int>(std::max<int>(llrs[elem], -maxLLR), maxLLR));
+                }
+            }
+            else std::memcpy(softOutput, llrs, outputSize * sizeof(std::int16_t));
+        }
+
+        // If a frame can't be fully decoded before its deadline, either
+        // decode it with as many iterations as we have time for, or drop it.
+        // For our cost estimate, a unit of work is one bit-iteration. Returns
+        // false if the frame should be dropped.
+        bool _checkDeadline(
+            size_t inputOffset,
+            size_t inputSize,
+            size_t numBits,
+            size_t* numIterationsInOut,
+            bool* hasDeadlineOut)
+        {
+            FrameDeadlineTracker::Clock::time_point deadline;
+            *hasDeadlineOut = _deadlineTracker.enabled() &&
+                              _deadlineTracker.findDeadline(inputOffset, inputSize, deadline);
+            if(!*hasDeadlineOut) return true;
+
+            const double maxIterations = std::min(
+                                             (_deadlineTracker.workUnitsRemaining(deadline) / double(numBits)),
+                                             double(*numIterationsInOut));
+            if(maxIterations < double(*numIterationsInOut))
+            {
+                if(("Degrade" == _deadlinePolicy) && (maxIterations >= 1.0))
+                {
+                    *numIterationsInOut = static_cast<size_t>(maxIterations);
+                    _deadlineTracker.frameDegraded();
+                }
+                else
+                {
+                    _deadlineTracker.frameDropped();
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void _recordIterations(size_t numIterations)
+        {
+            if(_iterationHistogram.size() <= numIterations) _iterationHistogram.resize(numIterations+1, 0);
+            ++_iterationHistogram[numIterations];
+        }
+
+        // With the adaptive iteration cap, estimates the block's SNR from its
+        // systematic soft bits, and picks its cap. Only reads the budget, so
+        // blocks can pick caps concurrently.
+        size_t _iterationCap(
+            const std::int8_t* const* inputs,
+            size_t outputSize,
+            size_t maxIterations,
+            double* snrOut) const
+        {
+            if(!_adaptiveIterations) return maxIterations;
+
+            *snrOut = AdaptiveIterationBudget::estimateSNR(inputs[0], outputSize, (_interleaved ? 3 : 1));
+            return _iterationBudget.iterationCap(*snrOut, maxIterations);
+        }
+
+        // TurboFEC doesn't say when a block converged.
+        bool _canObserveConvergence() const
+        {
+            return ("TurboFEC" != _engine);
+        }
+
+        // A block decoded with fewer iterations than its cap, to meet a
+        // deadline, says nothing about how many it would have needed.
+        void _recordAdaptiveDecode(double snr, size_t iterationCap, size_t convergedIteration, bool degraded)
+        {
+            if(_iterationCapHistogram.size() <= iterationCap) _iterationCapHistogram.resize(iterationCap+1, 0);
+            ++_iterationCapHistogram[iterationCap];
+
+            if(!degraded && _canObserveConvergence()) _iterationBudget.recordDecode(snr, convergedIteration);
+        }
+
+        // Common code when we've determined our input size. Decodes numBlocks
+        // consecutive blocks of this size, back to back in the output.
+        void _work(size_t inputSize, size_t numBlocks = 1)
+        {
+            const auto& inputs = _inputPorts;
+            auto output = this->output(0);
+
+            const auto outputSize = calcDecoderOutputSize(inputSize);
+            if((output->elements() < (numBlocks * (_unpack ? outputSize : (outputSize / 8)))) ||
+               (_hasSoftOutput() && (this->output(1)->elements() < (numBlocks * outputSize))))
+            {
+                // Wait for room in the outputs.
+                return;
+            }
+
+            // Dropped blocks leave no gap in the output.
+            size_t numDecodedBlocks = 0;
+            for(size_t block = 0; block < numBlocks; ++block)
+            {
+                const bool decoded = _decodeBlock(
+                                         (block * inputSize),
+                                         inputSize,
+                                         (numDecodedBlocks * (_unpack ? outputSize : (outputSize / 8))),
+                                         (numDecodedBlocks * outputSize));
+                if(decoded) ++numDecodedBlocks;
+            }
+
+            for(auto* input: inputs) input->consume(numBlocks * inputSize);
+            output->produce(numDecodedBlocks * (_unpack ? outputSize : (outputSize / 8)));
+            if(_hasSoftOutput()) this->output(1)->produce(numDecodedBlocks * outputSize);
+        }
+
+        // Decodes the block at the given input offset into the outputs at the
+        // given offsets. Returns false if the block was dropped.
+        bool _decodeBlock(
+            size_t inputOffset,
+            size_t inputSize,
+            size_t outputOffset,
+            size_t softOutputOffset)
+        {
+            const auto& inputs = _inputPorts;
+            auto output = this->output(0);
+
+            const auto outputSize = calcDecoderOutputSize(inputSize);
+
+            const std::uint8_t* rawInputs[3] = {};
+            for(size_t port = 0; port < inputs.size(); ++port)
+            {
+                rawInputs[port] = inputs[port]->buffer().as<const std::uint8_t*>() + (inputOffset * _inputElemSize);
+            }
+
+            const std::int8_t* inputBuffers[3] = {};
+            _scaleInputs(_decodeContexts[0], rawInputs, outputSize, inputBuffers);
+
+            double snr = 0.0;
+            const size_t iterationCap = _iterationCap(inputBuffers, outputSize, _numIterations, &snr);
+
+            size_t numIterations = iterationCap;
+            bool hasDeadline = false;
+            if(!_checkDeadline(inputOffset, inputSize, outputSize, &numIterations, &hasDeadline)) return false;
+
+            FrameDeadlineTracker::Clock::time_point decodeStartTime;
+            size_t convergedIteration = 0;
+            const bool degraded = (numIterations < iterationCap);
+            {
+                DecodeScheduler::Slot decodeSlot(_priority);
+
+                decodeStartTime = FrameDeadlineTracker::Clock::now();
+                numIterations = _decode(
+                                    _decodeContexts[0],
+                                    inputBuffers,
+                                    output->buffer().as<std::uint8_t*>() + outputOffset,
+                                    outputSize,
+                                    numIterations,
+                                    (_adaptiveIterations ? &convergedIteration : nullptr));
+            }
+
+            if(_hasSoftOutput())
+            {
+                auto softOutputBuffer = this->output(1)->buffer();
+                _writeSoftOutput(
+                    _decodeContexts[0],
+                    outputSize,
+                    softOutputBuffer.as<std::uint8_t*>() + (softOutputOffset * softOutputBuffer.dtype.size()));
+            }
+
+            if(hasDeadline)
+            {
+                _deadlineTracker.recordDecodeTime(
+                    double(outputSize * numIterations),
+                    (FrameDeadlineTracker::Clock::now() - decodeStartTime));
+            }
+
+            _recordIterations(numIterations);
+            if(_adaptiveIterations) _recordAdaptiveDecode(snr, iterationCap, convergedIteration, degraded);
 
             // Output a start block ID so an decoder can operate on the same data.
-            if(!_blockStartID.empty()) output->postLabel(_blockStartID, outputSize, 0);
+            if(!_blockStartID.empty())
+            {
+                output->postLabel(_blockStartID, outputSize, outputOffset);
+                if(_hasSoftOutput()) this->output(1)->postLabel(_blockStartID, outputSize, softOutputOffset);
+            }
+
+            // When stopping early, note how many iterations this block took.
+            if(_isStoppingEarly()) output->postLabel("iterations", numIterations, outputOffset);
+
+            return true;
         }
 
-        void _blockIDWork(size_t maxInputSize)
+        // Decodes a whole transport block, once it's fully buffered. Its
+        // code blocks are decoded concurrently, each thread with its own
+        // decode context.
+        void _transportBlockWork(size_t maxInputSize)
         {
-            size_t inputSize = maxInputSize;
+            if(_blockStartID.empty())
+            {
+                throw Pothos::InvalidArgumentException("Decoding transport blocks requires a block start ID");
+            }
 
-            const auto& inputs = this->inputs();
+            const auto& inputs = _inputPorts;
+            auto output = this->output(0);
 
-            bool blockFound = false;
+            size_t inputSize = 0;
+            bool transportBlockFound = false;
 
-            // We take in three inputs, but input 0 is expected to have
-            // the block ID label.
             for(const auto& label: inputs[0]->labels())
             {
-                // Skip if we haven't received enough data for this label.
-                if(label.index > maxInputSize) continue;
+                if((label.index > maxInputSize) || (label.id != _transportBlockID)) continue;
 
-                // Skip if this isn't a block start label.
-                if(label.id != _blockStartID) continue;
-
-                // If we have a length, use it.
-                if(label.data.canConvert(typeid(size_t)))
+                if(!label.data.canConvert(typeid(size_t)))
                 {
-                    inputSize = label.data.convert<size_t>();
-                    if(calcOutputSize(inputSize) > TURBO_MAX_K)
-                    {
-                        throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size. Max block size: " + std::to_string(TURBO_MAX_K));
-                    }
+                    throw Pothos::InvalidArgumentException("Transport block labels must contain the transport block's input length");
                 }
+                inputSize = label.data.convert<size_t>();
 
-                // Skip all data before the block starts.
+                // Skip all data before the transport block starts.
                 if(0 != label.index)
                 {
                     for(auto* input: inputs)
@@ -182,20 +1176,279 @@ class LTETurboDecoder: public Pothos::Block
                     return;
                 }
 
-                // If our block starts at the beginning of our buffer, wait until we have
-                // enough data to encode.
+                // Wait until the whole transport block is here.
                 if(maxInputSize < inputSize)
                 {
                     for(auto* input: inputs) input->setReserve(inputSize);
                     return;
                 }
 
-                blockFound = true;
+                transportBlockFound = true;
                 break;
             }
 
-            if(blockFound) this->_work(inputSize);
-            else           for(auto* input: inputs) input->consume(maxInputSize);
+            if(!transportBlockFound)
+            {
+                for(auto* input: inputs) input->consume(maxInputSize);
+                return;
+            }
+
+            // Each code block starts at a block start label. Without a length,
+            // a code block runs until the next one.
+            _codeBlocks.clear();
+            for(const auto& label: inputs[0]->labels())
+            {
+                if((label.index >= inputSize) || (label.id != _blockStartID)) continue;
+
+                LTETurboCodeBlock codeBlock{};
+                codeBlock.inputOffset = label.index;
+                codeBlock.inputSize = label.data.canConvert(typeid(size_t)) ? label.data.convert<size_t>() : 0;
+                _codeBlocks.push_back(codeBlock);
+            }
+            std::sort(
+                _codeBlocks.begin(),
+                _codeBlocks.end(),
+                [](const LTETurboCodeBlock& codeBlock0, const LTETurboCodeBlock& codeBlock1)
+                {
+                    return (codeBlock0.inputOffset < codeBlock1.inputOffset);
+                });
+
+            size_t outputSize = 0;
+            size_t numBits = 0;
+            for(size_t codeBlockIndex = 0; codeBlockIndex < _codeBlocks.size(); ++codeBlockIndex)
+            {
+                auto& codeBlock = _codeBlocks[codeBlockIndex];
+
+                const size_t codeBlockEnd = ((codeBlockIndex+1) < _codeBlocks.size()) ? _codeBlocks[codeBlockIndex+1].inputOffset
+                                                                                     : inputSize;
+                if(0 == codeBlock.inputSize) codeBlock.inputSize = codeBlockEnd - codeBlock.inputOffset;
+
+                const auto codeBlockOutputSize = calcDecoderOutputSize(codeBlock.inputSize);
+                if(((codeBlock.inputOffset + codeBlock.inputSize) > codeBlockEnd) ||
+                   (codeBlockOutputSize < TURBO_MIN_K) ||
+                   (codeBlockOutputSize > TURBO_MAX_K))
+                {
+                    throw Pothos::InvalidArgumentException("Invalid code block in transport block at input index " + std::to_string(codeBlock.inputOffset));
+                }
+
+                codeBlock.outputOffset = outputSize;
+                codeBlock.outputSize = codeBlockOutputSize;
+                codeBlock.softOutputOffset = numBits;
+                outputSize += _unpack ? codeBlockOutputSize : (codeBlockOutputSize / 8);
+                numBits += codeBlockOutputSize;
+            }
+
+            size_t numIterations = _numIterations;
+            bool hasDeadline = false;
+            if(_codeBlocks.empty() || !_checkDeadline(0, inputSize, numBits, &numIterations, &hasDeadline))
+            {
+                for(auto* input: inputs) input->consume(inputSize);
+                return;
+            }
+
+            // Decode into the output buffer when there's room. Larger
+            // transport blocks, such as PDSCH's with more than a dozen code
+            // blocks, are posted from a pool instead. The pool only
+            // allocates while it grows, or if downstream blocks hold every
+            // buffer in it.
+            const bool mustPostBuffer = (outputSize > output->elements());
+            Pothos::BufferChunk outputBuffer = mustPostBuffer ? _transportBlockPool.get("uint8", outputSize)
+                                                              : output->buffer();
+
+            // The soft output has one LLR per decoded bit.
+            Pothos::BufferChunk softOutputBuffer;
+            bool mustPostSoftBuffer = false;
+            if(_hasSoftOutput())
+            {
+                mustPostSoftBuffer = (numBits > this->output(1)->elements());
+                softOutputBuffer = mustPostSoftBuffer ? _softTransportBlockPool.get(_softOutputType, numBits)
+                                                      : this->output(1)->buffer();
+            }
+
+            // Bundled up so the task captures little enough to not allocate.
+            struct
+            {
+                const std::uint8_t* inputs[3];
+                std::uint8_t* output;
+                std::uint8_t* softOutput;
+                size_t softOutputElemSize;
+                size_t numIterations;
+            } transportBlock =
+            {
+                {},
+                outputBuffer,
+                softOutputBuffer.as<std::uint8_t*>(),
+                softOutputBuffer.dtype.size(),
+                numIterations
+            };
+            for(size_t port = 0; port < inputs.size(); ++port) transportBlock.inputs[port] = inputs[port]->buffer();
+
+            const auto decodeStartTime = FrameDeadlineTracker::Clock::now();
+
+            const WorkerPool::TaskFcn decodeCodeBlock = [this, &transportBlock](size_t codeBlockIndex, size_t threadIndex)
+            {
+                auto& codeBlock = _codeBlocks[codeBlockIndex];
+
+                const std::uint8_t* rawInputs[3] = {};
+                for(size_t port = 0; port < 3; ++port)
+                {
+                    if(transportBlock.inputs[port]) rawInputs[port] = transportBlock.inputs[port] + (codeBlock.inputOffset * _inputElemSize);
+                }
+
+                const std::int8_t* inputBuffers[3] = {};
+                _scaleInputs(_decodeContexts[threadIndex], rawInputs, codeBlock.outputSize, inputBuffers);
+
+                codeBlock.iterationCap = _iterationCap(
+                                             inputBuffers,
+                                             codeBlock.outputSize,
+                                             transportBlock.numIterations,
+                                             &codeBlock.snr);
+
+                DecodeScheduler::Slot decodeSlot(_priority);
+
+                codeBlock.numIterations = _decode(
+                                              _decodeContexts[threadIndex],
+                                              inputBuffers,
+                                              transportBlock.output + codeBlock.outputOffset,
+                                              codeBlock.outputSize,
+                                              codeBlock.iterationCap,
+                                              (_adaptiveIterations ? &codeBlock.convergedIteration : nullptr));
+
+                if(transportBlock.softOutput)
+                {
+                    _writeSoftOutput(
+                        _decodeContexts[threadIndex],
+                        codeBlock.outputSize,
+                        transportBlock.softOutput + (codeBlock.softOutputOffset * transportBlock.softOutputElemSize));
+                }
+            };
+
+            if(_workerPoolUPtr) _workerPoolUPtr->parallelFor(_codeBlocks.size(), decodeCodeBlock);
+            else
+            {
+                for(size_t codeBlockIndex = 0; codeBlockIndex < _codeBlocks.size(); ++codeBlockIndex)
+                {
+                    decodeCodeBlock(codeBlockIndex, 0);
+                }
+            }
+
+            if(hasDeadline)
+            {
+                size_t totalWork = 0;
+                for(const auto& codeBlock: _codeBlocks) totalWork += (codeBlock.outputSize * codeBlock.numIterations);
+
+                _deadlineTracker.recordDecodeTime(
+                    double(totalWork),
+                    (FrameDeadlineTracker::Clock::now() - decodeStartTime));
+            }
+
+            for(auto* input: inputs) input->consume(inputSize);
+            if(mustPostBuffer) output->postBuffer(std::move(outputBuffer));
+            else               output->produce(outputSize);
+
+            if(_hasSoftOutput())
+            {
+                if(mustPostSoftBuffer) this->output(1)->postBuffer(std::move(softOutputBuffer));
+                else                   this->output(1)->produce(numBits);
+            }
+
+            // Mark the transport block and each code block, so a downstream
+            // block can operate on the same data.
+            output->postLabel(_transportBlockID, outputSize, 0);
+            if(_hasSoftOutput()) this->output(1)->postLabel(_transportBlockID, numBits, 0);
+            for(const auto& codeBlock: _codeBlocks)
+            {
+                _recordIterations(codeBlock.numIterations);
+                if(_adaptiveIterations)
+                {
+                    _recordAdaptiveDecode(
+                        codeBlock.snr,
+                        codeBlock.iterationCap,
+                        codeBlock.convergedIteration,
+                        (transportBlock.numIterations < _numIterations));
+                }
+
+                output->postLabel(_blockStartID, codeBlock.outputSize, codeBlock.outputOffset);
+                if(_isStoppingEarly()) output->postLabel("iterations", codeBlock.numIterations, codeBlock.outputOffset);
+
+                if(_hasSoftOutput()) this->output(1)->postLabel(_blockStartID, codeBlock.outputSize, codeBlock.softOutputOffset);
+            }
+        }
+
+        // Decodes every whole block of the fixed size that fits in the
+        // outputs, back to back.
+        void _blockSizeWork(size_t maxInputSize)
+        {
+            const auto& inputs = _inputPorts;
+
+            const size_t inputSize = calcDecoderInputSize(_blockSize);
+            for(auto* input: inputs) input->setReserve(inputSize);
+            if(maxInputSize < inputSize) return;
+
+            size_t numBlocks = std::min(
+                                   (maxInputSize / inputSize),
+                                   (this->output(0)->elements() / (_unpack ? _blockSize : (_blockSize / 8))));
+            if(_hasSoftOutput()) numBlocks = std::min(numBlocks, (this->output(1)->elements() / _blockSize));
+
+            // Our output buffers always hold a block, so wait for the next.
+            if(0 == numBlocks) return;
+
+            this->_work(inputSize, numBlocks);
+        }
+
+        // Decodes every whole labeled block that fits in the outputs, back to
+        // back.
+        void _blockIDWork(size_t maxInputSize)
+        {
+            const auto& inputs = _inputPorts;
+            auto output = this->output(0);
+
+            // We take in three inputs, but input 0 is expected to have
+            // the block ID labels.
+            _framer.scan(inputs[0], _blockStartID, _transportBlockID, maxInputSize);
+            const auto& blocks = _framer.blocks();
+
+            size_t numBlocks = 0;
+            size_t outputSize = 0;
+            size_t numBits = 0;
+            for(const auto& block: blocks)
+            {
+                const auto blockBits = calcDecoderOutputSize(block.size);
+                if(blockBits > TURBO_MAX_K)
+                {
+                    throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size. Max block size: " + std::to_string(TURBO_MAX_K));
+                }
+
+                const size_t blockOutputSize = _unpack ? blockBits : (blockBits / 8);
+                const bool fits = ((outputSize + blockOutputSize) <= output->elements()) &&
+                                  (!_hasSoftOutput() || ((numBits + blockBits) <= this->output(1)->elements()));
+                if(!fits) break;
+
+                outputSize += blockOutputSize;
+                numBits += blockBits;
+                ++numBlocks;
+            }
+
+            // Our output buffers always hold a block, so wait for the next.
+            if(0 == numBlocks) return;
+
+            // Dropped blocks leave no gap in the output.
+            size_t outputOffset = 0;
+            size_t softOutputOffset = 0;
+            for(size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                const auto& block = blocks[blockIndex];
+                if(_decodeBlock(block.offset, block.size, outputOffset, softOutputOffset))
+                {
+                    const auto blockBits = calcDecoderOutputSize(block.size);
+                    outputOffset += _unpack ? blockBits : (blockBits / 8);
+                    softOutputOffset += blockBits;
+                }
+            }
+
+            _framer.consume(inputs, numBlocks);
+            if(outputOffset > 0) output->produce(outputOffset);
+            if(_hasSoftOutput() && (softOutputOffset > 0)) this->output(1)->produce(softOutputOffset);
         }
 };
 
@@ -206,8 +1459,31 @@ class LTETurboDecoder: public Pothos::Block
  * |keywords coder
  * |factory /fec/lte_turbo_decoder(numIterations,unpack)
  * |setter setNumIterations(numIterations)
+ * |setter setEngine(engine)
+ * |setter setSoftOutputType(softOutputType)
+ * |setter setStreamFormat(streamFormat)
+ * |setter setInputType(inputType)
+ * |setter setBlockStartID(blockStartID)
+ * |setter setBlockSize(blockSize)
+ * |setter setTransportBlockID(transportBlockID)
+ * |setter setNumCodeBlockThreads(numCodeBlockThreads)
+ * |setter setDeadlineBudget(deadlineBudget)
+ * |setter setTimestampID(timestampID)
+ * |setter setDeadlinePolicy(deadlinePolicy)
+ * |setter setPriority(priority)
+ * |setter setNumWindows(numWindows)
+ * |setter setNumThreads(numThreads)
+ * |setter setCRCType(crcType)
+ * |setter setStoppingCriterion(stoppingCriterion)
+ * |setter setMinLLRThreshold(minLLRThreshold)
+ * |setter setAdaptiveIterations(adaptiveIterations)
+ * |setter setTargetBLER(targetBLER)
+ * |setter setInputScaling(inputScaling)
+ * |setter setInputScale(inputScale)
+ * |setter setInputSaturation(inputSaturation)
  *
  * |param numIterations[Num Iterations]
+ * The maximum number of iterations per block.
  * |widget SpinBox(minimum=1)
  * |default 4
  * |preview enable
@@ -217,6 +1493,45 @@ class LTETurboDecoder: public Pothos::Block
  * |default true
  * |preview enable
  *
+ * |param softOutputType[Soft Output]
+ * If not "None", a second output carries the a-posteriori LLR of each decoded
+ * bit, in the same units as the soft inputs, where a positive value corresponds
+ * to a 1 bit. LLRs that don't fit in 8 bits are saturated. Soft output needs
+ * one of the in-tree engines, as TurboFEC only outputs decoded bits.
+ * The soft output, stream format, and input type set up the block's ports, so
+ * they can't be changed while the block is active.
+ * |widget ComboBox(editable=False)
+ * |option [None] "None"
+ * |option [Int8] "int8"
+ * |option [Int16] "int16"
+ * |default "None"
+ * |preview enable
+ *
+ * |param streamFormat[Stream Format]
+ * How the encoder's three output streams are input. "Separate" takes each
+ * stream on its own port. "Interleaved" takes all three on input 0, as
+ * d0[0], d1[0], d2[0], d0[1], ..., which saves synchronizing three inputs,
+ * and leaves inputs 1 and 2 unused.
+ * Either way, each block is 3(K+4) elements per port.
+ * |widget ComboBox(editable=False)
+ * |option [Separate] "Separate"
+ * |option [Interleaved] "Interleaved"
+ * |default "Separate"
+ * |preview enable
+ *
+ * |param inputType[Input Type]
+ * The type of the soft inputs, where a positive value corresponds to a 1 bit.
+ * The engines take 8-bit soft bits, so inputs are scaled and saturated to 8
+ * bits as they're decoded, without a separate conversion pass. "uint8" inputs
+ * are taken as signed, for compatibility with the encoder's output.
+ * |widget ComboBox(editable=False)
+ * |option [UInt8] "uint8"
+ * |option [Int8] "int8"
+ * |option [Int16] "int16"
+ * |option [Float32] "float32"
+ * |default "uint8"
+ * |preview enable
+ *
  * |param blockStartID[Block Start ID]
  * The label used by the block to determine the beginning of the block to decode.
  * This label will be placed at the start of the corresponding encoded block.
@@ -225,6 +1540,186 @@ class LTETurboDecoder: public Pothos::Block
  * |widget LineEdit()
  * |default "START"
  * |preview disable
+ *
+ * |param blockSize[Block Size]
+ * If nonzero, the input is split into consecutive encoded blocks of this many
+ * decoded bits, which must be a valid LTE turbo block size, and block start
+ * labels on the input are ignored. Every whole block available is decoded in
+ * one pass, so a stream of fixed-size blocks needs no labels. Each decoded
+ * block still gets a block start label if the block start ID isn't empty.
+ * Transport blocks are still framed by their labels.
+ * |widget SpinBox(minimum=0,maximum=6144)
+ * |default 0
+ * |preview valid
+ *
+ * |param transportBlockID[Transport Block ID]
+ * If not empty, the label used by the block to determine the beginning of a
+ * transport block, containing the transport block's input length. The
+ * transport block's code blocks each start with a block start label, and are
+ * decoded concurrently once the whole transport block has arrived. The output
+ * has a transport block label with the total output length, and a block start
+ * label for each decoded code block.
+ * |widget LineEdit()
+ * |default ""
+ * |preview valid
+ *
+ * |param numCodeBlockThreads[Code Block Threads]
+ * The number of threads that decode a transport block's code blocks, including
+ * the block's own thread. Each thread has its own preallocated decoder.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview valid
+ *
+ * |param deadlineBudget[Deadline Budget]
+ * If positive, each block with a timestamp label must be decoded within this
+ * many seconds of its timestamp. Blocks that can't be decoded in time are
+ * dropped or degraded, depending on the deadline policy.
+ * |units seconds
+ * |widget DoubleSpinBox(minimum=0.0,step=0.001,decimals=6)
+ * |default 0.0
+ * |preview valid
+ *
+ * |param timestampID[Timestamp ID]
+ * The label used by the block to determine a block's timestamp, in nanoseconds
+ * since the epoch of the host's system clock.
+ * |widget LineEdit()
+ * |default "rxTime"
+ * |preview valid
+ *
+ * |param deadlinePolicy[Deadline Policy]
+ * What to do with blocks that can't be decoded before their deadline. "Degrade"
+ * decodes with as many iterations as there's time for, if any.
+ * |widget ComboBox(editable=False)
+ * |option [Drop] "Drop"
+ * |option [Degrade] "Degrade"
+ * |default "Drop"
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ *
+ * |param engine[Engine]
+ * The decoder implementation. "TurboFEC" uses TurboFEC's decoder. The others use
+ * this module's max-log-MAP decoder, with 16-bit or faster saturating 8-bit state
+ * metrics, optionally with log-MAP correction for accuracy. Log-MAP correction
+ * assumes soft inputs are log-likelihood ratios scaled to 4 per nat. TurboFEC
+ * can't be used with soft output.
+ * |widget ComboBox(editable=False)
+ * |option [TurboFEC] "TurboFEC"
+ * |option [Max-Log-MAP 16-bit] "Max-Log-MAP 16-bit"
+ * |option [Log-MAP 16-bit] "Log-MAP 16-bit"
+ * |option [Max-Log-MAP 8-bit] "Max-Log-MAP 8-bit"
+ * |option [Log-MAP 8-bit] "Log-MAP 8-bit"
+ * |default "TurboFEC"
+ * |preview valid
+ *
+ * |param numWindows[Num Windows]
+ * For the in-tree engines, the number of windows to split each block into,
+ * for lower latency on large blocks. Windows are decoded side by side in
+ * SIMD registers, each starting from a short training run instead of the
+ * ends of the block, at a small cost in accuracy. Fewer windows are used if
+ * the block size isn't a multiple of this, or the windows would be too short.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview valid
+ *
+ * |param numThreads[Num Threads]
+ * For the in-tree engines, the number of threads that decode each block's
+ * windows, including the block's own thread. These threads are in addition
+ * to the module's decode slots.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview valid
+ *
+ * |param crcType[CRC Type]
+ * The CRC at the end of each decoded block, if any. Use CRC24B for a code block
+ * of a segmented transport block, and CRC24A for a transport block that fits in
+ * a single code block.
+ * |widget ComboBox(editable=False)
+ * |option [None] "None"
+ * |option [CRC24A] "CRC24A"
+ * |option [CRC24B] "CRC24B"
+ * |default "None"
+ * |preview valid
+ *
+ * |param stoppingCriterion[Stopping Criterion]
+ * When to stop decoding a block before the maximum number of iterations.
+ * "CRC" stops as soon as the decoded block passes its CRC, or runs all
+ * iterations if there's no CRC. "Hard Decision" stops when further
+ * iterations no longer change the decoded bits. "Min LLR" stops when every
+ * decoded bit's |LLR| reaches the min LLR threshold.
+ *
+ * Only the in-tree engines can stop early, as they check the stopping
+ * criterion after every iteration. TurboFEC can't be stopped partway through,
+ * so the TurboFEC engine always runs every iteration. When stopping early, the
+ * number of iterations used is posted in an "iterations" label at the start
+ * of the decoded block.
+ * |widget ComboBox(editable=False)
+ * |option [CRC] "CRC"
+ * |option [Hard Decision] "Hard Decision"
+ * |option [Min LLR] "Min LLR"
+ * |default "CRC"
+ * |preview valid
+ *
+ * |param minLLRThreshold[Min LLR Threshold]
+ * For the "Min LLR" stopping criterion, in the same units as the soft inputs.
+ * |widget DoubleSpinBox(minimum=0.0)
+ * |default 64.0
+ * |preview valid
+ *
+ * |param adaptiveIterations[Adaptive Iterations?]
+ * If true, each block's iteration cap is chosen from an estimate of its SNR,
+ * from its systematic soft bits, up to the maximum number of iterations. For
+ * each SNR, the decoder learns how many iterations blocks take for their
+ * decoded bits to stop changing, or to meet the stopping criterion, and caps
+ * blocks at the fewest iterations that let all but the target BLER of them
+ * converge. Until it has enough history for an SNR, blocks get the maximum.
+ * The TurboFEC engine doesn't say when a block converged, so its blocks always
+ * get the maximum. The chosen caps are counted in the iteration cap histogram.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview valid
+ *
+ * |param targetBLER[Target BLER]
+ * For adaptive iterations, the fraction of blocks at each SNR allowed to not
+ * converge within their cap.
+ * |widget DoubleSpinBox(minimum=0.0,maximum=1.0,step=0.001,decimals=4)
+ * |default 0.01
+ * |preview valid
+ *
+ * |param inputScaling[Input Scaling]
+ * How soft inputs are scaled before being saturated to 8 bits. "None" only
+ * rounds them. "Fixed" multiplies them by the input scale. "Auto" estimates
+ * each block's signal amplitude and noise power, assuming BPSK, and scales
+ * the inputs to log-likelihood ratios of 4 per nat, as log-MAP correction
+ * assumes. At high SNR, the scale is limited so the signal amplitude reaches
+ * the input saturation. Blocks with no measurable signal use the input scale.
+ * |widget ComboBox(editable=False)
+ * |option [None] "None"
+ * |option [Fixed] "Fixed"
+ * |option [Auto] "Auto"
+ * |default "None"
+ * |preview valid
+ *
+ * |param inputScale[Input Scale]
+ * For "Fixed" input scaling, the factor soft inputs are multiplied by.
+ * |widget DoubleSpinBox(minimum=0.0,decimals=6)
+ * |default 1.0
+ * |preview valid
+ *
+ * |param inputSaturation[Input Saturation]
+ * Scaled soft inputs are saturated to this magnitude. Less than 127 leaves
+ * headroom for the 8-bit engines' metrics.
+ * |widget SpinBox(minimum=1,maximum=127)
+ * |default 127
+ * |preview valid
  */
 static Pothos::BlockRegistry registerLTETurboDecoder(
     "/fec/lte_turbo_decoder",
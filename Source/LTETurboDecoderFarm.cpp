@@ -0,0 +1,263 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DecoderFarm.hpp"
+#include "LTETurbo.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+class LTETurboDecoderFarmWorkerState: public DecoderFarmWorkerState
+{
+    public:
+        LTETurboDecoderFarmWorkerState(
+            DecodeFcn decodeFcn,
+            const std::atomic<size_t>& numIterations
+        ):
+            _decodeFcn(decodeFcn),
+            _numIterations(numIterations),
+            _tDecoderUPtr(makeDecoderUPtr())
+        {}
+
+        void decode(DecoderFarmJob& job) override
+        {
+            const auto outputSize = calcDecoderOutputSize(job.inputs[0].elements());
+
+            throwOnErrCode(_decodeFcn(
+                _tDecoderUPtr.get(),
+                static_cast<int>(outputSize),
+                static_cast<int>(_numIterations.load()),
+                job.output.as<std::uint8_t*>(),
+                job.inputs[0].as<const std::int8_t*>(),
+                job.inputs[1].as<const std::int8_t*>(),
+                job.inputs[2].as<const std::int8_t*>()));
+        }
+
+    private:
+        DecodeFcn _decodeFcn;
+        const std::atomic<size_t>& _numIterations;
+        tDecoderUPtr _tDecoderUPtr;
+};
+
+class LTETurboDecoderFarm: public DecoderFarmBase
+{
+    public:
+        static Pothos::Block* make(size_t numIterations, bool unpack, size_t numWorkers)
+        {
+            return new LTETurboDecoderFarm(numIterations, unpack, numWorkers);
+        }
+
+        LTETurboDecoderFarm(size_t numIterations, bool unpack, size_t numWorkers):
+            DecoderFarmBase(3, "uint8", numWorkers),
+            _numIterations(numIterations),
+            _unpack(unpack),
+            _decodeFcn(_unpack ? ::lte_turbo_decode_unpack : ::lte_turbo_decode),
+            _nextBlockStart(0)
+        {
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoderFarm, numIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoderFarm, setNumIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoderFarm, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboDecoderFarm, setBlockStartID));
+
+            this->registerProbe("numIterations");
+            this->registerSignal("numIterationsChanged");
+        }
+
+        size_t numIterations() const
+        {
+            return _numIterations.load();
+        }
+
+        void setNumIterations(unsigned numIterations)
+        {
+            _numIterations = numIterations;
+
+            this->emitSignal("numIterationsChanged", numIterations);
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+    protected:
+        void indexFrames(size_t numAvailable) override
+        {
+            _blockStarts.clear();
+            _nextBlockStart = 0;
+            if(_blockStartID.empty()) return;
+
+            for(const auto& label: this->input(0)->labels())
+            {
+                if((label.id == _blockStartID) && (label.index < numAvailable)) _blockStarts.emplace_back(&label);
+            }
+
+            // Labels are almost always in order already.
+            const auto byIndex = [](const Pothos::Label* pLabel0, const Pothos::Label* pLabel1)
+            {
+                return (pLabel0->index < pLabel1->index);
+            };
+            if(!std::is_sorted(_blockStarts.begin(), _blockStarts.end(), byIndex))
+            {
+                std::stable_sort(_blockStarts.begin(), _blockStarts.end(), byIndex);
+            }
+        }
+
+        void findNextFrame(
+            size_t offset,
+            size_t numAvailable,
+            FrameInfo& frameInfoOut) override
+        {
+            // Without a block start ID, decode everything we have as a
+            // single block, as /fec/lte_turbo_decoder does.
+            if(_blockStartID.empty())
+            {
+                if(numAvailable >= (3 * (TURBO_MIN_K + 4)))
+                {
+                    frameInfoOut.inputSize = numAvailable;
+                    frameInfoOut.outputSize = this->_getOutputSize(numAvailable);
+                }
+                return;
+            }
+
+            // Find the first block start at or after the offset. Offsets
+            // only increase within a work() call, so the index is walked once.
+            while((_nextBlockStart < _blockStarts.size()) && (_blockStarts[_nextBlockStart]->index < offset))
+            {
+                ++_nextBlockStart;
+            }
+            const Pothos::Label* pBlockStartLabel = (_nextBlockStart < _blockStarts.size()) ? _blockStarts[_nextBlockStart]
+                                                                                           : nullptr;
+
+            // Nothing in here is part of a block, so it can all be dropped.
+            if(!pBlockStartLabel)
+            {
+                frameInfoOut.skip = numAvailable;
+                return;
+            }
+
+            frameInfoOut.skip = pBlockStartLabel->index - offset;
+
+            // If we have a length, use it.
+            size_t inputSize = numAvailable - frameInfoOut.skip;
+            if(pBlockStartLabel->data.canConvert(typeid(size_t)))
+            {
+                inputSize = pBlockStartLabel->data.convert<size_t>();
+            }
+            if((inputSize < (3 * (TURBO_MIN_K + 4))) ||
+               (calcDecoderOutputSize(inputSize) > TURBO_MAX_K))
+            {
+                throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size. Max block size: " + std::to_string(TURBO_MAX_K));
+            }
+
+            frameInfoOut.inputSize = inputSize;
+            frameInfoOut.outputSize = this->_getOutputSize(inputSize);
+        }
+
+        std::unique_ptr<DecoderFarmWorkerState> makeWorkerState() override
+        {
+            return std::unique_ptr<DecoderFarmWorkerState>(
+                       new LTETurboDecoderFarmWorkerState(_decodeFcn, _numIterations));
+        }
+
+        bool isFramingLabel(const Pothos::Label& label) const override
+        {
+            return (!_blockStartID.empty() && (label.id == _blockStartID));
+        }
+
+        void onFrameEmitted(const DecoderFarmJob& job, size_t outputOffset) override
+        {
+            // Output a start block ID so an encoder can operate on the same data.
+            if(!_blockStartID.empty())
+            {
+                const auto outputSize = calcDecoderOutputSize(job.inputs[0].elements());
+                this->output(0)->postLabel(_blockStartID, outputSize, outputOffset);
+            }
+        }
+
+    private:
+        std::atomic<size_t> _numIterations;
+        bool _unpack;
+        DecodeFcn _decodeFcn;
+
+        std::string _blockStartID;
+
+        // Input 0's block start labels, sorted by index, indexed once per
+        // work() call
+        std::vector<const Pothos::Label*> _blockStarts;
+        size_t _nextBlockStart;
+
+        size_t _getOutputSize(size_t inputSize) const
+        {
+            const auto outputSize = calcDecoderOutputSize(inputSize);
+            return _unpack ? outputSize : (outputSize / 8);
+        }
+};
+
+/*
+ * |PothosDoc LTE Turbo Decoder Farm
+ *
+ * Decodes LTE turbo-coded blocks using a pool of worker threads, each with
+ * its own decoder state, so a single stream can be decoded on multiple cores.
+ * Blocks are dispatched to the workers round-robin through lock-free queues,
+ * and decoded blocks are output in the order they were received.
+ *
+ * Labels within a block are output at the start of the decoded block.
+ *
+ * |category /FEC/Decoders
+ * |keywords coder thread parallel worker
+ * |factory /fec/lte_turbo_decoder_farm(numIterations,unpack,numWorkers)
+ * |setter setNumIterations(numIterations)
+ * |setter setBlockStartID(blockStartID)
+ * |setter setPriority(priority)
+ *
+ * |param numIterations[Num Iterations]
+ * |widget SpinBox(minimum=1)
+ * |default 4
+ * |preview enable
+ *
+ * |param unpack[Unpack?]
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default true
+ * |preview enable
+ *
+ * |param numWorkers[Num Workers]
+ * The number of decoding threads. If 0, one thread per core is used.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param blockStartID[Block Start ID]
+ * The label used by the block to determine the beginning of the block to decode.
+ * This label will be placed at the start of the corresponding decoded block.
+ * If the given string is empty, the block will decode the entire
+ * input buffer at once.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerLTETurboDecoderFarm(
+    "/fec/lte_turbo_decoder_farm",
+    Pothos::Callable(&LTETurboDecoderFarm::make));
@@ -1,6 +1,9 @@
 // Copyright (c) 2020 Nicholas Corgan
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "LabelFramer.hpp"
+#include "LTETurbo.hpp"
+#include "LTETurboRSC.hpp"
 #include "Utility.hpp"
 
 #include <Pothos/Exception.hpp>
@@ -13,7 +16,9 @@ extern "C"
 }
 
 #include <algorithm>
+#include <memory>
 #include <string>
+#include <vector>
 
 constexpr size_t calcOutputSize(size_t inputSize)
 {
@@ -32,7 +37,11 @@ class LTETurboEncoder: public Pothos::Block
             Pothos::Block(),
             _rgen(rgen),
             _gen(gen),
-            _blockStartID()
+            _interleaved(false),
+            _minOutElements(0),
+            _engine("TurboFEC"),
+            _blockStartID(),
+            _blockSize(0)
         {
             this->setupInput(0, "uint8");
 
@@ -44,11 +53,20 @@ class LTETurboEncoder: public Pothos::Block
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, setRGen));
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, gen));
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, setGen));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, streamFormat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, setStreamFormat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, engine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, setEngine));
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, blockStartID));
             this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, blockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(LTETurboEncoder, setBlockSize));
 
             this->registerProbe("rgen");
             this->registerProbe("gen");
+            this->registerProbe("streamFormat");
+            this->registerProbe("engine");
+            this->registerProbe("blockSize");
 
             this->registerSignal("rgenChanged");
             this->registerSignal("genChanged");
@@ -61,6 +79,7 @@ class LTETurboEncoder: public Pothos::Block
 
         void setRGen(unsigned rgen)
         {
+            _rscEncoderUPtr = _makeRSCEncoder(_engine, rgen, _gen);
             _rgen = rgen;
 
             this->emitSignal("rgenChanged", _rgen);
@@ -73,11 +92,44 @@ class LTETurboEncoder: public Pothos::Block
 
         void setGen(unsigned gen)
         {
+            _rscEncoderUPtr = _makeRSCEncoder(_engine, _rgen, gen);
             _gen = gen;
 
             this->emitSignal("genChanged", _gen);
         }
 
+        std::string streamFormat() const
+        {
+            return _interleaved ? "Interleaved" : "Separate";
+        }
+
+        // The outputs in use can't change under a running topology.
+        void setStreamFormat(const std::string& streamFormat)
+        {
+            const bool interleaved = isInterleavedStreamFormat(streamFormat);
+            if(this->isActive())
+            {
+                throw Pothos::IllegalStateException("The stream format can't be changed while the block is active");
+            }
+
+            // TurboFEC outputs the streams apart, so they're interleaved
+            // from here.
+            if(interleaved) _streams.resize(3 * (TURBO_MAX_K + 4));
+
+            _interleaved = interleaved;
+        }
+
+        std::string engine() const
+        {
+            return _engine;
+        }
+
+        void setEngine(const std::string& engine)
+        {
+            _rscEncoderUPtr = _makeRSCEncoder(engine, _rgen, _gen);
+            _engine = engine;
+        }
+
         std::string blockStartID() const
         {
             return _blockStartID;
@@ -88,24 +140,68 @@ class LTETurboEncoder: public Pothos::Block
             _blockStartID = blockStartID;
         }
 
+        size_t blockSize() const
+        {
+            return _blockSize;
+        }
+
+        void setBlockSize(size_t blockSize)
+        {
+            checkFixedBlockSize(blockSize);
+            _blockSize = blockSize;
+        }
+
         void propagateLabels(const Pothos::InputPort* input) override
         {
-            if(!_blockStartID.empty())
+            // The framer set aside the labels to pass on when it scanned.
+            if(_framer.scanned())
+            {
+                _framer.propagateLabels(_outputPorts.data(), _outputPorts.size());
+            }
+            else if(!_blockStartID.empty())
             {
                 // Don't propagate input label.
                 for(const auto& label: input->labels())
                 {
                     if(label.id != _blockStartID)
                     {
-                        for(auto* output: this->outputs()) output->postLabel(label);
+                        for(auto* output: _outputPorts) output->postLabel(label);
                     }
                 }
             }
             else Pothos::Block::propagateLabels(input);
         }
 
+        // Each output port gets its own pool of buffers large enough for the
+        // largest block, allocated once up front, so encoding never has to
+        // allocate output buffers itself. No engine needs aligned output, so
+        // no particular alignment is asked for.
+        Pothos::BufferManager::Sptr getOutputBufferManager(
+            const std::string& name,
+            const std::string& domain) override
+        {
+            if(domain.empty())
+            {
+                Pothos::BufferManagerArgs args;
+                args.bufferSize = calcOutputSize(TURBO_MAX_K);
+
+                return Pothos::BufferManager::make("generic", args);
+            }
+
+            return Pothos::Block::getOutputBufferManager(name, domain);
+        }
+
         void work() override
         {
+            _framer.reset();
+
+            // In the interleaved stream format, outputs 1 and 2 go unused.
+            const auto& outputs = this->outputs();
+            _outputPorts.assign(outputs.begin(), outputs.begin() + (_interleaved ? 1 : 3));
+
+            _minOutElements = _outputPorts[0]->elements();
+            for(const auto* output: _outputPorts) _minOutElements = std::min(_minOutElements, output->elements());
+
             const auto inputSize = this->input(0)->elements();
             if(inputSize < TURBO_MIN_K)
             {
@@ -113,22 +209,51 @@ class LTETurboEncoder: public Pothos::Block
                 return;
             }
 
-            if(_blockStartID.empty()) _work(inputSize);
-            else                      _blockIDWork(inputSize);
+            if(0 != _blockSize)            _blockSizeWork(inputSize);
+            else if(_blockStartID.empty()) _work(inputSize);
+            else                           _blockIDWork(inputSize);
         }
 
     private:
         unsigned _rgen;
         unsigned _gen;
 
+        // If true, the three streams are interleaved on output 0.
+        bool _interleaved;
+        std::vector<std::uint8_t> _streams;
+
+        // The outputs in use for the stream format, and their minimum size
+        std::vector<Pothos::OutputPort*> _outputPorts;
+        size_t _minOutElements;
+
+        std::string _engine;
+
+        // If null, TurboFEC is used.
+        std::unique_ptr<LTETurboRSCEncoder> _rscEncoderUPtr;
+
         std::string _blockStartID;
 
-        // Common code when we've determined our input size.
-        void _work(size_t inputSize)
+        // If nonzero, the input is split into blocks of this size.
+        size_t _blockSize;
+
+        LabelFramer _framer;
+
+        // Returns null for TurboFEC.
+        static std::unique_ptr<LTETurboRSCEncoder> _makeRSCEncoder(
+            const std::string& engine,
+            unsigned rgen,
+            unsigned gen)
         {
-            auto input = this->input(0);
-            const auto& outputs = this->outputs();
+            std::unique_ptr<LTETurboRSCEncoder> rscEncoderUPtr;
+
+            if(("Table" == engine) || ("Bitsliced" == engine)) rscEncoderUPtr.reset(new LTETurboRSCEncoder(rgen, gen));
+            else if("TurboFEC" != engine) throw Pothos::InvalidArgumentException("Invalid engine: "+engine);
 
+            return rscEncoderUPtr;
+        }
+
+        void _turboFECEncode(size_t inputSize, const std::uint8_t* bits, std::uint8_t* const* outputs)
+        {
             // Per TurboFEC's documentation, only a rate of 2 and
             // constraint length of 4 are supported.
             struct lte_turbo_code turboCode =
@@ -140,86 +265,204 @@ class LTETurboEncoder: public Pothos::Block
                 _gen
             };
 
-            const bool mustPostBuffer = (calcOutputSize(inputSize) > this->workInfo().minOutElements);
-
-            std::vector<Pothos::BufferChunk> outputBuffers;
-            for(size_t port = 0; port < 3; ++port)
+            const size_t streamLength = inputSize + 4;
+            std::uint8_t* streams[3];
+            for(size_t stream = 0; stream < 3; ++stream)
             {
-                if(mustPostBuffer) outputBuffers.emplace_back(Pothos::BufferChunk("uint8", calcOutputSize(inputSize)));
-                else               outputBuffers.emplace_back(outputs[0]->buffer());
+                streams[stream] = _interleaved ? (_streams.data() + (stream * streamLength))
+                                               : outputs[stream];
             }
 
             int outSizeOrErr = ::lte_turbo_encode(
                                    &turboCode,
-                                   input->buffer(),
-                                   outputBuffers[0],
-                                   outputBuffers[1],
-                                   outputBuffers[2]);
+                                   bits,
+                                   streams[0],
+                                   streams[1],
+                                   streams[2]);
             throwOnErrCode(outSizeOrErr);
             if(static_cast<size_t>(outSizeOrErr) != calcOutputSize(inputSize))
             {
                 throw Pothos::AssertionViolationException("Output did not match expected length");
             }
 
-            input->consume(inputSize);
-            for(size_t port = 0; port < 3; ++port)
+            if(_interleaved) interleaveStreams(streams, outputs[0], streamLength);
+        }
+
+        // With our own buffer managers, the outputs only lack room if a
+        // downstream block provides the output buffers, in which case we
+        // post our own.
+        void _getOutputBuffers(size_t outputSize, Pothos::BufferChunk* outputBuffersOut, bool* mustPostBufferOut)
+        {
+            const auto& outputs = _outputPorts;
+
+            *mustPostBufferOut = (outputSize > _minOutElements);
+            for(size_t port = 0; port < outputs.size(); ++port)
             {
-                if(mustPostBuffer) outputs[port]->postBuffer(std::move(outputBuffers[port]));
-                else               outputs[port]->produce(outSizeOrErr);
+                if(*mustPostBufferOut) outputBuffersOut[port] = Pothos::BufferChunk("uint8", outputSize);
+                else                   outputBuffersOut[port] = outputs[port]->buffer();
             }
+        }
 
-            // Output a start block ID so an decoder can operate on the same data.
-            if(!_blockStartID.empty()) outputs[0]->postLabel(_blockStartID, outSizeOrErr, 0);
+        void _produce(Pothos::BufferChunk* outputBuffers, size_t outputSize, bool mustPostBuffer)
+        {
+            const auto& outputs = _outputPorts;
+            for(size_t port = 0; port < outputs.size(); ++port)
+            {
+                if(mustPostBuffer) outputs[port]->postBuffer(std::move(outputBuffers[port]));
+                else               outputs[port]->produce(outputSize);
+            }
         }
 
-        void _blockIDWork(size_t maxInputSize)
+        // Encodes numBlocks consecutive blocks of this size into the output
+        // buffers, starting at the given offset. The bitsliced engine encodes
+        // them together, up to as many as it can at once.
+        void _encode(
+            const std::uint8_t* bits,
+            size_t inputSize,
+            size_t numBlocks,
+            Pothos::BufferChunk* outputBuffers,
+            size_t outputOffset)
         {
-            size_t inputSize = maxInputSize;
+            const size_t blockOutputSize = calcOutputSize(inputSize);
+
+            // The in-tree engines write interleaved streams directly.
+            const size_t stride = _interleaved ? 3 : 1;
+
+            size_t block = 0;
+            while(block < numBlocks)
+            {
+                const size_t blockOutputOffset = outputOffset + (block * blockOutputSize);
+
+                std::uint8_t* streams[3];
+                for(size_t stream = 0; stream < 3; ++stream)
+                {
+                    streams[stream] = _interleaved ? (outputBuffers[0].as<std::uint8_t*>() + blockOutputOffset + stream)
+                                                   : (outputBuffers[stream].as<std::uint8_t*>() + blockOutputOffset);
+                }
+
+                const auto* blockBits = bits + (block * inputSize);
+                const size_t numBitslicedBlocks = ("Bitsliced" == _engine) ? std::min((numBlocks - block), size_t(LTETurboRSCEncoder::MaxBitslicedBlocks))
+                                                                           : 1;
+                if(!_rscEncoderUPtr)            _turboFECEncode(inputSize, blockBits, streams);
+                else if(numBitslicedBlocks > 1) _rscEncoderUPtr->encodeBitsliced(inputSize, numBitslicedBlocks, blockBits, streams, stride, blockOutputSize);
+                else                            _rscEncoderUPtr->encode(inputSize, blockBits, streams, stride);
 
+                block += numBitslicedBlocks;
+            }
+        }
+
+        // Common code when we've determined our input size. Encodes numBlocks
+        // consecutive blocks of this size.
+        void _work(size_t inputSize, size_t numBlocks = 1)
+        {
             auto input = this->input(0);
+            const auto& outputs = _outputPorts;
+
+            const size_t blockOutputSize = calcOutputSize(inputSize);
+            const size_t outputSize = numBlocks * blockOutputSize;
+
+            Pothos::BufferChunk outputBuffers[3];
+            bool mustPostBuffer = false;
+            _getOutputBuffers(outputSize, outputBuffers, &mustPostBuffer);
+
+            _encode(input->buffer().as<const std::uint8_t*>(), inputSize, numBlocks, outputBuffers, 0);
 
-            bool blockFound = false;
+            input->consume(numBlocks * inputSize);
+            _produce(outputBuffers, outputSize, mustPostBuffer);
 
-            for(const auto& label: input->labels())
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty())
             {
-                // Skip if we haven't received enough data for this label.
-                if(label.index > maxInputSize) continue;
+                for(size_t block = 0; block < numBlocks; ++block)
+                {
+                    outputs[0]->postLabel(_blockStartID, blockOutputSize, (block * blockOutputSize));
+                }
+            }
+        }
 
-                // Skip if this isn't a block start label.
-                if(label.id != _blockStartID) continue;
+        // Encodes every whole block of the fixed size that fits in the
+        // output, back to back, or at least one.
+        void _blockSizeWork(size_t maxInputSize)
+        {
+            auto input = this->input(0);
+            input->setReserve(_blockSize);
+            if(maxInputSize < _blockSize) return;
+
+            const size_t numBlocks = std::max<size_t>(
+                                         1,
+                                         std::min(
+                                             (maxInputSize / _blockSize),
+                                             (_minOutElements / calcOutputSize(_blockSize))));
+            this->_work(_blockSize, numBlocks);
+        }
+
+        // Encodes every whole labeled block that fits in the output, back to
+        // back, or at least one. Runs of adjacent blocks of the same size are
+        // encoded together.
+        void _blockIDWork(size_t maxInputSize)
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
 
-                // If we have a length, use it.
-                if(label.data.canConvert(typeid(size_t)))
+            _framer.scan(input, _blockStartID, "", maxInputSize);
+            const auto& blocks = _framer.blocks();
+
+            size_t numBlocks = 0;
+            size_t outputSize = 0;
+            for(const auto& block: blocks)
+            {
+                if(block.size > TURBO_MAX_K)
                 {
-                    inputSize = label.data.convert<size_t>();
-                    if(inputSize > TURBO_MAX_K)
-                    {
-                        throw Pothos::InvalidArgumentException("Max block size: " + std::to_string(TURBO_MAX_K));
-                    }
+                    throw Pothos::InvalidArgumentException("Max block size: " + std::to_string(TURBO_MAX_K));
                 }
 
-                // Skip all data before the block starts.
-                if(0 != label.index)
+                const size_t blockOutputSize = calcOutputSize(block.size);
+                if((numBlocks > 0) && ((outputSize + blockOutputSize) > _minOutElements)) break;
+
+                outputSize += blockOutputSize;
+                ++numBlocks;
+            }
+
+            if(0 == numBlocks)
+            {
+                _framer.consume(this->inputs(), 0);
+                return;
+            }
+
+            Pothos::BufferChunk outputBuffers[3];
+            bool mustPostBuffer = false;
+            _getOutputBuffers(outputSize, outputBuffers, &mustPostBuffer);
+
+            const auto* bits = input->buffer().as<const std::uint8_t*>();
+            size_t outputOffset = 0;
+            for(size_t first = 0; first < numBlocks;)
+            {
+                const auto& block = blocks[first];
+
+                size_t last = first;
+                while(((last+1) < numBlocks) &&
+                      (blocks[last+1].size == block.size) &&
+                      (blocks[last+1].offset == (blocks[last].offset + block.size)))
                 {
-                    input->consume(label.index);
-                    input->setReserve(inputSize);
-                    return;
+                    ++last;
                 }
 
-                // If our block starts at the beginning of our buffer, wait until we have
-                // enough data to encode.
-                if(maxInputSize < inputSize)
+                const size_t numAdjacentBlocks = last - first + 1;
+                _encode(bits + block.offset, block.size, numAdjacentBlocks, outputBuffers, outputOffset);
+
+                // Output a start block ID so an decoder can operate on the same data.
+                const size_t blockOutputSize = calcOutputSize(block.size);
+                for(size_t adjacentBlock = 0; adjacentBlock < numAdjacentBlocks; ++adjacentBlock)
                 {
-                    input->setReserve(inputSize);
-                    return;
+                    output->postLabel(_blockStartID, blockOutputSize, outputOffset);
+                    outputOffset += blockOutputSize;
                 }
 
-                blockFound = true;
-                break;
+                first = last + 1;
             }
 
-            if(blockFound) this->_work(inputSize);
-            else           input->consume(maxInputSize);
+            _framer.consume(this->inputs(), numBlocks);
+            _produce(outputBuffers, outputSize, mustPostBuffer);
         }
 };
 
@@ -231,7 +474,10 @@ class LTETurboEncoder: public Pothos::Block
  * |factory /fec/lte_turbo_encoder(rgen,gen)
  * |setter setRGen(rgen)
  * |setter setGen(gen)
+ * |setter setStreamFormat(streamFormat)
+ * |setter setEngine(engine)
  * |setter setBlockStartID(blockStartID)
+ * |setter setBlockSize(blockSize)
  *
  * |param rgen[RGen] Recursive generator polynomial
  * |widget SpinBox(minimum=0,base=8)
@@ -243,6 +489,32 @@ class LTETurboEncoder: public Pothos::Block
  * |default 0
  * |preview enable
  *
+ * |param streamFormat[Stream Format]
+ * How the three encoded streams are output. "Separate" outputs each stream on
+ * its own port. "Interleaved" outputs all three on output 0, as d0[0], d1[0],
+ * d2[0], d0[1], ..., for a decoder with the same stream format, and leaves
+ * outputs 1 and 2 unused. Either way, each block is 3(K+4) elements per port.
+ * This sets up the block's ports, so it can't be changed while the block is
+ * active.
+ * |widget ComboBox(editable=False)
+ * |option [Separate] "Separate"
+ * |option [Interleaved] "Interleaved"
+ * |default "Separate"
+ * |preview enable
+ *
+ * |param engine[Engine]
+ * The encoder implementation. "TurboFEC" uses TurboFEC's encoder. "Table" uses
+ * this module's encoder, which steps each constituent encoder 8 bits at a time
+ * through lookup tables. "Bitsliced" does the same for single blocks, but
+ * encodes up to 64 consecutive blocks of the same size together, one per bit
+ * of each 64-bit word, which is fastest for streams of many blocks.
+ * |widget ComboBox(editable=False)
+ * |option [TurboFEC] "TurboFEC"
+ * |option [Table] "Table"
+ * |option [Bitsliced] "Bitsliced"
+ * |default "TurboFEC"
+ * |preview valid
+ *
  * |param blockStartID[Block Start ID]
  * The label used by the block to determine the beginning of the block to encode.
  * This label will be placed at the start of the corresponding decoded block on
@@ -251,6 +523,16 @@ class LTETurboEncoder: public Pothos::Block
  * |widget LineEdit()
  * |default "START"
  * |preview disable
+ *
+ * |param blockSize[Block Size]
+ * If nonzero, the input is split into consecutive blocks of this many bits,
+ * which must be a valid LTE turbo block size, and block start labels on the
+ * input are ignored. Every whole block available is encoded in one pass, so a
+ * stream of fixed-size blocks needs no labels. Each encoded block still gets a
+ * block start label if the block start ID isn't empty.
+ * |widget SpinBox(minimum=0,maximum=6144)
+ * |default 0
+ * |preview valid
  */
 static Pothos::BlockRegistry registerLTETurboEncoder(
     "/fec/lte_turbo_encoder",
@@ -0,0 +1,31 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "TurboInterleaver.hpp"
+
+#include <cstddef>
+
+// The LTE turbo code's quadratic permutation polynomial (QPP) interleaver
+// (3GPP TS 36.212, section 5.1.3.2.3). Interleaved bit i is input bit
+// ((f1*i) + (f2*i*i)) mod K.
+
+// Returns false if K isn't a valid LTE turbo block size.
+bool getQPPParams(size_t K, size_t* f1Out, size_t* f2Out);
+
+// The number of valid LTE turbo block sizes
+constexpr size_t NumLTETurboBlockSizes = 188;
+
+// Returns K's index among the valid LTE turbo block sizes, smallest first, for
+// tables kept per block size. Throws if K isn't a valid block size.
+size_t getLTETurboBlockSizeIndex(size_t K);
+
+// The inverse of getLTETurboBlockSizeIndex()
+size_t getLTETurboBlockSize(size_t index);
+
+// The permutations for each block size are built on first use, then
+// shared by every coder in the process. Throws if K isn't a valid LTE
+// turbo block size.
+const TurboInterleaver& getQPPInterleaver(size_t K);
+
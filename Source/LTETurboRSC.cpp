@@ -0,0 +1,428 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LTETurboRSC.hpp"
+#include "LTETurboInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Each tail is three steps, each with a systematic and a parity bit.
+static constexpr size_t NumTailBits = 6;
+
+// With this bit of each byte set, 8 bytes of bits can be moved as a word.
+// Like the SIMD code in this module, this assumes a little-endian host.
+static constexpr std::uint64_t ByteLSBs = 0x0101010101010101ULL;
+
+static inline unsigned parityOf(unsigned value)
+{
+    return (value ^ (value >> 1) ^ (value >> 2)) & 1;
+}
+
+// The polynomial's octal digits are its coefficients, D^0 first, so bit
+// (3-i) is D^i's coefficient. Returns the taps on D^1 to D^3 as bits 0-2.
+static unsigned delayTaps(unsigned polynomial)
+{
+    return ((polynomial >> 2) & 1) | (((polynomial >> 1) & 1) << 1) | ((polynomial & 1) << 2);
+}
+
+//
+// Tail bits
+//
+
+// The tail bits go round-robin across the three streams, starting with the
+// first RSC's at K and the second RSC's at K+2 (3GPP TS 36.212, section
+// 5.1.3.2.2).
+static void writeTail(
+    unsigned tailBits,
+    size_t start,
+    std::uint8_t* const* streamsOut,
+    size_t stride)
+{
+    for(size_t bit = 0; bit < NumTailBits; ++bit)
+    {
+        streamsOut[bit % 3][(start + (bit / 3)) * stride] = (tailBits >> bit) & 1;
+    }
+}
+
+static void writeSystematic(
+    const std::uint8_t* bits,
+    size_t K,
+    std::uint8_t* streamOut,
+    size_t stride)
+{
+    for(size_t elem = 0; elem < K; ++elem) streamOut[elem * stride] = bits[elem] & 1;
+}
+
+//
+// Packing
+//
+
+// Packs one bit per byte into bytes, first bit in the LSB. A partial last
+// byte is padded with zeros.
+static void packBitsLSBFirst(const std::uint8_t* bits, size_t K, std::uint8_t* bytesOut)
+{
+    size_t elem = 0;
+
+#if defined(__SSE2__)
+    for(; (elem + 16) <= K; elem += 16)
+    {
+        // Shifting each bit to its byte's MSB lets movemask collect them.
+        const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + elem));
+        const auto mask = _mm_movemask_epi8(_mm_slli_epi16(values, 7));
+
+        bytesOut[elem / 8] = std::uint8_t(mask);
+        bytesOut[(elem / 8) + 1] = std::uint8_t(mask >> 8);
+    }
+#endif
+
+    for(; elem < K; elem += 8)
+    {
+        const size_t numBits = std::min<size_t>(8, (K - elem));
+
+        std::uint8_t value = 0;
+        for(size_t bit = 0; bit < numBits; ++bit) value |= std::uint8_t((bits[elem + bit] & 1) << bit);
+        bytesOut[elem / 8] = value;
+    }
+}
+
+static void packInterleavedBits(
+    const std::uint8_t* bits,
+    const std::uint16_t* indices,
+    size_t K,
+    std::uint8_t* bytesOut)
+{
+    for(size_t elem = 0; elem < K; elem += 8)
+    {
+        const size_t numBits = std::min<size_t>(8, (K - elem));
+
+        std::uint8_t value = 0;
+        for(size_t bit = 0; bit < numBits; ++bit) value |= std::uint8_t((bits[indices[elem + bit]] & 1) << bit);
+        bytesOut[elem / 8] = value;
+    }
+}
+
+//
+// Bitslicing
+//
+
+// Transposes the blocks so bit b of word i is block b's bit i. Each group of
+// 8 blocks is transposed 8 bits at a time, collecting each block's bits in
+// its own bit of every byte. If K isn't a multiple of 8, the last 8 bits
+// are cut short, so blocks are never read past their ends.
+static void bitslice(
+    const std::uint8_t* bits,
+    size_t K,
+    size_t numBlocks,
+    std::uint64_t* wordsOut)
+{
+    std::fill(wordsOut, wordsOut + K, 0);
+
+    for(size_t group = 0; (group * 8) < numBlocks; ++group)
+    {
+        const size_t groupEnd = std::min(numBlocks, ((group + 1) * 8));
+
+        for(size_t elem = 0; elem < K; elem += 8)
+        {
+            const size_t numBits = std::min<size_t>(8, (K - elem));
+
+            std::uint64_t transposed = 0;
+            for(size_t block = group * 8; block < groupEnd; ++block)
+            {
+                std::uint64_t blockBits = 0;
+                std::memcpy(&blockBits, bits + (block * K) + elem, numBits);
+                transposed |= (blockBits & ByteLSBs) << (block % 8);
+            }
+
+            for(size_t byte = 0; byte < numBits; ++byte)
+            {
+                wordsOut[elem + byte] |= ((transposed >> (8 * byte)) & 0xFF) << (8 * group);
+            }
+        }
+    }
+}
+
+// Undoes bitslice() for one stream of each block.
+static void unbitslice(
+    const std::uint64_t* words,
+    size_t K,
+    size_t numBlocks,
+    std::uint8_t* streamOut,
+    size_t stride,
+    size_t blockOffset)
+{
+    for(size_t group = 0; (group * 8) < numBlocks; ++group)
+    {
+        const size_t groupEnd = std::min(numBlocks, ((group + 1) * 8));
+
+        for(size_t elem = 0; elem < K; elem += 8)
+        {
+            const size_t numBits = std::min<size_t>(8, (K - elem));
+
+            std::uint64_t transposed = 0;
+            for(size_t byte = 0; byte < numBits; ++byte)
+            {
+                transposed |= ((words[elem + byte] >> (8 * group)) & 0xFF) << (8 * byte);
+            }
+
+            for(size_t block = group * 8; block < groupEnd; ++block)
+            {
+                const std::uint64_t blockBits = (transposed >> (block % 8)) & ByteLSBs;
+                auto* blockOut = streamOut + (block * blockOffset) + (elem * stride);
+
+                if(1 == stride) std::memcpy(blockOut, &blockBits, numBits);
+                else
+                {
+                    for(size_t bit = 0; bit < numBits; ++bit) blockOut[bit * stride] = (blockBits >> (8 * bit)) & 1;
+                }
+            }
+        }
+    }
+}
+
+//
+// LTETurboRSCEncoder
+//
+
+LTETurboRSCEncoder::LTETurboRSCEncoder(unsigned rgen, unsigned gen, TurboInterleaverFcn interleaverFcn):
+    _rgen(rgen),
+    _gen(gen),
+    _interleaverFcn(interleaverFcn),
+    _stepTable(8 * 256),
+    _feedbackTaps(delayTaps(rgen)),
+    _parityTaps(delayTaps(gen)),
+    _parityFeedback(0 != ((gen >> 3) & 1))
+{
+    if((rgen > 017) || (gen > 017) || (0 == ((rgen >> 3) & 1)))
+    {
+        throw Pothos::InvalidArgumentException(
+                  "The generator polynomials must have a constraint length of 4, with a recursive feedback");
+    }
+
+    // The state holds the last three feedback bits, most recent in bit 0.
+    for(unsigned state = 0; state < 8; ++state)
+    {
+        for(unsigned byte = 0; byte < 256; ++byte)
+        {
+            unsigned nextState = state;
+            unsigned parityBits = 0;
+            for(unsigned bit = 0; bit < 8; ++bit)
+            {
+                const unsigned feedback = ((byte >> bit) & 1) ^ parityOf(nextState & _feedbackTaps);
+                const unsigned parity = (_parityFeedback ? feedback : 0) ^ parityOf(nextState & _parityTaps);
+
+                parityBits |= (parity << bit);
+                nextState = ((nextState << 1) | feedback) & 7;
+            }
+
+            _stepTable[(state * 256) + byte] = std::uint16_t((nextState << 8) | parityBits);
+        }
+
+        // Each tail input cancels the feedback, shifting in zeros.
+        unsigned tailState = state;
+        unsigned tailBits = 0;
+        for(unsigned step = 0; step < 3; ++step)
+        {
+            const unsigned input = parityOf(tailState & _feedbackTaps);
+            const unsigned parity = parityOf(tailState & _parityTaps);
+
+            tailBits |= (input << (2 * step)) | (parity << ((2 * step) + 1));
+            tailState = (tailState << 1) & 7;
+        }
+        _tailTable[state] = std::uint8_t(tailBits);
+    }
+
+    _resize(getLTETurboBlockSize(NumLTETurboBlockSizes - 1));
+}
+
+unsigned LTETurboRSCEncoder::rgen() const
+{
+    return _rgen;
+}
+
+unsigned LTETurboRSCEncoder::gen() const
+{
+    return _gen;
+}
+
+void LTETurboRSCEncoder::encode(
+    size_t K,
+    const std::uint8_t* bits,
+    std::uint8_t* const* streamsOut,
+    size_t stride)
+{
+    const auto& interleaver = _interleaverFcn(K);
+    _resize(K);
+
+    packBitsLSBFirst(bits, K, _packedBits.data());
+    packInterleavedBits(bits, interleaver.forward.data(), K, _packedInterleaved.data());
+
+    writeSystematic(bits, K, streamsOut[0], stride);
+
+    std::uint8_t tails[2];
+    _runRSC(_packedBits.data(), K, streamsOut[1], stride, &tails[0]);
+    _runRSC(_packedInterleaved.data(), K, streamsOut[2], stride, &tails[1]);
+
+    writeTail(tails[0], K, streamsOut, stride);
+    writeTail(tails[1], K+2, streamsOut, stride);
+}
+
+void LTETurboRSCEncoder::encodeBitsliced(
+    size_t K,
+    size_t numBlocks,
+    const std::uint8_t* bits,
+    std::uint8_t* const* streamsOut,
+    size_t stride,
+    size_t blockOffset)
+{
+    if((0 == numBlocks) || (numBlocks > MaxBitslicedBlocks))
+    {
+        throw Pothos::InvalidArgumentException(
+                  "Can only bitslice up to " + std::to_string(MaxBitslicedBlocks) + " blocks");
+    }
+
+    const auto& interleaver = _interleaverFcn(K);
+    _resize(K);
+
+    bitslice(bits, K, numBlocks, _sysWords.data());
+    for(size_t elem = 0; elem < K; ++elem)
+    {
+        _interleavedWords[elem] = _sysWords[interleaver.forward[elem]];
+    }
+
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        writeSystematic(bits + (block * K), K, streamsOut[0] + (block * blockOffset), stride);
+    }
+
+    std::uint64_t tailWords[2][NumTailBits];
+    _runBitslicedRSC(_sysWords.data(), K, _parityWords.data(), tailWords[0]);
+    unbitslice(_parityWords.data(), K, numBlocks, streamsOut[1], stride, blockOffset);
+
+    _runBitslicedRSC(_interleavedWords.data(), K, _parityWords.data(), tailWords[1]);
+    unbitslice(_parityWords.data(), K, numBlocks, streamsOut[2], stride, blockOffset);
+
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        std::uint8_t* const blockStreams[] =
+        {
+            streamsOut[0] + (block * blockOffset),
+            streamsOut[1] + (block * blockOffset),
+            streamsOut[2] + (block * blockOffset)
+        };
+
+        for(size_t rsc = 0; rsc < 2; ++rsc)
+        {
+            unsigned tailBits = 0;
+            for(size_t bit = 0; bit < NumTailBits; ++bit)
+            {
+                tailBits |= unsigned((tailWords[rsc][bit] >> block) & 1) << bit;
+            }
+            writeTail(tailBits, (K + (2 * rsc)), blockStreams, stride);
+        }
+    }
+}
+
+void LTETurboRSCEncoder::_resize(size_t K)
+{
+    if(_sysWords.size() >= K) return;
+
+    _packedBits.resize((K + 7) / 8);
+    _packedInterleaved.resize((K + 7) / 8);
+    _sysWords.resize(K);
+    _interleavedWords.resize(K);
+    _parityWords.resize(K);
+}
+
+void LTETurboRSCEncoder::_runRSC(
+    const std::uint8_t* packedBits,
+    size_t K,
+    std::uint8_t* parityOut,
+    size_t stride,
+    std::uint8_t* tailOut) const
+{
+    unsigned state = 0;
+    for(size_t byte = 0; byte < (K / 8); ++byte)
+    {
+        const auto step = _stepTable[(state * 256) + packedBits[byte]];
+        state = step >> 8;
+
+        auto* byteOut = parityOut + (byte * 8 * stride);
+        for(size_t bit = 0; bit < 8; ++bit) byteOut[bit * stride] = (step >> bit) & 1;
+    }
+
+    // Any bits past the last whole byte are stepped one at a time.
+    for(size_t elem = (K / 8) * 8; elem < K; ++elem)
+    {
+        const unsigned feedback = ((packedBits[elem / 8] >> (elem % 8)) & 1) ^ parityOf(state & _feedbackTaps);
+        const unsigned parity = (_parityFeedback ? feedback : 0) ^ parityOf(state & _parityTaps);
+
+        parityOut[elem * stride] = std::uint8_t(parity);
+        state = ((state << 1) | feedback) & 7;
+    }
+
+    *tailOut = _tailTable[state];
+}
+
+void LTETurboRSCEncoder::_runBitslicedRSC(
+    const std::uint64_t* words,
+    size_t K,
+    std::uint64_t* parityWordsOut,
+    std::uint64_t* tailWordsOut) const
+{
+    // All-ones masks for each tap, so taps are applied without branching
+    const std::uint64_t feedbackMasks[] =
+    {
+        0 - std::uint64_t(_feedbackTaps & 1),
+        0 - std::uint64_t((_feedbackTaps >> 1) & 1),
+        0 - std::uint64_t((_feedbackTaps >> 2) & 1)
+    };
+    const std::uint64_t parityMasks[] =
+    {
+        0 - std::uint64_t(_parityTaps & 1),
+        0 - std::uint64_t((_parityTaps >> 1) & 1),
+        0 - std::uint64_t((_parityTaps >> 2) & 1)
+    };
+    const std::uint64_t parityFeedbackMask = 0 - std::uint64_t(_parityFeedback);
+
+    // The three delay elements, most recent first
+    std::uint64_t s1 = 0;
+    std::uint64_t s2 = 0;
+    std::uint64_t s3 = 0;
+
+    auto feedbackOf = [&]()
+    {
+        return (s1 & feedbackMasks[0]) ^ (s2 & feedbackMasks[1]) ^ (s3 & feedbackMasks[2]);
+    };
+    auto parityOfState = [&]()
+    {
+        return (s1 & parityMasks[0]) ^ (s2 & parityMasks[1]) ^ (s3 & parityMasks[2]);
+    };
+
+    for(size_t elem = 0; elem < K; ++elem)
+    {
+        const std::uint64_t feedback = words[elem] ^ feedbackOf();
+        parityWordsOut[elem] = (feedback & parityFeedbackMask) ^ parityOfState();
+
+        s3 = s2;
+        s2 = s1;
+        s1 = feedback;
+    }
+
+    for(size_t step = 0; step < 3; ++step)
+    {
+        tailWordsOut[2 * step] = feedbackOf();
+        tailWordsOut[(2 * step) + 1] = parityOfState();
+
+        s3 = s2;
+        s2 = s1;
+        s1 = 0;
+    }
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "LTETurboInterleaver.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// An LTE turbo encoder (3GPP TS 36.212, section 5.1.3.2) built on two
+// table-driven recursive systematic convolutional (RSC) encoders. Each RSC
+// steps 8 bits at a time through a (state, input byte) table, and the
+// trellis termination bits come from a table of each state's tail.
+//
+// The bitsliced mode encodes up to 64 blocks of the same size together,
+// with each block in one bit of 64-bit words, so each RSC step is a few
+// bitwise operations for all blocks.
+//
+// Output matches TurboFEC's lte_turbo_encode(): three streams of K+4 bits,
+// the systematic bits and each RSC's parity bits, with the tail bits
+// spread across them. Each stream's elements are stride bytes apart, so
+// the streams can be written interleaved.
+//
+// The UMTS turbo code (3GPP TS 25.212, section 4.2.3.2) has the same
+// constituent encoders, and the same tail bits in the same order, so it's
+// encoded the same way with its own interleaver. Its block sizes needn't be
+// multiples of 8.
+class LTETurboRSCEncoder
+{
+public:
+    static constexpr size_t MaxBitslicedBlocks = 64;
+
+    // The generator polynomials are octal, as for TurboFEC, with a
+    // constraint length of 4. The interleaver defaults to LTE's.
+    LTETurboRSCEncoder(
+        unsigned rgen,
+        unsigned gen,
+        TurboInterleaverFcn interleaverFcn = &getQPPInterleaver);
+
+    unsigned rgen() const;
+
+    unsigned gen() const;
+
+    // Encodes K bits, one per byte.
+    void encode(
+        size_t K,
+        const std::uint8_t* bits,
+        std::uint8_t* const* streamsOut,
+        size_t stride);
+
+    // Encodes numBlocks consecutive blocks of K bits each. Block b's streams
+    // start blockOffset bytes after block (b-1)'s.
+    void encodeBitsliced(
+        size_t K,
+        size_t numBlocks,
+        const std::uint8_t* bits,
+        std::uint8_t* const* streamsOut,
+        size_t stride,
+        size_t blockOffset);
+
+private:
+    unsigned _rgen;
+    unsigned _gen;
+    TurboInterleaverFcn _interleaverFcn;
+
+    // [state][input byte], the next state in bits 8-10 and the parity bits
+    // in bits 0-7, first bit in the LSB
+    std::vector<std::uint16_t> _stepTable;
+
+    // [state], the tail bits x0, z0, x1, z1, x2, z2 in bits 0-5
+    std::uint8_t _tailTable[8];
+
+    // The feedback and parity taps on the three delay elements, most recent
+    // first, and whether the parity includes the feedback bit
+    unsigned _feedbackTaps;
+    unsigned _parityTaps;
+    bool _parityFeedback;
+
+    // Packed or bitsliced scratch space
+    std::vector<std::uint8_t> _packedBits;
+    std::vector<std::uint8_t> _packedInterleaved;
+    std::vector<std::uint64_t> _sysWords;
+    std::vector<std::uint64_t> _interleavedWords;
+    std::vector<std::uint64_t> _parityWords;
+
+    void _resize(size_t K);
+
+    void _runRSC(
+        const std::uint8_t* packedBits,
+        size_t K,
+        std::uint8_t* parityOut,
+        size_t stride,
+        std::uint8_t* tailOut) const;
+
+    void _runBitslicedRSC(
+        const std::uint64_t* words,
+        size_t K,
+        std::uint64_t* parityWordsOut,
+        std::uint64_t* tailWordsOut) const;
+};
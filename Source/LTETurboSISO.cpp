@@ -0,0 +1,1351 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LTETurboSISO.hpp"
+#include "LTETurboInterleaver.hpp"
+#include "Utility.hpp"
+#include "WorkerPool.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+//
+// Trellis
+//
+
+// The constituent encoder's state is its shift register (s1,s2,s3), with s1
+// as the most significant bit. An input bit u produces the feedback bit
+// a = u^s2^s3 and the parity bit z = a^s1^s3, and the next state is
+// (a,s1,s2). Indexing branches by state and feedback bit gives the same
+// shuffles every step.
+
+static constexpr size_t NumStates = 8;
+static constexpr size_t NumTailSteps = 3;
+
+static constexpr int branchInputBit(int state, int feedback)
+{
+    return feedback ^ ((state >> 1) & 1) ^ (state & 1);
+}
+
+static constexpr int branchParityBit(int state, int feedback)
+{
+    return feedback ^ ((state >> 2) & 1) ^ (state & 1);
+}
+
+static constexpr int nextState(int state, int feedback)
+{
+    return (feedback << 2) | (state >> 1);
+}
+
+// Forward: the predecessors of each state are 2*(state&3) and
+// 2*(state&3)+1, with feedback bit state>>2.
+static constexpr int prevState(int state, int pred)
+{
+    return (2 * (state & 3)) + pred;
+}
+
+//
+// Metric types
+//
+
+template <typename T>
+struct MetricTraits;
+
+// Branch inputs are clamped to leave headroom for the state metrics. Each
+// step's branch metrics are within 2*InputMax of each other, and any state
+// can reach any other in three steps, so the spread of the state metrics is
+// at most 6*InputMax.
+template <>
+struct MetricTraits<std::int16_t>
+{
+    static constexpr int InputMax = 2047;
+    static constexpr int Unreachable = -8192;
+
+    // There's room to spare, so state 0's metric is as good as any.
+    static constexpr bool NormalizeToMax = false;
+};
+
+template <>
+struct MetricTraits<std::int8_t>
+{
+    // 6*21 = 126, so normalized against the best state, every metric fits
+    // between -128 and 0 without saturating.
+    static constexpr int InputMax = 21;
+    static constexpr int Unreachable = -128;
+
+    // Normalizing against state 0 would need room both above and below it.
+    static constexpr bool NormalizeToMax = true;
+};
+
+template <typename T>
+static inline T saturate(int value)
+{
+    return static_cast<T>(std::min<int>(
+                              std::max<int>(value, std::numeric_limits<T>::min()),
+                              std::numeric_limits<T>::max()));
+}
+
+template <typename T>
+static inline T adds(T a, T b)
+{
+    return saturate<T>(int(a) + int(b));
+}
+
+template <typename T>
+static inline T subs(T a, T b)
+{
+    return saturate<T>(int(a) - int(b));
+}
+
+static constexpr size_t CorrectionTableSize = 16;
+using CorrectionTable = std::array<std::uint8_t, CorrectionTableSize>;
+
+// Log-MAP correction assumes soft values have 4 units per nat.
+static constexpr double UnitsPerNat = 4.0;
+
+// ln(1+e^-|a-b|), in metric units
+static const CorrectionTable& getCorrectionTable()
+{
+    static const CorrectionTable table = []()
+    {
+        CorrectionTable ret;
+        for(size_t diff = 0; diff < ret.size(); ++diff)
+        {
+            ret[diff] = static_cast<std::uint8_t>(std::lround(
+                            UnitsPerNat * std::log1p(std::exp(-double(diff) / UnitsPerNat))));
+        }
+
+        // Anything past the table gets no correction.
+        ret.back() = 0;
+
+        return ret;
+    }();
+
+    return table;
+}
+
+//
+// Windowing
+//
+
+// The trellis can be split into windows that are decoded independently.
+// Each window's recursions start from uniform state metrics a few steps
+// outside of it, which is enough for them to converge by the time they
+// reach the window. The first window's forward recursion and the last
+// window's backward recursion still start from the known states.
+static constexpr size_t TrainingLength = 32;
+
+struct WindowLayout
+{
+    size_t K;
+    size_t numWindows;
+    size_t windowLength;
+    size_t trainingLength;
+};
+
+static WindowLayout getWindowLayout(size_t K, size_t maxNumWindows)
+{
+    WindowLayout layout;
+    layout.K = K;
+    layout.numWindows = 1;
+
+    // LTE block sizes are multiples of 8, so there's always a usable split
+    // for small powers of two.
+    for(size_t numWindows = std::max<size_t>(maxNumWindows, 1); numWindows > 1; --numWindows)
+    {
+        if((0 == (K % numWindows)) && ((K / numWindows) >= TrainingLength))
+        {
+            layout.numWindows = numWindows;
+            break;
+        }
+    }
+
+    layout.windowLength = K / layout.numWindows;
+    layout.trainingLength = (layout.numWindows > 1) ? TrainingLength : 0;
+
+    return layout;
+}
+
+//
+// Scalar SISO
+//
+
+template <typename T, bool LogMAP>
+static inline T maxStar(T a, T b)
+{
+    T ret = std::max(a, b);
+    if(LogMAP)
+    {
+        const auto diff = std::min<int>(std::abs(int(subs(a, b))), (CorrectionTableSize - 1));
+        ret = adds<T>(ret, static_cast<T>(getCorrectionTable()[diff]));
+    }
+
+    return ret;
+}
+
+template <typename T>
+static inline T branchMetric(int input, int parity, T sys, T par)
+{
+    return adds<T>((input ? sys : T(0)), (parity ? par : T(0)));
+}
+
+// Only state 0 is reachable.
+template <typename T>
+static void startMetrics(T* metrics)
+{
+    std::fill(metrics, metrics+NumStates, T(MetricTraits<T>::Unreachable));
+    metrics[0] = 0;
+}
+
+template <typename T>
+static inline void normalize(T* metrics)
+{
+    const T norm = MetricTraits<T>::NormalizeToMax ? *std::max_element(metrics, metrics+NumStates)
+                                                   : metrics[0];
+    for(size_t state = 0; state < NumStates; ++state) metrics[state] = subs(metrics[state], norm);
+}
+
+template <typename T, bool LogMAP>
+static void forwardStepScalar(T* alpha, T sys, T par)
+{
+    T nextAlpha[NumStates];
+    for(int state = 0; state < int(NumStates); ++state)
+    {
+        const int feedback = state >> 2;
+        T paths[2];
+        for(int pred = 0; pred < 2; ++pred)
+        {
+            const int prev = prevState(state, pred);
+            paths[pred] = adds<T>(
+                              alpha[prev],
+                              branchMetric<T>(
+                                  branchInputBit(prev, feedback),
+                                  branchParityBit(prev, feedback),
+                                  sys,
+                                  par));
+        }
+        nextAlpha[state] = maxStar<T, LogMAP>(paths[0], paths[1]);
+    }
+
+    normalize(nextAlpha);
+    std::copy(nextAlpha, nextAlpha+NumStates, alpha);
+}
+
+// Steps the backward recursion, and if this step's forward state metrics
+// are given, outputs its LLR.
+template <typename T, bool LogMAP>
+static void backwardStepScalar(T* beta, T sys, T par, const T* alpha, std::int16_t* llrOut)
+{
+    T paths[2][NumStates];
+    T llrPaths[2][NumStates];
+    for(int state = 0; state < int(NumStates); ++state)
+    {
+        for(int feedback = 0; feedback < 2; ++feedback)
+        {
+            const T gamma = branchMetric<T>(
+                                branchInputBit(state, feedback),
+                                branchParityBit(state, feedback),
+                                sys,
+                                par);
+            const T nextBeta = beta[nextState(state, feedback)];
+
+            paths[feedback][state] = adds(nextBeta, gamma);
+            if(alpha) llrPaths[feedback][state] = adds(adds(alpha[state], gamma), nextBeta);
+        }
+    }
+
+    if(alpha)
+    {
+        // Sort paths by input bit, then combine them with the same
+        // reduction order as the SIMD implementation.
+        T byInput[2][NumStates];
+        for(int state = 0; state < int(NumStates); ++state)
+        {
+            const int input0 = branchInputBit(state, 0);
+            byInput[input0][state] = llrPaths[0][state];
+            byInput[1-input0][state] = llrPaths[1][state];
+        }
+
+        T maxes[2];
+        for(int input = 0; input < 2; ++input)
+        {
+            T* values = byInput[input];
+            for(int stride = 4; stride > 0; stride /= 2)
+            {
+                for(int state = 0; state < stride; ++state)
+                {
+                    values[state] = maxStar<T, LogMAP>(values[state], values[state ^ stride]);
+                }
+            }
+            maxes[input] = values[0];
+        }
+
+        *llrOut = saturate<std::int16_t>((int(maxes[1]) - int(maxes[0])));
+    }
+
+    for(size_t state = 0; state < NumStates; ++state)
+    {
+        beta[state] = maxStar<T, LogMAP>(paths[0][state], paths[1][state]);
+    }
+    normalize(beta);
+}
+
+// The backward state metrics at the end of the block, from the known end
+// state after the tail
+template <typename T, bool LogMAP>
+static void tailMetrics(size_t K, const T* branchSys, const T* branchParity, T* betaOut)
+{
+    startMetrics(betaOut);
+    for(size_t k = (K + NumTailSteps); k-- > K;)
+    {
+        backwardStepScalar<T, LogMAP>(betaOut, branchSys[k], branchParity[k], nullptr, nullptr);
+    }
+}
+
+template <typename T, bool LogMAP>
+static void runSISOWindowScalar(
+    const WindowLayout& layout,
+    size_t window,
+    const T* branchSys,
+    const T* branchParity,
+    const T* tailBeta,
+    std::int16_t* llrsOut,
+    T* alphas)
+{
+    const size_t windowStart = window * layout.windowLength;
+    const size_t windowEnd = windowStart + layout.windowLength;
+
+    // Forward recursion
+    T alpha[NumStates];
+    if(0 == window) startMetrics(alpha);
+    else
+    {
+        std::fill(alpha, alpha+NumStates, T(0));
+        for(size_t k = (windowStart - layout.trainingLength); k < windowStart; ++k)
+        {
+            forwardStepScalar<T, LogMAP>(alpha, branchSys[k], branchParity[k]);
+        }
+    }
+
+    for(size_t k = windowStart; k < windowEnd; ++k)
+    {
+        std::copy(alpha, alpha+NumStates, alphas + ((k - windowStart) * NumStates));
+        if((k+1) < windowEnd) forwardStepScalar<T, LogMAP>(alpha, branchSys[k], branchParity[k]);
+    }
+
+    // Backward recursion
+    T beta[NumStates];
+    if((layout.numWindows - 1) == window) std::copy(tailBeta, tailBeta+NumStates, beta);
+    else
+    {
+        std::fill(beta, beta+NumStates, T(0));
+        for(size_t k = (windowEnd + layout.trainingLength); k-- > windowEnd;)
+        {
+            backwardStepScalar<T, LogMAP>(beta, branchSys[k], branchParity[k], nullptr, nullptr);
+        }
+    }
+
+    for(size_t k = windowEnd; k-- > windowStart;)
+    {
+        backwardStepScalar<T, LogMAP>(
+            beta,
+            branchSys[k],
+            branchParity[k],
+            alphas + ((k - windowStart) * NumStates),
+            llrsOut + k);
+    }
+}
+
+//
+// SIMD SISO
+//
+
+// The eight states of a window fill eight lanes, so registers with more
+// lanes than that decode several windows side by side, in lockstep.
+
+#if defined(__SSE4_1__)
+
+template <typename T>
+struct SSEOps;
+
+template <>
+struct SSEOps<std::int16_t>
+{
+    using Metric = std::int16_t;
+    using Reg = __m128i;
+    static constexpr size_t WindowsPerReg = 1;
+
+    static Reg set1(std::int16_t value) {return _mm_set1_epi16(value);}
+    static Reg adds(Reg a, Reg b) {return _mm_adds_epi16(a, b);}
+    static Reg subs(Reg a, Reg b) {return _mm_subs_epi16(a, b);}
+    static Reg max(Reg a, Reg b) {return _mm_max_epi16(a, b);}
+    static Reg andReg(Reg a, Reg b) {return _mm_and_si128(a, b);}
+    static Reg blendv(Reg a, Reg b, Reg mask) {return _mm_blendv_epi8(a, b, mask);}
+    static Reg shuffle(Reg a, Reg mask) {return _mm_shuffle_epi8(a, mask);}
+    static Reg load(const void* p) {return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));}
+    static void store(void* p, Reg v) {_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);}
+    static Reg broadcast128(__m128i v) {return v;}
+
+    // The high byte of each index zeroes the high byte of the result.
+    static Reg correction(Reg a, Reg b, Reg table)
+    {
+        const auto diff = _mm_min_epu16(_mm_abs_epi16(_mm_subs_epi16(a, b)), _mm_set1_epi16(CorrectionTableSize - 1));
+        return _mm_shuffle_epi8(table, _mm_or_si128(diff, _mm_set1_epi16(std::int16_t(0x8000))));
+    }
+};
+
+template <>
+struct SSEOps<std::int8_t>
+{
+    using Metric = std::int8_t;
+    using Reg = __m128i;
+    static constexpr size_t WindowsPerReg = 2;
+
+    static Reg set1(std::int8_t value) {return _mm_set1_epi8(value);}
+    static Reg adds(Reg a, Reg b) {return _mm_adds_epi8(a, b);}
+    static Reg subs(Reg a, Reg b) {return _mm_subs_epi8(a, b);}
+    static Reg max(Reg a, Reg b) {return _mm_max_epi8(a, b);}
+    static Reg andReg(Reg a, Reg b) {return _mm_and_si128(a, b);}
+    static Reg blendv(Reg a, Reg b, Reg mask) {return _mm_blendv_epi8(a, b, mask);}
+    static Reg shuffle(Reg a, Reg mask) {return _mm_shuffle_epi8(a, mask);}
+    static Reg load(const void* p) {return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));}
+    static void store(void* p, Reg v) {_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);}
+    static Reg broadcast128(__m128i v) {return v;}
+
+    static Reg correction(Reg a, Reg b, Reg table)
+    {
+        const auto diff = _mm_min_epu8(_mm_abs_epi8(_mm_subs_epi8(a, b)), _mm_set1_epi8(CorrectionTableSize - 1));
+        return _mm_shuffle_epi8(table, diff);
+    }
+};
+
+#if defined(__AVX2__)
+
+template <typename T>
+struct AVX2Ops;
+
+template <>
+struct AVX2Ops<std::int16_t>
+{
+    using Metric = std::int16_t;
+    using Reg = __m256i;
+    static constexpr size_t WindowsPerReg = 2;
+
+    static Reg set1(std::int16_t value) {return _mm256_set1_epi16(value);}
+    static Reg adds(Reg a, Reg b) {return _mm256_adds_epi16(a, b);}
+    static Reg subs(Reg a, Reg b) {return _mm256_subs_epi16(a, b);}
+    static Reg max(Reg a, Reg b) {return _mm256_max_epi16(a, b);}
+    static Reg andReg(Reg a, Reg b) {return _mm256_and_si256(a, b);}
+    static Reg blendv(Reg a, Reg b, Reg mask) {return _mm256_blendv_epi8(a, b, mask);}
+    static Reg shuffle(Reg a, Reg mask) {return _mm256_shuffle_epi8(a, mask);}
+    static Reg load(const void* p) {return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));}
+    static void store(void* p, Reg v) {_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);}
+
+    // Shuffles work within 128-bit halves, so copy small values to both.
+    static Reg broadcast128(__m128i v) {return _mm256_broadcastsi128_si256(v);}
+
+    static Reg correction(Reg a, Reg b, Reg table)
+    {
+        const auto diff = _mm256_min_epu16(_mm256_abs_epi16(_mm256_subs_epi16(a, b)), _mm256_set1_epi16(CorrectionTableSize - 1));
+        return _mm256_shuffle_epi8(table, _mm256_or_si256(diff, _mm256_set1_epi16(std::int16_t(0x8000))));
+    }
+};
+
+template <>
+struct AVX2Ops<std::int8_t>
+{
+    using Metric = std::int8_t;
+    using Reg = __m256i;
+    static constexpr size_t WindowsPerReg = 4;
+
+    static Reg set1(std::int8_t value) {return _mm256_set1_epi8(value);}
+    static Reg adds(Reg a, Reg b) {return _mm256_adds_epi8(a, b);}
+    static Reg subs(Reg a, Reg b) {return _mm256_subs_epi8(a, b);}
+    static Reg max(Reg a, Reg b) {return _mm256_max_epi8(a, b);}
+    static Reg andReg(Reg a, Reg b) {return _mm256_and_si256(a, b);}
+    static Reg blendv(Reg a, Reg b, Reg mask) {return _mm256_blendv_epi8(a, b, mask);}
+    static Reg shuffle(Reg a, Reg mask) {return _mm256_shuffle_epi8(a, mask);}
+    static Reg load(const void* p) {return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));}
+    static void store(void* p, Reg v) {_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);}
+    static Reg broadcast128(__m128i v) {return _mm256_broadcastsi128_si256(v);}
+
+    static Reg correction(Reg a, Reg b, Reg table)
+    {
+        const auto diff = _mm256_min_epu8(_mm256_abs_epi8(_mm256_subs_epi8(a, b)), _mm256_set1_epi8(CorrectionTableSize - 1));
+        return _mm256_shuffle_epi8(table, diff);
+    }
+};
+
+#endif
+
+// The shuffles and branch masks never change, so set them up once.
+template <typename Ops>
+struct SIMDTrellis
+{
+    using T = typename Ops::Metric;
+    using Reg = typename Ops::Reg;
+
+    static constexpr size_t NumLanes = Ops::WindowsPerReg * NumStates;
+    static constexpr size_t NumBytes = NumLanes * sizeof(T);
+
+    // Forward
+    Reg prevShuffle[2];
+    Reg forwardInputMask[2];
+    Reg forwardParityMask[2];
+
+    // Backward
+    Reg nextShuffle[2];
+    Reg backwardInputMask[2];
+    Reg backwardParityMask[2];
+
+    // Horizontal reduction, pairing state i with state i^stride
+    Reg strideShuffle[3];
+
+    Reg broadcastState0;
+
+    // Spreads each window's branch inputs across the window's lanes
+    Reg sysShuffle;
+    Reg parityShuffle;
+
+    // A shuffle mask that moves state indices[i] into state i, within each
+    // window. Shuffles index within 128-bit halves, which windows never
+    // straddle.
+    static Reg shuffleMask(const int* indices)
+    {
+        alignas(32) std::uint8_t mask[NumBytes];
+        for(size_t window = 0; window < Ops::WindowsPerReg; ++window)
+        {
+            for(size_t state = 0; state < NumStates; ++state)
+            {
+                for(size_t byte = 0; byte < sizeof(T); ++byte)
+                {
+                    const size_t dst = (((window * NumStates) + state) * sizeof(T)) + byte;
+                    const size_t src = (((window * NumStates) + indices[state]) * sizeof(T)) + byte;
+                    mask[dst] = static_cast<std::uint8_t>(src % 16);
+                }
+            }
+        }
+        return Ops::load(mask);
+    }
+
+    static Reg laneMask(const bool* lanes)
+    {
+        alignas(32) T mask[NumLanes];
+        for(size_t lane = 0; lane < NumLanes; ++lane) mask[lane] = lanes[lane % NumStates] ? -1 : 0;
+        return Ops::load(mask);
+    }
+
+    // Each step's branch inputs are packed as one value per window for the
+    // systematic stream, then the same for the parity stream.
+    static Reg branchShuffle(size_t stream)
+    {
+        alignas(32) std::uint8_t mask[NumBytes];
+        for(size_t lane = 0; lane < NumLanes; ++lane)
+        {
+            const size_t window = lane / NumStates;
+            for(size_t byte = 0; byte < sizeof(T); ++byte)
+            {
+                mask[(lane * sizeof(T)) + byte] = static_cast<std::uint8_t>(
+                    (((stream * Ops::WindowsPerReg) + window) * sizeof(T)) + byte);
+            }
+        }
+        return Ops::load(mask);
+    }
+
+    SIMDTrellis()
+    {
+        for(int which = 0; which < 2; ++which)
+        {
+            int prevs[NumStates];
+            bool forwardInputs[NumStates];
+            bool forwardParities[NumStates];
+
+            int nexts[NumStates];
+            bool backwardInputs[NumStates];
+            bool backwardParities[NumStates];
+
+            for(int state = 0; state < int(NumStates); ++state)
+            {
+                prevs[state] = prevState(state, which);
+                forwardInputs[state] = (1 == branchInputBit(prevs[state], (state >> 2)));
+                forwardParities[state] = (1 == branchParityBit(prevs[state], (state >> 2)));
+
+                nexts[state] = nextState(state, which);
+                backwardInputs[state] = (1 == branchInputBit(state, which));
+                backwardParities[state] = (1 == branchParityBit(state, which));
+            }
+
+            prevShuffle[which] = shuffleMask(prevs);
+            forwardInputMask[which] = laneMask(forwardInputs);
+            forwardParityMask[which] = laneMask(forwardParities);
+
+            nextShuffle[which] = shuffleMask(nexts);
+            backwardInputMask[which] = laneMask(backwardInputs);
+            backwardParityMask[which] = laneMask(backwardParities);
+        }
+
+        for(int strideIndex = 0; strideIndex < 3; ++strideIndex)
+        {
+            const int stride = 4 >> strideIndex;
+
+            int indices[NumStates];
+            for(int state = 0; state < int(NumStates); ++state) indices[state] = state ^ stride;
+            strideShuffle[strideIndex] = shuffleMask(indices);
+        }
+
+        const int zeros[NumStates] = {0};
+        broadcastState0 = shuffleMask(zeros);
+
+        sysShuffle = branchShuffle(0);
+        parityShuffle = branchShuffle(1);
+    }
+};
+
+template <typename Ops, bool LogMAP>
+static inline typename Ops::Reg maxStarSIMD(
+    typename Ops::Reg a,
+    typename Ops::Reg b,
+    typename Ops::Reg correctionTable)
+{
+    auto ret = Ops::max(a, b);
+    if(LogMAP) ret = Ops::adds(ret, Ops::correction(a, b, correctionTable));
+
+    return ret;
+}
+
+template <typename Ops>
+static inline typename Ops::Reg branchMetricSIMD(
+    typename Ops::Reg inputMask,
+    typename Ops::Reg parityMask,
+    typename Ops::Reg sys,
+    typename Ops::Reg par)
+{
+    return Ops::adds(Ops::andReg(inputMask, sys), Ops::andReg(parityMask, par));
+}
+
+// As with the scalar normalize(), relative to each window's best state, or
+// to its state 0.
+template <typename Ops>
+static inline typename Ops::Reg normalizeSIMD(
+    const SIMDTrellis<Ops>& trellis,
+    typename Ops::Reg metrics)
+{
+    if(MetricTraits<typename Ops::Metric>::NormalizeToMax)
+    {
+        auto best = metrics;
+        for(const auto& strideShuffle: trellis.strideShuffle)
+        {
+            best = Ops::max(best, Ops::shuffle(best, strideShuffle));
+        }
+
+        return Ops::subs(metrics, best);
+    }
+
+    return Ops::subs(metrics, Ops::shuffle(metrics, trellis.broadcastState0));
+}
+
+// Loads one step's packed branch inputs, which fit in 64 bits.
+template <typename Ops>
+static inline __m128i loadBranches(const typename Ops::Metric* branches)
+{
+    std::uint64_t packed = 0;
+    std::memcpy(&packed, branches, (2 * Ops::WindowsPerReg * sizeof(typename Ops::Metric)));
+
+    return _mm_cvtsi64_si128(static_cast<long long>(packed));
+}
+
+template <typename Ops, bool LogMAP>
+static inline typename Ops::Reg forwardStepSIMD(
+    const SIMDTrellis<Ops>& trellis,
+    typename Ops::Reg alpha,
+    const typename Ops::Metric* branches,
+    typename Ops::Reg correctionTable)
+{
+    const auto packed = Ops::broadcast128(loadBranches<Ops>(branches));
+    const auto sys = Ops::shuffle(packed, trellis.sysShuffle);
+    const auto par = Ops::shuffle(packed, trellis.parityShuffle);
+
+    const auto path0 = Ops::adds(
+                           Ops::shuffle(alpha, trellis.prevShuffle[0]),
+                           branchMetricSIMD<Ops>(trellis.forwardInputMask[0], trellis.forwardParityMask[0], sys, par));
+    const auto path1 = Ops::adds(
+                           Ops::shuffle(alpha, trellis.prevShuffle[1]),
+                           branchMetricSIMD<Ops>(trellis.forwardInputMask[1], trellis.forwardParityMask[1], sys, par));
+
+    alpha = maxStarSIMD<Ops, LogMAP>(path0, path1, correctionTable);
+    return normalizeSIMD<Ops>(trellis, alpha);
+}
+
+// Steps the backward recursion, and if this step's forward state metrics
+// are given, outputs the max-star of each window's paths with inputs of 1
+// and 0 to each window's first lane.
+template <typename Ops, bool LogMAP>
+static inline typename Ops::Reg backwardStepSIMD(
+    const SIMDTrellis<Ops>& trellis,
+    typename Ops::Reg beta,
+    const typename Ops::Metric* branches,
+    typename Ops::Reg correctionTable,
+    const typename Ops::Metric* alpha,
+    typename Ops::Metric* onesOut,
+    typename Ops::Metric* zerosOut)
+{
+    const auto packed = Ops::broadcast128(loadBranches<Ops>(branches));
+    const auto sys = Ops::shuffle(packed, trellis.sysShuffle);
+    const auto par = Ops::shuffle(packed, trellis.parityShuffle);
+
+    const auto gamma0 = branchMetricSIMD<Ops>(trellis.backwardInputMask[0], trellis.backwardParityMask[0], sys, par);
+    const auto gamma1 = branchMetricSIMD<Ops>(trellis.backwardInputMask[1], trellis.backwardParityMask[1], sys, par);
+    const auto nextBeta0 = Ops::shuffle(beta, trellis.nextShuffle[0]);
+    const auto nextBeta1 = Ops::shuffle(beta, trellis.nextShuffle[1]);
+
+    if(alpha)
+    {
+        const auto alphaK = Ops::load(alpha);
+        const auto llrPath0 = Ops::adds(Ops::adds(alphaK, gamma0), nextBeta0);
+        const auto llrPath1 = Ops::adds(Ops::adds(alphaK, gamma1), nextBeta1);
+
+        // For each state, exactly one of the two branches has an input of 1.
+        const auto& input0Mask = trellis.backwardInputMask[0];
+        auto ones = Ops::blendv(llrPath1, llrPath0, input0Mask);
+        auto zeros = Ops::blendv(llrPath0, llrPath1, input0Mask);
+
+        for(const auto& strideShuffle: trellis.strideShuffle)
+        {
+            ones = maxStarSIMD<Ops, LogMAP>(ones, Ops::shuffle(ones, strideShuffle), correctionTable);
+            zeros = maxStarSIMD<Ops, LogMAP>(zeros, Ops::shuffle(zeros, strideShuffle), correctionTable);
+        }
+
+        Ops::store(onesOut, ones);
+        Ops::store(zerosOut, zeros);
+    }
+
+    beta = maxStarSIMD<Ops, LogMAP>(
+               Ops::adds(nextBeta0, gamma0),
+               Ops::adds(nextBeta1, gamma1),
+               correctionTable);
+    return normalizeSIMD<Ops>(trellis, beta);
+}
+
+// Decodes the windows in one group. The scratch space holds each step's
+// branch inputs for every window, training steps included, then the
+// forward state metrics.
+template <typename Ops, bool LogMAP>
+static void runSISOGroupSIMD(
+    const WindowLayout& layout,
+    size_t group,
+    const typename Ops::Metric* branchSys,
+    const typename Ops::Metric* branchParity,
+    const typename Ops::Metric* tailBeta,
+    std::int16_t* llrsOut,
+    typename Ops::Metric* scratch)
+{
+    using T = typename Ops::Metric;
+    using Trellis = SIMDTrellis<Ops>;
+
+    static const Trellis trellis;
+
+    constexpr size_t NumWindows = Ops::WindowsPerReg;
+    constexpr size_t NumLanes = Trellis::NumLanes;
+    constexpr size_t StepSize = 2 * NumWindows;
+
+    const size_t windowLength = layout.windowLength;
+    const size_t trainingLength = layout.trainingLength;
+    const size_t numSteps = windowLength + (2 * trainingLength);
+    const size_t firstWindow = group * NumWindows;
+    const size_t lastWindow = layout.numWindows - 1;
+
+    T* branches = scratch;
+    T* alphas = branches + (numSteps * StepSize);
+
+    // Anything past either end of the block, or in a window past the last,
+    // is zero, and its results are never used.
+    const auto numBranchSteps = std::ptrdiff_t(layout.K + NumTailSteps);
+    for(size_t window = 0; window < NumWindows; ++window)
+    {
+        const bool valid = ((firstWindow + window) <= lastWindow);
+        const auto offset = std::ptrdiff_t((firstWindow + window) * windowLength) - std::ptrdiff_t(trainingLength);
+
+        for(size_t step = 0; step < numSteps; ++step)
+        {
+            const auto k = offset + std::ptrdiff_t(step);
+            const bool inBlock = valid && (k >= 0) && (k < numBranchSteps);
+
+            branches[(step * StepSize) + window] = inBlock ? branchSys[k] : T(0);
+            branches[(step * StepSize) + NumWindows + window] = inBlock ? branchParity[k] : T(0);
+        }
+    }
+
+    const auto correctionTable = Ops::broadcast128(
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(getCorrectionTable().data())));
+
+    alignas(32) T lanes[NumLanes];
+    alignas(32) T ones[NumLanes];
+    alignas(32) T zeros[NumLanes];
+
+    // Forward recursion
+    auto alpha = Ops::set1(0);
+    for(size_t step = 0; step < trainingLength; ++step)
+    {
+        alpha = forwardStepSIMD<Ops, LogMAP>(trellis, alpha, branches + (step * StepSize), correctionTable);
+    }
+    if(0 == group)
+    {
+        Ops::store(lanes, alpha);
+        startMetrics(lanes);
+        alpha = Ops::load(lanes);
+    }
+
+    for(size_t pos = 0; pos < windowLength; ++pos)
+    {
+        Ops::store(alphas + (pos * NumLanes), alpha);
+        if((pos+1) < windowLength)
+        {
+            const size_t step = trainingLength + pos;
+            alpha = forwardStepSIMD<Ops, LogMAP>(trellis, alpha, branches + (step * StepSize), correctionTable);
+        }
+    }
+
+    // Backward recursion
+    auto beta = Ops::set1(0);
+    for(size_t step = numSteps; step-- > (trainingLength + windowLength);)
+    {
+        beta = backwardStepSIMD<Ops, LogMAP>(
+                   trellis,
+                   beta,
+                   branches + (step * StepSize),
+                   correctionTable,
+                   nullptr,
+                   nullptr,
+                   nullptr);
+    }
+    if((lastWindow / NumWindows) == group)
+    {
+        Ops::store(lanes, beta);
+        std::copy(tailBeta, tailBeta+NumStates, lanes + ((lastWindow % NumWindows) * NumStates));
+        beta = Ops::load(lanes);
+    }
+
+    for(size_t pos = windowLength; pos-- > 0;)
+    {
+        const size_t step = trainingLength + pos;
+        beta = backwardStepSIMD<Ops, LogMAP>(
+                   trellis,
+                   beta,
+                   branches + (step * StepSize),
+                   correctionTable,
+                   alphas + (pos * NumLanes),
+                   ones,
+                   zeros);
+
+        for(size_t window = 0; (window < NumWindows) && ((firstWindow + window) <= lastWindow); ++window)
+        {
+            const size_t lane = window * NumStates;
+            llrsOut[((firstWindow + window) * windowLength) + pos] = saturate<std::int16_t>((int(ones[lane]) - int(zeros[lane])));
+        }
+    }
+}
+
+#endif
+
+// Runs a SISO pass's window groups, across threads if given a pool.
+template <typename GroupFcn>
+static void runGroups(size_t numGroups, size_t scratchSize, WorkerPool* workerPool, const GroupFcn& groupFcn)
+{
+    if(workerPool)
+    {
+        workerPool->parallelFor(
+            numGroups,
+            [&](size_t group, size_t threadIndex)
+            {
+                groupFcn(group, threadIndex * scratchSize);
+            });
+    }
+    else
+    {
+        for(size_t group = 0; group < numGroups; ++group) groupFcn(group, 0);
+    }
+}
+
+// Wider registers only pay off when there are enough windows to fill them.
+template <typename T>
+static size_t windowsPerGroup(const WindowLayout& layout)
+{
+#if defined(__AVX2__)
+    if(layout.numWindows >= AVX2Ops<T>::WindowsPerReg) return AVX2Ops<T>::WindowsPerReg;
+#endif
+#if defined(__SSE4_1__)
+    (void)layout;
+    return SSEOps<T>::WindowsPerReg;
+#else
+    (void)layout;
+    return 1;
+#endif
+}
+
+template <typename T>
+static size_t groupScratchSize(const WindowLayout& layout)
+{
+#if defined(__SSE4_1__)
+    const size_t numSteps = layout.windowLength + (2 * layout.trainingLength);
+    return windowsPerGroup<T>(layout) * ((2 * numSteps) + (layout.windowLength * NumStates));
+#else
+    return (layout.windowLength * NumStates);
+#endif
+}
+
+template <typename T, bool LogMAP>
+static void runSISO(
+    const WindowLayout& layout,
+    WorkerPool* workerPool,
+    const T* branchSys,
+    const T* branchParity,
+    std::int16_t* llrsOut,
+    T* scratch)
+{
+    T tailBeta[NumStates];
+    tailMetrics<T, LogMAP>(layout.K, branchSys, branchParity, tailBeta);
+
+    const size_t groupSize = windowsPerGroup<T>(layout);
+    const size_t numGroups = (layout.numWindows + groupSize - 1) / groupSize;
+    const size_t scratchSize = groupScratchSize<T>(layout);
+
+#if defined(__SSE4_1__)
+#if defined(__AVX2__)
+    if(AVX2Ops<T>::WindowsPerReg == groupSize)
+    {
+        runGroups(
+            numGroups,
+            scratchSize,
+            workerPool,
+            [&](size_t group, size_t scratchOffset)
+            {
+                runSISOGroupSIMD<AVX2Ops<T>, LogMAP>(
+                    layout, group, branchSys, branchParity, tailBeta, llrsOut, scratch + scratchOffset);
+            });
+        return;
+    }
+#endif
+
+    runGroups(
+        numGroups,
+        scratchSize,
+        workerPool,
+        [&](size_t group, size_t scratchOffset)
+        {
+            runSISOGroupSIMD<SSEOps<T>, LogMAP>(
+                layout, group, branchSys, branchParity, tailBeta, llrsOut, scratch + scratchOffset);
+        });
+#else
+    runGroups(
+        numGroups,
+        scratchSize,
+        workerPool,
+        [&](size_t group, size_t scratchOffset)
+        {
+            runSISOWindowScalar<T, LogMAP>(
+                layout, group, branchSys, branchParity, tailBeta, llrsOut, scratch + scratchOffset);
+        });
+#endif
+}
+
+//
+// Element-wise stages
+//
+
+static void widen(const std::int8_t* in, std::int16_t* out, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + elem));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + elem), _mm256_cvtepi8_epi16(values));
+    }
+#endif
+
+    for(; elem < length; ++elem) out[elem] = in[elem];
+}
+
+static void addSaturate(const std::int16_t* a, const std::int16_t* b, std::int16_t* out, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        const auto aValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + elem));
+        const auto bValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + elem));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + elem), _mm256_adds_epi16(aValues, bValues));
+    }
+#endif
+
+    for(; elem < length; ++elem) out[elem] = adds(a[elem], b[elem]);
+}
+
+// Extrinsic information is what the SISO adds to its input. Max-log-MAP
+// overestimates its reliability, so it's scaled by 0.75. The SISO only saw
+// its systematic input clamped to sysLimit, so that's what's subtracted.
+static void calcExtrinsic(
+    const std::int16_t* llrs,
+    const std::int16_t* branchSys,
+    std::int16_t* out,
+    size_t length,
+    int sysLimit,
+    bool scale)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    const auto minValue = _mm256_set1_epi16(static_cast<std::int16_t>(-sysLimit));
+    const auto maxValue = _mm256_set1_epi16(static_cast<std::int16_t>(sysLimit));
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        const auto llrValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(llrs + elem));
+        auto sysValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(branchSys + elem));
+        sysValues = _mm256_min_epi16(_mm256_max_epi16(sysValues, minValue), maxValue);
+
+        auto extrinsic = _mm256_subs_epi16(llrValues, sysValues);
+        if(scale) extrinsic = _mm256_subs_epi16(extrinsic, _mm256_srai_epi16(extrinsic, 2));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + elem), extrinsic);
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        const auto sys = static_cast<std::int16_t>(std::min<int>(std::max<int>(branchSys[elem], -sysLimit), sysLimit));
+
+        auto extrinsic = subs(llrs[elem], sys);
+        if(scale) extrinsic = subs(extrinsic, static_cast<std::int16_t>(extrinsic >> 2));
+
+        out[elem] = extrinsic;
+    }
+}
+
+// Converts branch inputs to the metric type.
+template <typename T>
+static void toMetric(const std::int16_t* in, T* out, size_t length)
+{
+    using Traits = MetricTraits<T>;
+
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    const auto minValue = _mm256_set1_epi16(-Traits::InputMax);
+    const auto maxValue = _mm256_set1_epi16(Traits::InputMax);
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + elem));
+        values = _mm256_min_epi16(_mm256_max_epi16(values, minValue), maxValue);
+
+        if(std::is_same<T, std::int8_t>::value)
+        {
+            // Packing works within 128-bit lanes, so fix the order afterwards.
+            const auto packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(values, values), 0xD8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + elem), _mm256_castsi256_si128(packed));
+        }
+        else _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + elem), values);
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        out[elem] = static_cast<T>(std::min<int>(
+                                       std::max<int>(in[elem], -Traits::InputMax),
+                                       Traits::InputMax));
+    }
+}
+
+// Returns the smallest |LLR|.
+static int hardDecisions(const std::int16_t* llrs, std::uint8_t* bitsOut, size_t length)
+{
+    int minAbsLLR = std::numeric_limits<std::int16_t>::max();
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    const auto zero = _mm256_setzero_si256();
+    const auto one = _mm256_set1_epi8(1);
+    auto minAbs = _mm256_set1_epi16(std::numeric_limits<std::int16_t>::max());
+    for(; (elem + 32) <= length; elem += 32)
+    {
+        const auto llrs0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(llrs + elem));
+        const auto llrs1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(llrs + elem + 16));
+
+        const auto positive = _mm256_permute4x64_epi64(
+                                  _mm256_packs_epi16(_mm256_cmpgt_epi16(llrs0, zero), _mm256_cmpgt_epi16(llrs1, zero)),
+                                  0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bitsOut + elem), _mm256_and_si256(positive, one));
+
+        // abs(-32768) stays negative as a signed value, so compare unsigned.
+        minAbs = _mm256_min_epu16(minAbs, _mm256_abs_epi16(llrs0));
+        minAbs = _mm256_min_epu16(minAbs, _mm256_abs_epi16(llrs1));
+    }
+
+    alignas(32) std::uint16_t minAbsValues[16];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(minAbsValues), minAbs);
+    for(const auto value: minAbsValues) minAbsLLR = std::min<int>(minAbsLLR, value);
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        bitsOut[elem] = (llrs[elem] > 0) ? 1 : 0;
+        minAbsLLR = std::min<int>(minAbsLLR, std::abs(int(llrs[elem])));
+    }
+
+    return minAbsLLR;
+}
+
+//
+// Decoder
+//
+
+LTETurboSISODecoder::LTETurboSISODecoder(
+    TurboSISOMetric metric,
+    bool logMAP,
+    TurboInterleaverFcn interleaverFcn
+):
+    _metric(metric),
+    _logMAP(logMAP),
+    _interleaverFcn(interleaverFcn),
+    _numWindows(1),
+    _K(0),
+    _pInterleaver(nullptr)
+{
+}
+
+LTETurboSISODecoder::~LTETurboSISODecoder() = default;
+
+TurboSISOMetric LTETurboSISODecoder::metric() const
+{
+    return _metric;
+}
+
+bool LTETurboSISODecoder::logMAP() const
+{
+    return _logMAP;
+}
+
+size_t LTETurboSISODecoder::numWindows() const
+{
+    return _numWindows;
+}
+
+void LTETurboSISODecoder::setNumWindows(size_t numWindows)
+{
+    if(0 == numWindows)
+    {
+        throw Pothos::InvalidArgumentException("The number of windows must be positive");
+    }
+
+    _numWindows = numWindows;
+
+    // Force the scratch space to be resized.
+    _K = 0;
+}
+
+size_t LTETurboSISODecoder::numThreads() const
+{
+    return _workerPoolUPtr ? _workerPoolUPtr->numThreads() : 1;
+}
+
+void LTETurboSISODecoder::setNumThreads(size_t numThreads)
+{
+    if(0 == numThreads)
+    {
+        throw Pothos::InvalidArgumentException("The number of threads must be positive");
+    }
+
+    if(numThreads == this->numThreads()) return;
+
+    _workerPoolUPtr.reset((numThreads > 1) ? new WorkerPool(numThreads) : nullptr);
+    _K = 0;
+}
+
+const std::vector<std::int16_t>& LTETurboSISODecoder::llrs() const
+{
+    return _llrs;
+}
+
+void LTETurboSISODecoder::_setBlockSize(size_t K)
+{
+    if(K == _K) return;
+
+    _pInterleaver = &_interleaverFcn(K);
+
+    // Anything that's permuted needs padding for the gathers.
+    _sys.resize(K + 1);
+    _sysInterleaved.resize(K);
+    _apriori.resize(K);
+    _aprioriInterleaved.resize(K);
+    _extrinsic.resize(K + 1);
+    _branchSys.resize(K + NumTailSteps);
+    _branchParity1.resize(K + NumTailSteps);
+    _branchParity2.resize(K + NumTailSteps);
+    _sisoLLRs.resize(K + 1);
+    _llrs.resize(K);
+
+    // Branch inputs for both streams, then each thread's window scratch space
+    const auto layout = getWindowLayout(K, _numWindows);
+    const size_t branchSize = 2 * (K + NumTailSteps);
+    if(TurboSISOMetric::Int8 == _metric)
+    {
+        _scratch8.resize(branchSize + (numThreads() * groupScratchSize<std::int8_t>(layout)));
+    }
+    else
+    {
+        _scratch16.resize(branchSize + (numThreads() * groupScratchSize<std::int16_t>(layout)));
+    }
+
+    _K = K;
+}
+
+template <typename T>
+static void runSISOWithScratch(
+    const WindowLayout& layout,
+    WorkerPool* workerPool,
+    bool logMAP,
+    const std::int16_t* branchSys,
+    const std::int16_t* branchParity,
+    std::int16_t* llrsOut,
+    T* scratch)
+{
+    const size_t numSteps = layout.K + NumTailSteps;
+
+    T* sys = scratch;
+    T* par = scratch + numSteps;
+    T* groupScratch = scratch + (2 * numSteps);
+
+    toMetric<T>(branchSys, sys, numSteps);
+    toMetric<T>(branchParity, par, numSteps);
+
+    if(logMAP) runSISO<T, true>(layout, workerPool, sys, par, llrsOut, groupScratch);
+    else       runSISO<T, false>(layout, workerPool, sys, par, llrsOut, groupScratch);
+}
+
+void LTETurboSISODecoder::_runSISO(const std::int16_t* branchParity)
+{
+    const auto layout = getWindowLayout(_K, _numWindows);
+
+    if(TurboSISOMetric::Int8 == _metric)
+    {
+        runSISOWithScratch(layout, _workerPoolUPtr.get(), _logMAP, _branchSys.data(), branchParity, _sisoLLRs.data(), _scratch8.data());
+    }
+    else
+    {
+        runSISOWithScratch(layout, _workerPoolUPtr.get(), _logMAP, _branchSys.data(), branchParity, _sisoLLRs.data(), _scratch16.data());
+    }
+}
+
+size_t LTETurboSISODecoder::decode(
+    size_t K,
+    size_t maxIterations,
+    const std::int8_t* d0,
+    const std::int8_t* d1,
+    const std::int8_t* d2,
+    std::uint8_t* bitsOut,
+    const StopFcn& stopFcn)
+{
+    _setBlockSize(K);
+
+    widen(d0, _sys.data(), K);
+    widen(d1, _branchParity1.data(), K);
+    widen(d2, _branchParity2.data(), K);
+
+    return _decode(maxIterations, d0+K, d1+K, d2+K, bitsOut, stopFcn);
+}
+
+size_t LTETurboSISODecoder::decodeInterleaved(
+    size_t K,
+    size_t maxIterations,
+    const std::int8_t* d,
+    std::uint8_t* bitsOut,
+    const StopFcn& stopFcn)
+{
+    _setBlockSize(K);
+
+    // The inputs are split apart as they're widened.
+    std::int16_t* const streams[] = {_sys.data(), _branchParity1.data(), _branchParity2.data()};
+    deinterleaveStreams(d, streams, K);
+
+    // Each input ends with 4 tail soft bits.
+    std::int8_t tails[3][4];
+    std::int8_t* const tailPtrs[] = {tails[0], tails[1], tails[2]};
+    deinterleaveStreams(d + (3*K), tailPtrs, 4);
+
+    return _decode(maxIterations, tails[0], tails[1], tails[2], bitsOut, stopFcn);
+}
+
+size_t LTETurboSISODecoder::_decode(
+    size_t maxIterations,
+    const std::int8_t* tail0,
+    const std::int8_t* tail1,
+    const std::int8_t* tail2,
+    std::uint8_t* bitsOut,
+    const StopFcn& stopFcn)
+{
+    const size_t K = _K;
+
+    permute(_sys.data(), _pInterleaver->forward.data(), _sysInterleaved.data(), K);
+
+    // The tail bits of both encoders are spread across the three streams
+    // (3GPP TS 36.212, section 5.1.3.2.2). UMTS's are in the same order
+    // (3GPP TS 25.212, section 4.2.3.2.2).
+    const std::int16_t tailSys1[] = {tail0[0], tail2[0], tail1[1]};
+    const std::int16_t tailSys2[] = {tail0[2], tail2[2], tail1[3]};
+    const std::int16_t tailParity1[] = {tail1[0], tail0[1], tail2[1]};
+    const std::int16_t tailParity2[] = {tail1[2], tail0[3], tail2[3]};
+    std::copy(tailParity1, tailParity1+NumTailSteps, _branchParity1.begin()+K);
+    std::copy(tailParity2, tailParity2+NumTailSteps, _branchParity2.begin()+K);
+
+    std::fill(_apriori.begin(), _apriori.end(), 0);
+
+    if(0 == maxIterations)
+    {
+        std::copy(_sys.begin(), _sys.begin()+K, _llrs.begin());
+        hardDecisions(_llrs.data(), bitsOut, K);
+        return 0;
+    }
+
+    const bool scaleExtrinsic = !_logMAP;
+    const int sysLimit = (TurboSISOMetric::Int8 == _metric) ? MetricTraits<std::int8_t>::InputMax
+                                                            : MetricTraits<std::int16_t>::InputMax;
+
+    for(size_t iteration = 1; iteration <= maxIterations; ++iteration)
+    {
+        // First decoder, in input order
+        addSaturate(_sys.data(), _apriori.data(), _branchSys.data(), K);
+        std::copy(tailSys1, tailSys1+NumTailSteps, _branchSys.begin()+K);
+
+        _runSISO(_branchParity1.data());
+        calcExtrinsic(_sisoLLRs.data(), _branchSys.data(), _extrinsic.data(), K, sysLimit, scaleExtrinsic);
+
+        // Second decoder, in interleaved order
+        permute(_extrinsic.data(), _pInterleaver->forward.data(), _aprioriInterleaved.data(), K);
+        addSaturate(_sysInterleaved.data(), _aprioriInterleaved.data(), _branchSys.data(), K);
+        std::copy(tailSys2, tailSys2+NumTailSteps, _branchSys.begin()+K);
+
+        _runSISO(_branchParity2.data());
+        calcExtrinsic(_sisoLLRs.data(), _branchSys.data(), _extrinsic.data(), K, sysLimit, scaleExtrinsic);
+
+        // Deinterleaving with the inverse permutation is a gather too.
+        permute(_extrinsic.data(), _pInterleaver->inverse.data(), _apriori.data(), K);
+        permute(_sisoLLRs.data(), _pInterleaver->inverse.data(), _llrs.data(), K);
+
+        const auto minAbsLLR = hardDecisions(_llrs.data(), bitsOut, K);
+        if(stopFcn && stopFcn(iteration, bitsOut, minAbsLLR)) return iteration;
+    }
+
+    return maxIterations;
+}
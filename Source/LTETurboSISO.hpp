@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "LTETurboInterleaver.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+enum class TurboSISOMetric
+{
+    Int16,
+    Int8
+};
+
+class WorkerPool;
+
+// An iterative LTE turbo decoder built on a max-log-MAP soft-in soft-out
+// (SISO) decoder, with optional log-MAP correction. The eight trellis
+// states are processed together in one SSE register, with 16-bit or
+// saturating 8-bit state metrics. Element-wise work between the SISO
+// passes (extrinsic calculation, scaling, hard decisions) uses AVX2 when
+// available.
+//
+// For lower latency on large blocks, each SISO pass can be split into
+// windows, which start their recursions from a short training run instead
+// of the block's ends. Windows fill otherwise idle SIMD lanes, two or four
+// at a time depending on the metric and register widths, and groups of
+// windows can be spread across threads.
+//
+// Soft inputs follow TurboFEC's convention, where a positive value
+// corresponds to a 1 bit.
+//
+// The UMTS turbo code has the same constituent encoders and tail layout,
+// so it's decoded with the same kernels, given its own interleaver.
+class LTETurboSISODecoder
+{
+public:
+    // Called after each full iteration with the decoded bits so far, one
+    // per byte, and the smallest a-posteriori |LLR|. Return true to stop.
+    using StopFcn = std::function<bool(size_t numIterations, const std::uint8_t* bits, int minAbsLLR)>;
+
+    // The interleaver defaults to LTE's.
+    LTETurboSISODecoder(
+        TurboSISOMetric metric,
+        bool logMAP,
+        TurboInterleaverFcn interleaverFcn = &getQPPInterleaver);
+
+    ~LTETurboSISODecoder();
+
+    TurboSISOMetric metric() const;
+
+    bool logMAP() const;
+
+    // The maximum number of windows per block. Fewer are used if the block
+    // size isn't divisible by this, or the windows would be too short.
+    size_t numWindows() const;
+
+    void setNumWindows(size_t numWindows);
+
+    // The number of threads to decode a single block's windows, including
+    // the calling thread
+    size_t numThreads() const;
+
+    void setNumThreads(size_t numThreads);
+
+    // Each input holds K+4 soft bits, laid out as output by the LTE turbo
+    // encoder. The K decoded bits are output one per byte. Returns the
+    // number of iterations run.
+    size_t decode(
+        size_t K,
+        size_t maxIterations,
+        const std::int8_t* d0,
+        const std::int8_t* d1,
+        const std::int8_t* d2,
+        std::uint8_t* bitsOut,
+        const StopFcn& stopFcn = StopFcn());
+
+    // The same, with the three inputs interleaved in one buffer of 3(K+4)
+    // soft bits, as d0[0], d1[0], d2[0], d0[1], ...
+    size_t decodeInterleaved(
+        size_t K,
+        size_t maxIterations,
+        const std::int8_t* d,
+        std::uint8_t* bitsOut,
+        const StopFcn& stopFcn = StopFcn());
+
+    // The a-posteriori LLRs from the last decode, in input order
+    const std::vector<std::int16_t>& llrs() const;
+
+private:
+    TurboSISOMetric _metric;
+    bool _logMAP;
+    TurboInterleaverFcn _interleaverFcn;
+
+    size_t _numWindows;
+    std::unique_ptr<WorkerPool> _workerPoolUPtr;
+
+    size_t _K;
+    const TurboInterleaver* _pInterleaver;
+
+    std::vector<std::int16_t> _sys;
+    std::vector<std::int16_t> _sysInterleaved;
+    std::vector<std::int16_t> _apriori;
+    std::vector<std::int16_t> _aprioriInterleaved;
+    std::vector<std::int16_t> _extrinsic;
+    std::vector<std::int16_t> _branchSys;
+    std::vector<std::int16_t> _branchParity1;
+    std::vector<std::int16_t> _branchParity2;
+    std::vector<std::int16_t> _sisoLLRs;
+    std::vector<std::int16_t> _llrs;
+
+    // Scratch space for the SISO, in the metric's type
+    std::vector<std::int16_t> _scratch16;
+    std::vector<std::int8_t> _scratch8;
+
+    void _setBlockSize(size_t K);
+
+    void _runSISO(const std::int16_t* branchParity);
+
+    // Decodes once the first K soft bits of each input are loaded. Each
+    // tail holds the last 4 soft bits of an input.
+    size_t _decode(
+        size_t maxIterations,
+        const std::int8_t* tail0,
+        const std::int8_t* tail1,
+        const std::int8_t* tail2,
+        std::uint8_t* bitsOut,
+        const StopFcn& stopFcn);
+};
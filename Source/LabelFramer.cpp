@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LabelFramer.hpp"
+
+#include <algorithm>
+
+LabelFramer::LabelFramer():
+    _scanned(false),
+    _numElements(0),
+    _numConsumed(0),
+    _hasPendingBlock(false),
+    _pendingBlock{}
+{
+}
+
+void LabelFramer::reset()
+{
+    _scanned = false;
+    _numElements = 0;
+    _numConsumed = 0;
+    _blockStarts.clear();
+    _blocks.clear();
+    _hasPendingBlock = false;
+    _passThroughLabels.clear();
+}
+
+void LabelFramer::scan(
+    const Pothos::InputPort* input,
+    const std::string& blockStartID,
+    const std::string& otherFramingID,
+    size_t numElements)
+{
+    this->reset();
+    _scanned = true;
+    _numElements = numElements;
+
+    for(const auto& label: input->labels())
+    {
+        if(label.index >= numElements) continue;
+
+        if(label.id == blockStartID)
+        {
+            const size_t size = label.data.canConvert(typeid(size_t)) ? label.data.convert<size_t>() : 0;
+            _blockStarts.push_back(Block{label.index, size});
+        }
+        else if(otherFramingID.empty() || (label.id != otherFramingID))
+        {
+            _passThroughLabels.push_back(label);
+        }
+    }
+
+    // Labels are almost always in order already.
+    const auto byOffset = [](const Block& block0, const Block& block1)
+    {
+        return (block0.offset < block1.offset);
+    };
+    if(!std::is_sorted(_blockStarts.begin(), _blockStarts.end(), byOffset))
+    {
+        std::stable_sort(_blockStarts.begin(), _blockStarts.end(), byOffset);
+    }
+
+    size_t end = 0;
+    for(size_t start = 0; start < _blockStarts.size(); ++start)
+    {
+        auto block = _blockStarts[start];
+        if(block.offset < end) continue;
+
+        if(0 == block.size)
+        {
+            size_t next = start + 1;
+            while((next < _blockStarts.size()) && (_blockStarts[next].offset == block.offset)) ++next;
+
+            block.size = (next < _blockStarts.size()) ? (_blockStarts[next].offset - block.offset)
+                                                      : (numElements - block.offset);
+        }
+
+        if((block.offset + block.size) > numElements)
+        {
+            _hasPendingBlock = true;
+            _pendingBlock = block;
+            break;
+        }
+
+        _blocks.push_back(block);
+        end = block.offset + block.size;
+    }
+}
+
+bool LabelFramer::scanned() const
+{
+    return _scanned;
+}
+
+const std::vector<LabelFramer::Block>& LabelFramer::blocks() const
+{
+    return _blocks;
+}
+
+void LabelFramer::consume(const std::vector<Pothos::InputPort*>& inputs, size_t numBlocks)
+{
+    size_t reserve = 0;
+    if((0 == numBlocks) && !_blocks.empty())
+    {
+        _numConsumed = _blocks[0].offset;
+    }
+    else if(numBlocks < _blocks.size())
+    {
+        const auto& lastBlock = _blocks[numBlocks-1];
+        _numConsumed = lastBlock.offset + lastBlock.size;
+    }
+    else if(_hasPendingBlock)
+    {
+        _numConsumed = _pendingBlock.offset;
+        reserve = _pendingBlock.size;
+    }
+    else _numConsumed = _numElements;
+
+    for(auto* input: inputs)
+    {
+        input->consume(_numConsumed);
+        input->setReserve(reserve);
+    }
+}
+
+void LabelFramer::propagateLabels(Pothos::OutputPort* const* outputs, size_t numOutputs) const
+{
+    for(const auto& label: _passThroughLabels)
+    {
+        if(label.index >= _numConsumed) continue;
+
+        for(size_t output = 0; output < numOutputs; ++output) outputs[output]->postLabel(label);
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <Pothos/Framework.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Frames blocks on an input by their block start labels. Each work() call
+// scans the input's labels once into an index of block starts, sorted by
+// index, so every whole block available can be handled in that call. The
+// labels to pass downstream are set aside in the same scan, so propagating
+// them doesn't scan the labels again.
+//
+// A block start label's data, if any, is its block's size. Without a size,
+// a block runs until the next block start label, or the end of the input.
+class LabelFramer
+{
+public:
+    struct Block
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    LabelFramer();
+
+    // Call at the start of each work() call, so labels from a previous
+    // call's scan aren't propagated.
+    void reset();
+
+    // Scans the labels of the input's first numElements elements. Labels
+    // with the other framing ID, if not empty, are neither framing nor
+    // passed downstream.
+    void scan(
+        const Pothos::InputPort* input,
+        const std::string& blockStartID,
+        const std::string& otherFramingID,
+        size_t numElements);
+
+    bool scanned() const;
+
+    // The whole blocks found, in order. Blocks that start within a previous
+    // block are skipped.
+    const std::vector<Block>& blocks() const;
+
+    // Consumes the inputs through the first numBlocks whole blocks, or up
+    // to the first whole block if numBlocks is 0. Once every whole block is
+    // handled, the inputs are consumed up to the first block that isn't all
+    // here yet, and reserve enough for it, or else up to the end of the
+    // scanned input.
+    void consume(const std::vector<Pothos::InputPort*>& inputs, size_t numBlocks);
+
+    // Posts each set-aside label among the consumed elements to the given
+    // outputs, in one pass.
+    void propagateLabels(Pothos::OutputPort* const* outputs, size_t numOutputs) const;
+
+private:
+    bool _scanned;
+    size_t _numElements;
+    size_t _numConsumed;
+
+    std::vector<Block> _blockStarts;
+    std::vector<Block> _blocks;
+
+    bool _hasPendingBlock;
+    Block _pendingBlock;
+
+    std::vector<Pothos::Label> _passThroughLabels;
+};
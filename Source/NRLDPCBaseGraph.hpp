@@ -0,0 +1,94 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The 5G NR LDPC codes (3GPP TS 38.212, section 5.3.2) are quasi-cyclic:
+// each entry of a base graph is replaced by a Z x Z identity matrix,
+// cyclically shifted by the entry's shift value modulo Z, for a lifting
+// size Z from one of eight sets. Each base graph has columns for the
+// systematic bits, four core parity columns solved together, and an
+// extension parity column for each remaining row, with an identity
+// matrix on that row.
+
+constexpr size_t NumNRLDPCLiftingSizeSets = 8;
+
+constexpr size_t NRLDPCMinLiftingSize = 2;
+constexpr size_t NRLDPCMaxLiftingSize = 384;
+
+// Returns false if Z isn't a lifting size (3GPP TS 38.212, table
+// 5.3.2-1). Otherwise, outputs the index of Z's set, which picks the
+// shift values used.
+bool getNRLDPCLiftingSizeSet(size_t Z, size_t* iLSOut);
+
+// Throws if Z isn't a lifting size.
+void checkNRLDPCLiftingSize(size_t Z);
+
+// A base graph, as laid out in 3GPP TS 38.212, tables 5.3.2-2 (base graph 1)
+// and 5.3.2-3 (base graph 2): each nonzero entry's row, column, and shift
+// value for each lifting size set.
+struct NRLDPCBaseGraph
+{
+    struct Entry
+    {
+        std::uint16_t row;
+        std::uint16_t col;
+        std::uint16_t shifts[NumNRLDPCLiftingSizeSets];
+    };
+
+    // 1 or 2
+    size_t number;
+
+    size_t numRows;
+    size_t numCols;
+
+    // Systematic columns, the first two of which aren't transmitted
+    size_t numInfoCols;
+
+    // In row order
+    std::vector<Entry> entries;
+
+    // The four core parity columns are solved from the first four rows.
+    static constexpr size_t NumCoreRows = 4;
+
+    // Returns base graph 1 or 2. Throws if number is neither.
+    static const NRLDPCBaseGraph& get(size_t number);
+};
+
+// A base graph lifted by Z, in compressed row form. Each row's entries are
+// the columns and shifts of its circulants, where block row r checks that
+// the sum over its entries of column block c, cyclically shifted so that
+// its element (j+shift) mod Z is at position j, is zero.
+struct NRLDPCCode
+{
+    NRLDPCCode(const NRLDPCBaseGraph& baseGraph, size_t Z);
+
+    size_t baseGraph;
+    size_t Z;
+
+    size_t numRows;
+    size_t numCols;
+    size_t numInfoCols;
+
+    // Row r's entries are [rowStarts[r], rowStarts[r+1]).
+    std::vector<size_t> rowStarts;
+    std::vector<std::uint16_t> cols;
+    std::vector<std::uint16_t> shifts;
+
+    // The number of information bits per codeword
+    size_t K() const
+    {
+        return numInfoCols * Z;
+    }
+
+    // The number of codeword bits output, as the first two systematic
+    // columns are punctured
+    size_t N() const
+    {
+        return (numCols - 2) * Z;
+    }
+};
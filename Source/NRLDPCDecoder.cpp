@@ -0,0 +1,399 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DecodeScheduler.hpp"
+#include "NRLDPCBaseGraph.hpp"
+#include "NRLDPCMinSumDecoder.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class NRLDPCDecoder: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make(
+            size_t baseGraph,
+            size_t liftingSize,
+            size_t numIterations,
+            bool unpack)
+        {
+            return new NRLDPCDecoder(baseGraph, liftingSize, numIterations, unpack);
+        }
+
+        NRLDPCDecoder(
+            size_t baseGraph,
+            size_t liftingSize,
+            size_t numIterations,
+            bool unpack
+        ):
+            Pothos::Block(),
+            _minSumDecoder(NRLDPCCode(NRLDPCBaseGraph::get(baseGraph), liftingSize)),
+            _numIterations(numIterations),
+            _unpack(unpack),
+            _earlyTermination(true),
+            _priority(DecodePriority::Normal)
+        {
+            // As with the turbo decoders, uint8 inputs are taken as signed,
+            // for compatibility with the encoder's output.
+            this->setupInput(0, "uint8");
+            this->setupOutput(0, "uint8");
+
+            // Reserve up front, so decoding never allocates.
+            _decodedBits.reserve(numInfoBits());
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, baseGraph));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, liftingSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, numInfoBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, numCodedBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, numIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, setNumIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, variant));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, setVariant));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, offset));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, setOffset));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, earlyTermination));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, setEarlyTermination));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, priority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCDecoder, setPriority));
+
+            this->registerProbe("baseGraph");
+            this->registerProbe("liftingSize");
+            this->registerProbe("numInfoBits");
+            this->registerProbe("numCodedBits");
+            this->registerProbe("numIterations");
+            this->registerProbe("variant");
+            this->registerProbe("offset");
+            this->registerProbe("earlyTermination");
+            this->registerProbe("priority");
+
+            this->registerSignal("numIterationsChanged");
+        }
+
+        size_t baseGraph() const
+        {
+            return _minSumDecoder.code().baseGraph;
+        }
+
+        size_t liftingSize() const
+        {
+            return _minSumDecoder.code().Z;
+        }
+
+        size_t numInfoBits() const
+        {
+            return _minSumDecoder.code().K();
+        }
+
+        size_t numCodedBits() const
+        {
+            return _minSumDecoder.code().N();
+        }
+
+        size_t numIterations() const
+        {
+            return _numIterations;
+        }
+
+        void setNumIterations(unsigned numIterations)
+        {
+            _numIterations = numIterations;
+
+            this->emitSignal("numIterationsChanged", _numIterations);
+        }
+
+        std::string variant() const
+        {
+            return (NRLDPCMinSumVariant::Normalized == _minSumDecoder.variant()) ? "Normalized Min-Sum"
+                                                                                 : "Offset Min-Sum";
+        }
+
+        void setVariant(const std::string& variant)
+        {
+            if("Normalized Min-Sum" == variant)  _minSumDecoder.setVariant(NRLDPCMinSumVariant::Normalized);
+            else if("Offset Min-Sum" == variant) _minSumDecoder.setVariant(NRLDPCMinSumVariant::Offset);
+            else throw Pothos::InvalidArgumentException("Invalid min-sum variant: "+variant);
+        }
+
+        int offset() const
+        {
+            return _minSumDecoder.offset();
+        }
+
+        void setOffset(int offset)
+        {
+            _minSumDecoder.setOffset(offset);
+        }
+
+        bool earlyTermination() const
+        {
+            return _earlyTermination;
+        }
+
+        void setEarlyTermination(bool earlyTermination)
+        {
+            _earlyTermination = earlyTermination;
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+        std::string priority() const
+        {
+            return decodePriorityToString(_priority);
+        }
+
+        void setPriority(const std::string& priority)
+        {
+            _priority = decodePriorityFromString(priority);
+        }
+
+        void propagateLabels(const Pothos::InputPort* input) override
+        {
+            if(!_blockStartID.empty())
+            {
+                // Don't propagate input label.
+                for(const auto& label: input->labels())
+                {
+                    if(label.id != _blockStartID) this->output(0)->postLabel(label);
+                }
+            }
+            else Pothos::Block::propagateLabels(input);
+        }
+
+        // The largest blocks are more than a default buffer's worth, so the
+        // output gets its own pool of buffers large enough for a block.
+        Pothos::BufferManager::Sptr getOutputBufferManager(
+            const std::string& name,
+            const std::string& domain) override
+        {
+            if(domain.empty())
+            {
+                Pothos::BufferManagerArgs args;
+                args.bufferSize = _outputSize(numInfoBits());
+
+                return Pothos::BufferManager::make("generic", args);
+            }
+
+            return Pothos::Block::getOutputBufferManager(name, domain);
+        }
+
+        // Every block has the same size, so every whole block that fits in
+        // the output is decoded, back to back, or at least one.
+        void work() override
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            const size_t N = numCodedBits();
+            const size_t blockOutputSize = _outputSize(numInfoBits());
+
+            input->setReserve(N);
+            const auto elems = this->workInfo().minInElements;
+            if(elems < N)
+            {
+                // We don't have enough data to decode yet.
+                return;
+            }
+
+            const size_t numBlocks = std::max<size_t>(
+                                         1,
+                                         std::min(
+                                             (elems / N),
+                                             (output->elements() / blockOutputSize)));
+            const size_t outputSize = numBlocks * blockOutputSize;
+
+            // With our own buffer manager, the output only lacks room if a
+            // downstream block provides the output buffers, in which case we
+            // post our own.
+            const bool mustPostBuffer = (outputSize > output->elements());
+            auto outputBuffer = mustPostBuffer ? Pothos::BufferChunk("uint8", outputSize)
+                                               : output->buffer();
+
+            for(size_t block = 0; block < numBlocks; ++block)
+            {
+                _decodeBlock(
+                    (block * N),
+                    outputBuffer.as<std::uint8_t*>() + (block * blockOutputSize),
+                    (block * blockOutputSize));
+            }
+
+            input->consume(numBlocks * N);
+            if(mustPostBuffer) output->postBuffer(std::move(outputBuffer));
+            else               output->produce(outputSize);
+        }
+
+    private:
+        NRLDPCMinSumDecoder _minSumDecoder;
+
+        size_t _numIterations;
+        bool _unpack;
+        bool _earlyTermination;
+
+        std::string _blockStartID;
+
+        DecodePriority _priority;
+
+        std::vector<std::uint8_t> _decodedBits;
+
+        // K isn't always a multiple of 8, so a packed block's last byte may
+        // be padded.
+        size_t _outputSize(size_t numBits) const
+        {
+            return _unpack ? numBits : ((numBits + 7) / 8);
+        }
+
+        // Decodes the block at the given input offset into the given output
+        // bytes, labeled at the given output offset.
+        void _decodeBlock(
+            size_t inputOffset,
+            std::uint8_t* outputBytes,
+            size_t outputOffset)
+        {
+            auto output = this->output(0);
+
+            const auto K = numInfoBits();
+            const auto* input = this->input(0)->buffer().as<const std::int8_t*>() + inputOffset;
+
+            std::uint8_t* bits = outputBytes;
+            if(!_unpack)
+            {
+                _decodedBits.resize(K);
+                bits = _decodedBits.data();
+            }
+
+            size_t numIterations = 0;
+            {
+                DecodeScheduler::Slot decodeSlot(_priority);
+                numIterations = _minSumDecoder.decode(input, _numIterations, _earlyTermination, bits);
+            }
+
+            if(!_unpack) packBits(bits, outputBytes, K);
+
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty()) output->postLabel(_blockStartID, _outputSize(K), outputOffset);
+
+            // When stopping early, note how many iterations this block took.
+            if(_earlyTermination) output->postLabel("iterations", numIterations, outputOffset);
+        }
+};
+
+/*
+ * |PothosDoc 5G NR LDPC Decoder
+ *
+ * The 5G NR (3GPP TS 38.212, section 5.3.2) quasi-cyclic LDPC code, for
+ * either base graph and any lifting size Z. This is a layered min-sum
+ * decoder with saturating 8-bit messages: each base graph row is a layer,
+ * whose Z check nodes are updated together, 32 at a time with AVX2, and each
+ * layer uses the bit LLRs updated by the one before it, so it converges in
+ * about half as many iterations as flooding. Each column of bit LLRs is
+ * stored twice in a row, so every circulant's shifted bits are one
+ * contiguous run of unaligned loads.
+ *
+ * Each input block is the encoder's 66Z or 50Z soft bits, as signed 8-bit
+ * values where a positive value corresponds to a 1 bit. Rate recovery is left
+ * to other blocks, so punctured or unknown bits should be zero. The first 2Z
+ * systematic bits, which NR never transmits, are recovered by the decoder.
+ *
+ * Both base graphs are built in, from 38.212's tables 5.3.2-2 and 5.3.2-3,
+ * with the shift values for the lifting size set Z belongs to.
+ *
+ * |category /FEC/Decoders
+ * |keywords coder 5g nr ldpc qc quasi-cyclic min-sum layered
+ * |factory /fec/nr_ldpc_decoder(baseGraph,liftingSize,numIterations,unpack)
+ * |setter setNumIterations(numIterations)
+ * |setter setVariant(variant)
+ * |setter setOffset(offset)
+ * |setter setEarlyTermination(earlyTermination)
+ * |setter setBlockStartID(blockStartID)
+ * |setter setPriority(priority)
+ *
+ * |param baseGraph[Base Graph]
+ * Base graph 1 is for large blocks and high code rates, and base graph 2 for
+ * small blocks and low code rates.
+ * |widget ComboBox(editable=False)
+ * |option [Base Graph 1] 1
+ * |option [Base Graph 2] 2
+ * |default 1
+ * |preview enable
+ *
+ * |param liftingSize[Lifting Size]
+ * The lifting size Z, from 2 to 384, of the form a*2^j, where a is 2, 3, 5,
+ * 7, 9, 11, 13, or 15.
+ * |widget SpinBox(minimum=2,maximum=384)
+ * |default 384
+ * |preview enable
+ *
+ * |param numIterations[Num Iterations]
+ * The maximum number of iterations per block.
+ * |widget SpinBox(minimum=1)
+ * |default 10
+ * |preview enable
+ *
+ * |param unpack[Unpack?]
+ * If false, the decoded bits are packed MSB first, with the last byte padded
+ * with zeros if K isn't a multiple of 8.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default true
+ * |preview enable
+ *
+ * |param variant[Variant]
+ * How check node magnitudes are corrected for min-sum's overestimate.
+ * "Normalized Min-Sum" scales them by 0.75, and "Offset Min-Sum" subtracts
+ * a fixed offset.
+ * |widget ComboBox(editable=False)
+ * |option [Normalized Min-Sum] "Normalized Min-Sum"
+ * |option [Offset Min-Sum] "Offset Min-Sum"
+ * |default "Normalized Min-Sum"
+ * |preview valid
+ *
+ * |param offset[Offset]
+ * For offset min-sum, the amount subtracted from each check node magnitude,
+ * in input units. Check node magnitudes are capped at 31.
+ * |widget SpinBox(minimum=0,maximum=31)
+ * |default 1
+ * |preview valid
+ *
+ * |param earlyTermination[Early Termination?]
+ * If true, decoding a block stops once its hard decisions satisfy every
+ * parity check, and each decoded block gets an "iterations" label with the
+ * number of iterations it took.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default true
+ * |preview valid
+ *
+ * |param blockStartID[Block Start ID]
+ * If not empty, each decoded block gets a label with this ID at its start, and
+ * input labels with this ID are dropped. Every block has the same size, so
+ * input blocks need no labels.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerNRLDPCDecoder(
+    "/fec/nr_ldpc_decoder",
+    Pothos::Callable(&NRLDPCDecoder::make));
@@ -0,0 +1,211 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "NRLDPCBaseGraph.hpp"
+#include "NRLDPCQCEncoder.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <string>
+
+class NRLDPCEncoder: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make(size_t baseGraph, size_t liftingSize)
+        {
+            return new NRLDPCEncoder(baseGraph, liftingSize);
+        }
+
+        NRLDPCEncoder(size_t baseGraph, size_t liftingSize):
+            Pothos::Block(),
+            _qcEncoder(NRLDPCCode(NRLDPCBaseGraph::get(baseGraph), liftingSize)),
+            _blockStartID()
+        {
+            this->setupInput(0, "uint8");
+            this->setupOutput(0, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCEncoder, baseGraph));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCEncoder, liftingSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCEncoder, numInfoBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCEncoder, numCodedBits));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCEncoder, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NRLDPCEncoder, setBlockStartID));
+
+            this->registerProbe("baseGraph");
+            this->registerProbe("liftingSize");
+            this->registerProbe("numInfoBits");
+            this->registerProbe("numCodedBits");
+        }
+
+        size_t baseGraph() const
+        {
+            return _qcEncoder.code().baseGraph;
+        }
+
+        size_t liftingSize() const
+        {
+            return _qcEncoder.code().Z;
+        }
+
+        size_t numInfoBits() const
+        {
+            return _qcEncoder.code().K();
+        }
+
+        size_t numCodedBits() const
+        {
+            return _qcEncoder.code().N();
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+        void propagateLabels(const Pothos::InputPort* input) override
+        {
+            if(!_blockStartID.empty())
+            {
+                // Don't propagate input label.
+                for(const auto& label: input->labels())
+                {
+                    if(label.id != _blockStartID) this->output(0)->postLabel(label);
+                }
+            }
+            else Pothos::Block::propagateLabels(input);
+        }
+
+        // As with the turbo encoders, the output gets its own pool of
+        // buffers large enough for a block.
+        Pothos::BufferManager::Sptr getOutputBufferManager(
+            const std::string& name,
+            const std::string& domain) override
+        {
+            if(domain.empty())
+            {
+                Pothos::BufferManagerArgs args;
+                args.bufferSize = numCodedBits();
+
+                return Pothos::BufferManager::make("generic", args);
+            }
+
+            return Pothos::Block::getOutputBufferManager(name, domain);
+        }
+
+        // Every block has the same size, so every whole block that fits in
+        // the output is encoded, back to back, or at least one.
+        void work() override
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            const size_t K = numInfoBits();
+            const size_t N = numCodedBits();
+
+            input->setReserve(K);
+            const auto inputSize = input->elements();
+            if(inputSize < K)
+            {
+                // We don't have enough data to encode yet.
+                return;
+            }
+
+            const size_t numBlocks = std::max<size_t>(
+                                         1,
+                                         std::min(
+                                             (inputSize / K),
+                                             (this->workInfo().minOutElements / N)));
+            const size_t outputSize = numBlocks * N;
+
+            // With our own buffer manager, the output only lacks room if a
+            // downstream block provides the output buffers, in which case we
+            // post our own.
+            const bool mustPostBuffer = (outputSize > this->workInfo().minOutElements);
+            auto outputBuffer = mustPostBuffer ? Pothos::BufferChunk("uint8", outputSize)
+                                               : output->buffer();
+
+            const auto* bits = input->buffer().as<const std::uint8_t*>();
+            for(size_t block = 0; block < numBlocks; ++block)
+            {
+                _qcEncoder.encode(
+                    bits + (block * K),
+                    outputBuffer.as<std::uint8_t*>() + (block * N));
+            }
+
+            input->consume(numBlocks * K);
+            if(mustPostBuffer) output->postBuffer(std::move(outputBuffer));
+            else               output->produce(outputSize);
+
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty())
+            {
+                for(size_t block = 0; block < numBlocks; ++block)
+                {
+                    output->postLabel(_blockStartID, N, (block * N));
+                }
+            }
+        }
+
+    private:
+        NRLDPCQCEncoder _qcEncoder;
+
+        std::string _blockStartID;
+};
+
+/*
+ * |PothosDoc 5G NR LDPC Encoder
+ *
+ * The 5G NR (3GPP TS 38.212, section 5.3.2) quasi-cyclic LDPC code, for
+ * either base graph and any lifting size Z. Each block of K information bits
+ * is encoded a Z x Z circulant at a time, with each cyclic shift a
+ * vectorized XOR over a copy of the column stored twice in a row, in place
+ * of a bitwise parity check matrix.
+ *
+ * Base graph 1 has 22 information columns and 68 columns in all, and base
+ * graph 2 has 10 and 52, so K is 22Z or 10Z, and each codeword is output as
+ * 66Z or 50Z bits, without the first 2Z systematic bits, which NR never
+ * transmits. Rate matching and filler bits are left to other blocks.
+ *
+ * Both base graphs are built in, from 38.212's tables 5.3.2-2 and 5.3.2-3,
+ * with the shift values for the lifting size set Z belongs to.
+ *
+ * |category /FEC/Encoders
+ * |keywords coder 5g nr ldpc qc quasi-cyclic
+ * |factory /fec/nr_ldpc_encoder(baseGraph,liftingSize)
+ * |setter setBlockStartID(blockStartID)
+ *
+ * |param baseGraph[Base Graph]
+ * Base graph 1 is for large blocks and high code rates, and base graph 2 for
+ * small blocks and low code rates.
+ * |widget ComboBox(editable=False)
+ * |option [Base Graph 1] 1
+ * |option [Base Graph 2] 2
+ * |default 1
+ * |preview enable
+ *
+ * |param liftingSize[Lifting Size]
+ * The lifting size Z, from 2 to 384, of the form a*2^j, where a is 2, 3, 5,
+ * 7, 9, 11, 13, or 15.
+ * |widget SpinBox(minimum=2,maximum=384)
+ * |default 384
+ * |preview enable
+ *
+ * |param blockStartID[Block Start ID]
+ * If not empty, each encoded block gets a label with this ID at its start, and
+ * input labels with this ID are dropped. Every block has the same size, so
+ * input blocks need no labels.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ */
+static Pothos::BlockRegistry registerNRLDPCEncoder(
+    "/fec/nr_ldpc_encoder",
+    Pothos::Callable(&NRLDPCEncoder::make));
@@ -0,0 +1,379 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "NRLDPCMinSumDecoder.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Layers are processed a register of check nodes at a time.
+static constexpr size_t ChunkSize = 32;
+
+// Leaves -128 unused, so every magnitude fits.
+static constexpr int MaxLLR = 127;
+
+// Check-to-bit magnitudes are capped well below the bit LLRs'. Otherwise, a
+// saturated bit LLR loses what its messages added, and subtracting them back
+// out in the next iteration can flip confident bits.
+static constexpr int MaxMessage = 31;
+
+// A row has at most one circulant per column, and base graph 1 has the most.
+static constexpr size_t MaxRowDegree = 68;
+
+static inline size_t roundUp(size_t value, size_t multiple)
+{
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+static inline std::int8_t* alignedData(std::vector<std::int8_t>& storage)
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+    return storage.data() + (roundUp(address, ChunkSize) - address);
+}
+
+static inline std::int8_t saturate(int value)
+{
+    return static_cast<std::int8_t>(std::min(std::max(value, -128), 127));
+}
+
+//
+// Layer kernels
+//
+
+// Each circulant of a layer has a pointer to its shifted bit LLRs, its
+// check-to-bit messages, and where its updated bit LLRs go.
+struct LayerPointers
+{
+    const std::int8_t* llrs;
+    std::int8_t* messages;
+    std::int8_t* updated;
+};
+
+#if defined(__AVX2__)
+
+static void updateChunk(
+    const LayerPointers* circulants,
+    size_t degree,
+    size_t offset,
+    NRLDPCMinSumVariant variant,
+    int minSumOffset,
+    std::int8_t* bitToCheck)
+{
+    const auto minLLR = _mm256_set1_epi8(-MaxLLR);
+
+    auto min1 = _mm256_set1_epi8(MaxMessage);
+    auto min2 = _mm256_set1_epi8(MaxMessage);
+    auto minIndex = _mm256_setzero_si256();
+    auto signs = _mm256_setzero_si256();
+
+    // Bit-to-check messages, and the two smallest magnitudes and the sign
+    // of their product
+    for(size_t circulant = 0; circulant < degree; ++circulant)
+    {
+        const auto& pointers = circulants[circulant];
+        const auto llrs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pointers.llrs + offset));
+        const auto messages = _mm256_load_si256(reinterpret_cast<const __m256i*>(pointers.messages + offset));
+
+        const auto values = _mm256_max_epi8(_mm256_subs_epi8(llrs, messages), minLLR);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bitToCheck + (circulant * ChunkSize)), values);
+
+        const auto magnitudes = _mm256_abs_epi8(values);
+        const auto isNewMin = _mm256_cmpgt_epi8(min1, magnitudes);
+
+        min2 = _mm256_min_epi8(min2, _mm256_max_epi8(min1, magnitudes));
+        min1 = _mm256_min_epi8(min1, magnitudes);
+        minIndex = _mm256_blendv_epi8(minIndex, _mm256_set1_epi8(std::int8_t(circulant)), isNewMin);
+        signs = _mm256_xor_si256(signs, values);
+    }
+
+    if(NRLDPCMinSumVariant::Normalized == variant)
+    {
+        // 0.75x = x/2 + x/4, with shifts on 16-bit lanes masked to bytes.
+        auto scale = [](__m256i magnitudes)
+        {
+            return _mm256_add_epi8(
+                       _mm256_and_si256(_mm256_srli_epi16(magnitudes, 1), _mm256_set1_epi8(0x7F)),
+                       _mm256_and_si256(_mm256_srli_epi16(magnitudes, 2), _mm256_set1_epi8(0x3F)));
+        };
+        min1 = scale(min1);
+        min2 = scale(min2);
+    }
+    else
+    {
+        const auto offsets = _mm256_set1_epi8(std::int8_t(minSumOffset));
+        min1 = _mm256_subs_epu8(min1, offsets);
+        min2 = _mm256_subs_epu8(min2, offsets);
+    }
+
+    // Check-to-bit messages exclude each bit's own message.
+    const auto one = _mm256_set1_epi8(1);
+    for(size_t circulant = 0; circulant < degree; ++circulant)
+    {
+        const auto& pointers = circulants[circulant];
+        const auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitToCheck + (circulant * ChunkSize)));
+
+        const auto isMin = _mm256_cmpeq_epi8(minIndex, _mm256_set1_epi8(std::int8_t(circulant)));
+        const auto magnitudes = _mm256_blendv_epi8(min1, min2, isMin);
+
+        // The sign input is never zero, so the magnitude is never zeroed.
+        const auto messages = _mm256_sign_epi8(magnitudes, _mm256_or_si256(_mm256_xor_si256(signs, values), one));
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(pointers.messages + offset), messages);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(pointers.updated + offset), _mm256_adds_epi8(values, messages));
+    }
+}
+
+#else
+
+static void updateChunk(
+    const LayerPointers* circulants,
+    size_t degree,
+    size_t offset,
+    NRLDPCMinSumVariant variant,
+    int minSumOffset,
+    std::int8_t* bitToCheck)
+{
+    for(size_t lane = offset; lane < (offset + ChunkSize); ++lane)
+    {
+        int min1 = MaxMessage, min2 = MaxMessage;
+        size_t minIndex = 0;
+        bool negative = false;
+
+        for(size_t circulant = 0; circulant < degree; ++circulant)
+        {
+            const auto& pointers = circulants[circulant];
+            const int value = std::max<int>(saturate(pointers.llrs[lane] - pointers.messages[lane]), -MaxLLR);
+            bitToCheck[circulant] = std::int8_t(value);
+
+            const int magnitude = std::abs(value);
+            if(magnitude < min1) minIndex = circulant;
+
+            min2 = std::min(min2, std::max(min1, magnitude));
+            min1 = std::min(min1, magnitude);
+            negative ^= (value < 0);
+        }
+
+        if(NRLDPCMinSumVariant::Normalized == variant)
+        {
+            min1 = (min1 >> 1) + (min1 >> 2);
+            min2 = (min2 >> 1) + (min2 >> 2);
+        }
+        else
+        {
+            min1 = std::max(min1 - minSumOffset, 0);
+            min2 = std::max(min2 - minSumOffset, 0);
+        }
+
+        for(size_t circulant = 0; circulant < degree; ++circulant)
+        {
+            const auto& pointers = circulants[circulant];
+            const int value = bitToCheck[circulant];
+
+            const int magnitude = (circulant == minIndex) ? min2 : min1;
+            const int message = (negative != (value < 0)) ? -magnitude : magnitude;
+
+            pointers.messages[lane] = std::int8_t(message);
+            pointers.updated[lane] = saturate(value + message);
+        }
+    }
+}
+
+#endif
+
+//
+// Decoder
+//
+
+NRLDPCMinSumDecoder::NRLDPCMinSumDecoder(const NRLDPCCode& code):
+    _code(code),
+    _variant(NRLDPCMinSumVariant::Normalized),
+    _offset(1),
+    _paddedZ(roundUp(code.Z, ChunkSize)),
+    _columnStride(roundUp((2 * code.Z) + ChunkSize, ChunkSize)),
+    _maxRowDegree(0),
+    _parityChecksPassed(false)
+{
+    for(size_t row = 0; row < _code.numRows; ++row)
+    {
+        _maxRowDegree = std::max(_maxRowDegree, (_code.rowStarts[row+1] - _code.rowStarts[row]));
+    }
+
+    // Allocate up front, so decoding never allocates.
+    _llrStorage.resize((_code.numCols * _columnStride) + ChunkSize);
+    _llrs = alignedData(_llrStorage);
+
+    _messageStorage.resize((_code.cols.size() * _paddedZ) + ChunkSize);
+    _messages = alignedData(_messageStorage);
+
+    _updatedStorage.resize((_maxRowDegree * _paddedZ) + ChunkSize);
+    _updated = alignedData(_updatedStorage);
+
+    _bitToCheck.resize(_maxRowDegree * ChunkSize);
+}
+
+const NRLDPCCode& NRLDPCMinSumDecoder::code() const
+{
+    return _code;
+}
+
+NRLDPCMinSumVariant NRLDPCMinSumDecoder::variant() const
+{
+    return _variant;
+}
+
+void NRLDPCMinSumDecoder::setVariant(NRLDPCMinSumVariant variant)
+{
+    _variant = variant;
+}
+
+int NRLDPCMinSumDecoder::offset() const
+{
+    return _offset;
+}
+
+void NRLDPCMinSumDecoder::setOffset(int offset)
+{
+    if((offset < 0) || (offset > MaxMessage))
+    {
+        throw Pothos::InvalidArgumentException("Min-sum offset must be from 0 to "+std::to_string(MaxMessage));
+    }
+
+    _offset = offset;
+}
+
+bool NRLDPCMinSumDecoder::parityChecksPassed() const
+{
+    return _parityChecksPassed;
+}
+
+std::int8_t* NRLDPCMinSumDecoder::_column(size_t col)
+{
+    return _llrs + (col * _columnStride);
+}
+
+void NRLDPCMinSumDecoder::_updateLayer(size_t row)
+{
+    const size_t Z = _code.Z;
+    const size_t firstEntry = _code.rowStarts[row];
+    const size_t degree = _code.rowStarts[row+1] - firstEntry;
+
+    LayerPointers circulants[MaxRowDegree];
+    for(size_t circulant = 0; circulant < degree; ++circulant)
+    {
+        const size_t entry = firstEntry + circulant;
+        circulants[circulant].llrs = _column(_code.cols[entry]) + _code.shifts[entry];
+        circulants[circulant].messages = _messages + (entry * _paddedZ);
+        circulants[circulant].updated = _updated + (circulant * _paddedZ);
+    }
+
+    for(size_t offset = 0; offset < _paddedZ; offset += ChunkSize)
+    {
+        updateChunk(circulants, degree, offset, _variant, _offset, _bitToCheck.data());
+    }
+
+    // Every lane has been read, so the updated LLRs can go back, unshifted,
+    // as the encoder sets its columns.
+    for(size_t circulant = 0; circulant < degree; ++circulant)
+    {
+        const size_t entry = firstEntry + circulant;
+        const size_t shift = _code.shifts[entry];
+        auto* column = _column(_code.cols[entry]);
+
+        std::memcpy(column + shift, circulants[circulant].updated, Z);
+        std::memcpy(column, column + Z, shift);
+        std::memcpy(column + shift + Z, column + shift, Z - shift);
+    }
+}
+
+bool NRLDPCMinSumDecoder::_checkParity()
+{
+    const size_t Z = _code.Z;
+
+    for(size_t row = 0; row < _code.numRows; ++row)
+    {
+        for(size_t offset = 0; offset < Z; offset += ChunkSize)
+        {
+            const size_t numLanes = std::min(ChunkSize, (Z - offset));
+
+#if defined(__AVX2__)
+            const auto zero = _mm256_setzero_si256();
+            auto parity = _mm256_setzero_si256();
+            for(size_t entry = _code.rowStarts[row]; entry < _code.rowStarts[row+1]; ++entry)
+            {
+                const auto* llrs = _column(_code.cols[entry]) + _code.shifts[entry] + offset;
+                const auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(llrs));
+                parity = _mm256_xor_si256(parity, _mm256_cmpgt_epi8(zero, values));
+            }
+
+            auto failed = std::uint32_t(_mm256_movemask_epi8(parity));
+            if(numLanes < ChunkSize) failed &= ((std::uint32_t(1) << numLanes) - 1);
+            if(0 != failed) return false;
+#else
+            for(size_t lane = offset; lane < (offset + numLanes); ++lane)
+            {
+                bool parity = false;
+                for(size_t entry = _code.rowStarts[row]; entry < _code.rowStarts[row+1]; ++entry)
+                {
+                    parity ^= (_column(_code.cols[entry])[_code.shifts[entry] + lane] < 0);
+                }
+
+                if(parity) return false;
+            }
+#endif
+        }
+    }
+
+    return true;
+}
+
+size_t NRLDPCMinSumDecoder::decode(
+    const std::int8_t* in,
+    size_t maxIterations,
+    bool earlyTermination,
+    std::uint8_t* bitsOut)
+{
+    const size_t Z = _code.Z;
+
+    // The first two columns aren't transmitted, so nothing is known of them.
+    // The rest are negated, so a positive LLR corresponds to a 0 bit, and a
+    // check's messages take the sign of the product of its bits' signs.
+    std::fill(_llrStorage.begin(), _llrStorage.end(), 0);
+    for(size_t col = 2; col < _code.numCols; ++col)
+    {
+        auto* column = _column(col);
+        const auto* colInput = in + ((col - 2) * Z);
+        for(size_t elem = 0; elem < Z; ++elem)
+        {
+            column[elem] = std::int8_t(-std::max<int>(colInput[elem], -MaxLLR));
+        }
+        std::memcpy(column + Z, column, Z);
+    }
+
+    std::fill(_messageStorage.begin(), _messageStorage.end(), 0);
+
+    size_t iteration = 0;
+    _parityChecksPassed = false;
+    while(iteration < maxIterations)
+    {
+        ++iteration;
+        for(size_t row = 0; row < _code.numRows; ++row) _updateLayer(row);
+
+        if(earlyTermination && (_parityChecksPassed = _checkParity())) break;
+    }
+    if(!earlyTermination) _parityChecksPassed = _checkParity();
+
+    for(size_t col = 0; col < _code.numInfoCols; ++col)
+    {
+        const auto* column = _column(col);
+        for(size_t elem = 0; elem < Z; ++elem) bitsOut[(col * Z) + elem] = (column[elem] < 0) ? 1 : 0;
+    }
+
+    return iteration;
+}
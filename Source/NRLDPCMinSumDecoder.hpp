@@ -0,0 +1,98 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "NRLDPCBaseGraph.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class NRLDPCMinSumVariant
+{
+    // Check node magnitudes are scaled by 0.75.
+    Normalized,
+
+    // Check node magnitudes are reduced by a fixed offset.
+    Offset
+};
+
+// A layered min-sum 5G NR LDPC decoder with saturating 8-bit messages. Each
+// base graph row is a layer, whose Z check nodes are updated together, 32
+// at a time with AVX2, after which the updated bit LLRs are used by the
+// next layer.
+//
+// Each column block of bit LLRs is stored twice in a row, 32-byte aligned,
+// so any cyclic shift of it is a contiguous run, and each circulant's Z
+// lanes are plain unaligned loads. Check-to-bit messages are stored per
+// circulant, padded to whole registers.
+//
+// Soft inputs follow the turbo decoders' convention, where a positive value
+// corresponds to a 1 bit. Check-to-bit message magnitudes are capped at 31,
+// leaving the bit LLRs room to grow without saturating.
+class NRLDPCMinSumDecoder
+{
+public:
+    explicit NRLDPCMinSumDecoder(const NRLDPCCode& code);
+
+    const NRLDPCCode& code() const;
+
+    NRLDPCMinSumVariant variant() const;
+
+    void setVariant(NRLDPCMinSumVariant variant);
+
+    // For the offset variant, in input units, from 0 to 31
+    int offset() const;
+
+    void setOffset(int offset);
+
+    // Takes N soft bits, as output by the encoder, and outputs K decoded
+    // bits, one per byte. If earlyTermination, decoding stops once every
+    // parity check is satisfied. Returns the number of iterations run.
+    size_t decode(
+        const std::int8_t* in,
+        size_t maxIterations,
+        bool earlyTermination,
+        std::uint8_t* bitsOut);
+
+    // Whether the last decode's codeword satisfied every parity check
+    bool parityChecksPassed() const;
+
+private:
+    NRLDPCCode _code;
+
+    NRLDPCMinSumVariant _variant;
+    int _offset;
+
+    // Z, rounded up to a multiple of 32
+    size_t _paddedZ;
+
+    // Each column's bytes, at least 2Z plus a register
+    size_t _columnStride;
+
+    size_t _maxRowDegree;
+
+    // Allocated with room to align
+    std::vector<std::int8_t> _llrStorage;
+    std::int8_t* _llrs;
+
+    // Each circulant's check-to-bit messages
+    std::vector<std::int8_t> _messageStorage;
+    std::int8_t* _messages;
+
+    // Each circulant's updated bit LLRs, in shifted order
+    std::vector<std::int8_t> _updatedStorage;
+    std::int8_t* _updated;
+
+    // A layer's bit-to-check messages for one register
+    std::vector<std::int8_t> _bitToCheck;
+
+    bool _parityChecksPassed;
+
+    std::int8_t* _column(size_t col);
+
+    void _updateLayer(size_t row);
+
+    bool _checkParity();
+};
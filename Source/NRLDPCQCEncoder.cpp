@@ -0,0 +1,205 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "NRLDPCQCEncoder.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// dst ^= src
+static void xorInto(std::uint8_t* dst, const std::uint8_t* src, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    for(; (elem + 32) <= length; elem += 32)
+    {
+        const auto dstValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + elem));
+        const auto srcValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + elem));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + elem), _mm256_xor_si256(dstValues, srcValues));
+    }
+#endif
+
+    for(; elem < length; ++elem) dst[elem] ^= src[elem];
+}
+
+NRLDPCQCEncoder::NRLDPCQCEncoder(const NRLDPCCode& code):
+    _code(code),
+    _firstCoreCol(0),
+    _firstCoreShift(0)
+{
+    const size_t firstCol = _code.numInfoCols;
+    const size_t numCoreRows = NRLDPCBaseGraph::NumCoreRows;
+
+    // Summing the core rows, circulants with the same shift cancel.
+    std::vector<std::map<size_t, size_t>> shiftCounts(numCoreRows);
+    for(size_t row = 0; row < numCoreRows; ++row)
+    {
+        for(size_t entry = _code.rowStarts[row]; entry < _code.rowStarts[row+1]; ++entry)
+        {
+            const size_t col = _code.cols[entry];
+            if((col >= firstCol) && (col < (firstCol + numCoreRows)))
+            {
+                ++shiftCounts[col - firstCol][_code.shifts[entry]];
+            }
+        }
+    }
+
+    size_t numUncancelled = 0;
+    for(size_t coreCol = 0; coreCol < numCoreRows; ++coreCol)
+    {
+        std::vector<size_t> oddShifts;
+        for(const auto& shiftCount: shiftCounts[coreCol])
+        {
+            if(shiftCount.second % 2) oddShifts.push_back(shiftCount.first);
+        }
+
+        if(oddShifts.empty()) continue;
+        else if(1 == oddShifts.size())
+        {
+            _firstCoreCol = firstCol + coreCol;
+            _firstCoreShift = oddShifts[0];
+        }
+
+        ++numUncancelled;
+    }
+    if((1 != numUncancelled) || (0 == _firstCoreCol))
+    {
+        throw Pothos::InvalidArgumentException(
+                  "NR LDPC base graph's core parity columns can't be solved for Z="+std::to_string(_code.Z));
+    }
+
+    // Then each core row with one unsolved column solves it.
+    std::vector<bool> solvedCols(numCoreRows, false);
+    std::vector<bool> usedRows(numCoreRows, false);
+    solvedCols[_firstCoreCol - firstCol] = true;
+
+    while(_coreSteps.size() < (numCoreRows - 1))
+    {
+        bool found = false;
+        for(size_t row = 0; (row < numCoreRows) && !found; ++row)
+        {
+            if(usedRows[row]) continue;
+
+            size_t numUnsolved = 0;
+            CoreStep step = {row, 0, 0};
+            for(size_t entry = _code.rowStarts[row]; entry < _code.rowStarts[row+1]; ++entry)
+            {
+                const size_t col = _code.cols[entry];
+                if((col >= firstCol) && (col < (firstCol + numCoreRows)) && !solvedCols[col - firstCol])
+                {
+                    ++numUnsolved;
+                    step.col = col;
+                    step.shift = _code.shifts[entry];
+                }
+            }
+
+            if(1 == numUnsolved)
+            {
+                _coreSteps.push_back(step);
+                solvedCols[step.col - firstCol] = true;
+                usedRows[row] = true;
+                found = true;
+            }
+        }
+
+        if(!found)
+        {
+            throw Pothos::InvalidArgumentException(
+                      "NR LDPC base graph's core parity columns can't be solved for Z="+std::to_string(_code.Z));
+        }
+    }
+
+    _columns.resize(_code.numCols * 2 * _code.Z);
+    _coreSums.resize((numCoreRows + 1) * _code.Z);
+}
+
+const NRLDPCCode& NRLDPCQCEncoder::code() const
+{
+    return _code;
+}
+
+std::uint8_t* NRLDPCQCEncoder::_column(size_t col)
+{
+    return _columns.data() + (col * 2 * _code.Z);
+}
+
+void NRLDPCQCEncoder::_setColumn(size_t col, size_t shift, const std::uint8_t* sum)
+{
+    const size_t Z = _code.Z;
+    auto* column = _column(col);
+
+    // Element (j+shift) mod Z of the column is sum[j], so the sum goes in
+    // the middle of the doubled column as is, and the ends wrap around.
+    std::memcpy(column + shift, sum, Z);
+    std::memcpy(column, column + Z, shift);
+    std::memcpy(column + shift + Z, column + shift, Z - shift);
+}
+
+void NRLDPCQCEncoder::encode(const std::uint8_t* bits, std::uint8_t* codewordOut)
+{
+    const size_t Z = _code.Z;
+    const size_t firstCol = _code.numInfoCols;
+    const size_t numCoreRows = NRLDPCBaseGraph::NumCoreRows;
+
+    for(size_t col = 0; col < _code.numInfoCols; ++col)
+    {
+        for(size_t half = 0; half < 2; ++half) std::memcpy(_column(col) + (half * Z), bits + (col * Z), Z);
+    }
+
+    // Each core row's systematic circulants
+    auto* total = _coreSums.data() + (numCoreRows * Z);
+    std::fill(_coreSums.begin(), _coreSums.end(), 0);
+    for(size_t row = 0; row < numCoreRows; ++row)
+    {
+        auto* sum = _coreSums.data() + (row * Z);
+        for(size_t entry = _code.rowStarts[row]; entry < _code.rowStarts[row+1]; ++entry)
+        {
+            if(_code.cols[entry] < firstCol) xorInto(sum, _column(_code.cols[entry]) + _code.shifts[entry], Z);
+        }
+
+        xorInto(total, sum, Z);
+    }
+
+    _setColumn(_firstCoreCol, _firstCoreShift, total);
+
+    for(const auto& step: _coreSteps)
+    {
+        std::memcpy(total, _coreSums.data() + (step.row * Z), Z);
+        for(size_t entry = _code.rowStarts[step.row]; entry < _code.rowStarts[step.row+1]; ++entry)
+        {
+            const size_t col = _code.cols[entry];
+            if((col >= firstCol) && (col != step.col)) xorInto(total, _column(col) + _code.shifts[entry], Z);
+        }
+
+        _setColumn(step.col, step.shift, total);
+    }
+
+    // Each extension parity column has an unshifted identity.
+    for(size_t row = numCoreRows; row < _code.numRows; ++row)
+    {
+        const size_t parityCol = firstCol + row;
+
+        std::fill(total, total + Z, 0);
+        for(size_t entry = _code.rowStarts[row]; entry < _code.rowStarts[row+1]; ++entry)
+        {
+            const size_t col = _code.cols[entry];
+            if(col != parityCol) xorInto(total, _column(col) + _code.shifts[entry], Z);
+        }
+
+        _setColumn(parityCol, 0, total);
+    }
+
+    for(size_t col = 2; col < _code.numCols; ++col)
+    {
+        std::memcpy(codewordOut + ((col - 2) * Z), _column(col), Z);
+    }
+}
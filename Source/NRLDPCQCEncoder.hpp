@@ -0,0 +1,62 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "NRLDPCBaseGraph.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A 5G NR LDPC encoder that works a circulant at a time instead of a bit at
+// a time. Each column block is stored twice in a row, so any cyclic shift
+// of it is a contiguous run, and each circulant is a vectorized XOR.
+//
+// Parity is solved in the order the base graphs are built for (3GPP TS
+// 38.212, section 5.3.2): summing the four core rows cancels every core
+// parity column but one, which gives that column directly, then the other
+// three follow from the core rows one at a time, and each extension parity
+// column is the sum of its row's other circulants.
+class NRLDPCQCEncoder
+{
+public:
+    // Throws if the core parity columns can't be solved this way for this
+    // lifting size.
+    explicit NRLDPCQCEncoder(const NRLDPCCode& code);
+
+    const NRLDPCCode& code() const;
+
+    // Encodes K bits, one per byte, into N codeword bits, one per byte,
+    // without the first 2Z systematic bits.
+    void encode(const std::uint8_t* bits, std::uint8_t* codewordOut);
+
+private:
+    NRLDPCCode _code;
+
+    // Solving a core parity column from one core row's circulants
+    struct CoreStep
+    {
+        size_t row;
+        size_t col;
+        size_t shift;
+    };
+
+    // The column left by summing the core rows, and its total shift
+    size_t _firstCoreCol;
+    size_t _firstCoreShift;
+
+    std::vector<CoreStep> _coreSteps;
+
+    // Each column block, twice
+    std::vector<std::uint8_t> _columns;
+
+    // Each core row's systematic sum, then their total
+    std::vector<std::uint8_t> _coreSums;
+
+    std::uint8_t* _column(size_t col);
+
+    // Sets a column from the sum of its circulant's products, undoing the
+    // circulant's shift.
+    void _setColumn(size_t col, size_t shift, const std::uint8_t* sum);
+};
@@ -0,0 +1,104 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one
+// consumer thread. The capacity is rounded up to a power of two.
+template <typename T>
+class SPSCQueue
+{
+public:
+    explicit SPSCQueue(size_t capacity):
+        _buffer(roundUpToPowerOfTwo(capacity)),
+        _mask(_buffer.size() - 1),
+        _head(0),
+        _tail(0)
+    {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    size_t capacity() const
+    {
+        return _buffer.size();
+    }
+
+    // Producer only
+    bool push(T&& value)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if((tail - _head.load(std::memory_order_acquire)) == _buffer.size())
+        {
+            return false;
+        }
+
+        _buffer[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only
+    bool pop(T& valueOut)
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if(head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        valueOut = std::move(_buffer[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only. The returned pointer is valid until the next pop().
+    T* front()
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if(head == _tail.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        return &_buffer[head & _mask];
+    }
+
+    // Producer only
+    bool full() const
+    {
+        return ((_tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire)) == _buffer.size());
+    }
+
+    bool empty() const
+    {
+        return (_head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire));
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t ret = 1;
+        while(ret < value) ret <<= 1;
+
+        return ret;
+    }
+
+    std::vector<T> _buffer;
+    size_t _mask;
+
+    // Keep the indices on separate cache lines so the producer and
+    // consumer don't invalidate each other's lines on every operation.
+    // (Padding instead of alignas so this works with pre-C++17 operator new.)
+    char _headPadding[64];
+    std::atomic<size_t> _head;
+    char _tailPadding[64];
+    std::atomic<size_t> _tail;
+};
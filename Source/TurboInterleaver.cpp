@@ -0,0 +1,34 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "TurboInterleaver.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+void permute(const std::int16_t* in, const std::uint16_t* indices, std::int16_t* out, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    // Gather each value in the low half of a 32-bit lane, then pack them
+    // back down. Packing works within 128-bit lanes, so fix the order
+    // afterwards.
+    const auto* base = reinterpret_cast<const int*>(in);
+    const auto lowHalves = _mm256_set1_epi32(0xFFFF);
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        const auto indices0 = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + elem)));
+        const auto indices1 = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + elem + 8)));
+
+        const auto values0 = _mm256_and_si256(_mm256_i32gather_epi32(base, indices0, 2), lowHalves);
+        const auto values1 = _mm256_and_si256(_mm256_i32gather_epi32(base, indices1, 2), lowHalves);
+
+        const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(values0, values1), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + elem), packed);
+    }
+#endif
+
+    for(; elem < length; ++elem) out[elem] = in[indices[elem]];
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A turbo code's internal interleaver, as the permutations between input
+// order and interleaved order
+struct TurboInterleaver
+{
+    size_t K;
+
+    // Interleaved bit i is input bit forward[i].
+    std::vector<std::uint16_t> forward;
+
+    // Input bit i is interleaved bit inverse[i].
+    std::vector<std::uint16_t> inverse;
+};
+
+// Returns a code's cached interleaver for block size K. Throws if K isn't a
+// valid block size for the code.
+using TurboInterleaverFcn = const TurboInterleaver&(*)(size_t K);
+
+// out[i] = in[indices[i]]. With AVX2, this gathers 32 bits at a time, so in
+// must be readable one element past the largest index.
+void permute(const std::int16_t* in, const std::uint16_t* indices, std::int16_t* out, size_t length);
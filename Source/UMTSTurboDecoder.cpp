@@ -0,0 +1,551 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DecodeScheduler.hpp"
+#include "LabelFramer.hpp"
+#include "LTETurbo.hpp"
+#include "LTETurboSISO.hpp"
+#include "UMTSTurboInterleaver.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Block sizes needn't be multiples of 8, so packed output pads the last byte.
+constexpr size_t calcPackedSize(size_t numBits)
+{
+    return (numBits + 7) / 8;
+}
+
+class UMTSTurboDecoder: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make(
+            size_t numIterations,
+            bool unpack,
+            const std::string& streamFormat)
+        {
+            return new UMTSTurboDecoder(numIterations, unpack, streamFormat);
+        }
+
+        UMTSTurboDecoder(
+            size_t numIterations,
+            bool unpack,
+            const std::string& streamFormat
+        ):
+            Pothos::Block(),
+            _numIterations(numIterations),
+            _unpack(unpack),
+            _interleaved(isInterleavedStreamFormat(streamFormat)),
+            _blockSize(0),
+            _priority(DecodePriority::Normal),
+            _engine("Max-Log-MAP 16-bit"),
+            _numWindows(1),
+            _numThreads(1),
+            _stoppingCriterion("None")
+        {
+            // As with the LTE turbo decoder, uint8 inputs are taken as
+            // signed, for compatibility with the encoder's output.
+            this->setupInput(0, "uint8");
+            if(!_interleaved)
+            {
+                this->setupInput(1, "uint8");
+                this->setupInput(2, "uint8");
+            }
+
+            this->setupOutput(0, "uint8");
+
+            _sisoDecoderUPtr = _makeSISODecoder(_engine);
+
+            // Reserve up front, so decoding never allocates.
+            _decodedBits.reserve(UMTSTurboMaxK);
+            _prevOutput.reserve(UMTSTurboMaxK);
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, numIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setNumIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, blockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setBlockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, priority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setPriority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, engine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setEngine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, numWindows));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setNumWindows));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, numThreads));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setNumThreads));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, stoppingCriterion));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboDecoder, setStoppingCriterion));
+
+            this->registerProbe("numIterations");
+            this->registerProbe("blockSize");
+            this->registerProbe("priority");
+            this->registerProbe("engine");
+            this->registerProbe("numWindows");
+            this->registerProbe("numThreads");
+            this->registerProbe("stoppingCriterion");
+
+            this->registerSignal("numIterationsChanged");
+        }
+
+        size_t numIterations() const
+        {
+            return _numIterations;
+        }
+
+        void setNumIterations(unsigned numIterations)
+        {
+            _numIterations = numIterations;
+
+            this->emitSignal("numIterationsChanged", _numIterations);
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+        size_t blockSize() const
+        {
+            return _blockSize;
+        }
+
+        void setBlockSize(size_t blockSize)
+        {
+            checkUMTSFixedBlockSize(blockSize);
+            _blockSize = blockSize;
+        }
+
+        std::string priority() const
+        {
+            return decodePriorityToString(_priority);
+        }
+
+        void setPriority(const std::string& priority)
+        {
+            _priority = decodePriorityFromString(priority);
+        }
+
+        std::string engine() const
+        {
+            return _engine;
+        }
+
+        void setEngine(const std::string& engine)
+        {
+            _sisoDecoderUPtr = _makeSISODecoder(engine);
+            _engine = engine;
+        }
+
+        size_t numWindows() const
+        {
+            return _numWindows;
+        }
+
+        void setNumWindows(size_t numWindows)
+        {
+            if(0 == numWindows)
+            {
+                throw Pothos::InvalidArgumentException("Num windows must be positive");
+            }
+
+            _sisoDecoderUPtr->setNumWindows(numWindows);
+            _numWindows = numWindows;
+        }
+
+        size_t numThreads() const
+        {
+            return _numThreads;
+        }
+
+        void setNumThreads(size_t numThreads)
+        {
+            if(0 == numThreads)
+            {
+                throw Pothos::InvalidArgumentException("Num threads must be positive");
+            }
+
+            _sisoDecoderUPtr->setNumThreads(numThreads);
+            _numThreads = numThreads;
+        }
+
+        std::string stoppingCriterion() const
+        {
+            return _stoppingCriterion;
+        }
+
+        void setStoppingCriterion(const std::string& stoppingCriterion)
+        {
+            if(("None" != stoppingCriterion) && ("Hard Decision" != stoppingCriterion))
+            {
+                throw Pothos::InvalidArgumentException("Invalid stopping criterion: "+stoppingCriterion);
+            }
+
+            _stoppingCriterion = stoppingCriterion;
+        }
+
+        void propagateLabels(const Pothos::InputPort* input) override
+        {
+            // The framer set aside input 0's labels to pass on when it
+            // scanned.
+            if(_framer.scanned() && (input == this->input(0)))
+            {
+                auto* output = this->output(0);
+                _framer.propagateLabels(&output, 1);
+            }
+            else if(!_blockStartID.empty())
+            {
+                // Don't propagate input label.
+                for(const auto& label: input->labels())
+                {
+                    if(label.id != _blockStartID) this->output(0)->postLabel(label);
+                }
+            }
+            else Pothos::Block::propagateLabels(input);
+        }
+
+        void work() override
+        {
+            _framer.reset();
+
+            const auto elems = this->workInfo().minInElements;
+            if(elems < calcDecoderInputSize(UMTSTurboMinK))
+            {
+                return;
+            }
+
+            if(0 != _blockSize)            _blockSizeWork(elems);
+            else if(_blockStartID.empty()) _work(std::min(elems, calcDecoderInputSize(UMTSTurboMaxK)));
+            else                           _blockIDWork(elems);
+        }
+
+    private:
+        size_t _numIterations;
+        bool _unpack;
+
+        // If true, the three streams are interleaved on input 0.
+        bool _interleaved;
+
+        std::string _blockStartID;
+
+        // If nonzero, the input is split into blocks of this size.
+        size_t _blockSize;
+
+        LabelFramer _framer;
+
+        DecodePriority _priority;
+
+        std::string _engine;
+        std::unique_ptr<LTETurboSISODecoder> _sisoDecoderUPtr;
+
+        size_t _numWindows;
+        size_t _numThreads;
+
+        std::string _stoppingCriterion;
+
+        std::vector<std::uint8_t> _decodedBits;
+
+        // The previous iteration's output, for the hard decision criterion
+        std::vector<std::uint8_t> _prevOutput;
+
+        // The SISO kernels are shared with the LTE turbo decoder, which has
+        // no UMTS-specific code beyond the interleaver.
+        std::unique_ptr<LTETurboSISODecoder> _makeSISODecoder(const std::string& engine) const
+        {
+            std::unique_ptr<LTETurboSISODecoder> sisoDecoderUPtr;
+
+            if("Max-Log-MAP 16-bit" == engine)      sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int16, false, &getUMTSTurboInterleaver));
+            else if("Log-MAP 16-bit" == engine)     sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int16, true, &getUMTSTurboInterleaver));
+            else if("Max-Log-MAP 8-bit" == engine)  sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int8, false, &getUMTSTurboInterleaver));
+            else if("Log-MAP 8-bit" == engine)      sisoDecoderUPtr.reset(new LTETurboSISODecoder(TurboSISOMetric::Int8, true, &getUMTSTurboInterleaver));
+            else throw Pothos::InvalidArgumentException("Invalid engine: "+engine);
+
+            sisoDecoderUPtr->setNumWindows(_numWindows);
+            sisoDecoderUPtr->setNumThreads(_numThreads);
+
+            return sisoDecoderUPtr;
+        }
+
+        size_t _outputSize(size_t numBits) const
+        {
+            return _unpack ? numBits : calcPackedSize(numBits);
+        }
+
+        // Returns the number of iterations run.
+        size_t _decode(const std::int8_t* const* inputs, std::uint8_t* output, size_t outputSize)
+        {
+            std::uint8_t* bits = output;
+            if(!_unpack)
+            {
+                _decodedBits.resize(outputSize);
+                bits = _decodedBits.data();
+            }
+
+            LTETurboSISODecoder::StopFcn stopFcn;
+            if("Hard Decision" == _stoppingCriterion)
+            {
+                _prevOutput.clear();
+                stopFcn = [this, outputSize](size_t numIterations, const std::uint8_t* decodedBits, int)
+                {
+                    const bool converged = (1 < numIterations) &&
+                                           (0 == std::memcmp(_prevOutput.data(), decodedBits, outputSize));
+                    _prevOutput.assign(decodedBits, decodedBits + outputSize);
+
+                    return converged;
+                };
+            }
+
+            const auto numIterations = _interleaved ? _sisoDecoderUPtr->decodeInterleaved(
+                                                          outputSize,
+                                                          _numIterations,
+                                                          inputs[0],
+                                                          bits,
+                                                          stopFcn)
+                                                    : _sisoDecoderUPtr->decode(
+                                                          outputSize,
+                                                          _numIterations,
+                                                          inputs[0],
+                                                          inputs[1],
+                                                          inputs[2],
+                                                          bits,
+                                                          stopFcn);
+            if(!_unpack) packBits(bits, output, outputSize);
+
+            return numIterations;
+        }
+
+        // Decodes the block at the given input offset into the output at the
+        // given offset.
+        void _decodeBlock(size_t inputOffset, size_t inputSize, size_t outputOffset)
+        {
+            const auto& inputs = this->inputs();
+            auto output = this->output(0);
+
+            const auto outputSize = calcDecoderOutputSize(inputSize);
+
+            const std::int8_t* inputBuffers[3] = {};
+            for(size_t port = 0; port < inputs.size(); ++port)
+            {
+                inputBuffers[port] = inputs[port]->buffer().as<const std::int8_t*>() + inputOffset;
+            }
+
+            size_t numIterations = 0;
+            {
+                DecodeScheduler::Slot decodeSlot(_priority);
+                numIterations = _decode(inputBuffers, output->buffer().as<std::uint8_t*>() + outputOffset, outputSize);
+            }
+
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty()) output->postLabel(_blockStartID, outputSize, outputOffset);
+
+            // When stopping early, note how many iterations this block took.
+            if("None" != _stoppingCriterion) output->postLabel("iterations", numIterations, outputOffset);
+        }
+
+        // Common code when we've determined our input size. Decodes numBlocks
+        // consecutive blocks of this size, back to back in the output.
+        void _work(size_t inputSize, size_t numBlocks = 1)
+        {
+            const auto outputSize = calcDecoderOutputSize(inputSize);
+            if(!isUMTSTurboBlockSize(outputSize))
+            {
+                throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size: "+std::to_string(outputSize));
+            }
+
+            for(size_t block = 0; block < numBlocks; ++block)
+            {
+                _decodeBlock((block * inputSize), inputSize, (block * _outputSize(outputSize)));
+            }
+
+            for(auto* input: this->inputs()) input->consume(numBlocks * inputSize);
+            this->output(0)->produce(numBlocks * _outputSize(outputSize));
+        }
+
+        // Decodes every whole block of the fixed size that fits in the
+        // output, back to back, or at least one.
+        void _blockSizeWork(size_t maxInputSize)
+        {
+            const size_t inputSize = calcDecoderInputSize(_blockSize);
+            for(auto* input: this->inputs()) input->setReserve(inputSize);
+            if(maxInputSize < inputSize) return;
+
+            const size_t numBlocks = std::min(
+                                         (maxInputSize / inputSize),
+                                         (this->output(0)->elements() / _outputSize(_blockSize)));
+            this->_work(inputSize, std::max<size_t>(1, numBlocks));
+        }
+
+        // Decodes every whole labeled block that fits in the output, back to
+        // back, or at least one.
+        void _blockIDWork(size_t maxInputSize)
+        {
+            const auto& inputs = this->inputs();
+            auto output = this->output(0);
+
+            // We take in three inputs, but input 0 is expected to have
+            // the block ID labels.
+            _framer.scan(inputs[0], _blockStartID, "", maxInputSize);
+            const auto& blocks = _framer.blocks();
+
+            size_t numBlocks = 0;
+            size_t outputSize = 0;
+            for(const auto& block: blocks)
+            {
+                const auto blockBits = calcDecoderOutputSize(block.size);
+                if((block.size < calcDecoderInputSize(UMTSTurboMinK)) || !isUMTSTurboBlockSize(blockBits))
+                {
+                    throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size: "+std::to_string(block.size));
+                }
+
+                const size_t blockOutputSize = _outputSize(blockBits);
+                if((numBlocks > 0) && ((outputSize + blockOutputSize) > output->elements())) break;
+
+                outputSize += blockOutputSize;
+                ++numBlocks;
+            }
+
+            size_t outputOffset = 0;
+            for(size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                const auto& block = blocks[blockIndex];
+                _decodeBlock(block.offset, block.size, outputOffset);
+                outputOffset += _outputSize(calcDecoderOutputSize(block.size));
+            }
+
+            _framer.consume(inputs, numBlocks);
+            if(outputOffset > 0) output->produce(outputOffset);
+        }
+};
+
+/*
+ * |PothosDoc UMTS Turbo Decoder
+ *
+ * The UMTS/HSPA turbo code (3GPP TS 25.212, section 4.2.3.2), for block sizes
+ * of 40 to 5114 bits. This uses the same SIMD max-log-MAP decoder as the LTE
+ * turbo decoder's in-tree engines, with the UMTS prime interleaver. Each block
+ * size's interleaver is built on first use and cached for the rest of the
+ * process, shared with the UMTS turbo encoder.
+ *
+ * |category /FEC/Decoders
+ * |keywords coder umts hspa wcdma 3g
+ * |factory /fec/umts_turbo_decoder(numIterations,unpack,streamFormat)
+ * |setter setNumIterations(numIterations)
+ * |setter setBlockStartID(blockStartID)
+ * |setter setBlockSize(blockSize)
+ * |setter setPriority(priority)
+ * |setter setEngine(engine)
+ * |setter setNumWindows(numWindows)
+ * |setter setNumThreads(numThreads)
+ * |setter setStoppingCriterion(stoppingCriterion)
+ *
+ * |param numIterations[Num Iterations]
+ * The maximum number of iterations per block.
+ * |widget SpinBox(minimum=1)
+ * |default 4
+ * |preview enable
+ *
+ * |param unpack[Unpack?]
+ * If false, the decoded bits are packed MSB first, with the last byte of each
+ * block padded with zeros if the block size isn't a multiple of 8.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default true
+ * |preview enable
+ *
+ * |param streamFormat[Stream Format]
+ * How the encoder's three output streams are input, as signed 8-bit soft bits
+ * where a positive value corresponds to a 1 bit. "Separate" takes each stream on its
+ * own port. "Interleaved" takes all three on one port, in 25.212's output
+ * order, x[0], z[0], z'[0], x[1], ..., followed by the 12 trellis termination
+ * bits. Either way, each block is 3(K+4) elements per port.
+ * |widget ComboBox(editable=False)
+ * |option [Separate] "Separate"
+ * |option [Interleaved] "Interleaved"
+ * |default "Separate"
+ * |preview enable
+ *
+ * |param blockStartID[Block Start ID]
+ * The label used by the block to determine the beginning of the block to decode.
+ * This label will be placed at the start of the corresponding encoded block.
+ * If the given string is empty, the block will decode up to one block's worth
+ * of the largest size from the input buffer at once.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ *
+ * |param blockSize[Block Size]
+ * If nonzero, the input is split into consecutive encoded blocks of this many
+ * decoded bits, from 40 to 5114, and block start labels on the input are
+ * ignored. Every whole block available is decoded in one pass, so a stream of
+ * fixed-size blocks needs no labels. Each decoded block still gets a block
+ * start label if the block start ID isn't empty.
+ * |widget SpinBox(minimum=0,maximum=5114)
+ * |default 0
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ *
+ * |param engine[Engine]
+ * The decoder implementation, a max-log-MAP decoder with 16-bit or faster
+ * saturating 8-bit state metrics, optionally with log-MAP correction for
+ * accuracy. Log-MAP correction assumes soft inputs are log-likelihood ratios
+ * scaled to 4 per nat.
+ * |widget ComboBox(editable=False)
+ * |option [Max-Log-MAP 16-bit] "Max-Log-MAP 16-bit"
+ * |option [Log-MAP 16-bit] "Log-MAP 16-bit"
+ * |option [Max-Log-MAP 8-bit] "Max-Log-MAP 8-bit"
+ * |option [Log-MAP 8-bit] "Log-MAP 8-bit"
+ * |default "Max-Log-MAP 16-bit"
+ * |preview valid
+ *
+ * |param numWindows[Num Windows]
+ * The number of windows to split each block into, for lower latency on large
+ * blocks. Windows are decoded side by side in SIMD registers, each starting
+ * from a short training run instead of the ends of the block, at a small cost
+ * in accuracy. Fewer windows are used if the block size isn't a multiple of
+ * this, or the windows would be too short.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview valid
+ *
+ * |param numThreads[Num Threads]
+ * The number of threads that decode each block's windows, including the
+ * block's own thread. These threads are in addition to the module's decode
+ * slots.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview valid
+ *
+ * |param stoppingCriterion[Stopping Criterion]
+ * When to stop decoding a block before the maximum number of iterations.
+ * "None" runs every iteration. "Hard Decision" stops when further iterations
+ * no longer change the decoded bits. When stopping early, each decoded block
+ * gets an "iterations" label with the number of iterations it took.
+ * |widget ComboBox(editable=False)
+ * |option [None] "None"
+ * |option [Hard Decision] "Hard Decision"
+ * |default "None"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerUMTSTurboDecoder(
+    "/fec/umts_turbo_decoder",
+    Pothos::Callable(&UMTSTurboDecoder::make));
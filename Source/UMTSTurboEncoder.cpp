@@ -0,0 +1,407 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LabelFramer.hpp"
+#include "LTETurbo.hpp"
+#include "LTETurboRSC.hpp"
+#include "UMTSTurboInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <string>
+
+// The constituent encoders' transfer function is [1, g1(D)/g0(D)], with
+// g0(D) = 1 + D^2 + D^3 and g1(D) = 1 + D + D^3 (3GPP TS 25.212, section
+// 4.2.3.2.1).
+static constexpr unsigned UMTSTurboRGen = 013;
+static constexpr unsigned UMTSTurboGen = 015;
+
+// Each block is output as three streams of K+4 bits, the same as the
+// decoder's input.
+constexpr size_t calcOutputSize(size_t inputSize)
+{
+    return calcDecoderInputSize(inputSize);
+}
+
+class UMTSTurboEncoder: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make(const std::string& streamFormat)
+        {
+            return new UMTSTurboEncoder(streamFormat);
+        }
+
+        UMTSTurboEncoder(const std::string& streamFormat):
+            Pothos::Block(),
+            _interleaved(isInterleavedStreamFormat(streamFormat)),
+            _engine("Table"),
+            _rscEncoder(UMTSTurboRGen, UMTSTurboGen, &getUMTSTurboInterleaver),
+            _blockStartID(),
+            _blockSize(0)
+        {
+            this->setupInput(0, "uint8");
+
+            this->setupOutput(0, "uint8");
+            if(!_interleaved)
+            {
+                this->setupOutput(1, "uint8");
+                this->setupOutput(2, "uint8");
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboEncoder, engine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboEncoder, setEngine));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboEncoder, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboEncoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboEncoder, blockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(UMTSTurboEncoder, setBlockSize));
+
+            this->registerProbe("engine");
+            this->registerProbe("blockSize");
+        }
+
+        std::string engine() const
+        {
+            return _engine;
+        }
+
+        void setEngine(const std::string& engine)
+        {
+            if(("Table" != engine) && ("Bitsliced" != engine))
+            {
+                throw Pothos::InvalidArgumentException("Invalid engine: "+engine);
+            }
+
+            _engine = engine;
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+        size_t blockSize() const
+        {
+            return _blockSize;
+        }
+
+        void setBlockSize(size_t blockSize)
+        {
+            checkUMTSFixedBlockSize(blockSize);
+            _blockSize = blockSize;
+        }
+
+        void propagateLabels(const Pothos::InputPort* input) override
+        {
+            // The framer set aside the labels to pass on when it scanned.
+            if(_framer.scanned())
+            {
+                _framer.propagateLabels(this->outputs().data(), this->outputs().size());
+            }
+            else if(!_blockStartID.empty())
+            {
+                // Don't propagate input label.
+                for(const auto& label: input->labels())
+                {
+                    if(label.id != _blockStartID)
+                    {
+                        for(auto* output: this->outputs()) output->postLabel(label);
+                    }
+                }
+            }
+            else Pothos::Block::propagateLabels(input);
+        }
+
+        // Each output port gets its own pool of buffers large enough for the
+        // largest block, allocated once up front, so encoding never has to
+        // allocate output buffers itself.
+        Pothos::BufferManager::Sptr getOutputBufferManager(
+            const std::string& name,
+            const std::string& domain) override
+        {
+            if(domain.empty())
+            {
+                Pothos::BufferManagerArgs args;
+                args.bufferSize = calcOutputSize(UMTSTurboMaxK);
+
+                return Pothos::BufferManager::make("generic", args);
+            }
+
+            return Pothos::Block::getOutputBufferManager(name, domain);
+        }
+
+        void work() override
+        {
+            _framer.reset();
+
+            const auto inputSize = this->input(0)->elements();
+            if(inputSize < UMTSTurboMinK)
+            {
+                // We don't have enough data to encode yet.
+                return;
+            }
+
+            if(0 != _blockSize)            _blockSizeWork(inputSize);
+            else if(_blockStartID.empty()) _work(std::min(inputSize, UMTSTurboMaxK));
+            else                           _blockIDWork(inputSize);
+        }
+
+    private:
+        // If true, the three streams are interleaved on output 0.
+        bool _interleaved;
+
+        std::string _engine;
+        LTETurboRSCEncoder _rscEncoder;
+
+        std::string _blockStartID;
+
+        // If nonzero, the input is split into blocks of this size.
+        size_t _blockSize;
+
+        LabelFramer _framer;
+
+        // With our own buffer managers, the outputs only lack room if a
+        // downstream block provides the output buffers, in which case we
+        // post our own.
+        void _getOutputBuffers(size_t outputSize, Pothos::BufferChunk* outputBuffersOut, bool* mustPostBufferOut)
+        {
+            const auto& outputs = this->outputs();
+
+            *mustPostBufferOut = (outputSize > this->workInfo().minOutElements);
+            for(size_t port = 0; port < outputs.size(); ++port)
+            {
+                if(*mustPostBufferOut) outputBuffersOut[port] = Pothos::BufferChunk("uint8", outputSize);
+                else                   outputBuffersOut[port] = outputs[port]->buffer();
+            }
+        }
+
+        void _produce(Pothos::BufferChunk* outputBuffers, size_t outputSize, bool mustPostBuffer)
+        {
+            const auto& outputs = this->outputs();
+            for(size_t port = 0; port < outputs.size(); ++port)
+            {
+                if(mustPostBuffer) outputs[port]->postBuffer(std::move(outputBuffers[port]));
+                else               outputs[port]->produce(outputSize);
+            }
+        }
+
+        // Encodes numBlocks consecutive blocks of this size into the output
+        // buffers, starting at the given offset. The bitsliced engine encodes
+        // them together, up to as many as it can at once.
+        void _encode(
+            const std::uint8_t* bits,
+            size_t inputSize,
+            size_t numBlocks,
+            Pothos::BufferChunk* outputBuffers,
+            size_t outputOffset)
+        {
+            const size_t blockOutputSize = calcOutputSize(inputSize);
+            const size_t stride = _interleaved ? 3 : 1;
+
+            size_t block = 0;
+            while(block < numBlocks)
+            {
+                const size_t blockOutputOffset = outputOffset + (block * blockOutputSize);
+
+                std::uint8_t* streams[3];
+                for(size_t stream = 0; stream < 3; ++stream)
+                {
+                    streams[stream] = _interleaved ? (outputBuffers[0].as<std::uint8_t*>() + blockOutputOffset + stream)
+                                                   : (outputBuffers[stream].as<std::uint8_t*>() + blockOutputOffset);
+                }
+
+                const auto* blockBits = bits + (block * inputSize);
+                const size_t numBitslicedBlocks = ("Bitsliced" == _engine) ? std::min((numBlocks - block), size_t(LTETurboRSCEncoder::MaxBitslicedBlocks))
+                                                                           : 1;
+                if(numBitslicedBlocks > 1) _rscEncoder.encodeBitsliced(inputSize, numBitslicedBlocks, blockBits, streams, stride, blockOutputSize);
+                else                       _rscEncoder.encode(inputSize, blockBits, streams, stride);
+
+                block += numBitslicedBlocks;
+            }
+        }
+
+        // Common code when we've determined our input size. Encodes numBlocks
+        // consecutive blocks of this size.
+        void _work(size_t inputSize, size_t numBlocks = 1)
+        {
+            auto input = this->input(0);
+            const auto& outputs = this->outputs();
+
+            const size_t blockOutputSize = calcOutputSize(inputSize);
+            const size_t outputSize = numBlocks * blockOutputSize;
+
+            Pothos::BufferChunk outputBuffers[3];
+            bool mustPostBuffer = false;
+            _getOutputBuffers(outputSize, outputBuffers, &mustPostBuffer);
+
+            _encode(input->buffer().as<const std::uint8_t*>(), inputSize, numBlocks, outputBuffers, 0);
+
+            input->consume(numBlocks * inputSize);
+            _produce(outputBuffers, outputSize, mustPostBuffer);
+
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty())
+            {
+                for(size_t block = 0; block < numBlocks; ++block)
+                {
+                    outputs[0]->postLabel(_blockStartID, blockOutputSize, (block * blockOutputSize));
+                }
+            }
+        }
+
+        // Encodes every whole block of the fixed size that fits in the
+        // output, back to back, or at least one.
+        void _blockSizeWork(size_t maxInputSize)
+        {
+            auto input = this->input(0);
+            input->setReserve(_blockSize);
+            if(maxInputSize < _blockSize) return;
+
+            const size_t numBlocks = std::max<size_t>(
+                                         1,
+                                         std::min(
+                                             (maxInputSize / _blockSize),
+                                             (this->workInfo().minOutElements / calcOutputSize(_blockSize))));
+            this->_work(_blockSize, numBlocks);
+        }
+
+        // Encodes every whole labeled block that fits in the output, back to
+        // back, or at least one. Runs of adjacent blocks of the same size are
+        // encoded together.
+        void _blockIDWork(size_t maxInputSize)
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            _framer.scan(input, _blockStartID, "", maxInputSize);
+            const auto& blocks = _framer.blocks();
+
+            size_t numBlocks = 0;
+            size_t outputSize = 0;
+            for(const auto& block: blocks)
+            {
+                if(!isUMTSTurboBlockSize(block.size))
+                {
+                    throw Pothos::InvalidArgumentException("Invalid UMTS turbo block size: "+std::to_string(block.size));
+                }
+
+                const size_t blockOutputSize = calcOutputSize(block.size);
+                if((numBlocks > 0) && ((outputSize + blockOutputSize) > this->workInfo().minOutElements)) break;
+
+                outputSize += blockOutputSize;
+                ++numBlocks;
+            }
+
+            if(0 == numBlocks)
+            {
+                _framer.consume(this->inputs(), 0);
+                return;
+            }
+
+            Pothos::BufferChunk outputBuffers[3];
+            bool mustPostBuffer = false;
+            _getOutputBuffers(outputSize, outputBuffers, &mustPostBuffer);
+
+            const auto* bits = input->buffer().as<const std::uint8_t*>();
+            size_t outputOffset = 0;
+            for(size_t first = 0; first < numBlocks;)
+            {
+                const auto& block = blocks[first];
+
+                size_t last = first;
+                while(((last+1) < numBlocks) &&
+                      (blocks[last+1].size == block.size) &&
+                      (blocks[last+1].offset == (blocks[last].offset + block.size)))
+                {
+                    ++last;
+                }
+
+                const size_t numAdjacentBlocks = last - first + 1;
+                _encode(bits + block.offset, block.size, numAdjacentBlocks, outputBuffers, outputOffset);
+
+                // Output a start block ID so an decoder can operate on the same data.
+                const size_t blockOutputSize = calcOutputSize(block.size);
+                for(size_t adjacentBlock = 0; adjacentBlock < numAdjacentBlocks; ++adjacentBlock)
+                {
+                    output->postLabel(_blockStartID, blockOutputSize, outputOffset);
+                    outputOffset += blockOutputSize;
+                }
+
+                first = last + 1;
+            }
+
+            _framer.consume(this->inputs(), numBlocks);
+            _produce(outputBuffers, outputSize, mustPostBuffer);
+        }
+};
+
+/*
+ * |PothosDoc UMTS Turbo Encoder
+ *
+ * The UMTS/HSPA turbo code (3GPP TS 25.212, section 4.2.3.2), for block sizes
+ * of 40 to 5114 bits. Its constituent encoders are the same as the LTE turbo
+ * code's, with a prime interleaver in place of LTE's QPP interleaver. Each
+ * block size's interleaver is built on first use and cached for the rest of
+ * the process, shared with the UMTS turbo decoder.
+ *
+ * |category /FEC/Encoders
+ * |keywords coder umts hspa wcdma 3g
+ * |factory /fec/umts_turbo_encoder(streamFormat)
+ * |setter setEngine(engine)
+ * |setter setBlockStartID(blockStartID)
+ * |setter setBlockSize(blockSize)
+ *
+ * |param streamFormat[Stream Format]
+ * How the three encoded streams are output. "Separate" outputs the systematic
+ * bits and each constituent encoder's parity bits on their own ports, with the
+ * 12 trellis termination bits spread across them as the LTE turbo encoder
+ * does. "Interleaved" outputs all three on one port, as d0[0], d1[0], d2[0],
+ * d0[1], ..., which is 25.212's output order, x[0], z[0], z'[0], x[1], ...,
+ * followed by the termination bits. Either way, each block is 3(K+4) elements
+ * per port.
+ * |widget ComboBox(editable=False)
+ * |option [Separate] "Separate"
+ * |option [Interleaved] "Interleaved"
+ * |default "Separate"
+ * |preview enable
+ *
+ * |param engine[Engine]
+ * The encoder implementation. "Table" steps each constituent encoder 8 bits at
+ * a time through lookup tables. "Bitsliced" does the same for single blocks,
+ * but encodes up to 64 consecutive blocks of the same size together, one per
+ * bit of each 64-bit word, which is fastest for streams of many blocks.
+ * |widget ComboBox(editable=False)
+ * |option [Table] "Table"
+ * |option [Bitsliced] "Bitsliced"
+ * |default "Table"
+ * |preview valid
+ *
+ * |param blockStartID[Block Start ID]
+ * The label used by the block to determine the beginning of the block to encode.
+ * This label will be placed at the start of the corresponding decoded block on
+ * output port 0. If the given string is empty, the block will encode up to
+ * 5114 bits of the input buffer at once.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ *
+ * |param blockSize[Block Size]
+ * If nonzero, the input is split into consecutive blocks of this many bits,
+ * from 40 to 5114, and block start labels on the input are ignored. Every
+ * whole block available is encoded in one pass, so a stream of fixed-size
+ * blocks needs no labels. Each encoded block still gets a block start label
+ * if the block start ID isn't empty.
+ * |widget SpinBox(minimum=0,maximum=5114)
+ * |default 0
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerUMTSTurboEncoder(
+    "/fec/umts_turbo_encoder",
+    Pothos::Callable(&UMTSTurboEncoder::make));
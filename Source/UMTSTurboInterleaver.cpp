@@ -0,0 +1,171 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "UMTSTurboInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+struct UMTSPrime
+{
+    std::uint16_t p;
+    std::uint16_t v;
+};
+
+// 3GPP TS 25.212, table 2, each prime with its associated primitive root
+static const UMTSPrime UMTSPrimeTable[] =
+{
+    {7, 3}, {11, 2}, {13, 2}, {17, 3}, {19, 2}, {23, 5}, {29, 2}, {31, 3},
+    {37, 2}, {41, 6}, {43, 3}, {47, 5}, {53, 2}, {59, 2}, {61, 2}, {67, 2},
+    {71, 7}, {73, 5}, {79, 3}, {83, 2}, {89, 3}, {97, 5}, {101, 2}, {103, 5},
+    {107, 2}, {109, 6}, {113, 3}, {127, 3}, {131, 2}, {137, 3}, {139, 2}, {149, 2},
+    {151, 6}, {157, 5}, {163, 2}, {167, 5}, {173, 2}, {179, 2}, {181, 2}, {191, 19},
+    {193, 5}, {197, 2}, {199, 3}, {211, 2}, {223, 3}, {227, 2}, {229, 6}, {233, 3},
+    {239, 7}, {241, 7}, {251, 6}, {257, 3}
+};
+
+// 3GPP TS 25.212, table 3, the original row of each permuted row
+static const std::uint8_t RowPattern5[] = {4, 3, 2, 1, 0};
+static const std::uint8_t RowPattern10[] = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+static const std::uint8_t RowPattern20A[] = {19, 9, 14, 4, 0, 2, 5, 7, 12, 18, 10, 8, 13, 17, 3, 1, 16, 6, 15, 11};
+static const std::uint8_t RowPattern20B[] = {19, 9, 14, 4, 0, 2, 5, 7, 12, 18, 16, 13, 17, 15, 3, 1, 6, 11, 8, 10};
+
+static bool isPrime(size_t value)
+{
+    if(value < 2) return false;
+    for(size_t divisor = 2; (divisor * divisor) <= value; ++divisor)
+    {
+        if(0 == (value % divisor)) return false;
+    }
+
+    return true;
+}
+
+static size_t gcd(size_t a, size_t b)
+{
+    while(0 != b)
+    {
+        const size_t remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+static void buildUMTSTurboInterleaver(TurboInterleaver& interleaver, size_t K)
+{
+    // The number of rows, and their permutation
+    size_t R = 20;
+    const std::uint8_t* T = RowPattern20A;
+    if(K <= 159)
+    {
+        R = 5;
+        T = RowPattern5;
+    }
+    else if((K <= 200) || ((K >= 481) && (K <= 530)))
+    {
+        R = 10;
+        T = RowPattern10;
+    }
+    else if(((K >= 2281) && (K <= 2480)) || ((K >= 3161) && (K <= 3210)))
+    {
+        T = RowPattern20B;
+    }
+
+    // The prime, its primitive root, and the number of columns
+    size_t p = 53;
+    size_t v = 2;
+    size_t C = p;
+    if((K < 481) || (K > 530))
+    {
+        const auto* pPrime = std::find_if(
+                                 std::begin(UMTSPrimeTable),
+                                 std::end(UMTSPrimeTable),
+                                 [K, R](const UMTSPrime& prime)
+                                 {
+                                     return (K <= (R * (prime.p + 1)));
+                                 });
+        p = pPrime->p;
+        v = pPrime->v;
+
+        if(K <= (R * (p - 1)))  C = p - 1;
+        else if(K <= (R * p))   C = p;
+        else                    C = p + 1;
+    }
+
+    // The base sequence for the intra-row permutations
+    std::vector<size_t> s(p - 1);
+    s[0] = 1;
+    for(size_t j = 1; j < (p - 1); ++j) s[j] = (v * s[j - 1]) % p;
+
+    // Each row's prime, the i-th going to the row permuted to row i
+    std::vector<size_t> r(R);
+    size_t q = 1;
+    r[T[0]] = q;
+    for(size_t i = 1; i < R; ++i)
+    {
+        q = std::max<size_t>(q, 6);
+        do { ++q; } while(!isPrime(q) || (1 != gcd(q, p - 1)));
+        r[T[i]] = q;
+    }
+
+    // U[(row * C) + j] is the column of row's j-th permuted bit.
+    std::vector<size_t> U(R * C);
+    for(size_t row = 0; row < R; ++row)
+    {
+        auto* rowU = U.data() + (row * C);
+        for(size_t j = 0; j < (p - 1); ++j)
+        {
+            rowU[j] = s[(j * r[row]) % (p - 1)];
+            if(C == (p - 1)) rowU[j] -= 1;
+        }
+
+        if(C >= p) rowU[p - 1] = 0;
+        if(C == (p + 1)) rowU[p] = p;
+    }
+    if((C == (p + 1)) && (K == (R * C)))
+    {
+        std::swap(U[(R - 1) * C], U[((R - 1) * C) + p]);
+    }
+
+    // Read the permuted matrix out column by column, pruning the padding.
+    interleaver.K = K;
+    interleaver.forward.resize(K);
+    interleaver.inverse.resize(K);
+
+    size_t i = 0;
+    for(size_t column = 0; column < C; ++column)
+    {
+        for(size_t row = 0; row < R; ++row)
+        {
+            const size_t index = (T[row] * C) + U[(T[row] * C) + column];
+            if(index >= K) continue;
+
+            interleaver.forward[i] = static_cast<std::uint16_t>(index);
+            interleaver.inverse[index] = static_cast<std::uint16_t>(i);
+            ++i;
+        }
+    }
+}
+
+const TurboInterleaver& getUMTSTurboInterleaver(size_t K)
+{
+    static std::once_flag onceFlags[NumUMTSTurboBlockSizes];
+    static TurboInterleaver interleavers[NumUMTSTurboBlockSizes];
+
+    if(!isUMTSTurboBlockSize(K))
+    {
+        throw Pothos::InvalidArgumentException("Invalid UMTS turbo block size: "+std::to_string(K));
+    }
+
+    const size_t index = K - UMTSTurboMinK;
+    std::call_once(onceFlags[index], buildUMTSTurboInterleaver, std::ref(interleavers[index]), K);
+
+    return interleavers[index];
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "TurboInterleaver.hpp"
+
+#include <cstddef>
+
+// The UMTS turbo code's prime interleaver (3GPP TS 25.212, section
+// 4.2.3.2.3). The input is written row by row into a matrix of 5, 10 or 20
+// rows, each row is permuted by powers of a primitive root modulo a prime,
+// the rows are permuted, and the matrix is read column by column, skipping
+// the padding.
+
+constexpr size_t UMTSTurboMinK = 40;
+constexpr size_t UMTSTurboMaxK = 5114;
+
+// Every size in between is valid.
+constexpr size_t NumUMTSTurboBlockSizes = (UMTSTurboMaxK - UMTSTurboMinK) + 1;
+
+static inline bool isUMTSTurboBlockSize(size_t K)
+{
+    return (K >= UMTSTurboMinK) && (K <= UMTSTurboMaxK);
+}
+
+// Building the permutations takes a search for primes and a pass over the
+// padded matrix, so, as with the LTE interleaver, each block size's are
+// built on first use, then shared by every coder in the process. Throws if
+// K isn't a valid UMTS turbo block size.
+const TurboInterleaver& getUMTSTurboInterleaver(size_t K);
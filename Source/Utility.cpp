@@ -10,7 +10,15 @@ extern "C"
 
 #include <Pothos/Exception.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
 
 // TODO: move this into PothosCore(?)
 static std::string errnoName(int errCode)
@@ -25,3 +33,386 @@ void throwOnErrCode(int errCode)
         throw Pothos::RuntimeException(errnoName(errCode)+": "+std::strerror(-errCode));
     }
 }
+
+float meanAbsoluteValue(const std::int8_t* buffer, size_t length)
+{
+    if(0 == length) return 0.0f;
+
+    std::uint64_t sum = 0;
+    size_t elem = 0;
+
+    // Note: |-128| doesn't fit in an int8, but it does fit in the uint8
+    // lanes the sum of absolute differences operates on.
+#if defined(__AVX2__)
+    const __m256i zero256 = _mm256_setzero_si256();
+    __m256i acc256 = _mm256_setzero_si256();
+    for(; (elem + 32) <= length; elem += 32)
+    {
+        const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + elem));
+        acc256 = _mm256_add_epi64(acc256, _mm256_sad_epu8(_mm256_abs_epi8(values), zero256));
+    }
+
+    alignas(32) std::uint64_t lanes256[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes256), acc256);
+    sum += lanes256[0] + lanes256[1] + lanes256[2] + lanes256[3];
+#endif
+
+#if defined(__SSSE3__)
+    const __m128i zero128 = _mm_setzero_si128();
+    __m128i acc128 = _mm_setzero_si128();
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + elem));
+        acc128 = _mm_add_epi64(acc128, _mm_sad_epu8(_mm_abs_epi8(values), zero128));
+    }
+
+    alignas(16) std::uint64_t lanes128[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes128), acc128);
+    sum += lanes128[0] + lanes128[1];
+#endif
+
+    for(; elem < length; ++elem) sum += std::abs(int(buffer[elem]));
+
+    return float(double(sum) / double(length));
+}
+
+void packBits(const std::uint8_t* bits, std::uint8_t* bytesOut, size_t numBits)
+{
+    for(size_t byte = 0; byte < (numBits / 8); ++byte)
+    {
+        const auto* byteBits = bits + (byte * 8);
+
+        std::uint8_t value = 0;
+        for(size_t bit = 0; bit < 8; ++bit) value = std::uint8_t(value << 1) | (byteBits[bit] & 1);
+        bytesOut[byte] = value;
+    }
+
+    const size_t numExtraBits = numBits % 8;
+    if(0 != numExtraBits)
+    {
+        const auto* extraBits = bits + (numBits - numExtraBits);
+
+        std::uint8_t value = 0;
+        for(size_t bit = 0; bit < numExtraBits; ++bit) value |= std::uint8_t((extraBits[bit] & 1) << (7 - bit));
+        bytesOut[numBits / 8] = value;
+    }
+}
+
+void accumulateSaturate(std::int8_t* acc, const std::int8_t* values, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    for(; (elem + 32) <= length; elem += 32)
+    {
+        const auto sum = _mm256_adds_epi8(
+                             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + elem)),
+                             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + elem)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + elem), sum);
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        const int sum = int(acc[elem]) + int(values[elem]);
+        acc[elem] = static_cast<std::int8_t>(std::min<int>(
+                                              std::max<int>(sum, std::numeric_limits<std::int8_t>::min()),
+                                              std::numeric_limits<std::int8_t>::max()));
+    }
+}
+
+void accumulateSaturate(std::int16_t* acc, const std::int16_t* values, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        const auto sum = _mm256_adds_epi16(
+                             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + elem)),
+                             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + elem)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + elem), sum);
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        const int sum = int(acc[elem]) + int(values[elem]);
+        acc[elem] = static_cast<std::int16_t>(std::min<int>(
+                                              std::max<int>(sum, std::numeric_limits<std::int16_t>::min()),
+                                              std::numeric_limits<std::int16_t>::max()));
+    }
+}
+
+#if defined(__SSSE3__)
+// Byte shuffles between three consecutive registers of interleaved streams
+// and one register of each stream. Each output register is the OR of three
+// shuffles, with bytes from elsewhere zeroed.
+struct StreamShuffles
+{
+    // [stream][interleaved register]
+    __m128i deinterleave[3][3];
+
+    // [interleaved register][stream]
+    __m128i interleave[3][3];
+};
+
+static const StreamShuffles& getStreamShuffles()
+{
+    static const StreamShuffles streamShuffles = []()
+    {
+        StreamShuffles shuffles;
+        alignas(16) std::int8_t mask[16];
+
+        for(size_t stream = 0; stream < 3; ++stream)
+        {
+            for(size_t reg = 0; reg < 3; ++reg)
+            {
+                for(size_t byte = 0; byte < 16; ++byte)
+                {
+                    const size_t src = (3 * byte) + stream;
+                    mask[byte] = ((src / 16) == reg) ? std::int8_t(src % 16) : std::int8_t(-128);
+                }
+                shuffles.deinterleave[stream][reg] = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+
+                for(size_t byte = 0; byte < 16; ++byte)
+                {
+                    const size_t dst = (16 * reg) + byte;
+                    mask[byte] = ((dst % 3) == stream) ? std::int8_t(dst / 3) : std::int8_t(-128);
+                }
+                shuffles.interleave[reg][stream] = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+            }
+        }
+
+        return shuffles;
+    }();
+
+    return streamShuffles;
+}
+
+static inline __m128i shuffle3(const __m128i* regs, const __m128i* masks)
+{
+    return _mm_or_si128(
+               _mm_or_si128(_mm_shuffle_epi8(regs[0], masks[0]), _mm_shuffle_epi8(regs[1], masks[1])),
+               _mm_shuffle_epi8(regs[2], masks[2]));
+}
+
+static inline void loadInterleaved(const std::int8_t* in, __m128i* regs)
+{
+    for(size_t reg = 0; reg < 3; ++reg)
+    {
+        regs[reg] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + (16 * reg)));
+    }
+}
+#endif
+
+void interleaveStreams(const std::uint8_t* const* streams, std::uint8_t* out, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__SSSE3__)
+    const auto& shuffles = getStreamShuffles();
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        __m128i streamRegs[3];
+        for(size_t stream = 0; stream < 3; ++stream)
+        {
+            streamRegs[stream] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(streams[stream] + elem));
+        }
+
+        for(size_t reg = 0; reg < 3; ++reg)
+        {
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(out + (3 * elem) + (16 * reg)),
+                shuffle3(streamRegs, shuffles.interleave[reg]));
+        }
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        for(size_t stream = 0; stream < 3; ++stream) out[(3 * elem) + stream] = streams[stream][elem];
+    }
+}
+
+void deinterleaveStreams(const std::int8_t* in, std::int8_t* const* streamsOut, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__SSSE3__)
+    const auto& shuffles = getStreamShuffles();
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        __m128i regs[3];
+        loadInterleaved(in + (3 * elem), regs);
+
+        for(size_t stream = 0; stream < 3; ++stream)
+        {
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(streamsOut[stream] + elem),
+                shuffle3(regs, shuffles.deinterleave[stream]));
+        }
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        for(size_t stream = 0; stream < 3; ++stream) streamsOut[stream][elem] = in[(3 * elem) + stream];
+    }
+}
+
+void deinterleaveStreams(const std::int8_t* in, std::int16_t* const* streamsOut, size_t length)
+{
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    const auto& shuffles = getStreamShuffles();
+    for(; (elem + 16) <= length; elem += 16)
+    {
+        __m128i regs[3];
+        loadInterleaved(in + (3 * elem), regs);
+
+        for(size_t stream = 0; stream < 3; ++stream)
+        {
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(streamsOut[stream] + elem),
+                _mm256_cvtepi8_epi16(shuffle3(regs, shuffles.deinterleave[stream])));
+        }
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        for(size_t stream = 0; stream < 3; ++stream) streamsOut[stream][elem] = in[(3 * elem) + stream];
+    }
+}
+
+#if defined(__AVX2__)
+static inline __m256 loadFloats(const std::int8_t* in)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in))));
+}
+
+static inline __m256 loadFloats(const std::int16_t* in)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))));
+}
+
+static inline __m256 loadFloats(const float* in)
+{
+    return _mm256_loadu_ps(in);
+}
+#endif
+
+template <typename T>
+static void scaleSaturateImpl(const T* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation)
+{
+    const float maxValue = float(saturation);
+    size_t elem = 0;
+
+#if defined(__AVX2__)
+    const __m256 scale256 = _mm256_set1_ps(scale);
+    const __m256 min256 = _mm256_set1_ps(-maxValue);
+    const __m256 max256 = _mm256_set1_ps(maxValue);
+
+    // Packing works within 128-bit lanes, so each 32-bit group of the
+    // packed bytes needs moving back into order.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for(; (elem + 32) <= length; elem += 32)
+    {
+        // Clamp before converting, so the packs never saturate. If its
+        // first operand is NaN, max returns the second.
+        __m256i words[4];
+        for(size_t reg = 0; reg < 4; ++reg)
+        {
+            const __m256 values = _mm256_mul_ps(loadFloats(in + elem + (8 * reg)), scale256);
+            words[reg] = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(values, min256), max256));
+        }
+
+        const __m256i bytes = _mm256_packs_epi16(
+                                  _mm256_packs_epi32(words[0], words[1]),
+                                  _mm256_packs_epi32(words[2], words[3]));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + elem),
+            _mm256_permutevar8x32_epi32(bytes, order));
+    }
+#endif
+
+    for(; elem < length; ++elem)
+    {
+        float value = float(in[elem]) * scale;
+        if(!(value > -maxValue))  value = -maxValue;
+        else if(value > maxValue) value = maxValue;
+
+        out[elem] = static_cast<std::int8_t>(std::lrint(value));
+    }
+}
+
+void scaleSaturate(const std::int8_t* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation)
+{
+    scaleSaturateImpl(in, out, length, scale, saturation);
+}
+
+void scaleSaturate(const std::int16_t* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation)
+{
+    scaleSaturateImpl(in, out, length, scale, saturation);
+}
+
+void scaleSaturate(const float* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation)
+{
+    scaleSaturateImpl(in, out, length, scale, saturation);
+}
+
+template <typename T>
+static void estimateBPSKStatisticsImpl(
+    const T* const* buffers,
+    size_t numBuffers,
+    size_t length,
+    double* amplitudeOut,
+    double* noisePowerOut)
+{
+    double m2 = 0.0;
+    double m4 = 0.0;
+    size_t count = 0;
+    for(size_t buffer = 0; buffer < numBuffers; ++buffer)
+    {
+        for(size_t elem = 0; elem < length; ++elem)
+        {
+            const double value = double(buffers[buffer][elem]);
+            if((0.0 == value) || !std::isfinite(value)) continue;
+
+            m2 += value * value;
+            m4 += (value * value) * (value * value);
+            ++count;
+        }
+    }
+
+    *amplitudeOut = 0.0;
+    *noisePowerOut = 0.0;
+    if(0 == count) return;
+
+    m2 /= double(count);
+    m4 /= double(count);
+
+    // For real BPSK with signal power S and noise power N, M2 = S+N and
+    // M4 = S^2 + 6SN + 3N^2, so S = sqrt((3*M2^2 - M4) / 2).
+    const double signalPower = std::sqrt(std::max(0.0, (((3.0 * m2 * m2) - m4) / 2.0)));
+    *amplitudeOut = std::sqrt(signalPower);
+    *noisePowerOut = std::max(0.0, (m2 - signalPower));
+}
+
+void estimateBPSKStatistics(const std::int8_t* const* buffers, size_t numBuffers, size_t length, double* amplitudeOut, double* noisePowerOut)
+{
+    estimateBPSKStatisticsImpl(buffers, numBuffers, length, amplitudeOut, noisePowerOut);
+}
+
+void estimateBPSKStatistics(const std::int16_t* const* buffers, size_t numBuffers, size_t length, double* amplitudeOut, double* noisePowerOut)
+{
+    estimateBPSKStatisticsImpl(buffers, numBuffers, length, amplitudeOut, noisePowerOut);
+}
+
+void estimateBPSKStatistics(const float* const* buffers, size_t numBuffers, size_t length, double* amplitudeOut, double* noisePowerOut)
+{
+    estimateBPSKStatisticsImpl(buffers, numBuffers, length, amplitudeOut, noisePowerOut);
+}
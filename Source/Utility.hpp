@@ -3,4 +3,40 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 void throwOnErrCode(int errCode);
+
+// Mean of the absolute values of the given soft bits, used as a cheap
+// measure of whether a frame contains any signal.
+float meanAbsoluteValue(const std::int8_t* buffer, size_t length);
+
+// Packs one bit per byte into bytes, MSB first. A partial last byte is padded
+// with zeros.
+void packBits(const std::uint8_t* bits, std::uint8_t* bytesOut, size_t numBits);
+
+// acc[i] += values[i], saturating.
+void accumulateSaturate(std::int8_t* acc, const std::int8_t* values, size_t length);
+void accumulateSaturate(std::int16_t* acc, const std::int16_t* values, size_t length);
+
+// Interleaves three streams as s0[0], s1[0], s2[0], s0[1], ...
+void interleaveStreams(const std::uint8_t* const* streams, std::uint8_t* out, size_t length);
+
+// Undoes interleaveStreams(), optionally widening to 16 bits.
+void deinterleaveStreams(const std::int8_t* in, std::int8_t* const* streamsOut, size_t length);
+void deinterleaveStreams(const std::int8_t* in, std::int16_t* const* streamsOut, size_t length);
+
+// out[i] = in[i] * scale, rounded and saturated to +/- saturation, which
+// must be in [1, 127]. NaNs saturate to -saturation.
+void scaleSaturate(const std::int8_t* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation);
+void scaleSaturate(const std::int16_t* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation);
+void scaleSaturate(const float* in, std::int8_t* out, size_t length, float scale, std::int8_t saturation);
+
+// Estimates the amplitude and noise power of BPSK soft bits, across
+// numBuffers buffers of the given length, with the M2M4 moment estimator,
+// which doesn't need the transmitted bits. Zeros, as from punctured bits,
+// are skipped.
+void estimateBPSKStatistics(const std::int8_t* const* buffers, size_t numBuffers, size_t length, double* amplitudeOut, double* noisePowerOut);
+void estimateBPSKStatistics(const std::int16_t* const* buffers, size_t numBuffers, size_t length, double* amplitudeOut, double* noisePowerOut);
+void estimateBPSKStatistics(const float* const* buffers, size_t numBuffers, size_t length, double* amplitudeOut, double* noisePowerOut);
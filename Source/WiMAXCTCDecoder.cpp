@@ -0,0 +1,406 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DecodeScheduler.hpp"
+#include "DuoBinaryCTC.hpp"
+#include "LabelFramer.hpp"
+#include "Utility.hpp"
+#include "WiMAXCTCInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Each block of K bits is input as six subblocks of K/2 soft bits.
+static constexpr size_t calcOutputSize(size_t inputSize)
+{
+    return inputSize / 3;
+}
+
+static constexpr size_t WiMAXCTCMinInputSize = WiMAXCTCMinN * 6;
+static constexpr size_t WiMAXCTCMaxInputSize = WiMAXCTCMaxN * 6;
+
+class WiMAXCTCDecoder: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make(size_t numIterations, bool unpack)
+        {
+            return new WiMAXCTCDecoder(numIterations, unpack);
+        }
+
+        WiMAXCTCDecoder(size_t numIterations, bool unpack):
+            Pothos::Block(),
+            _numIterations(numIterations),
+            _unpack(unpack),
+            _blockSize(0),
+            _priority(DecodePriority::Normal),
+            _ctcDecoder(&getWiMAXCTCInterleaver),
+            _stoppingCriterion("None")
+        {
+            // As with the turbo decoders, uint8 inputs are taken as signed,
+            // for compatibility with the encoder's output.
+            this->setupInput(0, "uint8");
+            this->setupOutput(0, "uint8");
+
+            // Reserve up front, so decoding never allocates.
+            _decodedBits.reserve(calcOutputSize(WiMAXCTCMaxInputSize));
+            _prevOutput.reserve(calcOutputSize(WiMAXCTCMaxInputSize));
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, numIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, setNumIterations));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, blockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, setBlockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, priority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, setPriority));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, stoppingCriterion));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCDecoder, setStoppingCriterion));
+
+            this->registerProbe("numIterations");
+            this->registerProbe("blockSize");
+            this->registerProbe("priority");
+            this->registerProbe("stoppingCriterion");
+
+            this->registerSignal("numIterationsChanged");
+        }
+
+        size_t numIterations() const
+        {
+            return _numIterations;
+        }
+
+        void setNumIterations(unsigned numIterations)
+        {
+            _numIterations = numIterations;
+
+            this->emitSignal("numIterationsChanged", _numIterations);
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+        size_t blockSize() const
+        {
+            return _blockSize;
+        }
+
+        void setBlockSize(size_t blockSize)
+        {
+            checkWiMAXCTCFixedBlockSize(blockSize);
+            _blockSize = blockSize;
+        }
+
+        std::string priority() const
+        {
+            return decodePriorityToString(_priority);
+        }
+
+        void setPriority(const std::string& priority)
+        {
+            _priority = decodePriorityFromString(priority);
+        }
+
+        std::string stoppingCriterion() const
+        {
+            return _stoppingCriterion;
+        }
+
+        void setStoppingCriterion(const std::string& stoppingCriterion)
+        {
+            if(("None" != stoppingCriterion) && ("Hard Decision" != stoppingCriterion))
+            {
+                throw Pothos::InvalidArgumentException("Invalid stopping criterion: "+stoppingCriterion);
+            }
+
+            _stoppingCriterion = stoppingCriterion;
+        }
+
+        void propagateLabels(const Pothos::InputPort* input) override
+        {
+            // The framer set aside the labels to pass on when it scanned.
+            if(_framer.scanned())
+            {
+                auto* output = this->output(0);
+                _framer.propagateLabels(&output, 1);
+            }
+            else if(!_blockStartID.empty())
+            {
+                // Don't propagate input label.
+                for(const auto& label: input->labels())
+                {
+                    if(label.id != _blockStartID) this->output(0)->postLabel(label);
+                }
+            }
+            else Pothos::Block::propagateLabels(input);
+        }
+
+        void work() override
+        {
+            _framer.reset();
+
+            const auto elems = this->workInfo().minInElements;
+            if(elems < WiMAXCTCMinInputSize)
+            {
+                return;
+            }
+
+            if(0 != _blockSize)            _blockSizeWork(elems);
+            else if(_blockStartID.empty()) _work(std::min(elems, WiMAXCTCMaxInputSize));
+            else                           _blockIDWork(elems);
+        }
+
+    private:
+        size_t _numIterations;
+        bool _unpack;
+
+        std::string _blockStartID;
+
+        // If nonzero, the input is split into blocks of this size.
+        size_t _blockSize;
+
+        LabelFramer _framer;
+
+        DecodePriority _priority;
+
+        DuoBinaryCTCDecoder _ctcDecoder;
+
+        std::string _stoppingCriterion;
+
+        std::vector<std::uint8_t> _decodedBits;
+
+        // The previous iteration's output, for the hard decision criterion
+        std::vector<std::uint8_t> _prevOutput;
+
+        size_t _outputSize(size_t numBits) const
+        {
+            return _unpack ? numBits : (numBits / 8);
+        }
+
+        // Returns the number of iterations run.
+        size_t _decode(const std::int8_t* input, std::uint8_t* output, size_t outputSize)
+        {
+            std::uint8_t* bits = output;
+            if(!_unpack)
+            {
+                _decodedBits.resize(outputSize);
+                bits = _decodedBits.data();
+            }
+
+            DuoBinaryCTCDecoder::StopFcn stopFcn;
+            if("Hard Decision" == _stoppingCriterion)
+            {
+                _prevOutput.clear();
+                stopFcn = [this, outputSize](size_t numIterations, const std::uint8_t* decodedBits, int)
+                {
+                    const bool converged = (1 < numIterations) &&
+                                           (0 == std::memcmp(_prevOutput.data(), decodedBits, outputSize));
+                    _prevOutput.assign(decodedBits, decodedBits + outputSize);
+
+                    return converged;
+                };
+            }
+
+            const auto numIterations = _ctcDecoder.decode((outputSize / 2), _numIterations, input, bits, stopFcn);
+            if(!_unpack) packBits(bits, output, outputSize);
+
+            return numIterations;
+        }
+
+        // Decodes the block at the given input offset into the output at the
+        // given offset.
+        void _decodeBlock(size_t inputOffset, size_t inputSize, size_t outputOffset)
+        {
+            auto output = this->output(0);
+
+            const auto outputSize = calcOutputSize(inputSize);
+            const auto* input = this->input(0)->buffer().as<const std::int8_t*>() + inputOffset;
+
+            size_t numIterations = 0;
+            {
+                DecodeScheduler::Slot decodeSlot(_priority);
+                numIterations = _decode(input, output->buffer().as<std::uint8_t*>() + outputOffset, outputSize);
+            }
+
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty()) output->postLabel(_blockStartID, outputSize, outputOffset);
+
+            // When stopping early, note how many iterations this block took.
+            if("None" != _stoppingCriterion) output->postLabel("iterations", numIterations, outputOffset);
+        }
+
+        // Common code when we've determined our input size. Decodes numBlocks
+        // consecutive blocks of this size, back to back in the output.
+        void _work(size_t inputSize, size_t numBlocks = 1)
+        {
+            const auto outputSize = calcOutputSize(inputSize);
+            if((0 != (inputSize % 3)) || !isWiMAXCTCBlockSize(outputSize))
+            {
+                throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size: "+std::to_string(outputSize));
+            }
+
+            for(size_t block = 0; block < numBlocks; ++block)
+            {
+                _decodeBlock((block * inputSize), inputSize, (block * _outputSize(outputSize)));
+            }
+
+            this->input(0)->consume(numBlocks * inputSize);
+            this->output(0)->produce(numBlocks * _outputSize(outputSize));
+        }
+
+        // Decodes every whole block of the fixed size that fits in the
+        // output, back to back, or at least one.
+        void _blockSizeWork(size_t maxInputSize)
+        {
+            const size_t inputSize = _blockSize * 3;
+            this->input(0)->setReserve(inputSize);
+            if(maxInputSize < inputSize) return;
+
+            const size_t numBlocks = std::min(
+                                         (maxInputSize / inputSize),
+                                         (this->output(0)->elements() / _outputSize(_blockSize)));
+            this->_work(inputSize, std::max<size_t>(1, numBlocks));
+        }
+
+        // Decodes every whole labeled block that fits in the output, back to
+        // back, or at least one.
+        void _blockIDWork(size_t maxInputSize)
+        {
+            auto output = this->output(0);
+
+            _framer.scan(this->input(0), _blockStartID, "", maxInputSize);
+            const auto& blocks = _framer.blocks();
+
+            size_t numBlocks = 0;
+            size_t outputSize = 0;
+            for(const auto& block: blocks)
+            {
+                const auto blockBits = calcOutputSize(block.size);
+                if((0 != (block.size % 3)) || !isWiMAXCTCBlockSize(blockBits))
+                {
+                    throw Pothos::InvalidArgumentException("Input length corresponds to an invalid block size: "+std::to_string(block.size));
+                }
+
+                const size_t blockOutputSize = _outputSize(blockBits);
+                if((numBlocks > 0) && ((outputSize + blockOutputSize) > output->elements())) break;
+
+                outputSize += blockOutputSize;
+                ++numBlocks;
+            }
+
+            size_t outputOffset = 0;
+            for(size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                const auto& block = blocks[blockIndex];
+                _decodeBlock(block.offset, block.size, outputOffset);
+                outputOffset += _outputSize(calcOutputSize(block.size));
+            }
+
+            _framer.consume(this->inputs(), numBlocks);
+            if(outputOffset > 0) output->produce(outputOffset);
+        }
+};
+
+/*
+ * |PothosDoc WiMAX CTC Decoder
+ *
+ * The WiMAX (IEEE 802.16) convolutional turbo code (CTC), a rate 1/3
+ * duo-binary circular turbo code, for block sizes of 48 to 480 bits. This is
+ * an iterative max-log-MAP decoder working on couples of bits at a time, with
+ * each trellis step's four branches into every state taken together in SIMD
+ * registers. As the trellis is circular, each pass over a block starts from a
+ * short training run over the other end of the block, in place of the
+ * circulation state the encoder used.
+ *
+ * |category /FEC/Decoders
+ * |keywords coder wimax 802.16 ctc duo-binary circular turbo
+ * |factory /fec/wimax_ctc_decoder(numIterations,unpack)
+ * |setter setNumIterations(numIterations)
+ * |setter setBlockStartID(blockStartID)
+ * |setter setBlockSize(blockSize)
+ * |setter setPriority(priority)
+ * |setter setStoppingCriterion(stoppingCriterion)
+ *
+ * |param numIterations[Num Iterations]
+ * The maximum number of iterations per block.
+ * |widget SpinBox(minimum=1)
+ * |default 4
+ * |preview enable
+ *
+ * |param unpack[Unpack?]
+ * If false, the decoded bits are packed MSB first. Every block size is a
+ * multiple of 8 bits.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default true
+ * |preview enable
+ *
+ * |param blockStartID[Block Start ID]
+ * The label used by the block to determine the beginning of the block to decode.
+ * This label will be placed at the start of the corresponding encoded block.
+ * Each encoded block is the encoder's six subblocks of K/2 soft bits, as
+ * signed 8-bit values where a positive value corresponds to a 1 bit. If the
+ * given string is empty, the block will decode up to one block's worth of the
+ * largest size from the input buffer at once, which must be a valid block size.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ *
+ * |param blockSize[Block Size]
+ * If nonzero, the input is split into consecutive encoded blocks of this many
+ * decoded bits, and block start labels on the input are ignored. Every whole
+ * block available is decoded in one pass, so a stream of fixed-size blocks
+ * needs no labels. Each decoded block still gets a block start label if the
+ * block start ID isn't empty.
+ * |widget ComboBox(editable=False)
+ * |option [None] 0
+ * |option [48] 48
+ * |option [72] 72
+ * |option [96] 96
+ * |option [144] 144
+ * |option [192] 192
+ * |option [216] 216
+ * |option [240] 240
+ * |option [288] 288
+ * |option [360] 360
+ * |option [384] 384
+ * |option [432] 432
+ * |option [480] 480
+ * |default 0
+ * |preview valid
+ *
+ * |param priority[Priority]
+ * All decoders in this module share a limited number of decode slots.
+ * When slots are contended, higher-priority decoders are served first.
+ * |widget ComboBox(editable=False)
+ * |option [High] "High"
+ * |option [Normal] "Normal"
+ * |option [Low] "Low"
+ * |default "Normal"
+ * |preview valid
+ *
+ * |param stoppingCriterion[Stopping Criterion]
+ * When to stop decoding a block before the maximum number of iterations.
+ * "None" runs every iteration. "Hard Decision" stops when further iterations
+ * no longer change the decoded bits. When stopping early, each decoded block
+ * gets an "iterations" label with the number of iterations it took.
+ * |widget ComboBox(editable=False)
+ * |option [None] "None"
+ * |option [Hard Decision] "Hard Decision"
+ * |default "None"
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerWiMAXCTCDecoder(
+    "/fec/wimax_ctc_decoder",
+    Pothos::Callable(&WiMAXCTCDecoder::make));
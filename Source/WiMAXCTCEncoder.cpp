@@ -0,0 +1,315 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DuoBinaryCTC.hpp"
+#include "LabelFramer.hpp"
+#include "WiMAXCTCInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <algorithm>
+#include <string>
+
+// Each block of K bits is output as six subblocks of K/2 bits.
+static constexpr size_t calcOutputSize(size_t inputSize)
+{
+    return inputSize * 3;
+}
+
+static constexpr size_t WiMAXCTCMinK = WiMAXCTCMinN * 2;
+static constexpr size_t WiMAXCTCMaxK = WiMAXCTCMaxN * 2;
+
+class WiMAXCTCEncoder: public Pothos::Block
+{
+    public:
+        static Pothos::Block* make()
+        {
+            return new WiMAXCTCEncoder();
+        }
+
+        WiMAXCTCEncoder():
+            Pothos::Block(),
+            _ctcEncoder(&getWiMAXCTCInterleaver),
+            _blockStartID(),
+            _blockSize(0)
+        {
+            this->setupInput(0, "uint8");
+            this->setupOutput(0, "uint8");
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCEncoder, blockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCEncoder, setBlockStartID));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCEncoder, blockSize));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WiMAXCTCEncoder, setBlockSize));
+
+            this->registerProbe("blockSize");
+        }
+
+        std::string blockStartID() const
+        {
+            return _blockStartID;
+        }
+
+        void setBlockStartID(const std::string& blockStartID)
+        {
+            _blockStartID = blockStartID;
+        }
+
+        size_t blockSize() const
+        {
+            return _blockSize;
+        }
+
+        void setBlockSize(size_t blockSize)
+        {
+            checkWiMAXCTCFixedBlockSize(blockSize);
+            _blockSize = blockSize;
+        }
+
+        void propagateLabels(const Pothos::InputPort* input) override
+        {
+            // The framer set aside the labels to pass on when it scanned.
+            if(_framer.scanned())
+            {
+                _framer.propagateLabels(this->outputs().data(), this->outputs().size());
+            }
+            else if(!_blockStartID.empty())
+            {
+                // Don't propagate input label.
+                for(const auto& label: input->labels())
+                {
+                    if(label.id != _blockStartID) this->output(0)->postLabel(label);
+                }
+            }
+            else Pothos::Block::propagateLabels(input);
+        }
+
+        // As with the turbo encoders, the output gets its own pool of
+        // buffers large enough for the largest block.
+        Pothos::BufferManager::Sptr getOutputBufferManager(
+            const std::string& name,
+            const std::string& domain) override
+        {
+            if(domain.empty())
+            {
+                Pothos::BufferManagerArgs args;
+                args.bufferSize = calcOutputSize(WiMAXCTCMaxK);
+
+                return Pothos::BufferManager::make("generic", args);
+            }
+
+            return Pothos::Block::getOutputBufferManager(name, domain);
+        }
+
+        void work() override
+        {
+            _framer.reset();
+
+            const auto inputSize = this->input(0)->elements();
+            if(inputSize < WiMAXCTCMinK)
+            {
+                // We don't have enough data to encode yet.
+                return;
+            }
+
+            if(0 != _blockSize)            _blockSizeWork(inputSize);
+            else if(_blockStartID.empty()) _work(std::min(inputSize, WiMAXCTCMaxK));
+            else                           _blockIDWork(inputSize);
+        }
+
+    private:
+        DuoBinaryCTCEncoder _ctcEncoder;
+
+        std::string _blockStartID;
+
+        // If nonzero, the input is split into blocks of this size.
+        size_t _blockSize;
+
+        LabelFramer _framer;
+
+        // With our own buffer manager, the output only lacks room if a
+        // downstream block provides the output buffers, in which case we
+        // post our own.
+        Pothos::BufferChunk _getOutputBuffer(size_t outputSize, bool* mustPostBufferOut)
+        {
+            *mustPostBufferOut = (outputSize > this->workInfo().minOutElements);
+            return *mustPostBufferOut ? Pothos::BufferChunk("uint8", outputSize)
+                                      : this->output(0)->buffer();
+        }
+
+        void _produce(Pothos::BufferChunk& outputBuffer, size_t outputSize, bool mustPostBuffer)
+        {
+            if(mustPostBuffer) this->output(0)->postBuffer(std::move(outputBuffer));
+            else               this->output(0)->produce(outputSize);
+        }
+
+        // Common code when we've determined our input size. Encodes numBlocks
+        // consecutive blocks of this size.
+        void _work(size_t inputSize, size_t numBlocks = 1)
+        {
+            if(!isWiMAXCTCBlockSize(inputSize))
+            {
+                throw Pothos::InvalidArgumentException("Invalid WiMAX CTC block size: "+std::to_string(inputSize));
+            }
+
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            const size_t blockOutputSize = calcOutputSize(inputSize);
+            const size_t outputSize = numBlocks * blockOutputSize;
+
+            bool mustPostBuffer = false;
+            auto outputBuffer = _getOutputBuffer(outputSize, &mustPostBuffer);
+
+            const auto* bits = input->buffer().as<const std::uint8_t*>();
+            for(size_t block = 0; block < numBlocks; ++block)
+            {
+                _ctcEncoder.encode(
+                    (inputSize / 2),
+                    bits + (block * inputSize),
+                    outputBuffer.as<std::uint8_t*>() + (block * blockOutputSize));
+            }
+
+            input->consume(numBlocks * inputSize);
+            _produce(outputBuffer, outputSize, mustPostBuffer);
+
+            // Output a start block ID so an decoder can operate on the same data.
+            if(!_blockStartID.empty())
+            {
+                for(size_t block = 0; block < numBlocks; ++block)
+                {
+                    output->postLabel(_blockStartID, blockOutputSize, (block * blockOutputSize));
+                }
+            }
+        }
+
+        // Encodes every whole block of the fixed size that fits in the
+        // output, back to back, or at least one.
+        void _blockSizeWork(size_t maxInputSize)
+        {
+            auto input = this->input(0);
+            input->setReserve(_blockSize);
+            if(maxInputSize < _blockSize) return;
+
+            const size_t numBlocks = std::max<size_t>(
+                                         1,
+                                         std::min(
+                                             (maxInputSize / _blockSize),
+                                             (this->workInfo().minOutElements / calcOutputSize(_blockSize))));
+            this->_work(_blockSize, numBlocks);
+        }
+
+        // Encodes every whole labeled block that fits in the output, back to
+        // back, or at least one.
+        void _blockIDWork(size_t maxInputSize)
+        {
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            _framer.scan(input, _blockStartID, "", maxInputSize);
+            const auto& blocks = _framer.blocks();
+
+            size_t numBlocks = 0;
+            size_t outputSize = 0;
+            for(const auto& block: blocks)
+            {
+                if(!isWiMAXCTCBlockSize(block.size))
+                {
+                    throw Pothos::InvalidArgumentException("Invalid WiMAX CTC block size: "+std::to_string(block.size));
+                }
+
+                const size_t blockOutputSize = calcOutputSize(block.size);
+                if((numBlocks > 0) && ((outputSize + blockOutputSize) > this->workInfo().minOutElements)) break;
+
+                outputSize += blockOutputSize;
+                ++numBlocks;
+            }
+
+            if(0 == numBlocks)
+            {
+                _framer.consume(this->inputs(), 0);
+                return;
+            }
+
+            bool mustPostBuffer = false;
+            auto outputBuffer = _getOutputBuffer(outputSize, &mustPostBuffer);
+
+            const auto* bits = input->buffer().as<const std::uint8_t*>();
+            size_t outputOffset = 0;
+            for(size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                const auto& block = blocks[blockIndex];
+                _ctcEncoder.encode(
+                    (block.size / 2),
+                    bits + block.offset,
+                    outputBuffer.as<std::uint8_t*>() + outputOffset);
+
+                // Output a start block ID so an decoder can operate on the same data.
+                const size_t blockOutputSize = calcOutputSize(block.size);
+                output->postLabel(_blockStartID, blockOutputSize, outputOffset);
+                outputOffset += blockOutputSize;
+            }
+
+            _framer.consume(this->inputs(), numBlocks);
+            _produce(outputBuffer, outputSize, mustPostBuffer);
+        }
+};
+
+/*
+ * |PothosDoc WiMAX CTC Encoder
+ *
+ * The WiMAX (IEEE 802.16) convolutional turbo code (CTC), a rate 1/3
+ * duo-binary circular turbo code, for block sizes of 48 to 480 bits. Bits are
+ * encoded in couples (A,B) by two 8-state circular recursive systematic
+ * convolutional encoders, one in natural order and one in interleaved order.
+ * Each encoder starts in the circulation state that it also ends in, so there
+ * are no tail bits. The interleaver parameters for each block size are
+ * precomputed, and each size's permutation is shared with the WiMAX CTC
+ * decoder.
+ *
+ * Each block is output as 802.16's six subblocks of K/2 bits, before subblock
+ * interleaving and puncturing: the systematic bits A and B, the parity bits
+ * Y1 and Y2 of each encoder, and the parity bits W1 and W2 of each encoder.
+ *
+ * |category /FEC/Encoders
+ * |keywords coder wimax 802.16 ctc duo-binary circular turbo
+ * |factory /fec/wimax_ctc_encoder()
+ * |setter setBlockStartID(blockStartID)
+ * |setter setBlockSize(blockSize)
+ *
+ * |param blockStartID[Block Start ID]
+ * The label used by the block to determine the beginning of the block to encode.
+ * This label will be placed at the start of the corresponding decoded block on
+ * output port 0. If the given string is empty, the block will encode up to
+ * 480 bits of the input buffer at once, which must be a valid block size.
+ * |widget LineEdit()
+ * |default "START"
+ * |preview disable
+ *
+ * |param blockSize[Block Size]
+ * If nonzero, the input is split into consecutive blocks of this many bits,
+ * and block start labels on the input are ignored. Every whole block
+ * available is encoded in one pass, so a stream of fixed-size blocks needs no
+ * labels. Each encoded block still gets a block start label if the block
+ * start ID isn't empty.
+ * |widget ComboBox(editable=False)
+ * |option [None] 0
+ * |option [48] 48
+ * |option [72] 72
+ * |option [96] 96
+ * |option [144] 144
+ * |option [192] 192
+ * |option [216] 216
+ * |option [240] 240
+ * |option [288] 288
+ * |option [360] 360
+ * |option [384] 384
+ * |option [432] 432
+ * |option [480] 480
+ * |default 0
+ * |preview valid
+ */
+static Pothos::BlockRegistry registerWiMAXCTCEncoder(
+    "/fec/wimax_ctc_encoder",
+    Pothos::Callable(&WiMAXCTCEncoder::make));
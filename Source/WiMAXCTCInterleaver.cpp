@@ -0,0 +1,83 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "WiMAXCTCInterleaver.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string>
+
+const WiMAXCTCParams WiMAXCTCParamsTable[NumWiMAXCTCBlockSizes] =
+{
+    {24, 5, 0, 0, 0},
+    {36, 11, 18, 0, 18},
+    {48, 13, 24, 0, 24},
+    {72, 11, 6, 0, 6},
+    {96, 7, 48, 24, 72},
+    {108, 11, 54, 56, 2},
+    {120, 13, 60, 0, 60},
+    {144, 17, 74, 72, 2},
+    {180, 11, 90, 0, 90},
+    {192, 11, 96, 48, 144},
+    {216, 13, 108, 0, 108},
+    {240, 13, 120, 60, 180}
+};
+
+const WiMAXCTCParams* getWiMAXCTCParams(size_t N)
+{
+    const auto* pParams = std::find_if(
+                              std::begin(WiMAXCTCParamsTable),
+                              std::end(WiMAXCTCParamsTable),
+                              [N](const WiMAXCTCParams& params)
+                              {
+                                  return (N == params.N);
+                              });
+
+    return (pParams != std::end(WiMAXCTCParamsTable)) ? pParams : nullptr;
+}
+
+static void buildWiMAXCTCInterleaver(DuoBinaryCTCInterleaver& interleaver, const WiMAXCTCParams& params)
+{
+    const size_t N = params.N;
+    const size_t Q[] = {0, (N/2) + params.P1, params.P2, (N/2) + params.P3};
+
+    interleaver.N = N;
+    interleaver.forward.resize(N);
+    interleaver.inverse.resize(N);
+
+    for(size_t j = 0; j < N; ++j)
+    {
+        const size_t i = ((params.P0 * j) + 1 + Q[j % 4]) % N;
+
+        interleaver.forward[j] = static_cast<std::uint16_t>(i);
+        interleaver.inverse[i] = static_cast<std::uint16_t>(j);
+    }
+}
+
+using WiMAXCTCInterleavers = std::array<DuoBinaryCTCInterleaver, NumWiMAXCTCBlockSizes>;
+
+const DuoBinaryCTCInterleaver& getWiMAXCTCInterleaver(size_t N)
+{
+    // There are few enough block sizes to build them all at once.
+    static const WiMAXCTCInterleavers interleavers = []()
+    {
+        WiMAXCTCInterleavers ret;
+        for(size_t index = 0; index < NumWiMAXCTCBlockSizes; ++index)
+        {
+            buildWiMAXCTCInterleaver(ret[index], WiMAXCTCParamsTable[index]);
+        }
+
+        return ret;
+    }();
+
+    const auto* pParams = getWiMAXCTCParams(N);
+    if(!pParams)
+    {
+        throw Pothos::InvalidArgumentException("Invalid WiMAX CTC block size: "+std::to_string(N)+" couples");
+    }
+
+    return interleavers[pParams - WiMAXCTCParamsTable];
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "DuoBinaryCTC.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <cstddef>
+#include <string>
+
+// The WiMAX convolutional turbo code's interleaver (IEEE 802.16-2009,
+// section 8.4.9.2.3.2). After A and B are swapped in every odd couple,
+// interleaved couple j is input couple P(j), with
+//
+//     P(j) = (P0*j + 1 + Q(j)) mod N,
+//
+// where Q(j) is 0, N/2+P1, P2 or N/2+P3 as j mod 4 is 0, 1, 2 or 3.
+
+// The parameters of one block size
+struct WiMAXCTCParams
+{
+    size_t N;
+    size_t P0;
+    size_t P1;
+    size_t P2;
+    size_t P3;
+};
+
+constexpr size_t NumWiMAXCTCBlockSizes = 12;
+
+// IEEE 802.16-2009, table 8-310's block sizes, smallest first
+extern const WiMAXCTCParams WiMAXCTCParamsTable[NumWiMAXCTCBlockSizes];
+
+// Block sizes in couples
+constexpr size_t WiMAXCTCMinN = 24;
+constexpr size_t WiMAXCTCMaxN = 240;
+
+// Returns the parameters for N couples, or nullptr if N isn't a valid block
+// size.
+const WiMAXCTCParams* getWiMAXCTCParams(size_t N);
+
+// Every block size's permutation is built together on first use, then
+// shared by every coder in the process. Throws if N isn't a valid block
+// size.
+const DuoBinaryCTCInterleaver& getWiMAXCTCInterleaver(size_t N);
+
+// Block sizes in bits
+static inline bool isWiMAXCTCBlockSize(size_t K)
+{
+    return (0 == (K % 2)) && (nullptr != getWiMAXCTCParams(K / 2));
+}
+
+// The WiMAX CTC coders' fixed block size is either 0, for none, or a valid
+// block size in bits. Throws on an invalid size.
+static inline void checkWiMAXCTCFixedBlockSize(size_t blockSize)
+{
+    if((0 != blockSize) && !isWiMAXCTCBlockSize(blockSize))
+    {
+        throw Pothos::InvalidArgumentException("Invalid WiMAX CTC block size: "+std::to_string(blockSize));
+    }
+}
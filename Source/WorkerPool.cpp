@@ -0,0 +1,120 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "WorkerPool.hpp"
+
+#include <Pothos/Exception.hpp>
+
+WorkerPool::WorkerPool(size_t numThreads):
+    _generation(0),
+    _stopping(false),
+    _numBusyThreads(0),
+    _pTaskFcn(nullptr),
+    _count(0),
+    _nextIndex(0)
+{
+    if(0 == numThreads)
+    {
+        throw Pothos::InvalidArgumentException("A worker pool needs at least one thread");
+    }
+
+    // The caller is thread 0.
+    for(size_t threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+    {
+        _threads.emplace_back(&WorkerPool::_threadLoop, this, threadIndex);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _startCond.notify_all();
+
+    for(auto& thread: _threads) thread.join();
+}
+
+size_t WorkerPool::numThreads() const
+{
+    return _threads.size() + 1;
+}
+
+void WorkerPool::parallelFor(size_t count, const TaskFcn& taskFcn)
+{
+    if(0 == count) return;
+
+    // Not worth waking anyone up.
+    if(_threads.empty() || (1 == count))
+    {
+        for(size_t index = 0; index < count; ++index) taskFcn(index, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _pTaskFcn = &taskFcn;
+        _count = count;
+        _nextIndex = 0;
+        _error = nullptr;
+        _numBusyThreads = _threads.size();
+        ++_generation;
+    }
+    _startCond.notify_all();
+
+    _runTasks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _doneCond.wait(lock, [this](){return (0 == _numBusyThreads);});
+
+        _pTaskFcn = nullptr;
+        error = _error;
+    }
+
+    if(error) std::rethrow_exception(error);
+}
+
+void WorkerPool::_threadLoop(size_t threadIndex)
+{
+    unsigned long long lastGeneration = 0;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _startCond.wait(lock, [&](){return _stopping || (_generation != lastGeneration);});
+            if(_stopping) return;
+
+            lastGeneration = _generation;
+        }
+
+        _runTasks(threadIndex);
+
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            notify = (0 == --_numBusyThreads);
+        }
+        if(notify) _doneCond.notify_one();
+    }
+}
+
+void WorkerPool::_runTasks(size_t threadIndex)
+{
+    for(size_t index = _nextIndex++; index < _count; index = _nextIndex++)
+    {
+        try
+        {
+            (*_pTaskFcn)(index, threadIndex);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(!_error) _error = std::current_exception();
+        }
+    }
+}
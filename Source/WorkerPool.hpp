@@ -0,0 +1,57 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fork-join pool for splitting one piece of work across threads, such as
+// the windows of a single turbo block. The calling thread takes part, so a
+// pool of N threads starts N-1 of its own. Nothing is allocated per call.
+class WorkerPool
+{
+public:
+    using TaskFcn = std::function<void(size_t index, size_t threadIndex)>;
+
+    explicit WorkerPool(size_t numThreads);
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t numThreads() const;
+
+    // Calls taskFcn for each index in [0, count), and returns once all calls
+    // are done. The thread index is unique among concurrently running calls,
+    // so it can select per-thread scratch space. If any call throws, the
+    // first exception is rethrown here. Not reentrant.
+    void parallelFor(size_t count, const TaskFcn& taskFcn);
+
+private:
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _startCond;
+    std::condition_variable _doneCond;
+
+    unsigned long long _generation;
+    bool _stopping;
+    size_t _numBusyThreads;
+
+    const TaskFcn* _pTaskFcn;
+    size_t _count;
+    std::atomic<size_t> _nextIndex;
+    std::exception_ptr _error;
+
+    void _threadLoop(size_t threadIndex);
+
+    void _runTasks(size_t threadIndex);
+};
@@ -10,6 +10,8 @@
 #include <Poco/Format.h>
 #include <Poco/String.h>
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -434,3 +436,307 @@ POTHOS_TEST_BLOCK("/fec/tests", test_generic_conv_default_params)
     testCodersAndGetBER(encoder, decoder, &ber);
     std::cout << ber << std::endl;
 }
+
+//
+// Test skipping decoding of empty frames.
+//
+
+POTHOS_TEST_BLOCK("/fec/tests", test_conv_decoder_energy_gate)
+{
+    constexpr size_t numEmptyFrames = 4;
+    constexpr size_t numFullFrames = 4;
+
+    auto encoder = Pothos::BlockRegistry::make("/fec/gsm_xcch_encoder");
+    auto decoder = Pothos::BlockRegistry::make("/fec/gsm_xcch_decoder");
+    decoder.call("setEnergyThreshold", 1.0f);
+
+    const auto length = encoder.call<size_t>("length");
+    const auto randomInput = FECTests::getRandomInput(length * numFullFrames);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, encoder, 0);
+        topology.connect(encoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto encodedValues = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    const auto encodedFrameSize = encodedValues.length / numFullFrames;
+
+    // Silence followed by bursts with signal.
+    Pothos::BufferChunk decoderInput("uint8", encodedFrameSize * numEmptyFrames);
+    std::memset(decoderInput.as<std::uint8_t*>(), 0, decoderInput.length);
+
+    int numBitsChanged = 0;
+    decoderInput.append(FECTests::addNoiseAndGetError(
+        encodedValues,
+        FECTests::defaultSNR,
+        FECTests::defaultAmp,
+        &numBitsChanged));
+
+    feederSource.call("feedBuffer", decoderInput);
+    collectorSink.call("clear");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, decoder, 0);
+        topology.connect(decoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    POTHOS_TEST_EQUAL(numEmptyFrames, decoder.call<unsigned long long>("numSkippedFrames"));
+    POTHOS_TEST_EQUAL(numFullFrames, decoder.call<unsigned long long>("numDecodedFrames"));
+
+    // Skipped frames should still produce (zeroed) output so framing is preserved.
+    const auto decodedValues = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(length * (numEmptyFrames + numFullFrames), decodedValues.length);
+
+    const std::vector<std::uint8_t> zeros(length * numEmptyFrames, 0);
+    POTHOS_TEST_EQUALA(
+        zeros.data(),
+        decodedValues.as<const std::uint8_t*>(),
+        zeros.size());
+
+    const auto labels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(numEmptyFrames, labels.size());
+    for(size_t frame = 0; frame < numEmptyFrames; ++frame)
+    {
+        POTHOS_TEST_EQUAL("skipped", labels[frame].id);
+        POTHOS_TEST_EQUAL(frame * length, labels[frame].index);
+    }
+}
+
+//
+// Test that each channel of a multi-channel coder is independent.
+//
+
+POTHOS_TEST_BLOCK("/fec/tests", test_multichannel_conv_coder_symmetry)
+{
+    constexpr size_t numChannels = 3;
+    constexpr size_t numFrames = 8;
+    const std::string standard = "GSM XCCH";
+
+    auto encoder = Pothos::BlockRegistry::make("/fec/multichannel_conv_encoder", standard, numChannels);
+    auto decoder = Pothos::BlockRegistry::make("/fec/multichannel_conv_decoder", standard, numChannels);
+    POTHOS_TEST_EQUAL(numChannels, encoder.call<size_t>("numChannels"));
+    POTHOS_TEST_EQUAL(numChannels, decoder.call<size_t>("numChannels"));
+
+    const auto length = encoder.call<size_t>("length");
+
+    std::vector<Pothos::BufferChunk> randomInputs;
+    std::vector<Pothos::Proxy> feederSources;
+    std::vector<Pothos::Proxy> collectorSinks;
+    for(size_t chan = 0; chan < numChannels; ++chan)
+    {
+        randomInputs.emplace_back(FECTests::getRandomInput(length * numFrames));
+
+        feederSources.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8"));
+        feederSources.back().call("feedBuffer", randomInputs.back());
+
+        collectorSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    {
+        Pothos::Topology topology;
+
+        for(size_t chan = 0; chan < numChannels; ++chan)
+        {
+            topology.connect(feederSources[chan], 0, encoder, chan);
+            topology.connect(encoder, chan, decoder, chan);
+            topology.connect(decoder, chan, collectorSinks[chan], 0);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // With no noise added between encoding and decoding, each channel's
+    // output should be identical to its input.
+    for(size_t chan = 0; chan < numChannels; ++chan)
+    {
+        const auto outputBuffer = collectorSinks[chan].call<Pothos::BufferChunk>("getBuffer");
+        POTHOS_TEST_EQUAL(randomInputs[chan].length, outputBuffer.length);
+        POTHOS_TEST_EQUALA(
+            randomInputs[chan].as<const std::uint8_t*>(),
+            outputBuffer.as<const std::uint8_t*>(),
+            randomInputs[chan].length);
+    }
+
+    POTHOS_TEST_EQUAL(numChannels * numFrames, decoder.call<unsigned long long>("numDecodedFrames"));
+}
+
+//
+// Test that a decoder farm outputs the same frames as a single decoder.
+//
+
+POTHOS_TEST_BLOCK("/fec/tests", test_conv_decoder_farm_symmetry)
+{
+    constexpr size_t numFrames = 64;
+    constexpr size_t numWorkers = 4;
+    const std::string standard = "GSM XCCH";
+
+    auto encoder = Pothos::BlockRegistry::make("/fec/gsm_xcch_encoder");
+    auto decoderFarm = Pothos::BlockRegistry::make("/fec/conv_decoder_farm", standard, numWorkers);
+    POTHOS_TEST_EQUAL(standard, decoderFarm.call<std::string>("standard"));
+    POTHOS_TEST_EQUAL(numWorkers, decoderFarm.call<size_t>("numWorkers"));
+
+    const auto length = encoder.call<size_t>("length");
+    const auto randomInput = FECTests::getRandomInput(length * numFrames);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, encoder, 0);
+        topology.connect(encoder, 0, decoderFarm, 0);
+        topology.connect(decoderFarm, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    POTHOS_TEST_EQUAL(numFrames, decoderFarm.call<unsigned long long>("numFramesDecoded"));
+
+    // Frames must come out in the order they went in.
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(randomInput.length, outputBuffer.length);
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        randomInput.length);
+}
+
+//
+// Test that frames that can't meet their deadline are dropped.
+//
+
+POTHOS_TEST_BLOCK("/fec/tests", test_conv_decoder_deadlines)
+{
+    constexpr size_t numLateFrames = 3;
+    constexpr size_t numOnTimeFrames = 5;
+    constexpr size_t numFrames = numLateFrames + numOnTimeFrames;
+    const std::string timestampID = "rxTime";
+
+    auto encoder = Pothos::BlockRegistry::make("/fec/gsm_xcch_encoder");
+    auto decoder = Pothos::BlockRegistry::make("/fec/gsm_xcch_decoder");
+    decoder.call("setDeadlineBudget", 0.001);
+    decoder.call("setTimestampID", timestampID);
+
+    const auto length = encoder.call<size_t>("length");
+    const auto randomInput = FECTests::getRandomInput(length * numFrames);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, encoder, 0);
+        topology.connect(encoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto encodedValues = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    const auto encodedFrameSize = encodedValues.length / numFrames;
+
+    // The first frames were received long ago, and the rest are timestamped
+    // an hour from now, so they have plenty of time.
+    const long long nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::system_clock::now().time_since_epoch()).count();
+    const long long hourNs = 3600LL * 1000000000LL;
+
+    feederSource.call("feedBuffer", encodedValues);
+    for(size_t frame = 0; frame < numFrames; ++frame)
+    {
+        const long long timestampNs = (frame < numLateFrames) ? 0LL : (nowNs + hourNs);
+        feederSource.call("feedLabel", Pothos::Label(timestampID, timestampNs, (frame * encodedFrameSize)));
+        feederSource.call("feedLabel", Pothos::Label("frame", frame, ((frame * encodedFrameSize) + (encodedFrameSize / 2))));
+    }
+    collectorSink.call("clear");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, decoder, 0);
+        topology.connect(decoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    POTHOS_TEST_EQUAL(numLateFrames, decoder.call<unsigned long long>("numDroppedFrames"));
+    POTHOS_TEST_EQUAL(numOnTimeFrames, decoder.call<unsigned long long>("numDecodedFrames"));
+
+    // Only the on-time frames should be output.
+    const auto decodedValues = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(length * numOnTimeFrames, decodedValues.length);
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>() + (length * numLateFrames),
+        decodedValues.as<const std::uint8_t*>(),
+        decodedValues.length);
+
+    // Labels should follow their frames to the start of the decoded frame,
+    // with the dropped frames' labels dropped too.
+    const auto labels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(2 * numOnTimeFrames, labels.size());
+    for(size_t frame = 0; frame < numOnTimeFrames; ++frame)
+    {
+        const auto& timestampLabel = labels[2 * frame];
+        POTHOS_TEST_EQUAL(timestampID, timestampLabel.id);
+        POTHOS_TEST_EQUAL(frame * length, timestampLabel.index);
+
+        const auto& frameLabel = labels[(2 * frame) + 1];
+        POTHOS_TEST_EQUAL("frame", frameLabel.id);
+        POTHOS_TEST_EQUAL(numLateFrames + frame, frameLabel.data.convert<size_t>());
+        POTHOS_TEST_EQUAL(frame * length, frameLabel.index);
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_conv_decoder_priority)
+{
+    // Control channels default to high priority, everything else to normal.
+    auto rachDecoder = Pothos::BlockRegistry::make("/fec/gsm_rach_decoder");
+    POTHOS_TEST_EQUAL("High", rachDecoder.call<std::string>("priority"));
+
+    auto xcchDecoder = Pothos::BlockRegistry::make("/fec/gsm_xcch_decoder");
+    POTHOS_TEST_EQUAL("Normal", xcchDecoder.call<std::string>("priority"));
+
+    xcchDecoder.call("setPriority", "Low");
+    POTHOS_TEST_EQUAL("Low", xcchDecoder.call<std::string>("priority"));
+
+    POTHOS_TEST_THROWS(
+        xcchDecoder.call("setPriority", "Urgent"),
+        Pothos::ProxyExceptionMessage);
+
+    // Limiting decoding to a single slot must not stall decoding.
+    const auto maxConcurrentDecodes = FECTests::getAndCallPlugin<size_t>("/fec/decode_scheduler/get_max_concurrent_decodes");
+    FECTests::getAndCallPlugin<void>("/fec/decode_scheduler/set_max_concurrent_decodes", size_t(1));
+
+    double ber = 0.0;
+    testCodersAndGetBER(
+        Pothos::BlockRegistry::make("/fec/gsm_rach_encoder"),
+        rachDecoder,
+        &ber);
+    POTHOS_TEST_LT(ber, 1e-3);
+
+    FECTests::getAndCallPlugin<void>("/fec/decode_scheduler/set_max_concurrent_decodes", maxConcurrentDecodes);
+}
@@ -3,12 +3,22 @@
 
 #include "TestUtility.hpp"
 
+#include "CRC.hpp"
+#include "LTERateMatching.hpp"
+#include "LTESegmentation.hpp"
+#include "LTETurboInterleaver.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Exception.hpp>
 #include <Pothos/Framework.hpp>
 #include <Pothos/Proxy.hpp>
 #include <Pothos/Testing.hpp>
 
 #include <turbofec/turbo.h>
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -176,4 +186,1841 @@ POTHOS_TEST_BLOCK("/fec/tests", test_lte_coder_symmetry)
         randomInput.elements());
 }
 
+static void testLTEEncoderEngine(const std::string& engine)
+{
+    std::cout << " * Testing " << engine << "..." << std::endl;
+
+    constexpr size_t K = 512;
+    constexpr size_t numBlocks = 5;
+    constexpr size_t streamLength = K + 4;
+    constexpr size_t blockLength = 3 * streamLength;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(K * numBlocks);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        feederSource.call("feedLabel", Pothos::Label(blockStartID, K, (block * K)));
+    }
+
+    auto turboFECEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+
+    turboFECEncoder.call("setBlockStartID", blockStartID);
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteEncoder.call("setEngine", engine);
+    POTHOS_TEST_EQUAL(engine, lteEncoder.call<std::string>("engine"));
+
+    std::vector<Pothos::Proxy> expectedCollectorSinks;
+    std::vector<Pothos::Proxy> collectorSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        expectedCollectorSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+        collectorSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, turboFECEncoder, 0);
+        topology.connect(feederSource, 0, lteEncoder, 0);
+
+        for(size_t port = 0; port < 3; ++port)
+        {
+            topology.connect(turboFECEncoder, port, expectedCollectorSinks[port], 0);
+            topology.connect(lteEncoder, port, collectorSinks[port], 0);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // Only the first K+4 elements of each block are the stream.
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto expectedBuffer = expectedCollectorSinks[port].call<Pothos::BufferChunk>("getBuffer");
+        const auto outputBuffer = collectorSinks[port].call<Pothos::BufferChunk>("getBuffer");
+        POTHOS_TEST_EQUAL(numBlocks * blockLength, expectedBuffer.elements());
+        POTHOS_TEST_EQUAL(numBlocks * blockLength, outputBuffer.elements());
+
+        for(size_t block = 0; block < numBlocks; ++block)
+        {
+            POTHOS_TEST_EQUALA(
+                expectedBuffer.as<const std::uint8_t*>() + (block * blockLength),
+                outputBuffer.as<const std::uint8_t*>() + (block * blockLength),
+                streamLength);
+        }
+    }
+
+    const auto outputLabels = collectorSinks[0].call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(numBlocks, outputLabels.size());
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        testLabelsEqual(
+            Pothos::Label(blockStartID, blockLength, (block * blockLength)),
+            outputLabels[block]);
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_encoder_engines)
+{
+    testLTEEncoderEngine("Table");
+    testLTEEncoderEngine("Bitsliced");
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", 013U, 015U);
+    POTHOS_TEST_THROWS(
+        lteEncoder.call("setEngine", "Bitwise"),
+        Pothos::ProxyExceptionMessage);
+}
+
+// Encodes many more blocks than the encoder's output buffer pool holds, of
+// sizes up to the largest, so every pooled buffer is reused several times.
+static void testLTEEncoderBufferPool(const std::string& engine)
+{
+    std::cout << " * Testing " << engine << "..." << std::endl;
+
+    const std::vector<size_t> blockSizes = {40, TURBO_MAX_K, 512, 1056, TURBO_MAX_K, 40};
+    constexpr size_t numRepeats = 8;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    const std::string blockStartID = "START";
+
+    size_t numInputElems = 0;
+    for(size_t K: blockSizes) numInputElems += numRepeats * K;
+    const auto randomInput = getRandomInput(numInputElems);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteEncoder.call("setEngine", engine);
+
+    std::vector<Pothos::Proxy> collectorSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        collectorSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    // Encode each block on its own for the expected output.
+    std::vector<size_t> inputOffsets;
+    std::vector<std::vector<std::uint8_t>> expectedStreams(3);
+    size_t inputOffset = 0;
+    for(size_t repeat = 0; repeat < numRepeats; ++repeat)
+    {
+        for(size_t K: blockSizes)
+        {
+            feederSource.call("feedLabel", Pothos::Label(blockStartID, K, inputOffset));
+            inputOffsets.emplace_back(inputOffset);
+
+            struct lte_turbo_code turboCode = {2, 4, static_cast<int>(K), rgen, gen};
+            std::vector<std::uint8_t> streams(3 * (K + 4));
+            POTHOS_TEST_TRUE(::lte_turbo_encode(
+                                 &turboCode,
+                                 randomInput.as<const std::uint8_t*>() + inputOffset,
+                                 streams.data(),
+                                 streams.data() + (K + 4),
+                                 streams.data() + (2 * (K + 4))) > 0);
+            for(size_t port = 0; port < 3; ++port)
+            {
+                expectedStreams[port].insert(
+                    expectedStreams[port].end(),
+                    streams.begin() + (port * (K + 4)),
+                    streams.begin() + ((port + 1) * (K + 4)));
+            }
+
+            inputOffset += K;
+        }
+    }
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < 3; ++port)
+        {
+            topology.connect(lteEncoder, port, collectorSinks[port], 0);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // Only the first K+4 elements of each block are the stream.
+    const size_t numBlocks = inputOffsets.size();
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto outputBuffer = collectorSinks[port].call<Pothos::BufferChunk>("getBuffer");
+
+        size_t outputOffset = 0;
+        size_t streamOffset = 0;
+        for(size_t block = 0; block < numBlocks; ++block)
+        {
+            const size_t K = blockSizes[block % blockSizes.size()];
+            POTHOS_TEST_TRUE((outputOffset + (3 * (K + 4))) <= outputBuffer.elements());
+            POTHOS_TEST_EQUALA(
+                expectedStreams[port].data() + streamOffset,
+                outputBuffer.as<const std::uint8_t*>() + outputOffset,
+                (K + 4));
+
+            outputOffset += 3 * (K + 4);
+            streamOffset += K + 4;
+        }
+        POTHOS_TEST_EQUAL(outputOffset, outputBuffer.elements());
+    }
+
+    const auto outputLabels = collectorSinks[0].call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(numBlocks, outputLabels.size());
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_encoder_buffer_pool)
+{
+    testLTEEncoderBufferPool("TurboFEC");
+    testLTEEncoderBufferPool("Table");
+    testLTEEncoderBufferPool("Bitsliced");
+}
+
+static void testLTEInterleavedStreams(const std::string& engine)
+{
+    std::cout << " * Testing " << engine << "..." << std::endl;
+
+    constexpr size_t K = 1024;
+    constexpr size_t streamLength = K + 4;
+    constexpr size_t blockLength = 3 * streamLength;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(K);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, K, 0));
+
+    auto separateEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto interleavedEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+
+    separateEncoder.call("setBlockStartID", blockStartID);
+    interleavedEncoder.call("setStreamFormat", "Interleaved");
+    POTHOS_TEST_EQUAL("Interleaved", interleavedEncoder.call<std::string>("streamFormat"));
+    interleavedEncoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setStreamFormat", "Interleaved");
+    POTHOS_TEST_EQUAL("Interleaved", lteDecoder.call<std::string>("streamFormat"));
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+
+    std::vector<Pothos::Proxy> streamCollectorSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        streamCollectorSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+    auto interleavedCollectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, separateEncoder, 0);
+        topology.connect(feederSource, 0, interleavedEncoder, 0);
+
+        for(size_t port = 0; port < 3; ++port)
+        {
+            topology.connect(separateEncoder, port, streamCollectorSinks[port], 0);
+        }
+
+        topology.connect(interleavedEncoder, 0, interleavedCollectorSink, 0);
+        topology.connect(interleavedEncoder, 0, lteDecoder, 0);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // The interleaved output should hold the same streams.
+    const auto interleavedBuffer = interleavedCollectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(blockLength, interleavedBuffer.elements());
+
+    const auto interleavedLabels = interleavedCollectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(1, interleavedLabels.size());
+    testLabelsEqual(Pothos::Label(blockStartID, blockLength, 0), interleavedLabels[0]);
+
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto streamBuffer = streamCollectorSinks[port].call<Pothos::BufferChunk>("getBuffer");
+        POTHOS_TEST_EQUAL(blockLength, streamBuffer.elements());
+
+        for(size_t elem = 0; elem < streamLength; ++elem)
+        {
+            POTHOS_TEST_EQUAL(
+                int(streamBuffer.as<const std::uint8_t*>()[elem]),
+                int(interleavedBuffer.as<const std::uint8_t*>()[(3 * elem) + port]));
+        }
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(K, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        K);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_interleaved_streams)
+{
+    testLTEInterleavedStreams("TurboFEC");
+    testLTEInterleavedStreams("Max-Log-MAP 16-bit");
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", 013U, 015U);
+    POTHOS_TEST_THROWS(
+        lteEncoder.call("setStreamFormat", "Planar"),
+        Pothos::ProxyExceptionMessage);
+}
+
 // TODO: add noise to encoded values, decode, check BER
+
+static void testLTEFixedBlockSize(
+    size_t blockSize,
+    size_t numBlocks,
+    const std::string& encoderEngine,
+    const std::string& decoderEngine,
+    const std::string& streamFormat,
+    bool unpack)
+{
+    std::cout << " * Testing K=" << blockSize << " x " << numBlocks << " (" << encoderEngine << " -> " << decoderEngine
+              << ", " << streamFormat << ", unpack: " << std::boolalpha << unpack << ")..." << std::endl;
+
+    const size_t numElems = blockSize * numBlocks;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+
+    const auto randomInput = getRandomInput(numElems);
+
+    // Without labels, the blocks are only framed by their size.
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, unpack);
+
+    lteEncoder.call("setStreamFormat", streamFormat);
+    lteEncoder.call("setBlockStartID", "");
+    lteEncoder.call("setEngine", encoderEngine);
+    lteEncoder.call("setBlockSize", blockSize);
+    POTHOS_TEST_EQUAL(blockSize, lteEncoder.call<size_t>("blockSize"));
+
+    lteDecoder.call("setStreamFormat", streamFormat);
+    lteDecoder.call("setBlockStartID", "");
+    lteDecoder.call("setEngine", decoderEngine);
+    lteDecoder.call("setBlockSize", blockSize);
+    POTHOS_TEST_EQUAL(blockSize, lteDecoder.call<size_t>("blockSize"));
+
+    const size_t numPorts = ("Interleaved" == streamFormat) ? 1 : 3;
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < numPorts; ++port) topology.connect(lteEncoder, port, lteDecoder, port);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    auto expectedOutput = randomInput;
+    if(!unpack)
+    {
+        expectedOutput = Pothos::BufferChunk("uint8", (numElems / 8));
+        packBits(randomInput.as<const std::uint8_t*>(), expectedOutput.as<std::uint8_t*>(), numElems);
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.elements());
+
+    // Every block took the full number of iterations.
+    const auto iterationHistogram = lteDecoder.call<std::vector<unsigned long long>>("iterationHistogram");
+    POTHOS_TEST_EQUAL(numIterations+1, iterationHistogram.size());
+    POTHOS_TEST_EQUAL(numBlocks, iterationHistogram[numIterations]);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_fixed_block_size)
+{
+    testLTEFixedBlockSize(40, 200, "TurboFEC", "TurboFEC", "Separate", true);
+    testLTEFixedBlockSize(40, 200, "Bitsliced", "Max-Log-MAP 8-bit", "Interleaved", false);
+    testLTEFixedBlockSize(1024, 20, "Table", "Max-Log-MAP 16-bit", "Separate", true);
+    testLTEFixedBlockSize(6144, 3, "Bitsliced", "TurboFEC", "Interleaved", true);
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", 013U, 015U);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", size_t(4), true);
+    for(const size_t blockSize: {size_t(39), size_t(41), size_t(6145)})
+    {
+        POTHOS_TEST_THROWS(lteEncoder.call("setBlockSize", blockSize), Pothos::ProxyExceptionMessage);
+        POTHOS_TEST_THROWS(lteDecoder.call("setBlockSize", blockSize), Pothos::ProxyExceptionMessage);
+    }
+}
+
+static void testLTELabelFraming(const std::string& encoderEngine, const std::string& decoderEngine, bool sizedLabels)
+{
+    std::cout << " * Testing " << encoderEngine << " -> " << decoderEngine
+              << " (sized labels: " << std::boolalpha << sizedLabels << ")..." << std::endl;
+
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    // Runs of small blocks, which the bitsliced engine encodes together,
+    // between blocks of other sizes. With sized labels, there's junk between
+    // some blocks.
+    const std::vector<size_t> blockSizes = {40, 40, 40, 1024, 40, 6144, 512, 512, 512, 40};
+    const size_t junkSize = sizedLabels ? 13 : 0;
+
+    Pothos::BufferChunk input("uint8", 0);
+    std::vector<Pothos::Label> inputLabels;
+    Pothos::BufferChunk expectedOutput("uint8", 0);
+    for(size_t block = 0; block < blockSizes.size(); ++block)
+    {
+        if((junkSize > 0) && (0 == (block % 3))) input.append(getRandomInput(junkSize));
+
+        const auto blockBits = getRandomInput(blockSizes[block]);
+        if(sizedLabels) inputLabels.emplace_back(blockStartID, blockSizes[block], input.elements());
+        else            inputLabels.emplace_back(blockStartID, Pothos::Object(), input.elements());
+
+        input.append(blockBits);
+        expectedOutput.append(blockBits);
+    }
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", input);
+    for(const auto& label: inputLabels) feederSource.call("feedLabel", label);
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteEncoder.call("setEngine", encoderEngine);
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", decoderEngine);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < 3; ++port) topology.connect(lteEncoder, port, lteDecoder, port);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.elements());
+
+    // Each decoded block is marked, back to back.
+    std::vector<Pothos::Label> outputLabels;
+    for(const auto& label: collectorSink.call<std::vector<Pothos::Label>>("getLabels"))
+    {
+        if(label.id == blockStartID) outputLabels.push_back(label);
+    }
+    POTHOS_TEST_EQUAL(blockSizes.size(), outputLabels.size());
+
+    size_t offset = 0;
+    for(size_t block = 0; block < blockSizes.size(); ++block)
+    {
+        testLabelsEqual(Pothos::Label(blockStartID, blockSizes[block], offset), outputLabels[block]);
+        offset += blockSizes[block];
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_label_framing)
+{
+    testLTELabelFraming("TurboFEC", "TurboFEC", true);
+    testLTELabelFraming("Bitsliced", "Max-Log-MAP 8-bit", true);
+    testLTELabelFraming("Table", "Max-Log-MAP 16-bit", false);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_farm_symmetry)
+{
+    constexpr size_t numElems = 1024;
+    constexpr size_t numBlocks = 16;
+    constexpr size_t numWorkers = 3;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(numElems * numBlocks);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        feederSource.call("feedLabel", Pothos::Label(blockStartID, numElems, (block * numElems)));
+    }
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoderFarm = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder_farm", numIterations, true, numWorkers);
+    POTHOS_TEST_EQUAL(numWorkers, lteDecoderFarm.call<size_t>("numWorkers"));
+
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteDecoderFarm.call("setBlockStartID", blockStartID);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+
+        topology.connect(lteEncoder, 0, lteDecoderFarm, 0);
+        topology.connect(lteEncoder, 1, lteDecoderFarm, 1);
+        topology.connect(lteEncoder, 2, lteDecoderFarm, 2);
+
+        topology.connect(lteDecoderFarm, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    POTHOS_TEST_EQUAL(numBlocks, lteDecoderFarm.call<unsigned long long>("numFramesDecoded"));
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(randomInput.elements(), outputBuffer.elements());
+
+    // Blocks must come out in the order they went in.
+    const auto outputLabels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(numBlocks, outputLabels.size());
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        testLabelsEqual(
+            Pothos::Label(blockStartID, numElems, (block * numElems)),
+            outputLabels[block]);
+    }
+
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        randomInput.elements());
+}
+
+static void testLTEDecoderEarlyStopping(
+    const std::string& engine,
+    const std::string& stoppingCriterion,
+    const std::string& crcType,
+    size_t expectedNumIterations)
+{
+    constexpr size_t numElems = 1024;
+    constexpr size_t numCRCBits = 24;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 8;
+    const std::string blockStartID = "START";
+
+    // Fill the end of the block with its CRC, as a transmitter would.
+    auto randomInput = getRandomInput(numElems);
+    auto* inputBits = randomInput.as<std::uint8_t*>();
+    const auto crc = calcCRC24(CRCType::CRC24B, inputBits, (numElems - numCRCBits), true);
+    for(size_t bit = 0; bit < numCRCBits; ++bit)
+    {
+        inputBits[numElems - numCRCBits + bit] = (crc >> (numCRCBits - 1 - bit)) & 1;
+    }
+    POTHOS_TEST_TRUE(checkCRC24(CRCType::CRC24B, inputBits, numElems, true));
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, numElems, 0));
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+    lteDecoder.call("setCRCType", crcType);
+    lteDecoder.call("setStoppingCriterion", stoppingCriterion);
+    POTHOS_TEST_EQUAL(crcType, lteDecoder.call<std::string>("crcType"));
+    POTHOS_TEST_EQUAL(stoppingCriterion, lteDecoder.call<std::string>("stoppingCriterion"));
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+
+        topology.connect(lteEncoder, 0, lteDecoder, 0);
+        topology.connect(lteEncoder, 1, lteDecoder, 1);
+        topology.connect(lteEncoder, 2, lteDecoder, 2);
+
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(numElems, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        randomInput.elements());
+
+    // Only blocks that can stop early note how many iterations they took.
+    const bool stopsEarly = ("TurboFEC" != engine);
+    const auto outputLabels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL((stopsEarly ? 2 : 1), outputLabels.size());
+    testLabelsEqual(Pothos::Label(blockStartID, numElems, 0), outputLabels[0]);
+    if(stopsEarly) testLabelsEqual(Pothos::Label("iterations", expectedNumIterations, 0), outputLabels[1]);
+
+    const auto iterationHistogram = lteDecoder.call<std::vector<unsigned long long>>("iterationHistogram");
+    POTHOS_TEST_EQUAL(expectedNumIterations+1, iterationHistogram.size());
+    POTHOS_TEST_EQUAL(1, iterationHistogram[expectedNumIterations]);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_crc_early_termination)
+{
+    // With no noise, the in-tree engines' first iteration should pass the
+    // CRC, while TurboFEC can't stop early, so it runs all 8.
+    testLTEDecoderEarlyStopping("TurboFEC", "CRC", "CRC24B", 8);
+    testLTEDecoderEarlyStopping("Max-Log-MAP 16-bit", "CRC", "CRC24B", 1);
+    testLTEDecoderEarlyStopping("Log-MAP 8-bit", "CRC", "CRC24B", 1);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_hard_decision_early_termination)
+{
+    // With no noise, the second iteration should match the first.
+    testLTEDecoderEarlyStopping("TurboFEC", "Hard Decision", "None", 8);
+    testLTEDecoderEarlyStopping("Max-Log-MAP 16-bit", "Hard Decision", "None", 2);
+    testLTEDecoderEarlyStopping("Log-MAP 8-bit", "Hard Decision", "None", 2);
+}
+
+static void testLTEDecoderEngine(
+    const std::string& engine,
+    bool unpack,
+    size_t numWindows = 1,
+    size_t numThreads = 1)
+{
+    std::cout << " * Testing " << engine << " (unpack: " << std::boolalpha << unpack
+              << ", windows: " << numWindows << ", threads: " << numThreads << ")..." << std::endl;
+
+    constexpr size_t numElems = 1024;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(numElems);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, numElems, 0));
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, unpack);
+
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+    POTHOS_TEST_EQUAL(engine, lteDecoder.call<std::string>("engine"));
+    lteDecoder.call("setNumWindows", numWindows);
+    POTHOS_TEST_EQUAL(numWindows, lteDecoder.call<size_t>("numWindows"));
+    lteDecoder.call("setNumThreads", numThreads);
+    POTHOS_TEST_EQUAL(numThreads, lteDecoder.call<size_t>("numThreads"));
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+
+        topology.connect(lteEncoder, 0, lteDecoder, 0);
+        topology.connect(lteEncoder, 1, lteDecoder, 1);
+        topology.connect(lteEncoder, 2, lteDecoder, 2);
+
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // With no noise, every engine should recover the input exactly.
+    auto expectedOutput = randomInput;
+    if(!unpack)
+    {
+        expectedOutput = Pothos::BufferChunk("uint8", (numElems / 8));
+        packBits(randomInput.as<const std::uint8_t*>(), expectedOutput.as<std::uint8_t*>(), numElems);
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.elements());
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_engines)
+{
+    const std::vector<std::string> engines =
+    {
+        "TurboFEC",
+        "Max-Log-MAP 16-bit",
+        "Log-MAP 16-bit",
+        "Max-Log-MAP 8-bit",
+        "Log-MAP 8-bit",
+    };
+
+    for(const auto& engine: engines)
+    {
+        testLTEDecoderEngine(engine, true);
+        testLTEDecoderEngine(engine, false);
+    }
+}
+
+// The encoder's 0/1 output hides how an engine handles large LLRs, so map
+// each bit to +/- the amplitude instead, which any engine must decode
+// exactly.
+static void testLTEDecoderNoiselessLLRs(
+    const std::string& engine,
+    size_t K,
+    std::int8_t amplitude)
+{
+    std::cout << " * Testing " << engine << " (K: " << K << ", amplitude: " << int(amplitude) << ")..." << std::endl;
+
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(K);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, K, 0));
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    lteEncoder.call("setBlockStartID", blockStartID);
+
+    std::vector<Pothos::Proxy> encodedSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        encodedSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < 3; ++port) topology.connect(lteEncoder, port, encodedSinks[port], 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    std::vector<Pothos::Proxy> softSources;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto encoded = encodedSinks[port].call<Pothos::BufferChunk>("getBuffer");
+
+        Pothos::BufferChunk softBits("int8", encoded.elements());
+        for(size_t elem = 0; elem < encoded.elements(); ++elem)
+        {
+            softBits.as<std::int8_t*>()[elem] = encoded.as<const std::uint8_t*>()[elem] ? amplitude : -amplitude;
+        }
+
+        softSources.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", "int8"));
+        softSources.back().call("feedBuffer", softBits);
+        if(0 == port) softSources.back().call("feedLabel", Pothos::Label(blockStartID, encoded.elements(), 0));
+    }
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+    lteDecoder.call("setInputType", "int8");
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        for(size_t port = 0; port < 3; ++port) topology.connect(softSources[port], 0, lteDecoder, port);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(K, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        K);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_noiseless_llrs)
+{
+    const std::vector<std::string> engines =
+    {
+        "TurboFEC",
+        "Max-Log-MAP 16-bit",
+        "Log-MAP 16-bit",
+        "Max-Log-MAP 8-bit",
+        "Log-MAP 8-bit",
+    };
+
+    for(const auto& engine: engines)
+    {
+        for(size_t K: {40, 512, 6144})
+        {
+            for(std::int8_t amplitude: {8, 32, 64, 127})
+            {
+                testLTEDecoderNoiselessLLRs(engine, K, amplitude);
+            }
+        }
+    }
+}
+
+static void testLTEDecoderAdaptiveIterations(const std::string& engine)
+{
+    std::cout << " * Testing " << engine << "..." << std::endl;
+
+    constexpr size_t blockSize = 512;
+    constexpr size_t numBlocks = 64;
+    constexpr size_t numElems = blockSize * numBlocks;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(numElems);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        feederSource.call("feedLabel", Pothos::Label(blockStartID, blockSize, (block * blockSize)));
+    }
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+    lteDecoder.call("setStoppingCriterion", "Hard Decision");
+
+    POTHOS_TEST_THROWS(lteDecoder.call("setTargetBLER", 0.0), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(lteDecoder.call("setTargetBLER", 1.0), Pothos::ProxyExceptionMessage);
+
+    lteDecoder.call("setTargetBLER", 0.05);
+    POTHOS_TEST_CLOSE(0.05, lteDecoder.call<double>("targetBLER"), 1e-9);
+    lteDecoder.call("setAdaptiveIterations", true);
+    POTHOS_TEST_TRUE(lteDecoder.call<bool>("adaptiveIterations"));
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+
+        topology.connect(lteEncoder, 0, lteDecoder, 0);
+        topology.connect(lteEncoder, 1, lteDecoder, 1);
+        topology.connect(lteEncoder, 2, lteDecoder, 2);
+
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // Noiseless blocks converge right away, so the learned cap must not
+    // cost any decodes.
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(randomInput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        randomInput.elements());
+
+    // Every block's cap is recorded, and no cap exceeds numIterations.
+    const auto histogram = lteDecoder.call<std::vector<unsigned long long>>("iterationCapHistogram");
+    POTHOS_TEST_TRUE(histogram.size() <= (numIterations+1));
+
+    unsigned long long numCaps = 0;
+    for(const auto& count: histogram) numCaps += count;
+    POTHOS_TEST_EQUAL(numBlocks, numCaps);
+
+    lteDecoder.call("resetIterationCapHistogram");
+    POTHOS_TEST_TRUE(lteDecoder.call<std::vector<unsigned long long>>("iterationCapHistogram").empty());
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_adaptive_iterations)
+{
+    testLTEDecoderAdaptiveIterations("TurboFEC");
+    testLTEDecoderAdaptiveIterations("Max-Log-MAP 16-bit");
+    testLTEDecoderAdaptiveIterations("Log-MAP 8-bit");
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_windows)
+{
+    const std::vector<std::string> engines =
+    {
+        "Max-Log-MAP 16-bit",
+        "Log-MAP 16-bit",
+        "Max-Log-MAP 8-bit",
+        "Log-MAP 8-bit",
+    };
+
+    for(const auto& engine: engines)
+    {
+        testLTEDecoderEngine(engine, true, 8, 1);
+        testLTEDecoderEngine(engine, true, 8, 2);
+        testLTEDecoderEngine(engine, false, 3, 2);
+    }
+}
+
+template <typename T>
+static void testLTEDecoderSoftOutput(
+    const std::string& engine,
+    size_t numElems)
+{
+    const std::string softOutputType = Pothos::DType::fromDType<T>().name();
+    std::cout << " * Testing " << engine << " (soft output: " << softOutputType << ", K: " << numElems << ")..." << std::endl;
+
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(numElems);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, numElems, 0));
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+
+    lteEncoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+    lteDecoder.call("setSoftOutputType", softOutputType);
+    POTHOS_TEST_EQUAL(softOutputType, lteDecoder.call<std::string>("softOutputType"));
+    lteDecoder.call("setBlockStartID", blockStartID);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+    auto softCollectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", softOutputType);
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+
+        topology.connect(lteEncoder, 0, lteDecoder, 0);
+        topology.connect(lteEncoder, 1, lteDecoder, 1);
+        topology.connect(lteEncoder, 2, lteDecoder, 2);
+
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+        topology.connect(lteDecoder, 1, softCollectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // There should be one LLR per decoded bit, agreeing with the decoded bits.
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    const auto softOutputBuffer = softCollectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(numElems, outputBuffer.elements());
+    POTHOS_TEST_EQUAL(numElems, softOutputBuffer.elements());
+
+    const auto* bits = outputBuffer.as<const std::uint8_t*>();
+    const auto* llrs = softOutputBuffer.as<const T*>();
+    for(size_t elem = 0; elem < numElems; ++elem)
+    {
+        POTHOS_TEST_EQUAL(randomInput.as<const std::uint8_t*>()[elem], bits[elem]);
+        POTHOS_TEST_EQUAL((0 != bits[elem]), (llrs[elem] > 0));
+        POTHOS_TEST_TRUE(T(0) != llrs[elem]);
+    }
+
+    const auto softOutputLabels = softCollectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_FALSE(softOutputLabels.empty());
+    POTHOS_TEST_EQUAL(blockStartID, softOutputLabels[0].id);
+    POTHOS_TEST_EQUAL(0U, softOutputLabels[0].index);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_soft_output)
+{
+    // TurboFEC only outputs decoded bits.
+    const std::vector<std::string> engines =
+    {
+        "Max-Log-MAP 16-bit",
+        "Log-MAP 16-bit",
+        "Max-Log-MAP 8-bit",
+        "Log-MAP 8-bit",
+    };
+
+    for(const auto& engine: engines)
+    {
+        testLTEDecoderSoftOutput<std::int8_t>(engine, 1024);
+        testLTEDecoderSoftOutput<std::int16_t>(engine, 1024);
+    }
+
+    // The largest block, at the widest soft output type, must still fit in
+    // the output buffers.
+    testLTEDecoderSoftOutput<std::int16_t>("Max-Log-MAP 16-bit", TURBO_MAX_K);
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", size_t(4), true);
+    POTHOS_TEST_THROWS(
+        lteDecoder.call("setSoftOutputType", "float32"),
+        Pothos::ProxyExceptionMessage);
+
+    // Soft output can't be combined with TurboFEC, whichever is set first.
+    POTHOS_TEST_EQUAL("TurboFEC", lteDecoder.call<std::string>("engine"));
+    POTHOS_TEST_THROWS(
+        lteDecoder.call("setSoftOutputType", "int8"),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_EQUAL("None", lteDecoder.call<std::string>("softOutputType"));
+
+    lteDecoder.call("setEngine", "Max-Log-MAP 8-bit");
+    lteDecoder.call("setSoftOutputType", "int8");
+    POTHOS_TEST_THROWS(
+        lteDecoder.call("setEngine", "TurboFEC"),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_EQUAL("Max-Log-MAP 8-bit", lteDecoder.call<std::string>("engine"));
+
+    lteDecoder.call("setSoftOutputType", "None");
+    lteDecoder.call("setEngine", "TurboFEC");
+}
+
+template <typename T>
+static void testLTEDecoderInputScaling(
+    const std::string& engine,
+    const std::string& inputScaling,
+    double amplitude,
+    double inputScale,
+    int inputSaturation)
+{
+    const std::string inputType = Pothos::DType::fromDType<T>().name();
+    std::cout << " * Testing " << engine << " (input: " << inputType << ", scaling: " << inputScaling
+              << ", amplitude: " << amplitude << ", saturation: " << inputSaturation << ")..." << std::endl;
+
+    constexpr size_t K = 1024;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(K);
+
+    // First, encode the block.
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, K, 0));
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    lteEncoder.call("setBlockStartID", blockStartID);
+
+    std::vector<Pothos::Proxy> encodedSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        encodedSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < 3; ++port) topology.connect(lteEncoder, port, encodedSinks[port], 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // Map each bit to +/- the amplitude, with a little deterministic noise,
+    // so the auto scaling has noise to measure.
+    std::vector<Pothos::Proxy> softSources;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto encoded = encodedSinks[port].call<Pothos::BufferChunk>("getBuffer");
+
+        Pothos::BufferChunk softBits(inputType, encoded.elements());
+        for(size_t elem = 0; elem < encoded.elements(); ++elem)
+        {
+            const double noise = amplitude * double(int((elem * 5) % 7) - 3) / 12.0;
+            const double value = (encoded.as<const std::uint8_t*>()[elem] ? amplitude : -amplitude) + noise;
+            softBits.as<T*>()[elem] = static_cast<T>(value);
+        }
+
+        softSources.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", inputType));
+        softSources.back().call("feedBuffer", softBits);
+        if(0 == port) softSources.back().call("feedLabel", Pothos::Label(blockStartID, encoded.elements(), 0));
+    }
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+    lteDecoder.call("setInputType", inputType);
+    POTHOS_TEST_EQUAL(inputType, lteDecoder.call<std::string>("inputType"));
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setEngine", engine);
+    lteDecoder.call("setInputScaling", inputScaling);
+    lteDecoder.call("setInputScale", inputScale);
+    lteDecoder.call("setInputSaturation", inputSaturation);
+    POTHOS_TEST_EQUAL(inputScaling, lteDecoder.call<std::string>("inputScaling"));
+    POTHOS_TEST_CLOSE(inputScale, lteDecoder.call<double>("inputScale"), 1e-9);
+    POTHOS_TEST_EQUAL(inputSaturation, lteDecoder.call<int>("inputSaturation"));
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        for(size_t port = 0; port < 3; ++port) topology.connect(softSources[port], 0, lteDecoder, port);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(K, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        K);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_input_scaling)
+{
+    // Soft bits too small for 8 bits without scaling
+    testLTEDecoderInputScaling<float>("TurboFEC", "Auto", 0.5, 1.0, 127);
+    testLTEDecoderInputScaling<float>("Log-MAP 16-bit", "Auto", 0.5, 1.0, 127);
+    testLTEDecoderInputScaling<float>("Max-Log-MAP 8-bit", "Fixed", 0.5, 64.0, 127);
+
+    // Soft bits too large for 8 bits without scaling
+    testLTEDecoderInputScaling<std::int16_t>("TurboFEC", "Fixed", 2000.0, 0.05, 127);
+    testLTEDecoderInputScaling<std::int16_t>("Max-Log-MAP 16-bit", "Auto", 2000.0, 1.0, 127);
+    testLTEDecoderInputScaling<std::int16_t>("Log-MAP 8-bit", "None", 2000.0, 1.0, 100);
+
+    // 8-bit soft bits, saturated for headroom
+    testLTEDecoderInputScaling<std::int8_t>("Max-Log-MAP 8-bit", "None", 100.0, 1.0, 32);
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", size_t(4), true);
+    lteDecoder.call("setInputType", "int16");
+    POTHOS_TEST_THROWS(lteDecoder.call("setInputScaling", "Bad"), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(lteDecoder.call("setInputScale", 0.0), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(lteDecoder.call("setInputSaturation", 0), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(lteDecoder.call("setInputSaturation", 128), Pothos::ProxyExceptionMessage);
+
+    POTHOS_TEST_THROWS(
+        lteDecoder.call("setInputType", "complex_float32"),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        lteDecoder.call("setStreamFormat", "Bad"),
+        Pothos::ProxyExceptionMessage);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_qpp_interleavers)
+{
+    size_t numBlockSizes = 0;
+
+    for(size_t K = TURBO_MIN_K; K <= TURBO_MAX_K; ++K)
+    {
+        size_t f1 = 0;
+        size_t f2 = 0;
+        if(!getQPPParams(K, &f1, &f2))
+        {
+            POTHOS_TEST_THROWS(getQPPInterleaver(K), Pothos::InvalidArgumentException);
+            continue;
+        }
+        ++numBlockSizes;
+
+        // Every call should return the same shared tables.
+        const auto& interleaver = getQPPInterleaver(K);
+        POTHOS_TEST_EQUAL(&interleaver, &getQPPInterleaver(K));
+        POTHOS_TEST_EQUAL(K, interleaver.K);
+        POTHOS_TEST_EQUAL(K, interleaver.forward.size());
+        POTHOS_TEST_EQUAL(K, interleaver.inverse.size());
+
+        std::vector<std::int16_t> input(K + 1, 0);
+        for(size_t i = 0; i < K; ++i)
+        {
+            POTHOS_TEST_EQUAL(((f1 * i) + (f2 * i * i)) % K, interleaver.forward[i]);
+            POTHOS_TEST_EQUAL(i, interleaver.inverse[interleaver.forward[i]]);
+
+            input[i] = static_cast<std::int16_t>(i);
+        }
+
+        // Permuting with the inverse should undo the forward permutation.
+        std::vector<std::int16_t> interleaved(K + 1, 0);
+        std::vector<std::int16_t> deinterleaved(K, 0);
+        permute(input.data(), interleaver.forward.data(), interleaved.data(), K);
+        permute(interleaved.data(), interleaver.inverse.data(), deinterleaved.data(), K);
+        POTHOS_TEST_EQUALA(input.data(), deinterleaved.data(), K);
+    }
+
+    POTHOS_TEST_EQUAL(size_t(188), numBlockSizes);
+}
+
+static void testLTEDecoderTransportBlock(const std::string& engine, size_t numCodeBlockThreads)
+{
+    std::cout << " * Testing " << engine << " (threads: " << numCodeBlockThreads << ")..." << std::endl;
+
+    const std::vector<size_t> codeBlockSizes = {1024, 512, 6144, 40, 2048};
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+    const std::string transportBlockID = "TB_START";
+
+    size_t numElems = 0;
+    for(const auto codeBlockSize: codeBlockSizes) numElems += codeBlockSize;
+
+    const auto randomInput = getRandomInput(numElems);
+
+    // Encode each code block separately, as a transmitter would.
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    size_t offset = 0;
+    for(const auto codeBlockSize: codeBlockSizes)
+    {
+        feederSource.call("feedLabel", Pothos::Label(blockStartID, codeBlockSize, offset));
+        offset += codeBlockSize;
+    }
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    lteEncoder.call("setBlockStartID", blockStartID);
+
+    std::vector<Pothos::Proxy> encodedSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        encodedSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < 3; ++port) topology.connect(lteEncoder, port, encodedSinks[port], 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // Then decode them all at once, as one transport block.
+    std::vector<Pothos::Proxy> encodedSources;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto encoded = encodedSinks[port].call<Pothos::BufferChunk>("getBuffer");
+
+        encodedSources.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8"));
+        encodedSources.back().call("feedBuffer", encoded);
+        if(0 == port)
+        {
+            encodedSources.back().call("feedLabel", Pothos::Label(transportBlockID, encoded.elements(), 0));
+            for(const auto& label: encodedSinks[port].call<std::vector<Pothos::Label>>("getLabels"))
+            {
+                encodedSources.back().call("feedLabel", label);
+            }
+        }
+    }
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+    lteDecoder.call("setBlockStartID", blockStartID);
+    lteDecoder.call("setTransportBlockID", transportBlockID);
+    lteDecoder.call("setEngine", engine);
+    lteDecoder.call("setNumCodeBlockThreads", numCodeBlockThreads);
+    POTHOS_TEST_EQUAL(transportBlockID, lteDecoder.call<std::string>("transportBlockID"));
+    POTHOS_TEST_EQUAL(numCodeBlockThreads, lteDecoder.call<size_t>("numCodeBlockThreads"));
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        for(size_t port = 0; port < 3; ++port) topology.connect(encodedSources[port], 0, lteDecoder, port);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(numElems, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        numElems);
+
+    const auto outputLabels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(codeBlockSizes.size()+1, outputLabels.size());
+    testLabelsEqual(Pothos::Label(transportBlockID, numElems, 0), outputLabels[0]);
+
+    offset = 0;
+    for(size_t codeBlock = 0; codeBlock < codeBlockSizes.size(); ++codeBlock)
+    {
+        testLabelsEqual(
+            Pothos::Label(blockStartID, codeBlockSizes[codeBlock], offset),
+            outputLabels[codeBlock+1]);
+        offset += codeBlockSizes[codeBlock];
+    }
+
+    const auto iterationHistogram = lteDecoder.call<std::vector<unsigned long long>>("iterationHistogram");
+    POTHOS_TEST_EQUAL(numIterations+1, iterationHistogram.size());
+    POTHOS_TEST_EQUAL(codeBlockSizes.size(), iterationHistogram[numIterations]);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_decoder_transport_blocks)
+{
+    testLTEDecoderTransportBlock("TurboFEC", 1);
+    testLTEDecoderTransportBlock("TurboFEC", 3);
+    testLTEDecoderTransportBlock("Max-Log-MAP 8-bit", 3);
+}
+
+static void testLTERateMatching(
+    size_t outputSize,
+    size_t rv,
+    size_t numFillerBits,
+    size_t circularBufferSize)
+{
+    std::cout << " * Testing E=" << outputSize << ", rv=" << rv
+              << ", F=" << numFillerBits << ", Ncb=" << circularBufferSize << "..." << std::endl;
+
+    constexpr size_t K = 1024;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    constexpr std::int8_t amplitude = 32;
+    const std::string blockStartID = "START";
+
+    // Filler bits are encoded as zeros.
+    auto randomInput = getRandomInput(K);
+    std::memset(randomInput.as<std::uint8_t*>(), 0, numFillerBits);
+
+    // First, encode and rate match the block.
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, K, 0));
+
+    auto lteEncoder = Pothos::BlockRegistry::make("/fec/lte_turbo_encoder", rgen, gen);
+    lteEncoder.call("setBlockStartID", blockStartID);
+
+    auto rateMatcher = Pothos::BlockRegistry::make("/fec/lte_rate_matcher");
+    rateMatcher.call("setBlockStartID", blockStartID);
+    rateMatcher.call("setOutputSize", outputSize);
+    rateMatcher.call("setRV", rv);
+    rateMatcher.call("setNumFillerBits", numFillerBits);
+    rateMatcher.call("setCircularBufferSize", circularBufferSize);
+    POTHOS_TEST_EQUAL(outputSize, rateMatcher.call<size_t>("outputSize"));
+    POTHOS_TEST_EQUAL(rv, rateMatcher.call<size_t>("rv"));
+    POTHOS_TEST_EQUAL(numFillerBits, rateMatcher.call<size_t>("numFillerBits"));
+    POTHOS_TEST_EQUAL(circularBufferSize, rateMatcher.call<size_t>("circularBufferSize"));
+
+    auto rateMatchedSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, lteEncoder, 0);
+        for(size_t port = 0; port < 3; ++port) topology.connect(lteEncoder, port, rateMatcher, port);
+        topology.connect(rateMatcher, 0, rateMatchedSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto rateMatched = rateMatchedSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(outputSize, rateMatched.elements());
+
+    const auto rateMatchedLabels = rateMatchedSink.call<std::vector<Pothos::Label>>("getLabels");
+    const size_t Ncb = (0 == circularBufferSize) ? getLTEFullCircularBufferSize(K) : circularBufferSize;
+    POTHOS_TEST_EQUAL(5, rateMatchedLabels.size());
+    testLabelsEqual(Pothos::Label(blockStartID, outputSize, 0), rateMatchedLabels[0]);
+    testLabelsEqual(Pothos::Label("blockSize", K, 0), rateMatchedLabels[1]);
+    testLabelsEqual(Pothos::Label("rv", rv, 0), rateMatchedLabels[2]);
+    testLabelsEqual(Pothos::Label("numFillerBits", numFillerBits, 0), rateMatchedLabels[3]);
+    testLabelsEqual(Pothos::Label("circularBufferSize", Ncb, 0), rateMatchedLabels[4]);
+
+    // Then, without noise, de-rate-match and decode the soft bits.
+    Pothos::BufferChunk softBits("int8", outputSize);
+    for(size_t elem = 0; elem < outputSize; ++elem)
+    {
+        softBits.as<std::int8_t*>()[elem] = rateMatched.as<const std::uint8_t*>()[elem] ? amplitude : -amplitude;
+    }
+
+    auto softSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "int8");
+    softSource.call("feedBuffer", softBits);
+    for(const auto& label: rateMatchedLabels) softSource.call("feedLabel", label);
+
+    auto rateDematcher = Pothos::BlockRegistry::make("/fec/lte_rate_dematcher");
+    rateDematcher.call("setBlockStartID", blockStartID);
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+    lteDecoder.call("setBlockStartID", blockStartID);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(softSource, 0, rateDematcher, 0);
+        for(size_t port = 0; port < 3; ++port) topology.connect(rateDematcher, port, lteDecoder, port);
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(K, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        randomInput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        K);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_rate_matching)
+{
+    // Punctured, then repeated more than twice over
+    testLTERateMatching(2000, 0, 0, 0);
+    testLTERateMatching(7000, 2, 0, 0);
+
+    // Filler bits, and a downlink circular buffer smaller than Kw
+    testLTERateMatching(2000, 1, 40, 0);
+    testLTERateMatching(4000, 3, 24, 2500);
+
+    auto rateMatcher = Pothos::BlockRegistry::make("/fec/lte_rate_matcher");
+    POTHOS_TEST_THROWS(
+        rateMatcher.call("setRV", size_t(4)),
+        Pothos::ProxyExceptionMessage);
+}
+
+// A direct implementation of rate matching from 3GPP TS 36.212, section
+// 5.1.4.1, keeping the <NULL> bits in the circular buffer. Returns where
+// each transmitted bit comes from in the encoder output streams, laid out
+// one after another.
+static std::vector<size_t> referenceLTERateMatch(
+    size_t K,
+    size_t F,
+    size_t Ncb,
+    size_t rv,
+    size_t E)
+{
+    // Table 5.1.4-1
+    static const size_t P[32] =
+    {
+        0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30,
+        1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31
+    };
+    constexpr size_t C = 32;
+    constexpr long Null = -1;
+
+    const size_t D = K + 4;
+    const size_t R = (D + C - 1) / C;
+    const size_t Kpi = R * C;
+    const size_t ND = Kpi - D;
+
+    // Section 5.1.3.2.1: d(0) and d(1) are <NULL> where the input is filler.
+    std::vector<long> v[3];
+    for(size_t i = 0; i < 3; ++i)
+    {
+        std::vector<long> y(Kpi, Null);
+        for(size_t k = 0; k < D; ++k)
+        {
+            if((i < 2) && (k < F)) continue;
+            y[ND + k] = long((i * D) + k);
+        }
+
+        v[i].resize(Kpi);
+        for(size_t k = 0; k < Kpi; ++k)
+        {
+            const size_t index = P[k / R] + (C * (k % R));
+            v[i][k] = (i < 2) ? y[index] : y[(index + 1) % Kpi];
+        }
+    }
+
+    std::vector<long> w(3 * Kpi);
+    for(size_t k = 0; k < Kpi; ++k)
+    {
+        w[k] = v[0][k];
+        w[Kpi + (2 * k)] = v[1][k];
+        w[Kpi + (2 * k) + 1] = v[2][k];
+    }
+
+    const size_t k0 = R * ((2 * ((Ncb + (8 * R) - 1) / (8 * R)) * rv) + 2);
+
+    std::vector<size_t> e;
+    for(size_t j = 0; e.size() < E; ++j)
+    {
+        const auto bit = w[(k0 + j) % Ncb];
+        if(Null != bit) e.push_back(size_t(bit));
+    }
+
+    return e;
+}
+
+static void testLTERateMatchingReference(size_t K, size_t F, size_t Ncb)
+{
+    std::cout << " * Testing K=" << K << ", F=" << F << ", Ncb=" << Ncb << "..." << std::endl;
+
+    const size_t D = K + 4;
+    const auto& circularBuffer = getLTECircularBuffer(K, F, Ncb);
+
+    // Distinct enough values that any misplaced bit shows up
+    std::vector<std::uint8_t> streams(3 * D);
+    for(size_t elem = 0; elem < streams.size(); ++elem) streams[elem] = std::uint8_t((elem * 37) % 251);
+
+    std::vector<std::int8_t> softBits;
+    std::vector<std::int8_t> streamsOut(3 * D);
+    std::vector<std::int8_t> scratch(3 * D);
+
+    for(size_t rv = 0; rv < NumLTERedundancyVersions; ++rv)
+    {
+        // Punctured, then repeated
+        for(const size_t E: {(Ncb / 3), (2 * Ncb)})
+        {
+            const auto expectedIndices = referenceLTERateMatch(K, F, Ncb, rv, E);
+
+            std::vector<std::uint8_t> bits(E);
+            rateMatch(circularBuffer, rv, streams.data(), bits.data(), E);
+            for(size_t elem = 0; elem < E; ++elem)
+            {
+                POTHOS_TEST_EQUAL(int(streams[expectedIndices[elem]]), int(bits[elem]));
+            }
+
+            // De-rate-matching should put each soft bit back where it came
+            // from, combining repeats, and leave <NULL> bits at 0.
+            softBits.resize(E);
+            std::vector<int> expectedStreams(3 * D, 0);
+            for(size_t elem = 0; elem < E; ++elem)
+            {
+                softBits[elem] = (elem % 3) ? 1 : -1;
+                expectedStreams[expectedIndices[elem]] += softBits[elem];
+            }
+
+            deRateMatch(circularBuffer, rv, softBits.data(), E, streamsOut.data(), scratch.data());
+            for(size_t elem = 0; elem < (3 * D); ++elem)
+            {
+                POTHOS_TEST_EQUAL(expectedStreams[elem], int(streamsOut[elem]));
+            }
+        }
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_rate_matching_reference)
+{
+    testLTERateMatchingReference(40, 0, getLTEFullCircularBufferSize(40));
+    testLTERateMatchingReference(1024, 0, getLTEFullCircularBufferSize(1024));
+    testLTERateMatchingReference(1024, 40, getLTEFullCircularBufferSize(1024));
+    testLTERateMatchingReference(40, 8, 100);
+    testLTERateMatchingReference(2048, 63, 4000);
+    testLTERateMatchingReference(6144, 24, 12000);
+
+    POTHOS_TEST_THROWS(
+        getLTECircularBuffer(1024, 1024, getLTEFullCircularBufferSize(1024)),
+        Pothos::InvalidArgumentException);
+    POTHOS_TEST_THROWS(
+        getLTECircularBuffer(1024, 0, (getLTEFullCircularBufferSize(1024) + 1)),
+        Pothos::InvalidArgumentException);
+}
+
+template <typename T>
+static void testLTEHARQBuffer()
+{
+    const std::string softType = Pothos::DType::fromDType<T>().name();
+    std::cout << " * Testing " << softType << " soft buffers..." << std::endl;
+
+    constexpr size_t K = 1024;
+    constexpr size_t D = K + 4;
+    constexpr size_t circularBufferSize = 3 * D;
+    constexpr unsigned rgen = 013;
+    constexpr unsigned gen = 015;
+    constexpr size_t numIterations = 4;
+    constexpr size_t harqProcess = 3;
+    constexpr int amplitude = 32;
+    const std::string blockStartID = "START";
+
+    const auto randomInput = getRandomInput(K);
+
+    std::vector<std::uint8_t> encoded(3 * circularBufferSize);
+    struct lte_turbo_code turboCode = {2, 4, static_cast<int>(K), rgen, gen};
+    POTHOS_TEST_EQUAL(
+        int(circularBufferSize),
+        ::lte_turbo_encode(
+            &turboCode,
+            randomInput.as<const std::uint8_t*>(),
+            encoded.data(),
+            encoded.data() + circularBufferSize,
+            encoded.data() + (2 * circularBufferSize)));
+
+    // The soft circular buffer, as a rate matcher would transmit from
+    const auto& circularBuffer = getLTECircularBuffer(K);
+    POTHOS_TEST_EQUAL(circularBufferSize, circularBuffer.streamIndices.size());
+
+    std::vector<int> softCircularBuffer(circularBufferSize);
+    for(size_t elem = 0; elem < circularBufferSize; ++elem)
+    {
+        const size_t streamIndex = circularBuffer.streamIndices[elem];
+        const auto bit = encoded[((streamIndex / D) * circularBufferSize) + (streamIndex % D)];
+        softCircularBuffer[elem] = bit ? amplitude : -amplitude;
+    }
+
+    // A full first transmission, then half of the circular buffer again,
+    // at another redundancy version.
+    const size_t transmissionSizes[] = {circularBufferSize, (circularBufferSize / 2)};
+    const size_t rvs[] = {0, 2};
+
+    Pothos::BufferChunk softBits(softType, (transmissionSizes[0] + transmissionSizes[1]));
+    std::vector<int> expectedCombined(circularBufferSize, 0);
+
+    const size_t indices[] = {0, transmissionSizes[0]};
+    for(size_t transmission = 0; transmission < 2; ++transmission)
+    {
+        for(size_t elem = 0; elem < transmissionSizes[transmission]; ++elem)
+        {
+            const size_t position = (circularBuffer.startIndices[rvs[transmission]] + elem) % circularBufferSize;
+            softBits.as<T*>()[indices[transmission] + elem] = static_cast<T>(softCircularBuffer[position]);
+            expectedCombined[position] += softCircularBuffer[position];
+        }
+    }
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", softType);
+    feederSource.call("feedBuffer", softBits);
+
+    for(size_t transmission = 0; transmission < 2; ++transmission)
+    {
+        const size_t index = indices[transmission];
+        feederSource.call("feedLabel", Pothos::Label(blockStartID, transmissionSizes[transmission], index));
+        feederSource.call("feedLabel", Pothos::Label("blockSize", K, index));
+        feederSource.call("feedLabel", Pothos::Label("harqProcess", harqProcess, index));
+        feederSource.call("feedLabel", Pothos::Label("rv", rvs[transmission], index));
+    }
+
+    auto harqBuffer = Pothos::BlockRegistry::make("/fec/lte_harq_buffer", size_t(8), softType);
+    harqBuffer.call("setBlockStartID", blockStartID);
+
+    auto lteDecoder = Pothos::BlockRegistry::make("/fec/lte_turbo_decoder", numIterations, true);
+    lteDecoder.call("setBlockStartID", blockStartID);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+    std::vector<Pothos::Proxy> streamCollectorSinks;
+    for(size_t port = 0; port < 3; ++port)
+    {
+        streamCollectorSinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8"));
+    }
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, harqBuffer, 0);
+
+        for(size_t port = 0; port < 3; ++port)
+        {
+            topology.connect(harqBuffer, port, lteDecoder, port);
+            topology.connect(harqBuffer, port, streamCollectorSinks[port], 0);
+        }
+
+        topology.connect(lteDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    POTHOS_TEST_EQUAL(2, harqBuffer.call<size_t>("numTransmissions", harqProcess));
+
+    // The second output block holds both transmissions, combined.
+    for(size_t port = 0; port < 3; ++port)
+    {
+        const auto streamBuffer = streamCollectorSinks[port].call<Pothos::BufferChunk>("getBuffer");
+        POTHOS_TEST_EQUAL((2 * circularBufferSize), streamBuffer.elements());
+
+        const auto* combinedStream = streamBuffer.as<const std::int8_t*>() + circularBufferSize;
+        for(size_t elem = 0; elem < circularBufferSize; ++elem)
+        {
+            const size_t streamIndex = circularBuffer.streamIndices[elem];
+            if(port != (streamIndex / D)) continue;
+
+            const int expected = std::min(std::max(expectedCombined[elem], -128), 127);
+            POTHOS_TEST_EQUAL(expected, int(combinedStream[streamIndex % D]));
+        }
+    }
+
+    // Both blocks should decode.
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL((2 * K), outputBuffer.elements());
+    for(size_t block = 0; block < 2; ++block)
+    {
+        POTHOS_TEST_EQUALA(
+            randomInput.as<const std::uint8_t*>(),
+            outputBuffer.as<const std::uint8_t*>() + (block * K),
+            K);
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_harq_buffer)
+{
+    testLTEHARQBuffer<std::int8_t>();
+    testLTEHARQBuffer<std::int16_t>();
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/fec/lte_harq_buffer", size_t(17), "int8"),
+        Pothos::Exception);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/fec/lte_harq_buffer", size_t(8), "float32"),
+        Pothos::Exception);
+}
+
+static void testLTETransportBlockSegmentation(size_t transportBlockSize, bool corrupt)
+{
+    std::cout << " * Testing A=" << transportBlockSize << (corrupt ? " (corrupted)" : "") << "..." << std::endl;
+
+    const std::string transportBlockID = "TB";
+    const std::string blockStartID = "START";
+
+    const auto segmentation = getLTESegmentation(transportBlockSize);
+    const auto segmentedSize = segmentation.segmentedSize();
+    const auto randomInput = getRandomInput(transportBlockSize);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+    feederSource.call("feedLabel", Pothos::Label(transportBlockID, transportBlockSize, 0));
+
+    auto segmenter = Pothos::BlockRegistry::make("/fec/lte_transport_block_segmenter");
+    segmenter.call("setTransportBlockID", transportBlockID);
+    segmenter.call("setBlockStartID", blockStartID);
+
+    auto segmentedSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, segmenter, 0);
+        topology.connect(segmenter, 0, segmentedSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    auto segmented = segmentedSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(segmentedSize, segmented.elements());
+
+    // Each code block should be labeled for the encoder and pass its CRC.
+    const auto segmentedLabels = segmentedSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL((2 + (2 * segmentation.numCodeBlocks)), segmentedLabels.size());
+    testLabelsEqual(Pothos::Label(transportBlockID, segmentedSize, 0), segmentedLabels[0]);
+    testLabelsEqual(Pothos::Label("transportBlockSize", transportBlockSize, 0), segmentedLabels[1]);
+
+    size_t codeBlockStart = 0;
+    for(size_t codeBlockIndex = 0; codeBlockIndex < segmentation.numCodeBlocks; ++codeBlockIndex)
+    {
+        const size_t codeBlockSize = segmentation.codeBlockSize(codeBlockIndex);
+        testLabelsEqual(
+            Pothos::Label(blockStartID, codeBlockSize, codeBlockStart),
+            segmentedLabels[2 + (2 * codeBlockIndex)]);
+        testLabelsEqual(
+            Pothos::Label("numFillerBits", ((0 == codeBlockIndex) ? segmentation.numFillerBits : 0), codeBlockStart),
+            segmentedLabels[3 + (2 * codeBlockIndex)]);
+
+        if(segmentation.numCodeBlocks > 1)
+        {
+            POTHOS_TEST_TRUE(checkCRC24(
+                CRCType::CRC24B,
+                segmented.as<const std::uint8_t*>() + codeBlockStart,
+                codeBlockSize,
+                true));
+        }
+
+        codeBlockStart += codeBlockSize;
+    }
+
+    // Then, reassemble it, as if from the decoder.
+    if(corrupt) segmented.as<std::uint8_t*>()[segmentedSize / 2] ^= 1;
+
+    auto segmentedSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    segmentedSource.call("feedBuffer", segmented);
+    for(const auto& label: segmentedLabels) segmentedSource.call("feedLabel", label);
+
+    auto reassembler = Pothos::BlockRegistry::make("/fec/lte_transport_block_reassembler");
+    reassembler.call("setTransportBlockID", transportBlockID);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(segmentedSource, 0, reassembler, 0);
+        topology.connect(reassembler, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(transportBlockSize, outputBuffer.elements());
+    if(!corrupt)
+    {
+        POTHOS_TEST_EQUALA(
+            randomInput.as<const std::uint8_t*>(),
+            outputBuffer.as<const std::uint8_t*>(),
+            transportBlockSize);
+    }
+
+    const auto outputLabels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_TRUE(outputLabels.size() >= 2);
+    testLabelsEqual(Pothos::Label(transportBlockID, transportBlockSize, 0), outputLabels[0]);
+    testLabelsEqual(Pothos::Label("crcPassed", !corrupt, 0), outputLabels[1]);
+
+    POTHOS_TEST_EQUAL(
+        (corrupt ? 1ULL : 0ULL),
+        reassembler.call<unsigned long long>("numTransportBlockCRCFailures"));
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_lte_transport_block_segmentation)
+{
+    // Values from 3GPP TS 36.212, section 5.1.2
+    const auto oneBlock = getLTESegmentation(100);
+    POTHOS_TEST_EQUAL(1, oneBlock.numCodeBlocks);
+    POTHOS_TEST_EQUAL(128, oneBlock.largeCodeBlockSize);
+    POTHOS_TEST_EQUAL(4, oneBlock.numFillerBits);
+    POTHOS_TEST_EQUAL(0, oneBlock.codeBlockCRCSize);
+
+    const auto largestBlock = getLTESegmentation(6120);
+    POTHOS_TEST_EQUAL(1, largestBlock.numCodeBlocks);
+    POTHOS_TEST_EQUAL(6144, largestBlock.largeCodeBlockSize);
+    POTHOS_TEST_EQUAL(0, largestBlock.numFillerBits);
+
+    const auto twoBlocks = getLTESegmentation(6121);
+    POTHOS_TEST_EQUAL(2, twoBlocks.numCodeBlocks);
+    POTHOS_TEST_EQUAL(1, twoBlocks.numSmallCodeBlocks);
+    POTHOS_TEST_EQUAL(3072, twoBlocks.smallCodeBlockSize);
+    POTHOS_TEST_EQUAL(3136, twoBlocks.largeCodeBlockSize);
+    POTHOS_TEST_EQUAL(15, twoBlocks.numFillerBits);
+    POTHOS_TEST_EQUAL(24, twoBlocks.codeBlockCRCSize);
+
+    POTHOS_TEST_THROWS(getLTESegmentation(0), Pothos::InvalidArgumentException);
+
+    testLTETransportBlockSegmentation(100, false);
+    testLTETransportBlockSegmentation(6121, false);
+    testLTETransportBlockSegmentation(20000, false);
+    testLTETransportBlockSegmentation(20000, true);
+}
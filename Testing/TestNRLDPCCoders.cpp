@@ -0,0 +1,313 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "TestUtility.hpp"
+
+#include "NRLDPCBaseGraph.hpp"
+#include "NRLDPCQCEncoder.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Testing.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace FECTests;
+
+// Bit by bit, checks that j of each row sums bit (j + shift) mod Z of each of
+// its columns to zero.
+static void testSyndrome(const NRLDPCCode& code, const std::uint8_t* fullCodeword)
+{
+    const size_t Z = code.Z;
+
+    for(size_t row = 0; row < code.numRows; ++row)
+    {
+        for(size_t j = 0; j < Z; ++j)
+        {
+            unsigned parity = 0;
+            for(size_t entry = code.rowStarts[row]; entry < code.rowStarts[row+1]; ++entry)
+            {
+                parity ^= fullCodeword[(code.cols[entry] * Z) + ((j + code.shifts[entry]) % Z)];
+            }
+            POTHOS_TEST_EQUAL(0U, parity);
+        }
+    }
+}
+
+static void testBaseGraph(size_t number, size_t numRows, size_t numCols, size_t numInfoCols, size_t numEntries)
+{
+    const auto& baseGraph = NRLDPCBaseGraph::get(number);
+    POTHOS_TEST_EQUAL(number, baseGraph.number);
+    POTHOS_TEST_EQUAL(numRows, baseGraph.numRows);
+    POTHOS_TEST_EQUAL(numCols, baseGraph.numCols);
+    POTHOS_TEST_EQUAL(numInfoCols, baseGraph.numInfoCols);
+    POTHOS_TEST_EQUAL(numEntries, baseGraph.entries.size());
+
+    // Every row past the core ends with its own unshifted identity.
+    for(size_t entry = 0; entry < baseGraph.entries.size(); ++entry)
+    {
+        const auto& baseEntry = baseGraph.entries[entry];
+        if(baseEntry.row < NRLDPCBaseGraph::NumCoreRows) continue;
+
+        const bool isLast = ((entry + 1) == baseGraph.entries.size()) ||
+                            (baseGraph.entries[entry + 1].row != baseEntry.row);
+        POTHOS_TEST_EQUAL(isLast, (baseEntry.col == (numInfoCols + baseEntry.row)));
+    }
+
+    // The first core parity column can be solved for every lifting size,
+    // and every codeword checks out.
+    size_t iLS = 0;
+    for(size_t Z = NRLDPCMinLiftingSize; Z <= NRLDPCMaxLiftingSize; ++Z)
+    {
+        if(!getNRLDPCLiftingSizeSet(Z, &iLS)) continue;
+
+        const NRLDPCCode code(baseGraph, Z);
+        POTHOS_TEST_EQUAL(baseGraph.entries.size(), code.cols.size());
+        POTHOS_TEST_EQUAL(code.cols.size(), code.rowStarts.back());
+        for(const auto shift: code.shifts) POTHOS_TEST_TRUE(shift < Z);
+
+        NRLDPCQCEncoder qcEncoder(code);
+
+        const auto randomInput = getRandomInput(code.K());
+        const auto* bits = randomInput.as<const std::uint8_t*>();
+
+        std::vector<std::uint8_t> fullCodeword(bits, bits + (2 * Z));
+        fullCodeword.resize((2 * Z) + code.N());
+        qcEncoder.encode(bits, fullCodeword.data() + (2 * Z));
+        POTHOS_TEST_EQUALA(bits, fullCodeword.data(), code.K());
+
+        testSyndrome(code, fullCodeword.data());
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_nr_ldpc_base_graphs)
+{
+    size_t iLS = 0;
+    for(const size_t Z: {size_t(2), size_t(15), size_t(64), size_t(104), size_t(208), size_t(384)})
+    {
+        POTHOS_TEST_TRUE(getNRLDPCLiftingSizeSet(Z, &iLS));
+    }
+    POTHOS_TEST_TRUE(getNRLDPCLiftingSizeSet(320, &iLS));
+    POTHOS_TEST_EQUAL(size_t(2), iLS);
+    POTHOS_TEST_TRUE(getNRLDPCLiftingSizeSet(352, &iLS));
+    POTHOS_TEST_EQUAL(size_t(5), iLS);
+
+    for(const size_t Z: {size_t(0), size_t(1), size_t(17), size_t(385), size_t(768)})
+    {
+        POTHOS_TEST_TRUE(!getNRLDPCLiftingSizeSet(Z, &iLS));
+        POTHOS_TEST_THROWS(checkNRLDPCLiftingSize(Z), Pothos::InvalidArgumentException);
+    }
+
+    // 3GPP TS 38.212, tables 5.3.2-2 and 5.3.2-3
+    testBaseGraph(1, 46, 68, 22, 316);
+    testBaseGraph(2, 42, 52, 10, 197);
+
+    POTHOS_TEST_THROWS(NRLDPCBaseGraph::get(0), Pothos::InvalidArgumentException);
+    POTHOS_TEST_THROWS(NRLDPCBaseGraph::get(3), Pothos::InvalidArgumentException);
+
+    const NRLDPCCode code1(NRLDPCBaseGraph::get(1), 384);
+    POTHOS_TEST_EQUAL(size_t(8448), code1.K());
+    POTHOS_TEST_EQUAL(size_t(25344), code1.N());
+
+    const NRLDPCCode code2(NRLDPCBaseGraph::get(2), 13);
+    POTHOS_TEST_EQUAL(size_t(130), code2.K());
+    POTHOS_TEST_EQUAL(size_t(650), code2.N());
+
+    POTHOS_TEST_THROWS(NRLDPCCode(NRLDPCBaseGraph::get(2), 17), Pothos::InvalidArgumentException);
+}
+
+static void testNRLDPCEncoderOutput(size_t baseGraph, size_t Z)
+{
+    constexpr size_t numBlocks = 3;
+
+    const NRLDPCCode code(NRLDPCBaseGraph::get(baseGraph), Z);
+    const size_t K = code.K();
+    const size_t N = code.N();
+
+    std::cout << " * Testing base graph " << baseGraph << ", Z=" << Z << " (K=" << K << ", N=" << N << ")..." << std::endl;
+
+    const auto randomInput = getRandomInput(K * numBlocks);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto ldpcEncoder = Pothos::BlockRegistry::make("/fec/nr_ldpc_encoder", baseGraph, Z);
+    ldpcEncoder.call("setBlockStartID", "");
+    POTHOS_TEST_EQUAL(baseGraph, ldpcEncoder.call<size_t>("baseGraph"));
+    POTHOS_TEST_EQUAL(K, ldpcEncoder.call<size_t>("numInfoBits"));
+    POTHOS_TEST_EQUAL(N, ldpcEncoder.call<size_t>("numCodedBits"));
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, ldpcEncoder, 0);
+        topology.connect(ldpcEncoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(N * numBlocks, outputBuffer.elements());
+
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        const auto* bits = randomInput.as<const std::uint8_t*>() + (block * K);
+        const auto* codeword = outputBuffer.as<const std::uint8_t*>() + (block * N);
+
+        // The full codeword, with the systematic bits that aren't output
+        std::vector<std::uint8_t> fullCodeword(bits, bits + (2 * Z));
+        fullCodeword.insert(fullCodeword.end(), codeword, codeword + N);
+        POTHOS_TEST_EQUALA(bits, fullCodeword.data(), K);
+
+        testSyndrome(code, fullCodeword.data());
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_nr_ldpc_encoder_output)
+{
+    for(const size_t baseGraph: {size_t(1), size_t(2)})
+    {
+        // A lifting size from each set, including some with a single
+        // register or a partial last register
+        for(const size_t Z: {size_t(2), size_t(3), size_t(5), size_t(7), size_t(36), size_t(88), size_t(208), size_t(384)})
+        {
+            testNRLDPCEncoderOutput(baseGraph, Z);
+        }
+    }
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/fec/nr_ldpc_encoder", size_t(1), size_t(17)),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/fec/nr_ldpc_encoder", size_t(3), size_t(16)),
+        Pothos::ProxyExceptionMessage);
+}
+
+static void testNRLDPCCoderSymmetry(size_t baseGraph, size_t Z, const std::string& variant, bool unpack)
+{
+    std::cout << " * Testing base graph " << baseGraph << ", Z=" << Z << ", " << variant << ", unpack: " << std::boolalpha << unpack << "..." << std::endl;
+
+    constexpr size_t numBlocks = 4;
+    constexpr size_t numIterations = 10;
+    const std::string blockStartID = "START";
+
+    auto ldpcEncoder = Pothos::BlockRegistry::make("/fec/nr_ldpc_encoder", baseGraph, Z);
+    auto ldpcDecoder = Pothos::BlockRegistry::make("/fec/nr_ldpc_decoder", baseGraph, Z, numIterations, unpack);
+    ldpcDecoder.call("setVariant", variant);
+    ldpcDecoder.call("setBlockStartID", blockStartID);
+
+    const size_t K = ldpcEncoder.call<size_t>("numInfoBits");
+    const size_t N = ldpcEncoder.call<size_t>("numCodedBits");
+    const size_t blockOutputSize = unpack ? K : ((K + 7) / 8);
+
+    const auto randomInput = getRandomInput(K * numBlocks);
+
+    auto expectedOutput = randomInput;
+    if(!unpack)
+    {
+        expectedOutput = Pothos::BufferChunk("uint8", (blockOutputSize * numBlocks));
+        for(size_t block = 0; block < numBlocks; ++block)
+        {
+            packBits(
+                randomInput.as<const std::uint8_t*>() + (block * K),
+                expectedOutput.as<std::uint8_t*>() + (block * blockOutputSize),
+                K);
+        }
+    }
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto encodedSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, ldpcEncoder, 0);
+        topology.connect(ldpcEncoder, 0, encodedSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    // Unlike the turbo decoders, an LDPC decoder can't treat a 0 bit as an
+    // erasure, so the codeword bits are mapped to soft values.
+    const auto encodedBuffer = encodedSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(N * numBlocks, encodedBuffer.elements());
+
+    Pothos::BufferChunk softBits("uint8", encodedBuffer.elements());
+    for(size_t elem = 0; elem < softBits.elements(); ++elem)
+    {
+        softBits.as<std::int8_t*>()[elem] = encodedBuffer.as<const std::uint8_t*>()[elem] ? std::int8_t(defaultAmp)
+                                                                                            : std::int8_t(-defaultAmp);
+    }
+
+    auto softSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    softSource.call("feedBuffer", softBits);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(softSource, 0, ldpcDecoder, 0);
+        topology.connect(ldpcDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.elements());
+
+    // Each decoded block is marked, back to back, and notes how many
+    // iterations it took, which for a clean codeword is the first.
+    std::vector<Pothos::Label> outputLabels;
+    std::vector<Pothos::Label> iterationLabels;
+    for(const auto& label: collectorSink.call<std::vector<Pothos::Label>>("getLabels"))
+    {
+        if(label.id == blockStartID)      outputLabels.push_back(label);
+        else if(label.id == "iterations") iterationLabels.push_back(label);
+    }
+    POTHOS_TEST_EQUAL(numBlocks, outputLabels.size());
+    POTHOS_TEST_EQUAL(numBlocks, iterationLabels.size());
+
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        testLabelsEqual(Pothos::Label(blockStartID, blockOutputSize, (block * blockOutputSize)), outputLabels[block]);
+        POTHOS_TEST_EQUAL(size_t(1), iterationLabels[block].data.convert<size_t>());
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_nr_ldpc_coder_symmetry)
+{
+    for(const size_t baseGraph: {size_t(1), size_t(2)})
+    {
+        for(const std::string variant: {"Normalized Min-Sum", "Offset Min-Sum"})
+        {
+            // K isn't a multiple of 8 for odd Z, so the packed output is
+            // padded. For Z=384, an unpacked base graph 1 block is 8448
+            // bits, more than a default buffer holds.
+            for(const size_t Z: {size_t(5), size_t(64), size_t(384)})
+            {
+                testNRLDPCCoderSymmetry(baseGraph, Z, variant, true);
+                testNRLDPCCoderSymmetry(baseGraph, Z, variant, false);
+            }
+        }
+    }
+
+    auto ldpcDecoder = Pothos::BlockRegistry::make("/fec/nr_ldpc_decoder", size_t(2), size_t(64), size_t(10), true);
+    POTHOS_TEST_THROWS(ldpcDecoder.call("setVariant", "Sum-Product"), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(ldpcDecoder.call("setOffset", -1), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(ldpcDecoder.call("setOffset", 32), Pothos::ProxyExceptionMessage);
+}
@@ -0,0 +1,265 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "TestUtility.hpp"
+
+#include "UMTSTurboInterleaver.hpp"
+#include "Utility.hpp"
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Testing.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace FECTests;
+
+POTHOS_TEST_BLOCK("/fec/tests", test_umts_turbo_interleavers)
+{
+    POTHOS_TEST_THROWS(getUMTSTurboInterleaver(UMTSTurboMinK - 1), Pothos::InvalidArgumentException);
+    POTHOS_TEST_THROWS(getUMTSTurboInterleaver(UMTSTurboMaxK + 1), Pothos::InvalidArgumentException);
+
+    for(size_t K = UMTSTurboMinK; K <= UMTSTurboMaxK; ++K)
+    {
+        // Every call should return the same shared tables.
+        const auto& interleaver = getUMTSTurboInterleaver(K);
+        POTHOS_TEST_EQUAL(&interleaver, &getUMTSTurboInterleaver(K));
+        POTHOS_TEST_EQUAL(K, interleaver.K);
+        POTHOS_TEST_EQUAL(K, interleaver.forward.size());
+        POTHOS_TEST_EQUAL(K, interleaver.inverse.size());
+
+        // Each is a permutation, and the inverse of the other.
+        std::vector<bool> seen(K, false);
+        for(size_t i = 0; i < K; ++i)
+        {
+            const size_t index = interleaver.forward[i];
+            POTHOS_TEST_TRUE(index < K);
+            POTHOS_TEST_TRUE(!seen[index]);
+            seen[index] = true;
+
+            POTHOS_TEST_EQUAL(i, interleaver.inverse[index]);
+        }
+    }
+
+    // For K=40, 5 rows of 8 columns with p=7 and v=3, where the last row's
+    // first and last columns are exchanged, as the matrix has no padding
+    // (3GPP TS 25.212, section 4.2.3.2.3).
+    const std::vector<std::uint16_t> expectedForward40 =
+    {
+        39, 25, 17, 9, 1, 35, 27, 21, 11, 5,
+        34, 26, 20, 10, 4, 38, 30, 22, 14, 6,
+        36, 28, 18, 12, 2, 37, 29, 19, 13, 3,
+        32, 24, 16, 8, 0, 33, 31, 23, 15, 7
+    };
+    POTHOS_TEST_EQUALV(expectedForward40, getUMTSTurboInterleaver(40).forward);
+}
+
+// A bit at a time, straight from 3GPP TS 25.212, section 4.2.3.2, in the
+// specification's output order: x[k], z[k], z'[k] for each bit, then
+// each encoder's termination bits.
+static std::vector<std::uint8_t> referenceUMTSTurboEncode(const std::uint8_t* bits, size_t K)
+{
+    const auto& interleaver = getUMTSTurboInterleaver(K);
+
+    auto runRSC = [K](const std::vector<std::uint8_t>& input, std::vector<std::uint8_t>& parityOut, std::vector<std::uint8_t>& tailOut)
+    {
+        unsigned s1 = 0, s2 = 0, s3 = 0;
+        for(size_t k = 0; k < K; ++k)
+        {
+            const unsigned feedback = input[k] ^ s2 ^ s3;
+            parityOut.push_back(std::uint8_t(feedback ^ s1 ^ s3));
+            s3 = s2;
+            s2 = s1;
+            s1 = feedback;
+        }
+        for(size_t step = 0; step < 3; ++step)
+        {
+            tailOut.push_back(std::uint8_t(s2 ^ s3));
+            tailOut.push_back(std::uint8_t(s1 ^ s3));
+            s3 = s2;
+            s2 = s1;
+            s1 = 0;
+        }
+    };
+
+    std::vector<std::uint8_t> x(bits, bits + K);
+    std::vector<std::uint8_t> xInterleaved(K);
+    for(size_t k = 0; k < K; ++k) xInterleaved[k] = x[interleaver.forward[k]];
+
+    std::vector<std::uint8_t> z, zInterleaved, tails;
+    runRSC(x, z, tails);
+    runRSC(xInterleaved, zInterleaved, tails);
+
+    std::vector<std::uint8_t> output;
+    for(size_t k = 0; k < K; ++k)
+    {
+        output.push_back(x[k]);
+        output.push_back(z[k]);
+        output.push_back(zInterleaved[k]);
+    }
+    output.insert(output.end(), tails.begin(), tails.end());
+
+    return output;
+}
+
+static void testUMTSTurboEncoderOutput(size_t blockSize, size_t numBlocks, const std::string& engine)
+{
+    std::cout << " * Testing K=" << blockSize << " x " << numBlocks << " (" << engine << ")..." << std::endl;
+
+    const auto randomInput = getRandomInput(blockSize * numBlocks);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto umtsEncoder = Pothos::BlockRegistry::make("/fec/umts_turbo_encoder", "Interleaved");
+    umtsEncoder.call("setBlockStartID", "");
+    umtsEncoder.call("setEngine", engine);
+    umtsEncoder.call("setBlockSize", blockSize);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, umtsEncoder, 0);
+        topology.connect(umtsEncoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    std::vector<std::uint8_t> expectedOutput;
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        const auto blockOutput = referenceUMTSTurboEncode(randomInput.as<const std::uint8_t*>() + (block * blockSize), blockSize);
+        expectedOutput.insert(expectedOutput.end(), blockOutput.begin(), blockOutput.end());
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.size(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.data(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.size());
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_umts_turbo_encoder_output)
+{
+    // Sizes that aren't multiples of 8, and sizes from each row pattern
+    testUMTSTurboEncoderOutput(40, 70, "Bitsliced");
+    testUMTSTurboEncoderOutput(41, 3, "Table");
+    testUMTSTurboEncoderOutput(530, 3, "Table");
+    testUMTSTurboEncoderOutput(2281, 9, "Bitsliced");
+    testUMTSTurboEncoderOutput(5114, 2, "Table");
+
+    auto umtsEncoder = Pothos::BlockRegistry::make("/fec/umts_turbo_encoder", "Separate");
+    POTHOS_TEST_THROWS(umtsEncoder.call("setEngine", "TurboFEC"), Pothos::ProxyExceptionMessage);
+    for(const size_t blockSize: {size_t(39), size_t(5115)})
+    {
+        POTHOS_TEST_THROWS(umtsEncoder.call("setBlockSize", blockSize), Pothos::ProxyExceptionMessage);
+    }
+}
+
+static void testUMTSTurboCoderSymmetry(
+    const std::string& decoderEngine,
+    const std::string& streamFormat,
+    bool unpack)
+{
+    std::cout << " * Testing " << decoderEngine << " (" << streamFormat << ", unpack: " << std::boolalpha << unpack << ")..." << std::endl;
+
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    // Labeled blocks of sizes from each row pattern, most not multiples of 8
+    const std::vector<size_t> blockSizes = {40, 159, 160, 530, 1000, 40, 2281, 3161, 5114};
+
+    Pothos::BufferChunk input("uint8", 0);
+    std::vector<Pothos::Label> inputLabels;
+    Pothos::BufferChunk expectedOutput("uint8", 0);
+    for(const size_t blockSize: blockSizes)
+    {
+        const auto blockBits = getRandomInput(blockSize);
+        inputLabels.emplace_back(blockStartID, blockSize, input.elements());
+        input.append(blockBits);
+
+        if(unpack) expectedOutput.append(blockBits);
+        else
+        {
+            Pothos::BufferChunk packedBits("uint8", ((blockSize + 7) / 8));
+            packBits(blockBits.as<const std::uint8_t*>(), packedBits.as<std::uint8_t*>(), blockSize);
+            expectedOutput.append(packedBits);
+        }
+    }
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", input);
+    for(const auto& label: inputLabels) feederSource.call("feedLabel", label);
+
+    auto umtsEncoder = Pothos::BlockRegistry::make("/fec/umts_turbo_encoder", streamFormat);
+    auto umtsDecoder = Pothos::BlockRegistry::make("/fec/umts_turbo_decoder", numIterations, unpack, streamFormat);
+
+    umtsEncoder.call("setBlockStartID", blockStartID);
+    umtsDecoder.call("setBlockStartID", blockStartID);
+    umtsDecoder.call("setEngine", decoderEngine);
+    umtsDecoder.call("setStoppingCriterion", "Hard Decision");
+    POTHOS_TEST_EQUAL(decoderEngine, umtsDecoder.call<std::string>("engine"));
+
+    const size_t numPorts = ("Interleaved" == streamFormat) ? 1 : 3;
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, umtsEncoder, 0);
+        for(size_t port = 0; port < numPorts; ++port) topology.connect(umtsEncoder, port, umtsDecoder, port);
+        topology.connect(umtsDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.elements());
+
+    // Each decoded block is marked, back to back, and notes how many
+    // iterations it took.
+    std::vector<Pothos::Label> outputLabels;
+    size_t numIterationLabels = 0;
+    for(const auto& label: collectorSink.call<std::vector<Pothos::Label>>("getLabels"))
+    {
+        if(label.id == blockStartID)     outputLabels.push_back(label);
+        else if(label.id == "iterations") ++numIterationLabels;
+    }
+    POTHOS_TEST_EQUAL(blockSizes.size(), outputLabels.size());
+    POTHOS_TEST_EQUAL(blockSizes.size(), numIterationLabels);
+
+    size_t offset = 0;
+    for(size_t block = 0; block < blockSizes.size(); ++block)
+    {
+        testLabelsEqual(Pothos::Label(blockStartID, blockSizes[block], offset), outputLabels[block]);
+        offset += unpack ? blockSizes[block] : ((blockSizes[block] + 7) / 8);
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_umts_turbo_coder_symmetry)
+{
+    testUMTSTurboCoderSymmetry("Max-Log-MAP 16-bit", "Separate", true);
+    testUMTSTurboCoderSymmetry("Log-MAP 16-bit", "Interleaved", false);
+    testUMTSTurboCoderSymmetry("Max-Log-MAP 8-bit", "Interleaved", true);
+    testUMTSTurboCoderSymmetry("Log-MAP 8-bit", "Separate", false);
+
+    auto umtsDecoder = Pothos::BlockRegistry::make("/fec/umts_turbo_decoder", size_t(4), true, "Separate");
+    POTHOS_TEST_THROWS(umtsDecoder.call("setEngine", "TurboFEC"), Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(umtsDecoder.call("setStoppingCriterion", "CRC"), Pothos::ProxyExceptionMessage);
+    for(const size_t blockSize: {size_t(39), size_t(5115)})
+    {
+        POTHOS_TEST_THROWS(umtsDecoder.call("setBlockSize", blockSize), Pothos::ProxyExceptionMessage);
+    }
+}
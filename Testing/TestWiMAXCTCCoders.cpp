@@ -0,0 +1,344 @@
+// Copyright (c) 2020 Nicholas Corgan
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "TestUtility.hpp"
+
+#include "Utility.hpp"
+#include "WiMAXCTCInterleaver.hpp"
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Testing.hpp>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace FECTests;
+
+POTHOS_TEST_BLOCK("/fec/tests", test_wimax_ctc_interleavers)
+{
+    POTHOS_TEST_THROWS(getWiMAXCTCInterleaver(WiMAXCTCMinN - 1), Pothos::InvalidArgumentException);
+    POTHOS_TEST_THROWS(getWiMAXCTCInterleaver(100), Pothos::InvalidArgumentException);
+
+    for(const auto& params: WiMAXCTCParamsTable)
+    {
+        const size_t N = params.N;
+        POTHOS_TEST_TRUE(isWiMAXCTCBlockSize(2*N));
+        POTHOS_TEST_TRUE(!isWiMAXCTCBlockSize((2*N) + 1));
+
+        // Every call should return the same shared tables.
+        const auto& interleaver = getWiMAXCTCInterleaver(N);
+        POTHOS_TEST_EQUAL(&interleaver, &getWiMAXCTCInterleaver(N));
+        POTHOS_TEST_EQUAL(N, interleaver.N);
+        POTHOS_TEST_EQUAL(N, interleaver.forward.size());
+        POTHOS_TEST_EQUAL(N, interleaver.inverse.size());
+
+        // Each is a permutation, and the inverse of the other.
+        std::vector<bool> seen(N, false);
+        for(size_t j = 0; j < N; ++j)
+        {
+            const size_t index = interleaver.forward[j];
+            POTHOS_TEST_TRUE(index < N);
+            POTHOS_TEST_TRUE(!seen[index]);
+            seen[index] = true;
+
+            POTHOS_TEST_EQUAL(j, interleaver.inverse[index]);
+        }
+    }
+
+    // For N=24, P0=5 and the other parameters are 0, so P(j) = 5j+1, plus
+    // N/2 for odd j.
+    const std::vector<std::uint16_t> expectedForward24 =
+    {
+        1, 18, 11, 4, 21, 14, 7, 0, 17, 10, 3, 20,
+        13, 6, 23, 16, 9, 2, 19, 12, 5, 22, 15, 8
+    };
+    POTHOS_TEST_EQUALV(expectedForward24, getWiMAXCTCInterleaver(24).forward);
+}
+
+// A couple at a time, straight from IEEE 802.16-2009, section 8.4.9.2.3.1.
+// Rather than looking up the circulation state, this finds it by trying
+// every state and keeping the one the block returns to, which must be
+// unique.
+static std::vector<std::uint8_t> referenceWiMAXCTCEncode(const std::uint8_t* bits, size_t K)
+{
+    const size_t N = K / 2;
+    const auto& interleaver = getWiMAXCTCInterleaver(N);
+
+    using Couple = std::pair<unsigned, unsigned>;
+
+    auto runCRSC = [N](const std::vector<Couple>& input, std::vector<std::uint8_t>& yOut, std::vector<std::uint8_t>& wOut)
+    {
+        size_t numCirculationStates = 0;
+        for(unsigned startState = 0; startState < 8; ++startState)
+        {
+            unsigned s1 = (startState >> 2) & 1, s2 = (startState >> 1) & 1, s3 = startState & 1;
+            std::vector<std::uint8_t> y, w;
+            for(const auto& couple: input)
+            {
+                const unsigned A = couple.first, B = couple.second;
+                const unsigned feedback = A ^ B ^ s1 ^ s3;
+                y.push_back(std::uint8_t(feedback ^ s2 ^ s3));
+                w.push_back(std::uint8_t(feedback ^ s3));
+
+                s3 = s2 ^ B;
+                s2 = s1 ^ B;
+                s1 = feedback;
+            }
+
+            if(startState == ((s1 << 2) | (s2 << 1) | s3))
+            {
+                ++numCirculationStates;
+                yOut = y;
+                wOut = w;
+            }
+        }
+
+        POTHOS_TEST_EQUAL(size_t(1), numCirculationStates);
+        POTHOS_TEST_EQUAL(N, yOut.size());
+    };
+
+    std::vector<Couple> couples, interleavedCouples;
+    for(size_t i = 0; i < N; ++i) couples.emplace_back(bits[2*i], bits[(2*i)+1]);
+    for(size_t j = 0; j < N; ++j)
+    {
+        const size_t i = interleaver.forward[j];
+        const auto& couple = couples[i];
+        interleavedCouples.push_back((i % 2) ? Couple(couple.second, couple.first) : couple);
+    }
+
+    std::vector<std::uint8_t> y1, w1, y2, w2;
+    runCRSC(couples, y1, w1);
+    runCRSC(interleavedCouples, y2, w2);
+
+    std::vector<std::uint8_t> output;
+    for(const auto& couple: couples) output.push_back(std::uint8_t(couple.first));
+    for(const auto& couple: couples) output.push_back(std::uint8_t(couple.second));
+    for(const auto* subblock: {&y1, &y2, &w1, &w2})
+    {
+        output.insert(output.end(), subblock->begin(), subblock->end());
+    }
+
+    return output;
+}
+
+static void testWiMAXCTCEncoderOutput(size_t blockSize, size_t numBlocks)
+{
+    std::cout << " * Testing K=" << blockSize << " x " << numBlocks << "..." << std::endl;
+
+    const auto randomInput = getRandomInput(blockSize * numBlocks);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", randomInput);
+
+    auto ctcEncoder = Pothos::BlockRegistry::make("/fec/wimax_ctc_encoder");
+    ctcEncoder.call("setBlockStartID", "");
+    ctcEncoder.call("setBlockSize", blockSize);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, ctcEncoder, 0);
+        topology.connect(ctcEncoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    std::vector<std::uint8_t> expectedOutput;
+    for(size_t block = 0; block < numBlocks; ++block)
+    {
+        const auto blockOutput = referenceWiMAXCTCEncode(randomInput.as<const std::uint8_t*>() + (block * blockSize), blockSize);
+        expectedOutput.insert(expectedOutput.end(), blockOutput.begin(), blockOutput.end());
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.size(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.data(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.size());
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_wimax_ctc_encoder_output)
+{
+    // Every block size, whose values of N mod 7 between them cover every
+    // row of the circulation state table
+    for(const auto& params: WiMAXCTCParamsTable)
+    {
+        testWiMAXCTCEncoderOutput((2 * params.N), 5);
+    }
+
+    auto ctcEncoder = Pothos::BlockRegistry::make("/fec/wimax_ctc_encoder");
+    for(const size_t blockSize: {size_t(46), size_t(50), size_t(482)})
+    {
+        POTHOS_TEST_THROWS(ctcEncoder.call("setBlockSize", blockSize), Pothos::ProxyExceptionMessage);
+    }
+}
+
+static void testWiMAXCTCCoderSymmetry(bool unpack)
+{
+    std::cout << " * Testing unpack: " << std::boolalpha << unpack << "..." << std::endl;
+
+    constexpr size_t numIterations = 4;
+    const std::string blockStartID = "START";
+
+    // Labeled blocks of every size, not in order
+    std::vector<size_t> blockSizes;
+    for(const auto& params: WiMAXCTCParamsTable) blockSizes.insert(blockSizes.begin(), (2 * params.N));
+    blockSizes.push_back(48);
+
+    Pothos::BufferChunk input("uint8", 0);
+    std::vector<Pothos::Label> inputLabels;
+    Pothos::BufferChunk expectedOutput("uint8", 0);
+    for(const size_t blockSize: blockSizes)
+    {
+        const auto blockBits = getRandomInput(blockSize);
+        inputLabels.emplace_back(blockStartID, blockSize, input.elements());
+        input.append(blockBits);
+
+        if(unpack) expectedOutput.append(blockBits);
+        else
+        {
+            Pothos::BufferChunk packedBits("uint8", (blockSize / 8));
+            packBits(blockBits.as<const std::uint8_t*>(), packedBits.as<std::uint8_t*>(), blockSize);
+            expectedOutput.append(packedBits);
+        }
+    }
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", input);
+    for(const auto& label: inputLabels) feederSource.call("feedLabel", label);
+
+    auto ctcEncoder = Pothos::BlockRegistry::make("/fec/wimax_ctc_encoder");
+    auto ctcDecoder = Pothos::BlockRegistry::make("/fec/wimax_ctc_decoder", numIterations, unpack);
+
+    ctcEncoder.call("setBlockStartID", blockStartID);
+    ctcDecoder.call("setBlockStartID", blockStartID);
+    ctcDecoder.call("setStoppingCriterion", "Hard Decision");
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, ctcEncoder, 0);
+        topology.connect(ctcEncoder, 0, ctcDecoder, 0);
+        topology.connect(ctcDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(expectedOutput.elements(), outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        expectedOutput.as<const std::uint8_t*>(),
+        outputBuffer.as<const std::uint8_t*>(),
+        expectedOutput.elements());
+
+    // Each decoded block is marked, back to back, and notes how many
+    // iterations it took.
+    std::vector<Pothos::Label> outputLabels;
+    size_t numIterationLabels = 0;
+    for(const auto& label: collectorSink.call<std::vector<Pothos::Label>>("getLabels"))
+    {
+        if(label.id == blockStartID)     outputLabels.push_back(label);
+        else if(label.id == "iterations") ++numIterationLabels;
+    }
+    POTHOS_TEST_EQUAL(blockSizes.size(), outputLabels.size());
+    POTHOS_TEST_EQUAL(blockSizes.size(), numIterationLabels);
+
+    size_t offset = 0;
+    for(size_t block = 0; block < blockSizes.size(); ++block)
+    {
+        testLabelsEqual(Pothos::Label(blockStartID, blockSizes[block], offset), outputLabels[block]);
+        offset += unpack ? blockSizes[block] : (blockSizes[block] / 8);
+    }
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_wimax_ctc_coder_symmetry)
+{
+    testWiMAXCTCCoderSymmetry(true);
+    testWiMAXCTCCoderSymmetry(false);
+
+    auto ctcDecoder = Pothos::BlockRegistry::make("/fec/wimax_ctc_decoder", size_t(4), true);
+    POTHOS_TEST_THROWS(ctcDecoder.call("setStoppingCriterion", "CRC"), Pothos::ProxyExceptionMessage);
+    for(const size_t blockSize: {size_t(46), size_t(50), size_t(482)})
+    {
+        POTHOS_TEST_THROWS(ctcDecoder.call("setBlockSize", blockSize), Pothos::ProxyExceptionMessage);
+    }
+}
+
+static void testWiMAXCTCDecoderErrorCorrection(size_t N)
+{
+    std::cout << " * Testing N=" << N << "..." << std::endl;
+
+    constexpr size_t numIterations = 8;
+    constexpr int amplitude = 32;
+    const size_t blockSize = 2 * N;
+    const std::string blockStartID = "START";
+
+    // A fixed block and error pattern, so every run corrects the same
+    // errors
+    std::vector<std::uint8_t> bits(blockSize);
+    for(size_t elem = 0; elem < blockSize; ++elem) bits[elem] = std::uint8_t(((elem * 2654435761U) >> 13) & 1);
+
+    const auto encoded = referenceWiMAXCTCEncode(bits.data(), blockSize);
+
+    // Map each bit to +/- the amplitude, with a little deterministic noise,
+    // then flip every 13th symbol, systematic and parity alike.
+    Pothos::BufferChunk softBits("uint8", encoded.size());
+    size_t numSystematicErrors = 0;
+    for(size_t elem = 0; elem < encoded.size(); ++elem)
+    {
+        int value = (encoded[elem] ? amplitude : -amplitude) + ((amplitude * (int((elem * 5) % 7) - 3)) / 12);
+        if(4 == (elem % 13))
+        {
+            value = -value;
+            if(elem < blockSize) ++numSystematicErrors;
+        }
+
+        softBits.as<std::int8_t*>()[elem] = static_cast<std::int8_t>(value);
+    }
+    POTHOS_TEST_TRUE(numSystematicErrors > 0);
+
+    auto feederSource = Pothos::BlockRegistry::make("/blocks/feeder_source", "uint8");
+    feederSource.call("feedBuffer", softBits);
+    feederSource.call("feedLabel", Pothos::Label(blockStartID, softBits.elements(), 0));
+
+    auto ctcDecoder = Pothos::BlockRegistry::make("/fec/wimax_ctc_decoder", numIterations, true);
+    ctcDecoder.call("setBlockStartID", blockStartID);
+
+    auto collectorSink = Pothos::BlockRegistry::make("/blocks/collector_sink", "uint8");
+
+    {
+        Pothos::Topology topology;
+
+        topology.connect(feederSource, 0, ctcDecoder, 0);
+        topology.connect(ctcDecoder, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.05));
+    }
+
+    const auto outputBuffer = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_EQUAL(blockSize, outputBuffer.elements());
+    POTHOS_TEST_EQUALA(
+        bits.data(),
+        outputBuffer.as<const std::uint8_t*>(),
+        blockSize);
+}
+
+POTHOS_TEST_BLOCK("/fec/tests", test_wimax_ctc_decoder_error_correction)
+{
+    // Table 8-310's smallest and largest block sizes, and some between
+    for(const size_t N: {size_t(24), size_t(72), size_t(108), size_t(180), size_t(240)})
+    {
+        testWiMAXCTCDecoderErrorCorrection(N);
+    }
+}